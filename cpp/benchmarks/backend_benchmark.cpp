@@ -0,0 +1,184 @@
+#include "order_book.hpp"
+#include "order.hpp"
+#include "types.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace orderbook;
+
+// ============================================================================
+// Level Backend Benchmark
+// Records one synthetic order flow per profile, then replays the identical
+// flow through a book on each LevelBackend and prints throughput and
+// per-event latency percentiles. Use it to pick OrderBookConfig::levels for
+// an instrument: run it with the profile closest to that instrument's flow.
+//
+//   tight: crypto-style book. Orders land within ~50 ticks of a mid that
+//          random-walks a tick at a time; heavy add/cancel churn at the touch.
+//   wide:  illiquid book. Orders scatter over +-5000 ticks of a slow mid, so
+//          most levels hold one or two orders and sit far from the touch.
+//   deep:  adversarial for the array containers. Like wide, but orders land
+//          uniformly over the whole band rather than clustering at the touch,
+//          so nearly every insert and cancel is far from it.
+//
+// Usage: backend_benchmark [events_per_profile]
+// ============================================================================
+
+namespace {
+
+struct Event {
+    enum Kind : uint8_t { Add, Cancel, Market } kind;
+    Side side;
+    Price price;        // Add only
+    Quantity quantity;  // Add / Market
+    OrderId id;         // Add: the new order; Cancel: its target
+};
+
+struct Profile {
+    const char* name;
+    Price spread_ticks;   // Max distance of a new order from the mid
+    int walk_every;       // Events between mid moves
+    Price walk_ticks;     // Size of one mid move
+    bool uniform;         // Spread orders evenly over the band, not near the mid
+};
+
+constexpr Price TICK = 10'000;   // 0.01 in fixed point
+
+std::vector<Event> record(const Profile& profile, size_t count, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<Event> events;
+    std::vector<OrderId> resting;   // Ids that may still rest; targets for cancels
+    events.reserve(count);
+
+    Price mid = 10'000;   // In ticks
+    OrderId next_id = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (i % profile.walk_every == 0) {
+            mid += (rng() & 1) ? profile.walk_ticks : -profile.walk_ticks;
+            mid = std::max(mid, profile.spread_ticks + 2);
+        }
+        const uint64_t r = rng();
+        const Side side = (r >> 8) & 1 ? Side::Buy : Side::Sell;
+        const uint64_t roll = r % 100;
+
+        if (roll < 55 || resting.empty()) {
+            // Exponential distance from the mid (most orders near the touch)
+            // unless the profile is uniform
+            std::exponential_distribution<double> distance(6.0 / static_cast<double>(profile.spread_ticks));
+            const Price d = profile.uniform
+                ? 1 + static_cast<Price>((r >> 16) % static_cast<uint64_t>(profile.spread_ticks))
+                : std::min<Price>(profile.spread_ticks, 1 + static_cast<Price>(distance(rng)));
+            const Price ticks = side == Side::Buy ? mid - d : mid + d;
+            events.push_back({Event::Add, side, ticks * TICK, 1 + (r >> 32) % 500, ++next_id});
+            resting.push_back(next_id);
+        } else if (roll < 95) {
+            const size_t pick = (r >> 16) % resting.size();
+            events.push_back({Event::Cancel, side, 0, 0, resting[pick]});
+            resting[pick] = resting.back();
+            resting.pop_back();
+        } else {
+            events.push_back({Event::Market, side, 0, 1 + (r >> 32) % 1'000, ++next_id});
+        }
+    }
+    return events;
+}
+
+const char* backend_name(LevelBackend backend) {
+    switch (backend) {
+        case LevelBackend::Map:    return "map";
+        case LevelBackend::Ladder: return "ladder";
+        case LevelBackend::BTree:  return "btree";
+        case LevelBackend::Vector: return "vector";
+    }
+    return "?";
+}
+
+struct Result {
+    double events_per_sec = 0;
+    uint64_t p50 = 0, p99 = 0, p999 = 0;
+    size_t levels = 0;
+};
+
+Result replay(const std::vector<Event>& events, LevelBackend backend) {
+    OrderBookConfig config;
+    config.tick_size = TICK;
+    config.levels = backend;
+    OrderBook book("BTCUSD", config);
+
+    // Built up front so replay only times the book; reserve keeps Order* stable
+    std::vector<Order> orders;
+    orders.reserve(events.size());
+    for (const Event& e : events) {
+        if (e.kind == Event::Add) {
+            orders.emplace_back(e.id, "BTCUSD", e.side, OrderType::Limit, e.quantity, e.price);
+        } else if (e.kind == Event::Market) {
+            orders.emplace_back(e.id, "BTCUSD", e.side, OrderType::Market, e.quantity);
+        }
+    }
+
+    std::vector<uint64_t> latencies;
+    latencies.reserve(events.size());
+    using Clock = std::chrono::steady_clock;
+    size_t next_order = 0;
+
+    const auto start = Clock::now();
+    for (const Event& e : events) {
+        const auto t0 = Clock::now();
+        if (e.kind == Event::Cancel) {
+            book.cancel_order(e.id);
+        } else {
+            book.add_order(&orders[next_order++]);
+        }
+        const auto t1 = Clock::now();
+        latencies.push_back(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count()));
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    Result result;
+    result.events_per_sec = static_cast<double>(events.size()) / seconds;
+    std::sort(latencies.begin(), latencies.end());
+    auto at = [&](double q) {
+        return latencies[std::min(latencies.size() - 1,
+                                  static_cast<size_t>(q * static_cast<double>(latencies.size())))];
+    };
+    result.p50 = at(0.50);
+    result.p99 = at(0.99);
+    result.p999 = at(0.999);
+    result.levels = book.bid_levels() + book.ask_levels();
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+    const Profile profiles[] = {
+        {"tight", 50, 50, 1, false},
+        {"wide", 5'000, 500, 5, false},
+        {"deep", 5'000, 500, 5, true},
+    };
+    const LevelBackend backends[] = {LevelBackend::Map, LevelBackend::Ladder, LevelBackend::BTree,
+                                     LevelBackend::Vector};
+
+    std::printf("%-8s %-8s %12s %10s %10s %10s %10s\n",
+                "profile", "backend", "Mevents/s", "p50 ns", "p99 ns", "p99.9 ns", "levels");
+    for (const Profile& profile : profiles) {
+        const std::vector<Event> events = record(profile, count, 42);
+        for (LevelBackend backend : backends) {
+            replay(events, backend);   // Warm-up: page in the allocator and code
+            const Result r = replay(events, backend);
+            std::printf("%-8s %-8s %12.2f %10llu %10llu %10llu %10zu\n",
+                        profile.name, backend_name(backend), r.events_per_sec / 1e6,
+                        static_cast<unsigned long long>(r.p50),
+                        static_cast<unsigned long long>(r.p99),
+                        static_cast<unsigned long long>(r.p999), r.levels);
+        }
+    }
+    return 0;
+}
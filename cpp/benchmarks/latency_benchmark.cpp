@@ -1,7 +1,23 @@
 #include <benchmark/benchmark.h>
+#include "bar_aggregator.hpp"
 #include "order_book.hpp"
 #include "order.hpp"
 #include "types.hpp"
+#include "book_view.hpp"
+#include "replication.hpp"
+#include "async_client.hpp"
+#include "conflator.hpp"
+#include "market_data.hpp"
+#include "redis_publisher.hpp"
+#include "resp_writer.hpp"
+#include "trade_store.hpp"
+#include <hiredis.h>
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <thread>
 #include <vector>
 
 using namespace orderbook;
@@ -59,6 +75,44 @@ static void BM_AddOrder(benchmark::State& state) {
 }
 BENCHMARK(BM_AddOrder)->Unit(benchmark::kMicrosecond);
 
+// ============================================================================
+// BM_AddOrderPresized
+// Measures: BM_AddOrder on a book built from OrderBookConfig and warmed up,
+// i.e. what the first minute of a session costs. Should match steady state:
+// no rehashes, and with the pool allocator no malloc per node.
+// Arg 0 = system allocator, 1 = pool allocator.
+// ============================================================================
+static void BM_AddOrderPresized(benchmark::State& state) {
+    auto orders = make_limit_orders(POOL, 1, Side::Buy, 99.0);
+    OrderBookConfig config;
+    config.expected_orders = POOL;
+    config.expected_levels = 100;
+    config.allocator = state.range(0) ? AllocatorKind::Pool : AllocatorKind::System;
+
+    auto fresh_book = [&] {
+        OrderBook book("AAPL", config);
+        book.warm_up();
+        return book;
+    };
+
+    OrderBook book = fresh_book();
+    int64_t idx = 0;
+
+    for (auto _ : state) {
+        if (idx > 0 && idx % POOL == 0) {
+            state.PauseTiming();
+            book = fresh_book();
+            reset_orders(orders);
+            state.ResumeTiming();
+        }
+        benchmark::DoNotOptimize(book.add_order(&orders[idx % POOL]));
+        ++idx;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AddOrderPresized)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
 // ============================================================================
 // BM_CancelOrder
 // Measures: latency to cancel a resting order (O(1) via lookup map).
@@ -67,9 +121,13 @@ BENCHMARK(BM_AddOrder)->Unit(benchmark::kMicrosecond);
 static void BM_CancelOrder(benchmark::State& state) {
     auto orders = make_limit_orders(POOL, 1, Side::Buy, 99.0);
 
+    // Only ids the book issued itself get index pages
     auto repopulate = [&](OrderBook& book) {
         reset_orders(orders);
-        for (auto& o : orders) book.add_order(&o);
+        for (auto& o : orders) {
+            if (!state.range(0)) o.id = book.next_order_id();
+            book.add_order(&o);
+        }
     };
 
     OrderBook book("AAPL");
@@ -91,6 +149,83 @@ static void BM_CancelOrder(benchmark::State& state) {
 }
 BENCHMARK(BM_CancelOrder)->Unit(benchmark::kMicrosecond);
 
+// ============================================================================
+// BM_CancelByHandle
+// Measures: cancel through the OrderId lookup (Arg 0) vs through the
+// OrderHandle add_order() returned (Arg 1). Same book, same order sequence.
+// ============================================================================
+static void BM_CancelByHandle(benchmark::State& state) {
+    auto orders = make_limit_orders(POOL, 1, Side::Buy, 99.0);
+    std::vector<OrderHandle> handles(POOL);
+    const bool by_handle = state.range(0) != 0;
+
+    auto repopulate = [&](OrderBook& book) {
+        reset_orders(orders);
+        for (int i = 0; i < POOL; ++i) book.add_order(&orders[i], handles[i]);
+    };
+
+    OrderBook book("AAPL");
+    repopulate(book);
+    int64_t idx = 0;
+
+    for (auto _ : state) {
+        if (idx > 0 && idx % POOL == 0) {
+            state.PauseTiming();
+            book = OrderBook("AAPL");
+            repopulate(book);
+            state.ResumeTiming();
+        }
+        const int64_t i = idx % POOL;
+        benchmark::DoNotOptimize(by_handle ? book.cancel_order(handles[i])
+                                           : book.cancel_order(orders[i].id));
+        ++idx;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CancelByHandle)->Arg(0)->Arg(1)->Unit(benchmark::kNanosecond);
+
+// ============================================================================
+// BM_CancelOrderIdKind
+// Measures: cancel by id when ids are dense (Arg 0, as next_order_id() issues
+// them: direct page lookup) vs scattered 64-bit client ids (Arg 1: the
+// OrderIndex overflow hash map).
+// ============================================================================
+static void BM_CancelOrderIdKind(benchmark::State& state) {
+    auto orders = make_limit_orders(POOL, 1, Side::Buy, 99.0);
+    if (state.range(0)) {
+        std::mt19937_64 rng(42);
+        for (auto& o : orders) o.id = rng() | (OrderId{1} << 63);
+    }
+
+    // Only ids the book issued itself get index pages
+    auto repopulate = [&](OrderBook& book) {
+        reset_orders(orders);
+        for (auto& o : orders) {
+            if (!state.range(0)) o.id = book.next_order_id();
+            book.add_order(&o);
+        }
+    };
+
+    OrderBook book("AAPL");
+    repopulate(book);
+    int64_t idx = 0;
+
+    for (auto _ : state) {
+        if (idx > 0 && idx % POOL == 0) {
+            state.PauseTiming();
+            book = OrderBook("AAPL");
+            repopulate(book);
+            state.ResumeTiming();
+        }
+        benchmark::DoNotOptimize(book.cancel_order(orders[idx % POOL].id));
+        ++idx;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CancelOrderIdKind)->Arg(0)->Arg(1)->Unit(benchmark::kNanosecond);
+
 // ============================================================================
 // BM_MatchOrder
 // Measures: latency when an incoming order fully matches a resting order.
@@ -137,6 +272,127 @@ static void BM_MatchOrder(benchmark::State& state) {
 }
 BENCHMARK(BM_MatchOrder)->Unit(benchmark::kMicrosecond);
 
+// ============================================================================
+// BM_MatchMixedSides
+// Measures: matching when incoming sides arrive in random order, so the side
+// of the next order can't be predicted. Each incoming order fills exactly one
+// resting order. Run with --benchmark_perf_counters=BRANCH-MISSES (needs a
+// libbenchmark built with libpfm) to see the branch misses per match.
+// ============================================================================
+static void BM_MatchMixedSides(benchmark::State& state) {
+    auto resting_bids = make_limit_orders(POOL, 1, Side::Buy, 99.0);
+    auto resting_asks = make_limit_orders(POOL, POOL + 1, Side::Sell, 101.0);
+    std::vector<Order> incoming;
+    incoming.reserve(POOL);
+    std::mt19937_64 rng(7);
+    for (int i = 0; i < POOL; ++i) {
+        const bool buy = rng() & 1;
+        incoming.emplace_back(static_cast<OrderId>(2 * POOL + i + 1), "AAPL",
+                              buy ? Side::Buy : Side::Sell, OrderType::Limit, 100ULL,
+                              price_to_fixed(buy ? 102.0 : 98.0));
+    }
+
+    auto repopulate = [&](OrderBook& book) {
+        reset_orders(resting_bids);
+        reset_orders(resting_asks);
+        reset_orders(incoming);
+        for (auto& o : resting_bids) book.add_order(&o);
+        for (auto& o : resting_asks) book.add_order(&o);
+    };
+
+    OrderBook book("AAPL");
+    repopulate(book);
+    int64_t idx = 0;
+
+    for (auto _ : state) {
+        if (idx > 0 && idx % POOL == 0) {
+            state.PauseTiming();
+            book = OrderBook("AAPL");
+            repopulate(book);
+            state.ResumeTiming();
+        }
+        benchmark::DoNotOptimize(book.add_order(&incoming[idx % POOL]));
+        ++idx;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MatchMixedSides)->Unit(benchmark::kNanosecond);
+
+// ============================================================================
+// BM_Sweep
+// Measures: one aggressive buy sweeping Arg levels (4 orders each) on cold
+// caches, the case a news spike produces.
+// Orders go in in shuffled order so queue nodes, level nodes and Orders are
+// scattered in memory the way a live book's are, and a buffer larger than
+// L1+L2 is written between iterations so the sweep starts from cold private
+// caches (a large shared L3 may still hold part of the book).
+// ============================================================================
+static void BM_Sweep(benchmark::State& state) {
+    static constexpr int ORDERS_PER_LEVEL = 4;
+    const int levels = static_cast<int>(state.range(0));
+    const int count = levels * ORDERS_PER_LEVEL;
+
+    std::vector<Order> resting;
+    resting.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        resting.emplace_back(static_cast<OrderId>(i + 1), "AAPL", Side::Sell, OrderType::Limit,
+                             100ULL, price_to_fixed(101.0 + (i % levels) * 0.01));
+    }
+    std::vector<int> insert_order(count);
+    for (int i = 0; i < count; ++i) insert_order[i] = i;
+    std::shuffle(insert_order.begin(), insert_order.end(), std::mt19937_64(3));
+
+    Order sweep(static_cast<OrderId>(count + 1), "AAPL", Side::Buy, OrderType::Market,
+                100ULL * count);
+    std::vector<char> evict(8 << 20);
+    OrderBook book("AAPL");
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        book = OrderBook("AAPL");
+        reset_orders(resting);
+        for (int i : insert_order) book.add_order(&resting[i]);
+        sweep.filled_quantity = 0;
+        sweep.status = OrderStatus::New;
+        for (size_t i = 0; i < evict.size(); i += 64) evict[i] = static_cast<char>(i);
+        benchmark::ClobberMemory();
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(book.add_order(&sweep));
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_Sweep)->Arg(10)->Arg(100)->Arg(1000)->Iterations(2000)->Unit(benchmark::kMicrosecond);
+
+// ============================================================================
+// BM_TouchFlicker
+// Measures: one cycle of the best ask emptying and refilling: a sell rests
+// alone at 101.00, a buy takes it, the next sell re-creates the level. Arg is
+// OrderBookConfig::retain_empty_levels (0 = erase and rebuild every time).
+// 100 deeper ask levels keep the map realistic.
+// ============================================================================
+static void BM_TouchFlicker(benchmark::State& state) {
+    OrderBookConfig config;
+    config.retain_empty_levels = static_cast<size_t>(state.range(0));
+    OrderBook book("AAPL", config);
+    auto depth = make_limit_orders(100, 1, Side::Sell, 101.01);
+    for (auto& o : depth) book.add_order(&o);
+
+    const Price touch = price_to_fixed(101.0);
+    Order sell, buy;
+    for (auto _ : state) {
+        sell = Order(book.next_order_id(), "AAPL", Side::Sell, OrderType::Limit, 100ULL, touch);
+        book.add_order(&sell);
+        buy = Order(book.next_order_id(), "AAPL", Side::Buy, OrderType::Limit, 100ULL, touch);
+        benchmark::DoNotOptimize(book.add_order(&buy));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TouchFlicker)->Arg(0)->Arg(4)->Unit(benchmark::kNanosecond);
+
 // ============================================================================
 // BM_BestBidAsk
 // Measures: latency to query top-of-book (O(1)).
@@ -159,4 +415,515 @@ static void BM_BestBidAsk(benchmark::State& state) {
 }
 BENCHMARK(BM_BestBidAsk)->Unit(benchmark::kNanosecond);
 
+// ============================================================================
+// BM_ExpireBatch
+// Measures: cost of one tick() expiring a batch of GTT orders.
+// End-of-day expiry of a large book is a sequence of these batches, so this
+// bounds how long matching waits between two ticks.
+// ============================================================================
+static void BM_ExpireBatch(benchmark::State& state) {
+    const size_t batch = static_cast<size_t>(state.range(0));
+    const int N = 100'000;
+    auto orders = make_limit_orders(N, 1, Side::Buy, 99.0);
+    const Timestamp deadline = now() + std::chrono::seconds(1);
+    const Timestamp after = deadline + std::chrono::seconds(1);
+
+    auto repopulate = [&](OrderBook& book) {
+        reset_orders(orders);
+        for (auto& o : orders) {
+            o.time_in_force = TimeInForce::GoodTillTime;
+            o.expire_time = deadline;
+            book.add_order(&o);
+        }
+    };
+
+    OrderBook book("AAPL");
+    repopulate(book);
+    size_t expired = 0;
+
+    for (auto _ : state) {
+        if (book.empty()) {
+            state.PauseTiming();
+            book = OrderBook("AAPL");
+            repopulate(book);
+            state.ResumeTiming();
+        }
+        expired += book.tick(after, batch);
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(expired));
+}
+BENCHMARK(BM_ExpireBatch)->Arg(256)->Arg(4096)->Unit(benchmark::kMicrosecond);
+
+// ============================================================================
+// BM_TickToIndex
+// Measures: price -> tick index conversion used by tick validation.
+// Arg 0 = hardware division by a runtime tick (what `%` compiles to)
+// Arg 1 = TickSize (runtime tick, precomputed reciprocal)
+// Arg 2 = DecimalTick<2> (compile-time tick)
+// ============================================================================
+static void BM_TickToIndex(benchmark::State& state) {
+    std::vector<Price> prices(4096);
+    for (size_t i = 0; i < prices.size(); ++i) {
+        prices[i] = price_to_fixed(100.0) + static_cast<Price>(i * 7919);
+    }
+    Price runtime_tick = price_to_fixed(0.01);
+    benchmark::DoNotOptimize(runtime_tick);   // Keep the divisor opaque
+    const TickSize tick(runtime_tick);
+    const int mode = static_cast<int>(state.range(0));
+
+    for (auto _ : state) {
+        uint64_t sum = 0;
+        for (Price p : prices) {
+            if (mode == 0)      sum += static_cast<uint64_t>(p / runtime_tick);
+            else if (mode == 1) sum += tick.to_index(p);
+            else                sum += DecimalTick<2>::to_index(p);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(prices.size()));
+}
+BENCHMARK(BM_TickToIndex)->Arg(0)->Arg(1)->Arg(2)->Unit(benchmark::kMicrosecond);
+
+// ============================================================================
+// BM_AddOrderWithView
+// Measures: what publishing a 10-level BookView costs the matching thread.
+// Arg 0 = no view attached, 1 = view attached.
+// ============================================================================
+static void BM_AddOrderWithView(benchmark::State& state) {
+    auto orders = make_limit_orders(POOL, 1, Side::Buy, 99.0);
+    for (int i = 0; i < POOL; ++i) {
+        orders[i].price = price_to_fixed(90.0 + (i % 20) * 0.5);   // Fill 10+ levels
+    }
+    BookView view;
+
+    auto fresh_book = [&] {
+        OrderBook book("AAPL");
+        if (state.range(0)) book.attach_view(&view);
+        return book;
+    };
+
+    OrderBook book = fresh_book();
+    int64_t idx = 0;
+
+    for (auto _ : state) {
+        if (idx > 0 && idx % POOL == 0) {
+            state.PauseTiming();
+            book = fresh_book();
+            reset_orders(orders);
+            state.ResumeTiming();
+        }
+        benchmark::DoNotOptimize(book.add_order(&orders[idx % POOL]));
+        ++idx;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AddOrderWithView)->Arg(0)->Arg(1)->Unit(benchmark::kNanosecond);
+
+// ============================================================================
+// BM_ViewRead
+// Measures: reader-side latency of BookView::read() while a writer thread
+// publishes continuously (Arg 1) or not at all (Arg 0). The writer never
+// waits for readers; readers pay for retries instead.
+// ============================================================================
+static void BM_ViewRead(benchmark::State& state) {
+    BookView view;
+    std::atomic<bool> stop{false};
+    std::thread writer;
+
+    if (state.range(0)) {
+        writer = std::thread([&] {
+            BookSnapshot snap;
+            snap.bid_depth = snap.ask_depth = BookSnapshot::MAX_DEPTH;
+            while (!stop.load(std::memory_order_relaxed)) {
+                ++snap.bids[0].quantity;
+                view.publish(snap);
+            }
+        });
+    }
+
+    for (auto _ : state) {
+        BookSnapshot snap = view.read();
+        benchmark::DoNotOptimize(snap);
+    }
+
+    stop.store(true, std::memory_order_relaxed);
+    if (writer.joinable()) writer.join();
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ViewRead)->Arg(0)->Arg(1)->Unit(benchmark::kNanosecond);
+
+// ============================================================================
+// BM_AddOrderWithConflator
+// Measures: matching-thread cost of feeding a Conflator. Arg = consumers
+// subscribed (0 = no listener attached). Nobody drains, so every update after
+// the first coalesces: the producer's cost must not depend on how far behind
+// the consumers are.
+// ============================================================================
+static void BM_AddOrderWithConflator(benchmark::State& state) {
+    auto orders = make_limit_orders(POOL, 1, Side::Buy, 99.0);
+    for (int i = 0; i < POOL; ++i) {
+        orders[i].price = price_to_fixed(90.0 + (i % 20) * 0.5);
+    }
+    Conflator conflator;
+    const uint32_t instrument = conflator.add_instrument("AAPL");
+    for (int64_t c = 0; c < state.range(0); ++c) {
+        conflator.subscribe();
+    }
+
+    auto fresh_book = [&] {
+        OrderBook book("AAPL");
+        if (state.range(0)) book.set_listener(&conflator.feed(instrument));
+        return book;
+    };
+
+    OrderBook book = fresh_book();
+    int64_t idx = 0;
+
+    for (auto _ : state) {
+        if (idx > 0 && idx % POOL == 0) {
+            state.PauseTiming();
+            book = fresh_book();
+            reset_orders(orders);
+            state.ResumeTiming();
+        }
+        benchmark::DoNotOptimize(book.add_order(&orders[idx % POOL]));
+        ++idx;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AddOrderWithConflator)->Arg(0)->Arg(1)->Arg(4)->Unit(benchmark::kNanosecond);
+
+// ============================================================================
+// BM_SequencedSubmit
+// Measures: primary-side cost of sequencing + replicating one new order.
+// Arg 0 = sequencer only, 1 = replicating to a backup over loopback TCP.
+// The socket write happens on the link's thread; the matching thread only
+// pays for the queue push.
+// ============================================================================
+static void BM_SequencedSubmit(benchmark::State& state) {
+    const bool replicate = state.range(0) != 0;
+    std::unique_ptr<ReplicationPrimary> primary;
+    std::unique_ptr<ReplicationBackup> backup;
+    if (replicate) {
+        primary = std::make_unique<ReplicationPrimary>();
+        backup = std::make_unique<ReplicationBackup>("127.0.0.1", primary->port(),
+                                                     std::chrono::milliseconds(1000));
+        if (!backup->connect() || !primary->wait_for_backup(std::chrono::milliseconds(1000))) {
+            state.SkipWithError("loopback replication link unavailable");
+            return;
+        }
+    }
+
+    SequencedEngine engine;
+    Sequencer sequencer(engine, primary.get());
+    sequencer.submit(Command::add_book("AAPL"));
+
+    // Non-crossing flow: one resting order and one cancel per pair
+    Order order(1, "AAPL", Side::Buy, OrderType::Limit, 10, price_to_fixed(99.0));
+    Command add = Command::new_order(order);
+    Command cancel = Command::cancel("AAPL", 1);
+    OrderId id = 1;
+
+    for (auto _ : state) {
+        add.order_id = cancel.order_id = id++;
+        benchmark::DoNotOptimize(sequencer.submit(add));
+        benchmark::DoNotOptimize(sequencer.submit(cancel));
+    }
+
+    if (replicate) {
+        primary->flush(std::chrono::milliseconds(5000));
+    }
+    state.SetItemsProcessed(2 * state.iterations());
+}
+BENCHMARK(BM_SequencedSubmit)->Arg(0)->Arg(1)->Unit(benchmark::kNanosecond);
+
+// ============================================================================
+// BM_SubmitSyncVsAsync
+// Measures: cost per order of the three ways to reach the engine.
+// Arg 0 = synchronous Sequencer::submit on the caller's thread
+// Arg 1 = AsyncClient round trip, one order in flight (submit + wait for ack)
+// Arg 2 = AsyncClient pipelined, up to 1024 in flight (throughput mode)
+// Each order rests and is cancelled by the next pair, so the book stays small.
+// ============================================================================
+static void BM_SubmitSyncVsAsync(benchmark::State& state) {
+    const int64_t mode = state.range(0);
+    SequencedEngine engine;
+    Sequencer sequencer(engine);
+    sequencer.submit(Command::add_book("AAPL"));
+
+    Order order(1, "AAPL", Side::Buy, OrderType::Limit, 10, price_to_fixed(99.0));
+    Command add = Command::new_order(order);
+    Command cancel = Command::cancel("AAPL", 1);
+    OrderId id = 1;
+
+    if (mode == 0) {
+        for (auto _ : state) {
+            add.order_id = cancel.order_id = id++;
+            benchmark::DoNotOptimize(sequencer.submit(add));
+            benchmark::DoNotOptimize(sequencer.submit(cancel));
+        }
+        state.SetItemsProcessed(2 * state.iterations());
+        return;
+    }
+
+    AsyncEngine async(sequencer);
+    AsyncClient& client = async.connect(1024);
+    async.start();
+
+    size_t acked = 0;
+    auto on_ack = [&acked](const OrderAck&) { ++acked; };
+
+    for (auto _ : state) {
+        add.order_id = cancel.order_id = id++;
+        if (mode == 1) {
+            benchmark::DoNotOptimize(client.submit(add).get());
+            benchmark::DoNotOptimize(client.submit(cancel).get());
+        } else {
+            while (!client.submit(add, on_ack)) client.wait();
+            while (!client.submit(cancel, on_ack)) client.wait();
+        }
+    }
+    while (client.in_flight() > 0) client.wait();
+
+    async.stop();
+    state.SetItemsProcessed(2 * state.iterations());
+}
+BENCHMARK(BM_SubmitSyncVsAsync)->Arg(0)->Arg(1)->Arg(2)->Unit(benchmark::kNanosecond)->UseRealTime();
+
+// ============================================================================
+// BM_TradeStoreScan
+// Measures: VWAP over one day of stored trades (price and quantity columns).
+// Arg 0 = the same columns in std::vectors (memory-bandwidth baseline)
+// Arg 1 = TradeStore::query() over the mapped day files
+// Bytes processed counts the two columns read, 12 bytes per trade.
+// ============================================================================
+static void BM_TradeStoreScan(benchmark::State& state) {
+    constexpr size_t TRADES = 4'000'000;
+    const bool mapped = state.range(0) != 0;
+    const std::string root = (std::filesystem::temp_directory_path() /
+                              "bm_trade_store_scan").string();
+    std::filesystem::remove_all(root);
+
+    std::vector<Price> prices(TRADES);
+    std::vector<uint32_t> quantities(TRADES);
+    std::mt19937 rng(42);
+    for (size_t i = 0; i < TRADES; ++i) {
+        prices[i] = price_to_fixed(100.0) + static_cast<Price>(rng() % 1000);
+        quantities[i] = 1 + rng() % 500;
+    }
+
+    TradeStore store(root, false, TRADES);
+    if (mapped) {
+        std::vector<TradeRecord> records(TRADES);
+        for (size_t i = 0; i < TRADES; ++i) {
+            records[i].timestamp_ns = static_cast<int64_t>(i);
+            records[i].price = prices[i];
+            records[i].quantity = quantities[i];
+        }
+        if (store.append("AAPL", records.data(), TRADES) != TRADES) {
+            state.SkipWithError("trade store directory unavailable");
+            return;
+        }
+    }
+    const int64_t from = store.wall_time(0);
+
+    for (auto _ : state) {
+        __int128 notional = 0;
+        uint64_t volume = 0;
+        auto scan = [&](const Price* p, const uint32_t* q, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                notional += static_cast<__int128>(p[i]) * q[i];
+                volume += q[i];
+            }
+        };
+        if (mapped) {
+            for (const TradeColumns& c : store.query("AAPL", from, from + static_cast<int64_t>(TRADES))) {
+                scan(c.price, c.quantity, c.size);
+            }
+        } else {
+            scan(prices.data(), quantities.data(), TRADES);
+        }
+        benchmark::DoNotOptimize(notional);
+        benchmark::DoNotOptimize(volume);
+    }
+
+    std::filesystem::remove_all(root);
+    state.SetItemsProcessed(state.iterations() * TRADES);
+    state.SetBytesProcessed(state.iterations() * TRADES * (sizeof(Price) + sizeof(uint32_t)));
+}
+BENCHMARK(BM_TradeStoreScan)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+// ============================================================================
+// BM_BarAggregatorTrade
+// Measures: cost per trade of keeping the 1s/1m/1h bars of one instrument
+// up to date, fed in batches of 1024 records as MatchingEngine does.
+// Trades are 1ms apart, so a 1-second bar closes every 1000 trades.
+// ============================================================================
+static void BM_BarAggregatorTrade(benchmark::State& state) {
+    constexpr size_t BATCH = 1024;
+    constexpr size_t TRADES = 1 << 20;
+    OrderBook book("AAPL");
+    BarAggregator bars;
+
+    std::vector<TradeRecord> records(TRADES);
+    std::mt19937 rng(42);
+    for (size_t i = 0; i < TRADES; ++i) {
+        records[i].timestamp_ns = static_cast<int64_t>(i) * 1'000'000;
+        records[i].price = price_to_fixed(100.0) + static_cast<Price>(rng() % 1000);
+        records[i].quantity = 1 + rng() % 500;
+    }
+
+    size_t next = 0;
+    for (auto _ : state) {
+        bars.on_trades(book, records.data() + next, BATCH);
+        next = (next + BATCH) % TRADES;
+    }
+    benchmark::DoNotOptimize(bars.current("AAPL", BarInterval::Second));
+    state.SetItemsProcessed(state.iterations() * BATCH);
+}
+BENCHMARK(BM_BarAggregatorTrade)->Unit(benchmark::kMicrosecond);
+
+// ============================================================================
+// BM_MulticastPublish
+// Measures: matching-thread cost of publishing one order's fills (4 trades,
+// one packet) over loopback multicast. Arg = receivers joined to the group;
+// they never read, so the kernel drops once their buffers fill.
+// On loopback the kernel copies to each local receiver inside sendto();
+// across hosts the network does the fan-out and the cost stays flat.
+// ============================================================================
+static void BM_MulticastPublish(benchmark::State& state) {
+    struct Ignore : MarketDataHandler {
+        void on_packet(uint64_t, const TradeRecord*, size_t) override {}
+    } ignore;
+
+    MarketDataConfig config;
+    config.group = "239.255.42.2";
+    config.port = 31999;
+    MarketDataPublisher publisher(config);
+    if (!publisher.ok()) {
+        state.SkipWithError("multicast unavailable");
+        return;
+    }
+    std::vector<std::unique_ptr<MarketDataReceiver>> receivers;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        receivers.push_back(std::make_unique<MarketDataReceiver>(config, ignore));
+    }
+
+    std::vector<TradeRecord> fills(4);
+    for (auto _ : state) {
+        publisher.publish(fills.data(), fills.size());
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["send_failures"] = static_cast<double>(publisher.send_failures());
+}
+BENCHMARK(BM_MulticastPublish)->Arg(0)->Arg(1)->Arg(4)->Unit(benchmark::kNanosecond);
+
+// ============================================================================
+// BM_RespEncodeTrade
+// Measures: CPU to turn one trade into a PUBLISH command, no I/O.
+// Arg 0 = the old path: std::to_string message + redisFormatCommand (the
+//         format parsing and buffer redisCommand does for every call)
+// Arg 1 = RespWriter::publish_trade into a reused buffer
+// ============================================================================
+static void BM_RespEncodeTrade(benchmark::State& state) {
+    TradeRecord trade;
+    trade.price = price_to_fixed(101.25);
+    trade.quantity = 100;
+    const std::string symbol = "AAPL";
+    RespWriter writer;
+
+    for (auto _ : state) {
+        ++trade.buy_order_id;
+        ++trade.sell_order_id;
+        if (state.range(0) == 0) {
+            std::string msg =
+                "symbol=" + symbol +
+                " price=" + std::to_string(price_to_double(trade.price)) +
+                " qty="   + std::to_string(trade.quantity) +
+                " buy="   + std::to_string(trade.buy_order_id) +
+                " sell="  + std::to_string(trade.sell_order_id);
+            char* cmd = nullptr;
+            const int len = redisFormatCommand(&cmd, "PUBLISH trades %s", msg.c_str());
+            benchmark::DoNotOptimize(len);
+            redisFreeCommand(cmd);
+        } else {
+            writer.clear();
+            writer.publish_trade("trades", symbol, trade);
+            benchmark::DoNotOptimize(writer.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RespEncodeTrade)->Arg(0)->Arg(1)->Unit(benchmark::kNanosecond);
+
+// ============================================================================
+// BM_RedisPublishTrade
+// Measures: matching-thread cost of publishing trades to Redis on
+// 127.0.0.1:6379 (skipped if there is none). Items are trades.
+// Arg 0 = redisCommand("PUBLISH trades %s") per trade: waits for each reply
+// Arg 1 = RedisPublisher::publish_trades, one trade per call
+// Arg 2 = RedisPublisher::publish_trades, 64 trades per call
+// Arg 3 = as 2 with Redis unreachable: every trade goes to the spill log
+// RedisPublisher's I/O thread encodes and sends; the timed loop only
+// queues. Arg 1/2 wait for Redis to acknowledge everything before stopping.
+// ============================================================================
+static void BM_RedisPublishTrade(benchmark::State& state) {
+    constexpr size_t BATCH = 64;
+    std::vector<TradeRecord> trades(BATCH);
+    for (size_t i = 0; i < BATCH; ++i) {
+        trades[i].price = price_to_fixed(101.25);
+        trades[i].quantity = 100;
+        trades[i].buy_order_id = 2 * i + 1;
+        trades[i].sell_order_id = 2 * i + 2;
+    }
+    const std::string symbol = "AAPL";
+
+    if (state.range(0) == 0) {
+        redisContext* ctx = redisConnect("127.0.0.1", 6379);
+        if (ctx == nullptr || ctx->err) {
+            if (ctx) redisFree(ctx);
+            state.SkipWithError("redis unavailable");
+            return;
+        }
+        for (auto _ : state) {
+            const TradeRecord& t = trades[state.iterations() % BATCH];
+            std::string msg =
+                "symbol=" + symbol +
+                " price=" + std::to_string(price_to_double(t.price)) +
+                " qty="   + std::to_string(t.quantity) +
+                " buy="   + std::to_string(t.buy_order_id) +
+                " sell="  + std::to_string(t.sell_order_id);
+            freeReplyObject(redisCommand(ctx, "PUBLISH trades %s", msg.c_str()));
+        }
+        redisFree(ctx);
+        state.SetItemsProcessed(state.iterations());
+        return;
+    }
+
+    RedisPublisherConfig config;
+    config.spill_path = (std::filesystem::temp_directory_path() / "orderbook_bench.spill").string();
+    if (state.range(0) == 3) config.port = 1;            // Nothing listens there
+    RedisPublisher publisher(config);
+    if (state.range(0) != 3 && !publisher.wait_connected(std::chrono::seconds(1))) {
+        state.SkipWithError("redis unavailable");
+        return;
+    }
+
+    const size_t per_call = state.range(0) == 1 ? 1 : BATCH;
+    for (auto _ : state) {
+        publisher.publish_trades(symbol, trades.data(), per_call);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * per_call));
+    if (state.range(0) != 3) publisher.flush(std::chrono::seconds(30));
+    state.counters["backlog_MB"] = static_cast<double>(publisher.backlog_bytes()) / (1 << 20);
+    publisher.stop();
+    std::filesystem::remove(config.spill_path);
+}
+BENCHMARK(BM_RedisPublishTrade)->Arg(0)->Arg(1)->Arg(2)->Unit(benchmark::kNanosecond);
+BENCHMARK(BM_RedisPublishTrade)->Arg(3)->Iterations(10'000)->Unit(benchmark::kNanosecond);
+
 BENCHMARK_MAIN();
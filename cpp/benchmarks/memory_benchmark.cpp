@@ -0,0 +1,62 @@
+#include "order_book.hpp"
+#include "order.hpp"
+#include "types.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+
+using namespace orderbook;
+
+// ============================================================================
+// Memory Benchmark
+// Grows one book to N resting orders (default 10M) and prints the heap
+// footprint by component at each power of ten. Used to size hosts and to
+// compare allocator changes: run before and after, diff the bytes/order column.
+//
+// Usage: memory_benchmark [max_orders] [price_levels] [system|pool]
+// ============================================================================
+
+static void print_header() {
+    std::printf("%12s %14s %14s %14s %14s %14s %14s %14s %14s %14s %10s\n",
+                "orders", "levels", "queue_nodes", "lookup_table", "expiry_wheel",
+                "orders_bytes", "strings", "pool_slack", "trade_tape", "total", "B/order");
+}
+
+static void print_row(size_t n, const MemoryStats& s) {
+    std::printf("%12zu %14zu %14zu %14zu %14zu %14zu %14zu %14zu %14zu %14zu %10.1f\n",
+                n, s.levels, s.queue_nodes, s.lookup_table, s.expiry_wheel,
+                s.orders, s.strings, s.pool_slack, s.trade_tape, s.total(),
+                n ? static_cast<double>(s.total()) / static_cast<double>(n) : 0.0);
+}
+
+int main(int argc, char** argv) {
+    const size_t max_orders = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10'000'000;
+    const size_t levels     = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1'000;
+
+    OrderBookConfig config;
+    if (argc > 3 && std::strcmp(argv[3], "pool") == 0) {
+        config.allocator = AllocatorKind::Pool;
+    }
+    OrderBook book("AAPL", config);
+    // std::deque never relocates elements, so resting Order* stay valid
+    std::deque<Order> orders;
+
+    print_header();
+    print_row(0, book.memory_stats());
+
+    size_t checkpoint = 1'000;
+    for (size_t i = 0; i < max_orders; ++i) {
+        // Bids only, so nothing matches; spread over `levels` 0.01 ticks
+        Price price = price_to_fixed(100.0) - static_cast<Price>(i % levels) * 10'000;
+        orders.emplace_back(static_cast<OrderId>(i + 1), "AAPL", Side::Buy,
+                            OrderType::Limit, 100ULL, price);
+        book.add_order(&orders.back());
+
+        if (i + 1 == checkpoint || i + 1 == max_orders) {
+            print_row(i + 1, book.memory_stats());
+            checkpoint *= 10;
+        }
+    }
+    return 0;
+}
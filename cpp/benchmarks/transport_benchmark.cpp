@@ -0,0 +1,283 @@
+#include "local_transport.hpp"
+#include "redis_publisher.hpp"
+#include "trade.hpp"
+#include "types.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <hiredis.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace orderbook;
+
+// ============================================================================
+// Transport Benchmark
+// Ships the same stream of trades from this (engine) process to a forked
+// consumer process through each transport:
+//
+//   redis: RedisPublisher::publish_trade() (queued, PUBLISH trades "<text>"
+//          pipelined by its I/O thread); the consumer SUBSCRIBEs with
+//          hiredis. Skipped if Redis is not up.
+//   uds:   UdsTradePublisher -> UdsTradeSubscriber, batched 48-byte records
+//   shm:   ShmTradeWriter -> ShmTradeReader, shared-memory ring
+//
+// Two runs per transport:
+//   latency:    `messages` trades paced at `rate` per second. The consumer
+//               takes now - send time for every trade and reports
+//               percentiles. steady_clock is CLOCK_MONOTONIC, which both
+//               processes share; send times live in a shared mapping
+//               indexed by trade id, so Redis's text format needs no
+//               extra field.
+//   throughput: 10x `messages` trades as fast as the transport takes them;
+//               the consumer reports trades received per second.
+//
+// Usage: transport_benchmark [messages] [rate_per_sec] [redis_host]
+// ============================================================================
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+struct Result {
+    uint64_t received = 0;
+    double per_sec = 0;
+    uint64_t p50 = 0, p99 = 0, p999 = 0, max = 0;   // ns
+};
+
+// Consumer side: `read(ids, max)` returns the trade ids that arrived (0 if
+// none yet). Stops after `expected` trades or a second without any.
+template <typename Read>
+Result consume(Read read, size_t expected, const int64_t* sent_ns) {
+    std::vector<uint64_t> latencies;
+    latencies.reserve(expected);
+    uint64_t ids[256];
+    int64_t first = 0, last = 0, idle_since = now_ns();
+
+    while (latencies.size() < expected) {
+        const size_t n = read(ids, 256);
+        const int64_t t = now_ns();
+        if (n == 0) {
+            if (t - idle_since > 1'000'000'000) break;
+            std::this_thread::yield();
+            continue;
+        }
+        if (first == 0) first = t;
+        last = idle_since = t;
+        for (size_t i = 0; i < n; ++i) {
+            latencies.push_back(static_cast<uint64_t>(t - sent_ns[ids[i]]));
+        }
+    }
+
+    Result r;
+    r.received = latencies.size();
+    if (latencies.empty()) return r;
+    r.per_sec = last > first ? static_cast<double>(r.received) * 1e9 / static_cast<double>(last - first) : 0;
+    std::sort(latencies.begin(), latencies.end());
+    auto at = [&](double q) {
+        return latencies[std::min(latencies.size() - 1,
+                                  static_cast<size_t>(q * static_cast<double>(latencies.size())))];
+    };
+    r.p50 = at(0.50);
+    r.p99 = at(0.99);
+    r.p999 = at(0.999);
+    r.max = latencies.back();
+    return r;
+}
+
+// Engine side: send trade ids 0..n-1, paced at `rate` per second (0 = as
+// fast as `send` accepts them; it returns false when the transport is full)
+template <typename Send>
+void produce(Send send, size_t n, double rate, int64_t* sent_ns) {
+    const int64_t start = now_ns();
+    const double interval = rate > 0 ? 1e9 / rate : 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (rate > 0) {
+            const int64_t due = start + static_cast<int64_t>(static_cast<double>(i) * interval);
+            while (now_ns() < due) std::this_thread::yield();
+        }
+        sent_ns[i] = now_ns();
+        while (!send(i)) std::this_thread::yield();
+    }
+}
+
+TradeRecord record_for(uint64_t id) {
+    TradeRecord r;
+    r.id = id;
+    r.price = price_to_fixed(100.0);
+    r.quantity = 1;
+    return r;
+}
+
+// Fork a consumer running `consumer(sent_ns)`, wait for it to signal ready,
+// run `producer(sent_ns)`, and collect the consumer's Result
+template <typename Consumer, typename Producer>
+Result run(size_t n, Consumer consumer, Producer producer) {
+    auto* sent_ns = static_cast<int64_t*>(mmap(nullptr, n * sizeof(int64_t), PROT_READ | PROT_WRITE,
+                                               MAP_SHARED | MAP_ANONYMOUS, -1, 0));
+    int ready[2], results[2];
+    if (sent_ns == MAP_FAILED || pipe(ready) != 0 || pipe(results) != 0) {
+        std::perror("transport_benchmark");
+        std::exit(1);
+    }
+
+    const pid_t child = fork();
+    if (child == 0) {
+        Result r = consumer(sent_ns, ready[1]);
+        (void)!write(results[1], &r, sizeof(r));
+        _exit(0);                                      // Skip the parent's destructors
+    }
+
+    Result r;
+    char byte;
+    if (read(ready[0], &byte, 1) == 1) {
+        producer(sent_ns);
+        if (read(results[0], &r, sizeof(r)) != static_cast<ssize_t>(sizeof(r))) r = Result{};
+    }
+    waitpid(child, nullptr, 0);
+    for (int fd : {ready[0], ready[1], results[0], results[1]}) close(fd);
+    munmap(sent_ns, n * sizeof(int64_t));
+    return r;
+}
+
+void signal_ready(int fd) {
+    const char byte = 1;
+    (void)!write(fd, &byte, 1);
+}
+
+// ----------------------------------------------------------------------------
+// Transports
+// ----------------------------------------------------------------------------
+
+Result run_uds(size_t n, double rate) {
+    const std::string path = "/tmp/orderbook_transport_bench_" + std::to_string(getpid());
+    UdsTradePublisher publisher(path);
+    return run(n,
+        [&](const int64_t* sent_ns, int ready_fd) {
+            UdsTradeSubscriber subscriber(path);
+            if (!subscriber.connect()) return Result{};
+            signal_ready(ready_fd);
+            TradeRecord records[256];
+            return consume([&](uint64_t* ids, size_t max) {
+                const size_t got = subscriber.read(records, max, 1);
+                for (size_t i = 0; i < got; ++i) ids[i] = records[i].id;
+                return got;
+            }, n, sent_ns);
+        },
+        [&](int64_t* sent_ns) {
+            publisher.wait_for_subscribers(1, std::chrono::milliseconds(5000));
+            produce([&](uint64_t id) {
+                const TradeRecord r = record_for(id);
+                return publisher.publish(&r, 1) == 1;
+            }, n, rate, sent_ns);
+            publisher.flush(std::chrono::milliseconds(10000));
+        });
+}
+
+Result run_shm(size_t n, double rate) {
+    const std::string name = "/orderbook_transport_bench_" + std::to_string(getpid());
+    ShmTradeWriter writer(name, 1 << 16);
+    return run(n,
+        [&](const int64_t* sent_ns, int ready_fd) {
+            ShmTradeReader reader(name);
+            if (!reader.ok()) return Result{};
+            signal_ready(ready_fd);
+            TradeRecord records[256];
+            return consume([&](uint64_t* ids, size_t max) {
+                const size_t got = reader.read(records, max);
+                for (size_t i = 0; i < got; ++i) ids[i] = records[i].id;
+                return got;
+            }, n, sent_ns);
+        },
+        [&](int64_t* sent_ns) {
+            produce([&](uint64_t id) {
+                const TradeRecord r = record_for(id);
+                return writer.publish(&r, 1) == 1;
+            }, n, rate, sent_ns);
+        });
+}
+
+Result run_redis(size_t n, double rate, const std::string& host) {
+    RedisPublisherConfig config;
+    config.host = host;
+    config.spill_path = "/tmp/orderbook_transport_bench_" + std::to_string(getpid()) + ".spill";
+    RedisPublisher publisher(config);
+    return run(n,
+        [&](const int64_t* sent_ns, int ready_fd) {
+            redisContext* ctx = redisConnect(host.c_str(), 6379);
+            if (ctx == nullptr || ctx->err) return Result{};
+            freeReplyObject(redisCommand(ctx, "SUBSCRIBE trades"));
+            signal_ready(ready_fd);
+
+            // redisGetReply blocks; a 1s socket timeout ends the run when
+            // messages stop
+            redisSetTimeout(ctx, timeval{1, 0});
+            Result r = consume([&](uint64_t* ids, size_t) -> size_t {
+                void* raw = nullptr;
+                if (redisGetReply(ctx, &raw) != REDIS_OK || raw == nullptr) return 0;
+                auto* reply = static_cast<redisReply*>(raw);
+                size_t got = 0;
+                if (reply->type == REDIS_REPLY_ARRAY && reply->elements == 3) {
+                    const char* buy = std::strstr(reply->element[2]->str, " buy=");
+                    if (buy != nullptr) ids[got++] = std::strtoull(buy + 5, nullptr, 10);
+                }
+                freeReplyObject(reply);
+                return got;
+            }, n, sent_ns);
+            redisFree(ctx);
+            return r;
+        },
+        [&](int64_t* sent_ns) {
+            produce([&](uint64_t id) {
+                Trade trade(id + 1, id, id, "AAPL", price_to_fixed(100.0), 1, Side::Buy);
+                publisher.publish_trade(trade);
+                return true;
+            }, n, rate, sent_ns);
+            publisher.flush(std::chrono::milliseconds(10000));
+        });
+}
+
+void print_row(const char* transport, const Result& latency, const Result& throughput, size_t n) {
+    std::printf("%-8s %10.1f %10.1f %10.1f %10.1f %14.0f %12llu\n", transport,
+                latency.p50 / 1e3, latency.p99 / 1e3, latency.p999 / 1e3, latency.max / 1e3,
+                throughput.per_sec,
+                static_cast<unsigned long long>(n - latency.received));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t messages = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100'000;
+    const double rate = argc > 2 ? std::strtod(argv[2], nullptr) : 50'000;
+    const std::string redis_host = argc > 3 ? argv[3] : "127.0.0.1";
+
+    std::printf("%zu trades at %.0f/s for latency, %zu unpaced for throughput\n\n",
+                messages, rate, messages * 10);
+    std::printf("%-8s %10s %10s %10s %10s %14s %12s\n",
+                "", "p50 us", "p99 us", "p99.9 us", "max us", "max trades/s", "lost");
+
+    redisContext* probe = redisConnect(redis_host.c_str(), 6379);
+    const bool redis_up = probe != nullptr && !probe->err;
+    if (probe != nullptr) redisFree(probe);
+    if (redis_up) {
+        const Result latency = run_redis(messages, rate, redis_host);
+        const Result throughput = run_redis(messages * 10, 0, redis_host);
+        print_row("redis", latency, throughput, messages);
+    } else {
+        std::printf("%-8s unavailable (no server on %s:6379)\n", "redis", redis_host.c_str());
+    }
+    print_row("uds", run_uds(messages, rate), run_uds(messages * 10, 0), messages);
+    print_row("shm", run_shm(messages, rate), run_shm(messages * 10, 0), messages);
+    return 0;
+}
@@ -1,16 +1,25 @@
 #include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
 #include <pybind11/stl.h>
+#include "bar_aggregator.hpp"
 #include "order_book.hpp"
 #include "order.hpp"
 #include "trade.hpp"
+#include "trade_store.hpp"
+#include "trade_tape.hpp"
 #include "types.hpp"
+#include <type_traits>
 
 namespace py = pybind11;
 using namespace orderbook;
 
-// Each Order needs a stable memory address while it's on the book.
-// We keep a counter here so every order gets a unique ID.
-static OrderId g_next_id = 1;
+// Lets Python classes derive from BarListener
+class PyBarListener : public BarListener {
+public:
+    void on_bar(const std::string& symbol, const Bar& bar) override {
+        PYBIND11_OVERRIDE_PURE(void, BarListener, on_bar, symbol, bar);
+    }
+};
 
 PYBIND11_MODULE(orderbook_engine, m) {
     m.doc() = "Low-latency order book engine";
@@ -32,12 +41,215 @@ PYBIND11_MODULE(orderbook_engine, m) {
                    + " @ $" + std::to_string(price_to_double(t.price));
         });
 
+    // ----------------------------------------------------------------
+    // Expose TradeRecord / TradeTape: the book's trades without copies.
+    // since() hands back read-only memoryviews over the ring itself;
+    // numpy.frombuffer(view, dtype) reads them as a structured array.
+    // ----------------------------------------------------------------
+    py::class_<TradeRecord>(m, "TradeRecord")
+        .def_readonly("id",            &TradeRecord::id)
+        .def_readonly("buy_order_id",  &TradeRecord::buy_order_id)
+        .def_readonly("sell_order_id", &TradeRecord::sell_order_id)
+        .def_readonly("quantity",      &TradeRecord::quantity)
+        .def_readonly("timestamp_ns",  &TradeRecord::timestamp_ns)
+        .def_readonly("instrument",    &TradeRecord::instrument)
+        .def_property_readonly("aggressor_side", [](const TradeRecord& r) {
+            return std::string(r.aggressor_side == Side::Buy ? "buy" : "sell");
+        })
+        .def("price", [](const TradeRecord& r) {
+            return price_to_double(r.price);
+        });
+
+    py::class_<TradeTape>(m, "TradeTape")
+        .def_property_readonly("head",     &TradeTape::head)
+        .def_property_readonly("tail",     &TradeTape::tail)
+        .def_property_readonly("capacity", &TradeTape::capacity)
+        .def("__len__", &TradeTape::size)
+        .def("at", [](const TradeTape& tape, uint64_t seq) {
+            if (seq < tape.tail() || seq >= tape.head()) throw py::index_error();
+            return tape.at(seq);
+        })
+        // (first sequence number, [memoryview, ...]). The views point into the
+        // ring: read them before the book trades again, and keep the book alive
+        .def("since", [](const TradeTape& tape, uint64_t seq) {
+            TradeTape::Range range = tape.since(seq);
+            py::list views;
+            for (const TradeTape::Span& span : {range.first, range.second}) {
+                if (span.size == 0) continue;
+                views.append(py::memoryview::from_memory(
+                    span.data, static_cast<py::ssize_t>(span.size * sizeof(TradeRecord))));
+            }
+            return py::make_tuple(range.begin, views);
+        }, py::arg("seq"));
+
+    // ----------------------------------------------------------------
+    // Expose TradeStore: query() returns, per day, a dict of read-only
+    // NumPy arrays over the mapped columns (no copy; they keep the store
+    // alive). Prices are fixed point, side is 0 = buy / 1 = sell.
+    // ----------------------------------------------------------------
+    py::class_<TradeStore>(m, "TradeStore")
+        .def(py::init<std::string, bool, size_t>(),
+             py::arg("root"), py::arg("read_only") = true,
+             py::arg("day_capacity") = TradeStore::DEFAULT_DAY_CAPACITY)
+        .def_property_readonly("root",      &TradeStore::root)
+        .def_property_readonly("read_only", &TradeStore::read_only)
+        .def("flush", &TradeStore::flush)
+        .def("query", [](TradeStore& store, const std::string& symbol, int64_t from_ns, int64_t to_ns) {
+            py::object owner = py::cast(&store, py::return_value_policy::reference);
+            auto column = [&owner](const auto* data, size_t size) {
+                using T = std::remove_const_t<std::remove_pointer_t<decltype(data)>>;
+                py::array_t<T> array(static_cast<py::ssize_t>(size), data, owner);
+                array.attr("setflags")(py::arg("write") = false);
+                return array;
+            };
+            py::list days;
+            for (const TradeColumns& c : store.query(symbol, from_ns, to_ns)) {
+                py::dict day;
+                day["day"]          = TradeStore::day_name(c.day);
+                day["timestamp_ns"] = column(c.timestamp_ns, c.size);
+                day["price"]        = column(c.price, c.size);
+                day["quantity"]     = column(c.quantity, c.size);
+                day["side"]         = column(reinterpret_cast<const uint8_t*>(c.side), c.size);
+                days.append(day);
+            }
+            return days;
+        }, py::arg("symbol"), py::arg("from_ns"), py::arg("to_ns"))
+        // Append the book's trades from tape sequence `cursor` on; returns
+        // the cursor to pass next time
+        .def("feed", [](TradeStore& store, const OrderBook& book, uint64_t cursor) {
+            return feed_trades(store, book, book.trade_tape(), cursor);
+        }, py::arg("book"), py::arg("cursor") = 0)
+        .def_static("day_name", &TradeStore::day_name, py::arg("day"));
+
+    // ----------------------------------------------------------------
+    // Expose BarAggregator: 1s/1m/1h OHLCV bars from the trade stream.
+    // Subclass BarListener and implement on_bar(symbol, bar) to receive
+    // each bar as it closes.
+    // ----------------------------------------------------------------
+    py::enum_<BarInterval>(m, "BarInterval")
+        .value("Second", BarInterval::Second)
+        .value("Minute", BarInterval::Minute)
+        .value("Hour",   BarInterval::Hour);
+
+    py::class_<Bar>(m, "Bar")
+        .def_readonly("start_ns", &Bar::start_ns)
+        .def_readonly("volume",   &Bar::volume)
+        .def_readonly("trades",   &Bar::trades)
+        .def_readonly("interval", &Bar::interval)
+        .def_property_readonly("end_ns", &Bar::end_ns)
+        .def_property_readonly("open",  [](const Bar& b) { return price_to_double(b.open); })
+        .def_property_readonly("high",  [](const Bar& b) { return price_to_double(b.high); })
+        .def_property_readonly("low",   [](const Bar& b) { return price_to_double(b.low); })
+        .def_property_readonly("close", [](const Bar& b) { return price_to_double(b.close); })
+        .def_property_readonly("vwap",  [](const Bar& b) { return price_to_double(b.vwap()); })
+        .def("__repr__", [](const Bar& b) {
+            return std::string(to_string(b.interval)) + " bar @" + std::to_string(b.start_ns)
+                   + " close=$" + std::to_string(price_to_double(b.close))
+                   + " volume=" + std::to_string(b.volume);
+        });
+
+    py::class_<BarListener, PyBarListener>(m, "BarListener")
+        .def(py::init<>())
+        .def("on_bar", &BarListener::on_bar, py::arg("symbol"), py::arg("bar"));
+
+    py::class_<BarAggregator>(m, "BarAggregator")
+        .def(py::init<>())
+        .def("add_listener",    &BarAggregator::add_listener, py::keep_alive<1, 2>(),
+             py::arg("listener"))
+        .def("remove_listener", &BarAggregator::remove_listener, py::arg("listener"))
+        .def("add", [](BarAggregator& bars, const std::string& symbol, int64_t wall_ns,
+                       double price, uint64_t quantity) {
+            bars.add(symbol, wall_ns, price_to_fixed(price), quantity);
+        }, py::arg("symbol"), py::arg("wall_ns"), py::arg("price"), py::arg("quantity"))
+        // Columns as returned by TradeStore.query() (fixed-point prices),
+        // aggregated in one call
+        .def("add_trades", [](BarAggregator& bars, const std::string& symbol,
+                              py::array_t<int64_t, py::array::c_style | py::array::forcecast> timestamp_ns,
+                              py::array_t<int64_t, py::array::c_style | py::array::forcecast> price,
+                              py::array_t<uint32_t, py::array::c_style | py::array::forcecast> quantity) {
+            if (price.size() != timestamp_ns.size() || quantity.size() != timestamp_ns.size()) {
+                throw py::value_error("columns differ in length");
+            }
+            auto t = timestamp_ns.unchecked<1>();
+            auto p = price.unchecked<1>();
+            auto q = quantity.unchecked<1>();
+            for (py::ssize_t i = 0; i < t.shape(0); ++i) {
+                bars.add(symbol, t(i), p(i), q(i));
+            }
+        }, py::arg("symbol"), py::arg("timestamp_ns"), py::arg("price"), py::arg("quantity"))
+        // Add the book's trades from tape sequence `cursor` on; returns the
+        // cursor to pass next time
+        .def("feed", [](BarAggregator& bars, const OrderBook& book, uint64_t cursor) {
+            return feed_trades(bars, book, book.trade_tape(), cursor);
+        }, py::arg("book"), py::arg("cursor") = 0)
+        .def("advance",   &BarAggregator::advance, py::arg("wall_ns"))
+        .def("close_all", &BarAggregator::close_all)
+        .def("current", [](const BarAggregator& bars, const std::string& symbol, BarInterval interval) {
+            const Bar* bar = bars.current(symbol, interval);
+            return bar ? py::cast(*bar) : py::none();
+        }, py::arg("symbol"), py::arg("interval"))
+        .def("wall_time", &BarAggregator::wall_time, py::arg("steady_ns"));
+
+    // ----------------------------------------------------------------
+    // Expose MemoryStats so Python can size hosts from live books
+    // ----------------------------------------------------------------
+    py::class_<MemoryStats>(m, "MemoryStats")
+        .def_readonly("levels",       &MemoryStats::levels)
+        .def_readonly("queue_nodes",  &MemoryStats::queue_nodes)
+        .def_readonly("lookup_table", &MemoryStats::lookup_table)
+        .def_readonly("expiry_wheel", &MemoryStats::expiry_wheel)
+        .def_readonly("orders",       &MemoryStats::orders)
+        .def_readonly("strings",      &MemoryStats::strings)
+        .def_readonly("pool_slack",   &MemoryStats::pool_slack)
+        .def_readonly("trade_tape",   &MemoryStats::trade_tape)
+        .def("total", &MemoryStats::total)
+        .def("__repr__", [](const MemoryStats& s) {
+            return "MemoryStats(total=" + std::to_string(s.total()) + " bytes)";
+        });
+
+    // ----------------------------------------------------------------
+    // Expose OrderBookConfig (prices are plain floats on the Python side)
+    // ----------------------------------------------------------------
+    py::enum_<AllocatorKind>(m, "AllocatorKind")
+        .value("System", AllocatorKind::System)
+        .value("Pool",   AllocatorKind::Pool);
+
+    py::enum_<LevelBackend>(m, "LevelBackend")
+        .value("Map",    LevelBackend::Map)
+        .value("Ladder", LevelBackend::Ladder)
+        .value("BTree",  LevelBackend::BTree)
+        .value("Vector", LevelBackend::Vector);
+
+    py::class_<OrderBookConfig>(m, "OrderBookConfig")
+        .def(py::init<>())
+        .def_readwrite("expected_orders", &OrderBookConfig::expected_orders)
+        .def_readwrite("expected_levels", &OrderBookConfig::expected_levels)
+        .def_readwrite("allocator",       &OrderBookConfig::allocator)
+        .def_readwrite("id_base",         &OrderBookConfig::id_base)
+        .def_readwrite("sparse_ids",      &OrderBookConfig::sparse_ids)
+        .def_readwrite("retain_empty_levels", &OrderBookConfig::retain_empty_levels)
+        .def_readwrite("levels",          &OrderBookConfig::levels)
+        .def_readwrite("instrument_id",   &OrderBookConfig::instrument_id)
+        .def_readwrite("trade_tape",      &OrderBookConfig::trade_tape)
+        .def_property("tick_size",
+            [](const OrderBookConfig& c) { return price_to_double(c.tick_size); },
+            [](OrderBookConfig& c, double v) { c.tick_size = price_to_fixed(v); })
+        .def_property("min_price",
+            [](const OrderBookConfig& c) { return price_to_double(c.min_price); },
+            [](OrderBookConfig& c, double v) { c.min_price = price_to_fixed(v); })
+        .def_property("max_price",
+            [](const OrderBookConfig& c) { return price_to_double(c.max_price); },
+            [](OrderBookConfig& c, double v) { c.max_price = price_to_fixed(v); });
+
     // ----------------------------------------------------------------
     // Expose the OrderBook class
     // add_order takes plain Python values — no pointers needed
     // ----------------------------------------------------------------
     py::class_<OrderBook>(m, "OrderBook")
         .def(py::init<const std::string&>(), py::arg("symbol"))
+        .def(py::init<const std::string&, const OrderBookConfig&>(),
+             py::arg("symbol"), py::arg("config"))
+        .def("warm_up", &OrderBook::warm_up)
 
         // add_order: Python passes side/price/qty, we build the Order in C++
         .def("add_order", [](OrderBook& book,
@@ -47,9 +259,10 @@ PYBIND11_MODULE(orderbook_engine, m) {
 
             Side s = (side == "buy") ? Side::Buy : Side::Sell;
 
-            // Order is heap-allocated so it outlives this call
+            // Order is heap-allocated so it outlives this call. The book
+            // issues the id: dense ids keep its lookup on the direct path.
             auto* order = new Order(
-                g_next_id++,
+                book.next_order_id(),
                 book.symbol(),
                 s,
                 OrderType::Limit,
@@ -61,7 +274,8 @@ PYBIND11_MODULE(orderbook_engine, m) {
         },
         py::arg("side"), py::arg("price"), py::arg("quantity"))
 
-        .def("cancel_order", &OrderBook::cancel_order, py::arg("order_id"))
+        .def("cancel_order", py::overload_cast<OrderId>(&OrderBook::cancel_order),
+             py::arg("order_id"))
         .def("best_bid", [](const OrderBook& book) {
             auto bid = book.best_bid();
             return bid ? py::object(py::float_(price_to_double(*bid))) : py::none();
@@ -71,6 +285,14 @@ PYBIND11_MODULE(orderbook_engine, m) {
             return ask ? py::object(py::float_(price_to_double(*ask))) : py::none();
         })
         .def("order_count", &OrderBook::order_count)
+        .def("memory_stats", &OrderBook::memory_stats)
+        .def("state_checksum", &OrderBook::state_checksum)
+        .def("trade_tape", &OrderBook::trade_tape, py::return_value_policy::reference_internal)
+        // Empty string if the book is consistent, else the violated invariant
+        .def("verify", [](const OrderBook& book) {
+            VerifyResult result = book.verify();
+            return result.ok() ? std::string() : std::string(to_string(result.violation));
+        })
         .def("spread", [](const OrderBook& book) {
             auto s = book.spread();
             return s ? py::object(py::float_(price_to_double(*s))) : py::none();
@@ -0,0 +1,281 @@
+#ifndef ORDERBOOK_ASYNC_CLIENT_HPP
+#define ORDERBOOK_ASYNC_CLIENT_HPP
+
+#include "sequencer.hpp"
+#include "spsc_queue.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace orderbook {
+
+class AsyncClient;
+
+// Engine's answer to one submitted command
+struct OrderAck {
+    uint64_t request_id = 0;
+    SequenceNumber seq = 0;              // Sequence number the command was given; 0 = none
+    OrderId order_id = INVALID_ORDER_ID;
+    ErrorCode result = ErrorCode::Success;
+    Quantity filled_quantity = 0;        // Filled on arrival (aggressive fills)
+    int64_t notional = 0;                // Sum of price * quantity of those fills
+    uint32_t trade_count = 0;
+};
+
+static_assert(std::is_trivially_copyable_v<OrderAck>, "Acks travel through an SpscQueue");
+
+// A later, passive fill of an order the client submitted: another command
+// traded against it while it rested. Fills on arrival are in the OrderAck.
+struct FillEvent {
+    OrderId order_id = INVALID_ORDER_ID;
+    SequenceNumber seq = 0;              // Command whose matching produced the fill
+    TradeId trade_id = INVALID_TRADE_ID;
+    Price price = INVALID_PRICE;
+    Quantity quantity = 0;
+    Quantity leaves_quantity = 0;        // Still resting after this fill; 0 = filled
+};
+
+static_assert(std::is_trivially_copyable_v<FillEvent>, "Fills travel through an SpscQueue");
+
+// ============================================================================
+// AckFuture
+// ============================================================================
+//
+// Handle to the ack of one submitted command. Lighter than std::future: no
+// shared state allocation and no mutex - the result lives in a slot of the
+// client that issued it, and is filled in when that client polls.
+//
+// get() drives the client's event loop until the ack arrives, so it must be
+// called on the client's thread. Dropping an unready future is fine; its ack
+// is discarded when it arrives.
+//
+// Every command still queued when the engine stops is answered with an
+// EngineStopped ack: it was not applied. One submitted while the engine isn't
+// running (stopped, or never started) waits for the next start(); get() then
+// returns an AckPending ack instead of waiting for it, and the future stays
+// valid, so get() can be called again once the engine is running.
+//
+
+class AckFuture {
+public:
+    AckFuture() = default;
+    AckFuture(AckFuture&& other) noexcept;
+    AckFuture& operator=(AckFuture&& other) noexcept;
+    ~AckFuture();
+
+    AckFuture(const AckFuture&) = delete;
+    AckFuture& operator=(const AckFuture&) = delete;
+
+    bool valid() const noexcept { return client_ != nullptr; }
+    bool ready() const noexcept;
+
+    // Wait for the ack (polling the client) and take it, invalidating the
+    // future. If the engine isn't running and hasn't served the command,
+    // returns an AckPending ack at once and keeps the future valid.
+    OrderAck get();
+
+private:
+    friend class AsyncClient;
+    AckFuture(AsyncClient* client, uint64_t request_id) noexcept
+        : client_(client), request_id_(request_id) {}
+
+    void release() noexcept;
+
+    AsyncClient* client_ = nullptr;
+    uint64_t request_id_ = 0;
+};
+
+// ============================================================================
+// AsyncClient
+// ============================================================================
+//
+// One session with an AsyncEngine, used from a single thread (typically the
+// service's event loop). submit() queues a command and returns immediately;
+// poll() delivers every ack that has arrived since the last call, in one
+// batch, running callbacks and completing futures.
+//
+//   client.submit(cmd, [](const OrderAck& ack) { ... });   // callback style
+//   AckFuture f = client.submit(cmd);  ...  f.get();       // future style
+//
+// The callback form is what a coroutine awaiter would wrap: resume the
+// coroutine from the callback.
+//
+// FILLS:
+//   An ack carries the fills an order got on arrival. Fills it gets later,
+//   while resting, arrive as FillEvents on the same poll() and go to the
+//   on_fill() handler, in sequence order with the acks around them. Only
+//   orders submitted through this client are reported to it.
+//
+// IN-FLIGHT LIMIT:
+//   At most max_in_flight commands can be outstanding. Pending requests are
+//   tracked in a slot table, so in-flight bookkeeping never allocates after
+//   construction. The completion ring has room for every in-flight ack plus
+//   fill_capacity fills; if a client stops polling while its orders keep
+//   filling, the engine parks the overflow in a backlog rather than wait, so
+//   it never blocks on a client.
+//
+// WAKEUPS:
+//   wait() sleeps on an eventfd. The engine only writes to it when the client
+//   is actually asleep, so a busy client never pays for a syscall. fd() can be
+//   added to an existing epoll loop instead.
+//
+
+class AsyncClient {
+public:
+    using Callback = std::function<void(const OrderAck&)>;
+
+    AsyncClient(const AsyncClient&) = delete;
+    AsyncClient& operator=(const AsyncClient&) = delete;
+    ~AsyncClient();
+
+    // Returns false (nothing queued) if max_in_flight commands are outstanding
+    bool submit(const Command& cmd, Callback callback);
+
+    // Future form. If the client is at its in-flight limit this polls until a
+    // slot frees up.
+    AckFuture submit(const Command& cmd);
+
+    // Handler for passive fills of this client's resting orders. Without
+    // one, fill events are consumed and discarded.
+    void on_fill(std::function<void(const FillEvent&)> handler) { fill_handler_ = std::move(handler); }
+
+    // Deliver all acks and fills that have arrived; returns how many
+    size_t poll();
+
+    // Sleep until at least one ack or fill is available (or timeout), then
+    // poll(). Returns at once if nothing is in flight and there's no fill
+    // handler.
+    size_t wait(std::chrono::microseconds timeout = std::chrono::milliseconds(10));
+
+    size_t in_flight() const noexcept { return in_flight_; }
+    size_t max_in_flight() const noexcept { return slots_.size(); }
+
+    // eventfd that becomes readable when acks arrive while the client sleeps
+    int fd() const noexcept { return event_fd_; }
+
+private:
+    friend class AsyncEngine;
+    friend class AckFuture;
+
+    struct Request {
+        uint64_t request_id;
+        Command cmd;
+    };
+
+    // Acks and fills share one ring, so a fill can't overtake the ack of
+    // the order it belongs to
+    using Completion = std::variant<OrderAck, FillEvent>;
+
+    enum class SlotState : uint8_t { Free, Callback, Future, Ready, Detached };
+
+    struct Slot {
+        uint32_t generation = 0;
+        SlotState state = SlotState::Free;
+        OrderAck ack;
+        Callback callback;
+    };
+
+    AsyncClient(size_t max_in_flight, size_t fill_capacity, const std::atomic<bool>& serving);
+
+    // request_id = generation << 32 | slot index
+    Slot* slot_for(uint64_t request_id) noexcept;
+    int64_t acquire_slot(SlotState state) noexcept;
+    void free_slot(Slot& slot) noexcept;
+    bool push_request(uint64_t request_id, const Command& cmd) noexcept;
+    void deliver(const Completion& completion);
+    void deliver(const OrderAck& ack);
+
+    // Engine thread side
+    void push_completion(const Completion& completion);
+    size_t flush_backlog() noexcept;       // Returns how many moved to the ring
+    void notify() noexcept;
+
+    std::vector<Slot> slots_;
+    std::vector<uint32_t> free_slots_;
+    size_t in_flight_ = 0;
+
+    SpscQueue<Request> requests_;        // client -> engine
+    SpscQueue<Completion> completions_;  // engine -> client
+    std::vector<Completion> batch_;
+    std::function<void(const FillEvent&)> fill_handler_;
+
+    // Engine thread only. Fills are unsolicited, so the ring can be full
+    // when the engine has something to send; rather than wait for the client
+    // the engine parks it here, in order, and retries on its next pass.
+    std::deque<Completion> backlog_;
+
+    int event_fd_ = -1;
+    std::atomic<bool> sleeping_{false};
+    const std::atomic<bool>& serving_;  // AsyncEngine::serving_
+};
+
+// ============================================================================
+// AsyncEngine
+// ============================================================================
+//
+// Runs a Sequencer on its own thread and serves any number of AsyncClients.
+// Each client has a private pair of SPSC rings, so clients never contend
+// with each other or take locks on the way in or out.
+//
+// Create every client with connect() before start(). stop() answers every
+// request still queued with EngineStopped; after it, the sequencer and its
+// engine may be used from the calling thread again.
+//
+// The engine remembers which client each resting order came from, and sends
+// that client a FillEvent whenever someone trades against it. Orders entered
+// into the sequencer directly aren't tracked.
+//
+
+class AsyncEngine {
+public:
+    static constexpr size_t DEFAULT_MAX_IN_FLIGHT = 4096;
+    static constexpr size_t DEFAULT_FILL_CAPACITY = 4096;
+
+    explicit AsyncEngine(Sequencer& sequencer);
+    ~AsyncEngine();
+
+    AsyncEngine(const AsyncEngine&) = delete;
+    AsyncEngine& operator=(const AsyncEngine&) = delete;
+
+    AsyncClient& connect(size_t max_in_flight = DEFAULT_MAX_IN_FLIGHT,
+                         size_t fill_capacity = DEFAULT_FILL_CAPACITY);
+
+    void start();
+    void stop();
+    bool running() const noexcept { return running_.load(std::memory_order_acquire); }
+
+private:
+    // A resting order submitted through a client, for routing its fills
+    struct Resting {
+        AsyncClient* client;
+        Quantity leaves;
+    };
+
+    void run();
+    size_t serve(AsyncClient& client, std::vector<Trade>& trades);
+    void reject_queued(AsyncClient& client);
+    void track(AsyncClient& client, const Command& cmd, const OrderAck& ack,
+               const std::vector<Trade>& trades);
+
+    Sequencer& sequencer_;
+    std::vector<std::unique_ptr<AsyncClient>> clients_;
+    std::unordered_map<OrderId, Resting> resting_;   // Engine thread only
+    std::vector<AsyncClient*> to_notify_;            // Clients sent fills this pass
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    // Like running_, but cleared only after the thread has exited, so a
+    // client that sees it false has every ack the engine will push
+    std::atomic<bool> serving_{false};
+};
+
+} // namespace orderbook
+
+#endif // ORDERBOOK_ASYNC_CLIENT_HPP
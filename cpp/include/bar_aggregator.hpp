@@ -0,0 +1,160 @@
+#ifndef ORDERBOOK_BAR_AGGREGATOR_HPP
+#define ORDERBOOK_BAR_AGGREGATOR_HPP
+
+#include "trade_sink.hpp"
+#include "types.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace orderbook {
+
+// ============================================================================
+// BarAggregator
+// ============================================================================
+//
+// OHLCV bars built incrementally from the trade stream: 1-second, 1-minute
+// and 1-hour bars of every instrument at once.
+//
+// WHY?
+//   Strategies and the backtester want bars, and recomputing them from raw
+//   trades (or downloading them) costs a pass over every trade. Keeping the
+//   open bars up to date as trades happen costs a few adds and compares per
+//   trade, so the bars come for free.
+//
+// HOW IT WORKS:
+//   Each instrument has a fixed array holding its open bar per interval.
+//   A trade updates all of them: high/low are a max and a min, close is a
+//   store, volume, notional and the trade count are adds. Only a trade past
+//   the end of an open bar does more: it hands the finished bar to the
+//   listeners and starts the next one at the interval boundary.
+//
+//   Bars are aligned to UTC wall-clock boundaries (TradeRecords carry
+//   steady-clock time; one offset taken at construction converts them).
+//   An interval without trades produces no bar. A quiet instrument's last
+//   bar would otherwise stay open until its next trade, so a timer should
+//   call advance() with the current time to close bars that have ended.
+//
+// Runs on the thread that feeds it (the matching thread when registered
+// with MatchingEngine::add_trade_sink); listeners run there too.
+//
+
+enum class BarInterval : uint8_t {
+    Second = 0,
+    Minute = 1,
+    Hour = 2
+};
+
+constexpr size_t BAR_INTERVALS = 3;
+
+// Length of each BarInterval, in nanoseconds
+constexpr int64_t BAR_INTERVAL_NS[BAR_INTERVALS] = {
+    1'000'000'000,
+    60'000'000'000,
+    3'600'000'000'000,
+};
+
+inline const char* to_string(BarInterval interval) {
+    switch (interval) {
+        case BarInterval::Second: return "1s";
+        case BarInterval::Minute: return "1m";
+        case BarInterval::Hour:   return "1h";
+    }
+    return "UNKNOWN";
+}
+
+struct Bar {
+    int64_t start_ns = 0;                  // Wall clock, UTC; a multiple of the interval
+    Price open = INVALID_PRICE;
+    Price high = INVALID_PRICE;
+    Price low = INVALID_PRICE;
+    Price close = INVALID_PRICE;
+    uint64_t volume = 0;
+    double notional = 0.0;                 // Sum of price * quantity (fixed point)
+    uint32_t trades = 0;                   // 0 = no bar open
+    BarInterval interval = BarInterval::Second;
+
+    int64_t end_ns() const noexcept {
+        return start_ns + BAR_INTERVAL_NS[static_cast<size_t>(interval)];
+    }
+
+    // Volume-weighted average price
+    Price vwap() const noexcept {
+        return volume == 0 ? INVALID_PRICE
+                           : static_cast<Price>(notional / static_cast<double>(volume) + 0.5);
+    }
+};
+
+// Receives every bar as it closes
+class BarListener {
+public:
+    virtual ~BarListener() = default;
+
+    virtual void on_bar(const std::string& symbol, const Bar& bar) = 0;
+};
+
+class BarAggregator : public TradeSink {
+public:
+    BarAggregator();
+
+    void add_listener(BarListener* listener);
+    void remove_listener(BarListener* listener);
+
+    // TradeSink: add the book's trades under its symbol
+    void on_trades(const OrderBook& book, const TradeRecord* records, size_t count) override;
+
+    // One trade at wall-clock time wall_ns. A trade older than an open bar
+    // counts towards that bar.
+    void add(const std::string& symbol, int64_t wall_ns, Price price, uint64_t quantity);
+
+    // Close every open bar that ends at or before wall_ns
+    void advance(int64_t wall_ns);
+
+    // Close every open bar (end of a session or a replay)
+    void close_all();
+
+    // The open bar of symbol, nullptr if it has none
+    const Bar* current(const std::string& symbol, BarInterval interval) const;
+
+    // Wall-clock nanoseconds of a TradeRecord's steady-clock timestamp
+    int64_t wall_time(int64_t steady_ns) const noexcept { return steady_ns + clock_offset_ns_; }
+
+private:
+    struct Instrument {
+        std::string symbol;
+        std::array<Bar, BAR_INTERVALS> bars;
+    };
+
+    Instrument& instrument(const std::string& symbol);
+
+    void update(Instrument& inst, int64_t wall_ns, Price price, uint64_t quantity) {
+        for (size_t i = 0; i < BAR_INTERVALS; ++i) {
+            Bar& bar = inst.bars[i];
+            if (bar.trades == 0 || wall_ns >= bar.end_ns()) {
+                roll(inst, bar, wall_ns, price);
+            }
+            if (price > bar.high) bar.high = price;
+            if (price < bar.low) bar.low = price;
+            bar.close = price;
+            bar.volume += quantity;
+            bar.notional += static_cast<double>(price) * static_cast<double>(quantity);
+            ++bar.trades;
+        }
+    }
+
+    // Emit bar if open, then start an empty one holding wall_ns
+    void roll(const Instrument& inst, Bar& bar, int64_t wall_ns, Price open);
+    void emit(const Instrument& inst, Bar& bar);
+
+    int64_t clock_offset_ns_;              // Wall clock - steady clock
+    std::vector<Instrument> instruments_;
+    std::unordered_map<std::string, size_t> by_symbol_;
+    std::vector<BarListener*> listeners_;
+};
+
+} // namespace orderbook
+
+#endif // ORDERBOOK_BAR_AGGREGATOR_HPP
@@ -0,0 +1,115 @@
+#ifndef ORDERBOOK_BOOK_CHECKSUM_HPP
+#define ORDERBOOK_BOOK_CHECKSUM_HPP
+
+#include "types.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace orderbook {
+
+// ============================================================================
+// Rolling Book Checksum
+// ============================================================================
+//
+// OrderBook keeps a checksum of its resting state: the wrapping SUM of one
+// hash per resting order over (id, side, price, remaining quantity).
+//
+// WHY A SUM?
+//   Addition is invertible and order-independent, so every mutation updates
+//   the checksum in O(1): add a hash when an order rests, subtract it when the
+//   order leaves, subtract-then-add when a fill changes its remaining quantity.
+//   Two books with the same resting orders have the same checksum no matter
+//   how they got there, so replicas can compare one word instead of diffing
+//   books.
+//
+// Not covered: queue order within a level (positions aren't tracked
+// incrementally). verify_image() checks the full structure when needed.
+//
+
+// splitmix64 finalizer: full avalanche, 3 multiplies/shifts
+constexpr uint64_t mix64(uint64_t x) noexcept {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+// Contribution of one resting order to the book checksum
+constexpr uint64_t order_state_hash(OrderId id, Side side, Price price, Quantity remaining) noexcept {
+    return mix64(mix64(id ^ (static_cast<uint64_t>(side) << 63)) ^
+                 mix64(static_cast<uint64_t>(price)) ^
+                 (remaining * 0x9e3779b97f4a7c15ULL));
+}
+
+// ============================================================================
+// BookImage / verify_image()
+// ============================================================================
+//
+// Deep copy of a book's resting state, captured on the matching thread by
+// OrderBook::image() (O(orders)) and checked anywhere else by verify_image().
+// The image owns all its data, so the expensive check never touches the
+// live book.
+//
+
+struct BookImage {
+    struct QueuedOrder {
+        OrderId id = INVALID_ORDER_ID;
+        Side side = Side::Buy;
+        Price price = INVALID_PRICE;          // The order's own price
+        Quantity remaining = 0;
+        OrderStatus status = OrderStatus::New;
+    };
+
+    struct Level {
+        Side side = Side::Buy;
+        Price price = INVALID_PRICE;
+        Quantity total_quantity = 0;          // As cached by PriceLevel
+        size_t order_count = 0;               // As reported by PriceLevel
+        std::vector<QueuedOrder> queue;       // Front (oldest) first
+    };
+
+    struct LookupEntry {
+        OrderId id = INVALID_ORDER_ID;        // Key in the lookup table
+        Side side = Side::Buy;
+        Price price = INVALID_PRICE;
+        bool iterator_matches = false;        // Queue iterator and handle both lead back here
+    };
+
+    std::vector<Level> levels;                // Bids best first, then asks best first
+    std::vector<LookupEntry> lookup;
+    uint64_t checksum = 0;                    // Rolling checksum at capture time
+};
+
+enum class BookInvariant : uint8_t {
+    Ok = 0,
+    EmptyLevel,          // A level with no orders was left in the book
+    LevelQuantity,       // total_quantity != sum of remaining quantities
+    LevelCount,          // order_count != queue length
+    LevelOrdering,       // Levels not strictly best-first, or bid >= ask
+    MisplacedOrder,      // Order's side or price differs from its level's
+    InactiveOrder,       // Filled / cancelled / zero-remaining order still queued
+    LookupMismatch,      // Lookup table and queues disagree
+    ChecksumMismatch     // Rolling checksum != checksum recomputed from queues
+};
+
+const char* to_string(BookInvariant invariant) noexcept;
+
+struct VerifyResult {
+    BookInvariant violation = BookInvariant::Ok;
+    Price price = INVALID_PRICE;          // Level involved, if any
+    OrderId order_id = INVALID_ORDER_ID;  // Order involved, if any
+
+    bool ok() const noexcept { return violation == BookInvariant::Ok; }
+};
+
+// Check every structural invariant of the image; reports the first violation
+VerifyResult verify_image(const BookImage& image);
+
+// Checksum recomputed from the image's queues
+uint64_t image_checksum(const BookImage& image) noexcept;
+
+} // namespace orderbook
+
+#endif // ORDERBOOK_BOOK_CHECKSUM_HPP
@@ -0,0 +1,45 @@
+#ifndef ORDERBOOK_BOOK_LISTENER_HPP
+#define ORDERBOOK_BOOK_LISTENER_HPP
+
+#include "types.hpp"
+#include <cstdint>
+
+namespace orderbook {
+
+class OrderBook;
+
+// New aggregate of one price level. quantity == 0 means the level is gone.
+struct LevelChange {
+    Side side = Side::Buy;
+    Price price = INVALID_PRICE;
+    Quantity quantity = 0;
+    uint64_t order_count = 0;
+};
+
+// ============================================================================
+// BookListener
+// ============================================================================
+//
+// Depth event stream of one OrderBook, delivered synchronously on the
+// matching thread. Attach with OrderBook::set_listener().
+//
+// on_level() fires for every level an add, fill, cancel or expiry touched;
+// on_update_end() once at the end of each add_order / cancel_order /
+// cancel_orders / tick call, when the book is consistent again (a good
+// moment to look at the BBO).
+//
+// Listeners run inside the matching path: they should record and return,
+// leaving anything slow (I/O, serialisation) to another thread.
+//
+
+class BookListener {
+public:
+    virtual ~BookListener() = default;
+
+    virtual void on_level(const OrderBook& book, const LevelChange& change) = 0;
+    virtual void on_update_end(const OrderBook& book) { (void)book; }
+};
+
+} // namespace orderbook
+
+#endif // ORDERBOOK_BOOK_LISTENER_HPP
@@ -0,0 +1,95 @@
+#ifndef ORDERBOOK_BOOK_VIEW_HPP
+#define ORDERBOOK_BOOK_VIEW_HPP
+
+#include "types.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+
+namespace orderbook {
+
+// One aggregated price level as seen by readers
+struct LevelSnapshot {
+    Price price = INVALID_PRICE;
+    Quantity quantity = 0;
+    uint64_t order_count = 0;
+};
+
+// Top-of-book picture published by the matching thread.
+// Plain data: readers get their own copy and can keep it as long as they like.
+struct BookSnapshot {
+    static constexpr size_t MAX_DEPTH = 10;
+
+    uint64_t version = 0;       // Increases with every publish
+    uint64_t bid_depth = 0;     // Valid entries in bids[] / asks[]
+    uint64_t ask_depth = 0;
+    LevelSnapshot bids[MAX_DEPTH];   // Best first
+    LevelSnapshot asks[MAX_DEPTH];   // Best first
+
+    std::optional<Price> best_bid() const noexcept {
+        return bid_depth ? std::optional<Price>(bids[0].price) : std::nullopt;
+    }
+    std::optional<Price> best_ask() const noexcept {
+        return ask_depth ? std::optional<Price>(asks[0].price) : std::nullopt;
+    }
+
+    // (bid qty - ask qty) / (bid qty + ask qty) over the published depth, in [-1, 1]
+    double imbalance() const noexcept;
+};
+
+static_assert(std::is_trivially_copyable_v<BookSnapshot>,
+              "BookSnapshot is copied word by word through the seqlock");
+
+// ============================================================================
+// BookView Class
+// ============================================================================
+//
+// Seqlock that lets analytics threads read a consistent BookSnapshot while the
+// matching thread keeps going.
+//
+// HOW IT WORKS:
+//   The writer bumps the sequence to an odd value, stores the snapshot, then
+//   bumps it to the next even value. A reader copies the snapshot between two
+//   loads of the sequence; if both loads return the same even value, nothing
+//   changed underneath it and the copy is consistent.
+//
+// PROPERTIES:
+//   - The writer never blocks or waits for readers (no locks, no CAS)
+//   - try_read() is wait-free: a bounded number of loads, returns false if it
+//     raced the writer. read() simply retries until it succeeds.
+//   - Any number of readers; exactly one writer (the book's matching thread)
+//
+// The payload is held as relaxed atomic words so the racing copy is well
+// defined under the C++ memory model (see Boehm, "Can Seqlocks Get Along
+// With Programming Language Memory Models?").
+//
+
+class BookView {
+public:
+    BookView() noexcept;
+
+    BookView(const BookView&) = delete;
+    BookView& operator=(const BookView&) = delete;
+
+    // Writer side (matching thread only)
+    void publish(const BookSnapshot& snapshot) noexcept;
+
+    // Reader side (any thread)
+    bool try_read(BookSnapshot& out) const noexcept;
+    BookSnapshot read() const noexcept;
+
+    // Number of completed publishes
+    uint64_t version() const noexcept { return seq_.load(std::memory_order_acquire) / 2; }
+
+private:
+    static constexpr size_t WORDS = (sizeof(BookSnapshot) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    alignas(64) std::atomic<uint64_t> seq_{0};
+    alignas(64) std::atomic<uint64_t> words_[WORDS];
+};
+
+} // namespace orderbook
+
+#endif // ORDERBOOK_BOOK_VIEW_HPP
@@ -0,0 +1,245 @@
+#ifndef ORDERBOOK_CONFLATOR_HPP
+#define ORDERBOOK_CONFLATOR_HPP
+
+#include "book_listener.hpp"
+#include "types.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace orderbook {
+
+enum class UpdateKind : uint8_t {
+    Level = 0,   // One price level of one side
+    Bbo = 1      // Best bid and offer of one instrument
+};
+
+// Latest state of one conflation key, as handed to consumers.
+struct ConflatedUpdate {
+    uint32_t instrument = 0;      // Id returned by Conflator::add_instrument()
+    UpdateKind kind = UpdateKind::Level;
+    Side side = Side::Buy;        // Level only
+    uint16_t reserved = 0;
+    Price price = INVALID_PRICE;  // Level: level price.  Bbo: best bid (INVALID_PRICE if none)
+    Quantity quantity = 0;        // Level: total (0 = level removed).  Bbo: best bid quantity
+    uint64_t order_count = 0;     // Level only
+    Price ask_price = INVALID_PRICE;   // Bbo only (INVALID_PRICE if none)
+    Quantity ask_quantity = 0;         // Bbo only
+    uint64_t version = 0;         // Writes to this key so far; a jump = updates coalesced
+};
+
+static_assert(std::is_trivially_copyable_v<ConflatedUpdate>,
+              "ConflatedUpdate is copied word by word through the slot seqlock");
+
+// ============================================================================
+// Conflator Class
+// ============================================================================
+//
+// Market-data fan-out that never makes the matching thread wait for a slow
+// consumer.
+//
+// A queue per consumer would either grow without bound behind a slow reader
+// or push back on the matcher. Depth data doesn't need the full history, only
+// the latest value of each key, so the conflator keeps exactly that:
+//
+//   - one slot per key (instrument, side, price) or (instrument, BBO), holding
+//     the latest ConflatedUpdate behind a seqlock (same scheme as BookView)
+//   - one dirty bitset per consumer, one bit per key
+//
+// The producer (matching thread) overwrites the slot, then sets the key's bit
+// in every consumer's bitset with one fetch_or each. A consumer's drain()
+// swaps its bitset words to zero and reads the slots whose bits were set.
+//
+// A consumer that drains between every update sees every update. One that
+// falls behind finds the bit already set: the newer value replaces the
+// undelivered one in place (counted in coalesced()) and it later receives a
+// single, current snapshot of that key. Memory is fixed at construction
+// (max_keys slots, max_consumers bitsets and version arrays); nothing queues.
+//
+// A drain that lands between the producer's slot write and its fetch_or
+// reads the new value early, then finds the bit set again on the next drain.
+// Each consumer keeps the last version it delivered per key and skips such a
+// repeat, so the versions it sees for one key strictly increase.
+//
+// THREADING:
+//   - add_instrument() / feed(): setup, before producing starts
+//   - the BookListeners returned by feed(): one producer thread
+//   - subscribe(): any thread, at any time. A new consumer starts with every
+//     existing key dirty, so its first drain() is a full snapshot.
+//   - drain() / coalesced() for a consumer: that consumer's thread only
+//
+// KEY RECYCLING:
+//   A removed level keeps its slot (reporting quantity 0) so it can come back
+//   without a new key. Once the table is full, a new level takes over the key
+//   of a removed one - but only after every consumer has been handed that
+//   removal, so nobody misses it. Size max_keys for the levels that can be
+//   live at once plus the removals a slow consumer can lag behind on.
+//
+//   If no key can be freed the update is dropped and overflowed() latches
+//   true: some consumer's depth is now missing a level. That is a sizing
+//   error, not a steady state; consumers should check it after draining and
+//   treat their depth as unreliable once it's set.
+//
+
+class Conflator {
+public:
+    using ConsumerId = size_t;
+
+    static constexpr size_t DEFAULT_MAX_KEYS = 1 << 16;
+    static constexpr size_t DEFAULT_MAX_CONSUMERS = 8;
+
+    explicit Conflator(size_t max_keys = DEFAULT_MAX_KEYS,
+                       size_t max_consumers = DEFAULT_MAX_CONSUMERS);
+    ~Conflator();
+
+    Conflator(const Conflator&) = delete;
+    Conflator& operator=(const Conflator&) = delete;
+
+    // Register an instrument; returns its id in ConflatedUpdate::instrument
+    uint32_t add_instrument(const std::string& symbol);
+    const std::string& symbol(uint32_t instrument) const { return symbols_[instrument]; }
+
+    // Listener to attach to the instrument's book with OrderBook::set_listener()
+    BookListener& feed(uint32_t instrument);
+
+    // Add a consumer. Returns max_consumers() when all consumer slots are taken.
+    ConsumerId subscribe();
+
+    // Deliver up to `max` dirty keys to fn(const ConflatedUpdate&), oldest
+    // bitset position first and round-robin across calls so a bounded drain
+    // can't starve high keys. Returns the number delivered.
+    template <typename Fn>
+    size_t drain(ConsumerId consumer, Fn&& fn,
+                 size_t max = std::numeric_limits<size_t>::max());
+
+    // Updates this consumer never saw because a newer one replaced them
+    uint64_t coalesced(ConsumerId consumer) const noexcept;
+
+    // Producer-side counters
+    uint64_t updates() const noexcept { return updates_.load(std::memory_order_relaxed); }
+    uint64_t dropped_updates() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+    uint64_t recycled_keys() const noexcept { return recycled_.load(std::memory_order_relaxed); }
+    size_t keys() const noexcept { return keys_used_.load(std::memory_order_relaxed); }
+
+    // Some level update was dropped for want of a key (see KEY RECYCLING)
+    bool overflowed() const noexcept { return dropped_updates() != 0; }
+
+    size_t max_keys() const noexcept { return max_keys_; }
+    size_t max_consumers() const noexcept { return max_consumers_; }
+
+private:
+    static constexpr size_t PAYLOAD_WORDS = sizeof(ConflatedUpdate) / sizeof(uint64_t);
+    static_assert(sizeof(ConflatedUpdate) % sizeof(uint64_t) == 0, "Whole words only");
+
+    // Sequence + payload fill exactly one cache line: no false sharing
+    // between neighbouring keys
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> seq{0};
+        std::atomic<uint64_t> words[PAYLOAD_WORDS];
+    };
+
+    struct alignas(64) Consumer {
+        std::unique_ptr<std::atomic<uint64_t>[]> dirty;
+        // Per key, last version handed out. Atomic so the producer can tell
+        // when a removed level's key is safe to recycle.
+        std::unique_ptr<std::atomic<uint64_t>[]> last_version;
+        size_t cursor = 0;                             // Next bitset word to scan
+        alignas(64) std::atomic<uint64_t> coalesced{0};
+    };
+
+    // (instrument * 2 + side, price)
+    using LevelKey = std::pair<uint64_t, Price>;
+    struct LevelKeyHash {
+        size_t operator()(const LevelKey& key) const noexcept;
+    };
+
+    class Feed;
+    friend class Feed;
+
+    static constexpr size_t NO_KEY = std::numeric_limits<size_t>::max();
+    static constexpr uint8_t KEY_REMOVED = 1;   // Last level write was quantity 0
+    static constexpr uint8_t KEY_RETIRED = 2;   // Listed in retired_
+
+    // Producer side
+    size_t new_key() noexcept;                 // NO_KEY when full
+    size_t level_key(uint32_t instrument, Side side, Price price, bool allocate);
+    size_t recycle_key();                      // NO_KEY if no removed level is fully drained
+    bool drained_by_all(size_t key) const noexcept;
+    void write(size_t key, ConflatedUpdate& update) noexcept;
+    void write_level(size_t key, ConflatedUpdate& update);
+
+    // Consumer side: copy a consistent slot, retrying while the producer is mid-write
+    void read(size_t key, ConflatedUpdate& out) const noexcept;
+
+    const size_t max_keys_;
+    const size_t max_consumers_;
+    const size_t words_per_bitset_;
+
+    std::unique_ptr<Slot[]> slots_;
+    std::unique_ptr<Consumer[]> consumers_;
+    std::atomic<size_t> consumer_count_{0};
+    std::atomic<size_t> keys_used_{0};
+
+    // Producer-only state
+    std::vector<std::string> symbols_;
+    std::vector<std::unique_ptr<Feed>> feeds_;         // Stable addresses for set_listener()
+    std::unordered_map<LevelKey, size_t, LevelKeyHash> level_keys_;
+    std::vector<LevelKey> key_levels_;                 // Per key, the level it holds
+    std::vector<uint8_t> key_state_;                   // Per key, KEY_* flags
+    std::vector<size_t> retired_;                      // KEY_RETIRED keys, oldest first
+    std::vector<uint64_t> versions_;                   // Per key, producer's copy
+    size_t next_key_ = 0;
+
+    std::atomic<uint64_t> updates_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> recycled_{0};
+};
+
+template <typename Fn>
+size_t Conflator::drain(ConsumerId consumer, Fn&& fn, size_t max) {
+    Consumer& c = consumers_[consumer];
+    size_t delivered = 0;
+
+    for (size_t scanned = 0; scanned < words_per_bitset_ && delivered < max; ++scanned) {
+        const size_t w = c.cursor;
+        c.cursor = (c.cursor + 1 == words_per_bitset_) ? 0 : c.cursor + 1;
+
+        if (c.dirty[w].load(std::memory_order_relaxed) == 0) continue;
+
+        // Acquire pairs with the producer's release fetch_or: a bit we take
+        // here guarantees its slot write is visible to read()
+        uint64_t bits = c.dirty[w].exchange(0, std::memory_order_acquire);
+        while (bits != 0 && delivered < max) {
+            const unsigned bit = static_cast<unsigned>(__builtin_ctzll(bits));
+            bits &= bits - 1;
+
+            const size_t key = w * 64 + bit;
+            ConflatedUpdate update;
+            read(key, update);
+            // Already handed out early
+            if (update.version <= c.last_version[key].load(std::memory_order_relaxed)) continue;
+            fn(static_cast<const ConflatedUpdate&>(update));
+            // After fn: the producer may reuse a removed level's key as soon
+            // as it sees this version
+            c.last_version[key].store(update.version, std::memory_order_release);
+            ++delivered;
+        }
+        if (bits != 0) {
+            // Ran out of budget mid-word: the rest stay dirty for next time
+            c.dirty[w].fetch_or(bits, std::memory_order_relaxed);
+            c.cursor = w;
+        }
+    }
+    return delivered;
+}
+
+} // namespace orderbook
+
+#endif // ORDERBOOK_CONFLATOR_HPP
@@ -0,0 +1,134 @@
+#ifndef ORDERBOOK_COUNTING_ALLOCATOR_HPP
+#define ORDERBOOK_COUNTING_ALLOCATOR_HPP
+
+#include "node_pool.hpp"
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+
+namespace orderbook {
+
+// ============================================================================
+// AllocationCounter
+// ============================================================================
+//
+// Running total of the bytes a container currently holds on the heap.
+// Shared by every copy (and rebind) of one CountingAllocator, so it also sees
+// the allocations a container makes internally: std::map/std::list nodes,
+// unordered_map nodes *and* its bucket array.
+//
+// When `pool` is set, single-node allocations are served from it instead of
+// operator new (see AllocatorKind in order_book.hpp). Multi-element blocks such
+// as bucket arrays always go to operator new.
+//
+
+struct AllocationCounter {
+    size_t bytes = 0;         // Bytes currently allocated
+    size_t allocations = 0;   // Blocks currently allocated
+    std::unique_ptr<NodePool> pool;
+};
+
+// ============================================================================
+// CountingAllocator
+// ============================================================================
+//
+// std-compatible allocator that forwards to operator new/delete and keeps an
+// AllocationCounter up to date. The cost is two integer adds per allocation,
+// plus one well-predicted branch to check for a NodePool.
+//
+// WHY shared_ptr for the counter?
+//   Containers carry their allocator around when they are moved (see the
+//   propagate_* traits below). If the counter lived inside OrderBook, moving a
+//   book would leave the containers pointing at the old book's counter. The
+//   shared_ptr is only copied when the container copies its allocator (rare:
+//   construction and rehash), never per node.
+//
+// A default-constructed allocator has no counter and counts nothing, so
+// PriceLevel and friends still work standalone.
+//
+
+template <typename T>
+class CountingAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    CountingAllocator() noexcept = default;
+
+    explicit CountingAllocator(std::shared_ptr<AllocationCounter> counter) noexcept
+        : counter_(std::move(counter))
+    {}
+
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>& other) noexcept
+        : counter_(other.counter())
+    {}
+
+    T* allocate(size_t n) {
+        const size_t bytes = n * sizeof(T);
+        if (!counter_) {
+            return static_cast<T*>(::operator new(bytes));
+        }
+        counter_->bytes += bytes;
+        ++counter_->allocations;
+        if (NodePool* pool = pooled(n)) {
+            return static_cast<T*>(pool->allocate(bytes));
+        }
+        return static_cast<T*>(::operator new(bytes));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        if (counter_) {
+            counter_->bytes -= n * sizeof(T);
+            --counter_->allocations;
+            if (NodePool* pool = pooled(n)) {
+                pool->deallocate(p);
+                return;
+            }
+        }
+        ::operator delete(p);
+    }
+
+    const std::shared_ptr<AllocationCounter>& counter() const noexcept { return counter_; }
+
+    // Bytes counted so far (0 when this allocator has no counter)
+    size_t bytes() const noexcept { return counter_ ? counter_->bytes : 0; }
+
+    // Equal only when sharing a counter: each counter has its own tally and
+    // NodePool, so memory from one can't be returned through another
+    template <typename U>
+    bool operator==(const CountingAllocator<U>& other) const noexcept {
+        return counter_ == other.counter();
+    }
+    template <typename U>
+    bool operator!=(const CountingAllocator<U>& other) const noexcept { return !(*this == other); }
+
+private:
+    // Pool that serves n objects of T, or nullptr for operator new
+    NodePool* pooled(size_t n) const noexcept {
+        NodePool* pool = counter_->pool.get();
+        if (pool == nullptr || n != 1 || alignof(T) > alignof(void*)) return nullptr;
+        return pool->serves(sizeof(T)) ? pool : nullptr;
+    }
+
+    std::shared_ptr<AllocationCounter> counter_;
+};
+
+// Heap bytes owned by a std::string: 0 while the text fits in the inline
+// small-string buffer, capacity + terminator once it has spilled to the heap.
+inline size_t string_heap_bytes(const std::string& s) noexcept {
+    const char* object = reinterpret_cast<const char*>(&s);
+    const char* data = s.data();
+    std::less<const char*> before;
+    bool inline_buffer = !before(data, object) && before(data, object + sizeof(std::string));
+    return inline_buffer ? 0 : s.capacity() + 1;
+}
+
+} // namespace orderbook
+
+#endif // ORDERBOOK_COUNTING_ALLOCATOR_HPP
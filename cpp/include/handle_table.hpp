@@ -0,0 +1,102 @@
+#ifndef ORDERBOOK_HANDLE_TABLE_HPP
+#define ORDERBOOK_HANDLE_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace orderbook {
+
+// Opaque reference to one resting order, returned by OrderBook::add_order().
+// Only meaningful to the book that issued it. A default-constructed handle
+// never resolves.
+struct OrderHandle {
+    uint32_t index = 0;
+    uint32_t generation = 0;      // 0 = null handle
+
+    bool is_null() const noexcept { return generation == 0; }
+
+    friend bool operator==(const OrderHandle& a, const OrderHandle& b) noexcept {
+        return a.index == b.index && a.generation == b.generation;
+    }
+    friend bool operator!=(const OrderHandle& a, const OrderHandle& b) noexcept {
+        return !(a == b);
+    }
+};
+
+// ============================================================================
+// HandleTable Class
+// ============================================================================
+//
+// Slot array that turns an OrderHandle back into a pointer without hashing:
+// one bounds check, one array index, one generation compare.
+//
+// WHY GENERATIONS?
+//   Slots are reused as soon as an order leaves the book. Every release bumps
+//   the slot's generation, so a handle kept past its order's fill or cancel
+//   carries an old generation and resolves to nullptr instead of to whatever
+//   order took the slot next. (After 2^32 reuses of one slot a generation
+//   repeats; no client holds a handle that long.)
+//
+// Free slots form an intrusive LIFO list, so acquire/release are O(1) and the
+// most recently freed (cache-warm) slot is handed out first.
+//
+
+template <typename T>
+class HandleTable {
+public:
+    void reserve(size_t slots) { slots_.reserve(slots); }
+
+    OrderHandle acquire(T* target) {
+        uint32_t index;
+        if (free_head_ != NONE) {
+            index = free_head_;
+            free_head_ = slots_[index].next_free;
+        } else {
+            index = static_cast<uint32_t>(slots_.size());
+            slots_.emplace_back();
+        }
+        Slot& slot = slots_[index];
+        slot.target = target;
+        slot.next_free = NONE;
+        ++live_;
+        return OrderHandle{index, slot.generation};
+    }
+
+    // nullptr for null, stale or foreign-index handles
+    T* resolve(OrderHandle handle) const noexcept {
+        if (handle.index >= slots_.size()) return nullptr;
+        const Slot& slot = slots_[handle.index];
+        return slot.generation == handle.generation ? slot.target : nullptr;
+    }
+
+    // Invalidate every outstanding handle to this slot and recycle it
+    void release(OrderHandle handle) noexcept {
+        Slot& slot = slots_[handle.index];
+        slot.target = nullptr;
+        if (++slot.generation == 0) slot.generation = 1;   // 0 is the null handle
+        slot.next_free = free_head_;
+        free_head_ = handle.index;
+        --live_;
+    }
+
+    size_t live() const noexcept { return live_; }
+    size_t memory_bytes() const noexcept { return slots_.capacity() * sizeof(Slot); }
+
+private:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    struct Slot {
+        T* target = nullptr;
+        uint32_t generation = 1;
+        uint32_t next_free = NONE;
+    };
+
+    std::vector<Slot> slots_;
+    uint32_t free_head_ = NONE;
+    size_t live_ = 0;
+};
+
+} // namespace orderbook
+
+#endif // ORDERBOOK_HANDLE_TABLE_HPP
@@ -0,0 +1,682 @@
+#ifndef ORDERBOOK_LEVEL_CONTAINERS_HPP
+#define ORDERBOOK_LEVEL_CONTAINERS_HPP
+
+#include "types.hpp"
+#include "price_level.hpp"
+#include "counting_allocator.hpp"
+#include "tick_size.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace orderbook {
+
+// ============================================================================
+// Level containers
+// ============================================================================
+//
+// OrderBook keeps each side's price levels in one of these (chosen per book
+// with OrderBookConfig::levels). They all implement the same subset of the
+// std::map<Price, PriceLevel> interface, best price first (Compare is
+// std::greater for bids, std::less for asks), so the book's code is written
+// once as templates and compiled per container:
+//
+//   begin() / end()              forward iterators, best price first;
+//                                it->first is the Price, it->second the PriceLevel
+//   find(price)                  end() if absent
+//   try_emplace(price, args...)  {iterator, inserted}; args build the PriceLevel
+//   erase(it)                    returns the iterator after `it`
+//   erase(price)                 number erased (0 or 1)
+//   size() / empty() / key_comp() / get_allocator()
+//   can_hold(price)              false if adding price would break a size
+//                                bound (only the ladder has one)
+//
+// A PriceLevel's address is stable until its level is erased (OrderLocation
+// keeps a pointer to it). Any insert or erase may invalidate other iterators,
+// except that erase(it) returns a valid one.
+//
+// Every container is built from a LevelAllocator and a TickSize, and takes
+// all of its memory from (rebinds of) that allocator, so memory_stats() counts
+// it whichever container is in use.
+//
+
+using LevelAllocator = CountingAllocator<std::pair<const Price, PriceLevel>>;
+
+// ============================================================================
+// MapLevels: one std::map node per level
+// ============================================================================
+//
+// The default. O(log n) find, insert and erase, O(1) best, no tuning needed.
+// Each level is its own heap node, so walking many levels is a pointer chase.
+//
+
+template <typename Compare>
+class MapLevels : public std::map<Price, PriceLevel, Compare, LevelAllocator> {
+public:
+    MapLevels(const LevelAllocator& alloc, const TickSize&)
+        : std::map<Price, PriceLevel, Compare, LevelAllocator>(Compare(), alloc) {}
+
+    bool can_hold(Price) const noexcept { return true; }
+};
+
+// ============================================================================
+// LevelPool
+// ============================================================================
+//
+// Stable home for the PriceLevels of the array-based containers below, which
+// shuffle their entries around and so hold a 32-bit pool index per level
+// instead of the level itself. std::deque never relocates its elements, and
+// released slots are reused LIFO.
+//
+
+class LevelPool {
+public:
+    explicit LevelPool(const LevelAllocator& alloc) : levels_(alloc), free_(alloc) {}
+
+    // Build a PriceLevel from args in a free slot; returns its index
+    template <typename... Args>
+    uint32_t acquire(Args&&... args) {
+        if (!free_.empty()) {
+            const uint32_t index = free_.back();
+            free_.pop_back();
+            levels_[index] = PriceLevel(std::forward<Args>(args)...);
+            return index;
+        }
+        levels_.emplace_back(std::forward<Args>(args)...);
+        return static_cast<uint32_t>(levels_.size() - 1);
+    }
+
+    // Destroy the level's queue and recycle the slot
+    void release(uint32_t index) {
+        levels_[index] = PriceLevel();
+        free_.push_back(index);
+    }
+
+    PriceLevel& operator[](uint32_t index) noexcept { return levels_[index]; }
+    const PriceLevel& operator[](uint32_t index) const noexcept { return levels_[index]; }
+
+private:
+    std::deque<PriceLevel, CountingAllocator<PriceLevel>> levels_;
+    std::vector<uint32_t, CountingAllocator<uint32_t>> free_;
+};
+
+// What a pool-backed container's iterator dereferences to: the same
+// .first / .second shape as std::map's value_type, built on the fly
+template <typename Level>
+struct LevelRef {
+    Price first;
+    Level& second;
+};
+
+// operator-> for iterators that return LevelRef by value
+template <typename Level>
+struct LevelArrow {
+    LevelRef<Level> ref;
+    LevelRef<Level>* operator->() noexcept { return &ref; }
+};
+
+// ============================================================================
+// LadderLevels: one slot per tick
+// ============================================================================
+//
+// An array indexed by (price in ticks - base): find, insert and erase are an
+// index computation, and the best level is cached. Walking from one level to
+// the next scans the empty ticks between them.
+//
+// Suits tight-tick books whose levels are packed near the touch (crypto
+// majors, liquid futures). A wide-band, sparse book pays for every empty tick
+// in memory (4 bytes each) and in every walk; use Map or BTree there.
+//
+// The array grows (at least doubling) to cover any new price and never
+// shrinks while the book lives. Growing at the front shifts the array, which
+// is why slots hold pool indices rather than PriceLevels. It spans at most
+// MAX_TICKS: can_hold() is false for a price that would stretch it further,
+// and OrderBook rejects such orders instead of allocating for one outlier.
+// An empty ladder re-centres on the next price inserted.
+//
+// Tick is TickSize, or a FixedTickSize when the book's tick is known at
+// compile time (CentLadderLevels): price -> slot is then a division by a
+// constant the compiler lowers itself, inlined into every find and insert.
+//
+
+template <typename Compare, typename Tick>
+class BasicLadderLevels {
+    static constexpr bool HIGH_IS_BEST = std::is_same_v<Compare, std::greater<Price>>;
+    static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+    static constexpr size_t NPOS = std::numeric_limits<size_t>::max();
+
+public:
+    static constexpr size_t INITIAL_TICKS = 1024;
+    static constexpr size_t MAX_TICKS = size_t{1} << 22;     // 16 MB of slots per side
+
+    template <bool Const>
+    class Iterator {
+        using Owner = std::conditional_t<Const, const BasicLadderLevels, BasicLadderLevels>;
+        using Level = std::conditional_t<Const, const PriceLevel, PriceLevel>;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = LevelRef<Level>;
+        using difference_type = std::ptrdiff_t;
+        using reference = LevelRef<Level>;
+        using pointer = LevelArrow<Level>;
+
+        Iterator() = default;
+        Iterator(Owner* owner, size_t pos) noexcept : owner_(owner), pos_(pos) {}
+
+        reference operator*() const noexcept {
+            return {owner_->price_at(pos_), owner_->pool_[owner_->slots_[pos_]]};
+        }
+        pointer operator->() const noexcept { return {**this}; }
+        Iterator& operator++() noexcept { pos_ = owner_->worse_than(pos_); return *this; }
+        Iterator operator++(int) noexcept { Iterator old = *this; ++*this; return old; }
+        bool operator==(const Iterator& other) const noexcept { return pos_ == other.pos_; }
+        bool operator!=(const Iterator& other) const noexcept { return pos_ != other.pos_; }
+
+    private:
+        friend class BasicLadderLevels;
+        Owner* owner_ = nullptr;
+        size_t pos_ = NPOS;
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    // A FixedTickSize ignores `tick`: OrderBook only picks one that matches it
+    BasicLadderLevels(const LevelAllocator& alloc, const TickSize& tick)
+        : tick_(adopt(tick)), slots_(alloc), pool_(alloc) {}
+
+    iterator begin() noexcept { return {this, best_}; }
+    iterator end() noexcept { return {this, NPOS}; }
+    const_iterator begin() const noexcept { return {this, best_}; }
+    const_iterator end() const noexcept { return {this, NPOS}; }
+
+    iterator find(Price price) noexcept { return {this, find_pos(price)}; }
+    const_iterator find(Price price) const noexcept { return {this, find_pos(price)}; }
+
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(Price price, Args&&... args) {
+        const size_t pos = make_room(price);
+        if (slots_[pos] != NONE) {
+            return {iterator(this, pos), false};
+        }
+        slots_[pos] = pool_.acquire(std::forward<Args>(args)...);
+        ++size_;
+        if (best_ == NPOS || better(pos, best_)) {
+            best_ = pos;
+        }
+        return {iterator(this, pos), true};
+    }
+
+    iterator erase(iterator it) {
+        const size_t pos = it.pos_;
+        const size_t next = worse_than(pos);
+        pool_.release(slots_[pos]);
+        slots_[pos] = NONE;
+        --size_;
+        if (pos == best_) {
+            best_ = next;
+        }
+        return {this, next};
+    }
+
+    size_t erase(Price price) {
+        iterator it = find(price);
+        if (it == end()) return 0;
+        erase(it);
+        return 1;
+    }
+
+    size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+    Compare key_comp() const { return Compare(); }
+    LevelAllocator get_allocator() const noexcept { return LevelAllocator(slots_.get_allocator()); }
+
+    // The array, grown to cover price, would still span at most MAX_TICKS
+    bool can_hold(Price price) const noexcept {
+        if (size_ == 0) return true;                         // Re-centres instead
+        const uint64_t index = tick_.to_index(price);
+        const uint64_t low = std::min(index, base_);
+        const uint64_t high = std::max(index + 1, base_ + slots_.size());
+        return high - low <= MAX_TICKS;
+    }
+
+private:
+    static Tick adopt(const TickSize& tick) noexcept {
+        if constexpr (std::is_same_v<Tick, TickSize>) {
+            return tick;
+        } else {
+            return Tick{};
+        }
+    }
+
+    Price price_at(size_t pos) const noexcept { return tick_.from_index(base_ + pos); }
+
+    bool better(size_t a, size_t b) const noexcept { return HIGH_IS_BEST ? a > b : a < b; }
+
+    size_t find_pos(Price price) const noexcept {
+        const uint64_t index = tick_.to_index(price);
+        if (slots_.empty() || index < base_ || index - base_ >= slots_.size()) return NPOS;
+        const size_t pos = static_cast<size_t>(index - base_);
+        return slots_[pos] == NONE ? NPOS : pos;
+    }
+
+    // Next occupied slot in the worse direction, NPOS if none
+    size_t worse_than(size_t pos) const noexcept {
+        if constexpr (HIGH_IS_BEST) {
+            while (pos-- > 0) {
+                if (slots_[pos] != NONE) return pos;
+            }
+        } else {
+            while (++pos < slots_.size()) {
+                if (slots_[pos] != NONE) return pos;
+            }
+        }
+        return NPOS;
+    }
+
+    // Grow the array to cover price; returns its position. Doubling stops
+    // at MAX_TICKS; past it the array grows only by what price needs.
+    size_t make_room(Price price) {
+        const uint64_t index = tick_.to_index(price);
+        if (slots_.empty()) {
+            slots_.assign(INITIAL_TICKS, NONE);
+        }
+        if (size_ == 0) {
+            base_ = index > slots_.size() / 2 ? index - slots_.size() / 2 : 0;   // All slots NONE
+        }
+        const uint64_t doubling = std::min<uint64_t>(slots_.size(),
+                                                     MAX_TICKS > slots_.size() ? MAX_TICKS - slots_.size() : 0);
+        if (index < base_) {
+            const uint64_t grow = std::max<uint64_t>(base_ - index, doubling);
+            const uint64_t shift = std::min(grow, base_);              // Index 0 is the floor
+            slots_.insert(slots_.begin(), static_cast<size_t>(shift), NONE);
+            base_ -= shift;
+            if (best_ != NPOS) best_ += static_cast<size_t>(shift);
+        } else if (index - base_ >= slots_.size()) {
+            const uint64_t needed = index - base_ + 1;
+            slots_.resize(static_cast<size_t>(std::max<uint64_t>(needed, slots_.size() + doubling)), NONE);
+        }
+        return static_cast<size_t>(index - base_);
+    }
+
+    Tick tick_;
+    uint64_t base_ = 0;                   // Tick index of slots_[0]
+    std::vector<uint32_t, CountingAllocator<uint32_t>> slots_;   // Pool index or NONE
+    LevelPool pool_;
+    size_t best_ = NPOS;                  // Position of the best occupied slot
+    size_t size_ = 0;
+};
+
+template <typename Compare>
+using LadderLevels = BasicLadderLevels<Compare, TickSize>;
+
+// The compile-time ladder, used for books whose tick_size is CentTick::tick()
+using CentTick = DecimalTick<2>;
+template <typename Compare>
+using CentLadderLevels = BasicLadderLevels<Compare, CentTick>;
+
+// ============================================================================
+// BTreeLevels: sorted blocks of levels under a flat index
+// ============================================================================
+//
+// A B+tree of height two. Levels are stored sorted, best first, in leaves of
+// LEAF_SIZE (price, pool index) pairs; a flat index holds each leaf's first
+// price. A lookup is a binary search of the index and then of one leaf, both
+// in contiguous memory, and walking levels in price order reads consecutive
+// entries of a leaf instead of chasing one node per level.
+//
+// A full leaf splits in half. An emptied leaf is unlinked and reused;
+// partly empty leaves are not merged, which costs at most some slack.
+// Height two covers LEAF_SIZE * (index length) levels with an index small
+// enough to memmove, far beyond what one side of a book holds.
+//
+// Suits wide-band or sparse books (many levels, prices far apart) where a
+// ladder would be mostly empty ticks and a map mostly pointer chasing.
+//
+
+template <typename Compare>
+class BTreeLevels {
+    static constexpr size_t NPOS = std::numeric_limits<size_t>::max();
+
+public:
+    static constexpr size_t LEAF_SIZE = 64;
+
+    template <bool Const>
+    class Iterator {
+        using Owner = std::conditional_t<Const, const BTreeLevels, BTreeLevels>;
+        using Level = std::conditional_t<Const, const PriceLevel, PriceLevel>;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = LevelRef<Level>;
+        using difference_type = std::ptrdiff_t;
+        using reference = LevelRef<Level>;
+        using pointer = LevelArrow<Level>;
+
+        Iterator() = default;
+        Iterator(Owner* owner, size_t leaf, size_t slot) noexcept
+            : owner_(owner), leaf_(leaf), slot_(slot) {}
+
+        reference operator*() const noexcept {
+            const Leaf& leaf = owner_->leaf_at(leaf_);
+            return {leaf.keys[slot_], owner_->pool_[leaf.levels[slot_]]};
+        }
+        pointer operator->() const noexcept { return {**this}; }
+        Iterator& operator++() noexcept {
+            *this = Iterator(owner_, owner_->next(leaf_, slot_));
+            return *this;
+        }
+        Iterator operator++(int) noexcept { Iterator old = *this; ++*this; return old; }
+        bool operator==(const Iterator& o) const noexcept { return leaf_ == o.leaf_ && slot_ == o.slot_; }
+        bool operator!=(const Iterator& o) const noexcept { return !(*this == o); }
+
+    private:
+        friend class BTreeLevels;
+        Iterator(Owner* owner, std::pair<size_t, size_t> at) noexcept
+            : owner_(owner), leaf_(at.first), slot_(at.second) {}
+
+        Owner* owner_ = nullptr;
+        size_t leaf_ = NPOS;      // Position in the index
+        size_t slot_ = 0;
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    BTreeLevels(const LevelAllocator& alloc, const TickSize&)
+        : leaves_(alloc), free_leaves_(alloc), index_(alloc), firsts_(alloc), pool_(alloc) {}
+
+    bool can_hold(Price) const noexcept { return true; }
+
+    iterator begin() noexcept { return empty() ? end() : iterator(this, 0, 0); }
+    iterator end() noexcept { return {this, NPOS, 0}; }
+    const_iterator begin() const noexcept { return empty() ? end() : const_iterator(this, 0, 0); }
+    const_iterator end() const noexcept { return {this, NPOS, 0}; }
+
+    iterator find(Price price) noexcept { return {this, locate(price)}; }
+    const_iterator find(Price price) const noexcept { return {this, locate(price)}; }
+
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(Price price, Args&&... args) {
+        if (index_.empty()) {
+            index_.push_back(new_leaf());
+            firsts_.push_back(price);
+        }
+        size_t li = leaf_for(price);
+        size_t slot = slot_in(leaf_at(li), price);
+        {
+            const Leaf& leaf = leaf_at(li);
+            if (slot < leaf.count && leaf.keys[slot] == price) {
+                return {iterator(this, li, slot), false};
+            }
+        }
+
+        if (leaf_at(li).count == LEAF_SIZE) {
+            split(li);
+            if (slot > LEAF_SIZE / 2) {
+                ++li;
+                slot -= LEAF_SIZE / 2;
+            }
+        }
+
+        const uint32_t level = pool_.acquire(std::forward<Args>(args)...);
+        Leaf& leaf = leaf_at(li);
+        std::copy_backward(leaf.keys + slot, leaf.keys + leaf.count, leaf.keys + leaf.count + 1);
+        std::copy_backward(leaf.levels + slot, leaf.levels + leaf.count, leaf.levels + leaf.count + 1);
+        leaf.keys[slot] = price;
+        leaf.levels[slot] = level;
+        ++leaf.count;
+        if (slot == 0) firsts_[li] = price;
+        ++size_;
+        return {iterator(this, li, slot), true};
+    }
+
+    iterator erase(iterator it) {
+        const size_t li = it.leaf_;
+        const size_t slot = it.slot_;
+        Leaf& leaf = leaf_at(li);
+        pool_.release(leaf.levels[slot]);
+        std::copy(leaf.keys + slot + 1, leaf.keys + leaf.count, leaf.keys + slot);
+        std::copy(leaf.levels + slot + 1, leaf.levels + leaf.count, leaf.levels + slot);
+        --leaf.count;
+        --size_;
+
+        if (leaf.count == 0) {
+            free_leaves_.push_back(index_[li]);
+            index_.erase(index_.begin() + static_cast<std::ptrdiff_t>(li));
+            firsts_.erase(firsts_.begin() + static_cast<std::ptrdiff_t>(li));
+            return li < index_.size() ? iterator(this, li, 0) : end();
+        }
+        if (slot == 0) firsts_[li] = leaf.keys[0];
+        if (slot < leaf.count) return {this, li, slot};
+        return li + 1 < index_.size() ? iterator(this, li + 1, 0) : end();
+    }
+
+    size_t erase(Price price) {
+        iterator it = find(price);
+        if (it == end()) return 0;
+        erase(it);
+        return 1;
+    }
+
+    size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+    Compare key_comp() const { return Compare(); }
+    LevelAllocator get_allocator() const noexcept { return LevelAllocator(index_.get_allocator()); }
+
+private:
+    struct Leaf {
+        uint32_t count = 0;
+        Price keys[LEAF_SIZE];
+        uint32_t levels[LEAF_SIZE];
+    };
+
+    Leaf& leaf_at(size_t li) noexcept { return leaves_[index_[li]]; }
+    const Leaf& leaf_at(size_t li) const noexcept { return leaves_[index_[li]]; }
+
+    // Index position of the leaf that holds (or would hold) price
+    size_t leaf_for(Price price) const noexcept {
+        auto it = std::upper_bound(firsts_.begin(), firsts_.end(), price, Compare());
+        return it == firsts_.begin() ? 0 : static_cast<size_t>(it - firsts_.begin()) - 1;
+    }
+
+    static size_t slot_in(const Leaf& leaf, Price price) noexcept {
+        return static_cast<size_t>(std::lower_bound(leaf.keys, leaf.keys + leaf.count, price,
+                                                    Compare()) - leaf.keys);
+    }
+
+    std::pair<size_t, size_t> locate(Price price) const noexcept {
+        if (index_.empty()) return {NPOS, 0};
+        const size_t li = leaf_for(price);
+        const Leaf& leaf = leaf_at(li);
+        const size_t slot = slot_in(leaf, price);
+        if (slot < leaf.count && leaf.keys[slot] == price) return {li, slot};
+        return {NPOS, 0};
+    }
+
+    std::pair<size_t, size_t> next(size_t li, size_t slot) const noexcept {
+        if (slot + 1 < leaf_at(li).count) return {li, slot + 1};
+        if (li + 1 < index_.size()) return {li + 1, 0};
+        return {NPOS, 0};
+    }
+
+    uint32_t new_leaf() {
+        if (!free_leaves_.empty()) {
+            const uint32_t leaf = free_leaves_.back();
+            free_leaves_.pop_back();
+            leaves_[leaf].count = 0;
+            return leaf;
+        }
+        leaves_.emplace_back();
+        return static_cast<uint32_t>(leaves_.size() - 1);
+    }
+
+    // Move the upper half of a full leaf into a new leaf just after it
+    void split(size_t li) {
+        const uint32_t right = new_leaf();                // May reallocate leaves_
+        Leaf& left_leaf = leaf_at(li);
+        Leaf& right_leaf = leaves_[right];
+        constexpr size_t HALF = LEAF_SIZE / 2;
+        std::copy(left_leaf.keys + HALF, left_leaf.keys + LEAF_SIZE, right_leaf.keys);
+        std::copy(left_leaf.levels + HALF, left_leaf.levels + LEAF_SIZE, right_leaf.levels);
+        right_leaf.count = LEAF_SIZE - HALF;
+        left_leaf.count = HALF;
+        index_.insert(index_.begin() + static_cast<std::ptrdiff_t>(li + 1), right);
+        firsts_.insert(firsts_.begin() + static_cast<std::ptrdiff_t>(li + 1), right_leaf.keys[0]);
+    }
+
+    std::vector<Leaf, CountingAllocator<Leaf>> leaves_;           // Leaf storage, any order
+    std::vector<uint32_t, CountingAllocator<uint32_t>> free_leaves_;
+    std::vector<uint32_t, CountingAllocator<uint32_t>> index_;    // leaves_ positions, best first
+    std::vector<Price, CountingAllocator<Price>> firsts_;         // First price of each index_ leaf
+    LevelPool pool_;
+    size_t size_ = 0;
+};
+
+// ============================================================================
+// VectorLevels: one sorted array, best price at the back
+// ============================================================================
+//
+// Levels are 16-byte (price, pool index) entries in a single contiguous
+// array sorted worst-first, so the best level is the last entry:
+//   - adding or clearing the touch is a push_back / pop_back
+//   - a new level near the touch is found by a short scan from the back and
+//     inserted with a memmove of the few entries better than it
+//   - anything deeper is a binary search plus a memmove of the entries above
+//   - walking levels best-first reads the array backwards
+//
+// Suits books whose activity sits in the top few levels. Inserting or
+// erasing far from the touch moves every better entry, so a deep book with
+// churn at the bottom should use BTree instead.
+//
+
+template <typename Compare>
+class VectorLevels {
+    static constexpr size_t NPOS = std::numeric_limits<size_t>::max();
+
+public:
+    // Entries checked linearly from the touch before falling back to a
+    // binary search: one or two cache lines
+    static constexpr size_t TOUCH_SCAN = 8;
+
+    template <bool Const>
+    class Iterator {
+        using Owner = std::conditional_t<Const, const VectorLevels, VectorLevels>;
+        using Level = std::conditional_t<Const, const PriceLevel, PriceLevel>;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = LevelRef<Level>;
+        using difference_type = std::ptrdiff_t;
+        using reference = LevelRef<Level>;
+        using pointer = LevelArrow<Level>;
+
+        Iterator() = default;
+        Iterator(Owner* owner, size_t pos) noexcept : owner_(owner), pos_(pos) {}
+
+        reference operator*() const noexcept {
+            const Entry& entry = owner_->entries_[pos_];
+            return {entry.price, owner_->pool_[entry.level]};
+        }
+        pointer operator->() const noexcept { return {**this}; }
+        Iterator& operator++() noexcept { --pos_; return *this; }     // 0 wraps to NPOS (end)
+        Iterator operator++(int) noexcept { Iterator old = *this; ++*this; return old; }
+        bool operator==(const Iterator& other) const noexcept { return pos_ == other.pos_; }
+        bool operator!=(const Iterator& other) const noexcept { return pos_ != other.pos_; }
+
+    private:
+        friend class VectorLevels;
+        Owner* owner_ = nullptr;
+        size_t pos_ = NPOS;       // Index into entries_
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    VectorLevels(const LevelAllocator& alloc, const TickSize&)
+        : entries_(alloc), pool_(alloc) {}
+
+    bool can_hold(Price) const noexcept { return true; }
+
+    iterator begin() noexcept { return {this, entries_.size() - 1}; }      // Empty: NPOS
+    iterator end() noexcept { return {this, NPOS}; }
+    const_iterator begin() const noexcept { return {this, entries_.size() - 1}; }
+    const_iterator end() const noexcept { return {this, NPOS}; }
+
+    iterator find(Price price) noexcept { return {this, find_pos(price)}; }
+    const_iterator find(Price price) const noexcept { return {this, find_pos(price)}; }
+
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(Price price, Args&&... args) {
+        const size_t pos = lower_bound(price);
+        if (pos < entries_.size() && entries_[pos].price == price) {
+            return {iterator(this, pos), false};
+        }
+        const uint32_t level = pool_.acquire(std::forward<Args>(args)...);
+        entries_.insert(entries_.begin() + static_cast<std::ptrdiff_t>(pos), Entry{price, level});
+        return {iterator(this, pos), true};
+    }
+
+    iterator erase(iterator it) {
+        const size_t pos = it.pos_;
+        pool_.release(entries_[pos].level);
+        entries_.erase(entries_.begin() + static_cast<std::ptrdiff_t>(pos));
+        return {this, pos - 1};       // Worse entries don't move; 0 wraps to end
+    }
+
+    size_t erase(Price price) {
+        iterator it = find(price);
+        if (it == end()) return 0;
+        erase(it);
+        return 1;
+    }
+
+    size_t size() const noexcept { return entries_.size(); }
+    bool empty() const noexcept { return entries_.empty(); }
+    Compare key_comp() const { return Compare(); }
+    LevelAllocator get_allocator() const noexcept { return LevelAllocator(entries_.get_allocator()); }
+
+private:
+    struct Entry {
+        Price price;
+        uint32_t level;           // Index into pool_
+    };
+
+    // First position whose price is not worse than `price`: where it is, or
+    // where it would be inserted
+    size_t lower_bound(Price price) const noexcept {
+        const Compare better;
+        size_t pos = entries_.size();
+        const size_t floor = pos > TOUCH_SCAN ? pos - TOUCH_SCAN : 0;
+        while (pos > floor && !better(price, entries_[pos - 1].price)) {
+            --pos;
+        }
+        if (pos > floor || floor == 0) {
+            return pos;
+        }
+        auto it = std::partition_point(entries_.begin(), entries_.begin() + static_cast<std::ptrdiff_t>(floor),
+                                       [&](const Entry& e) { return better(price, e.price); });
+        return static_cast<size_t>(it - entries_.begin());
+    }
+
+    size_t find_pos(Price price) const noexcept {
+        const size_t pos = lower_bound(price);
+        return pos < entries_.size() && entries_[pos].price == price ? pos : NPOS;
+    }
+
+    std::vector<Entry, CountingAllocator<Entry>> entries_;   // Worst first, best at the back
+    LevelPool pool_;
+};
+
+} // namespace orderbook
+
+#endif // ORDERBOOK_LEVEL_CONTAINERS_HPP
@@ -0,0 +1,215 @@
+#ifndef ORDERBOOK_LOCAL_TRANSPORT_HPP
+#define ORDERBOOK_LOCAL_TRANSPORT_HPP
+
+#include "spsc_queue.hpp"
+#include "trade_sink.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace orderbook {
+
+// ============================================================================
+// Same-Host Transports
+// ============================================================================
+//
+// Two ways to ship TradeRecords to consumer processes on the engine's host
+// without a broker. Both send the raw 48-byte records.
+//
+//   Unix domain socket:  engine --SpscQueue--> sender thread --batched
+//                        send()--> each subscriber's socket
+//   Shared memory ring:  engine --store + release--> /dev/shm ring
+//                        <--acquire + load-- one reader process
+//
+// WHY?
+//   RedisPublisher formats text and writes it to the broker's socket on the
+//   matching thread, and the broker then writes to every subscriber. For
+//   consumers on the same host the UDS publisher costs the matching thread
+//   one queue push per trade, and the shm ring costs a copy into shared
+//   memory: no syscall at all. benchmarks/transport_benchmark.cpp compares
+//   the three end to end.
+//
+// Neither blocks the matching thread: when a consumer falls behind far
+// enough to fill the queue or ring, records are dropped and counted.
+//
+
+// ============================================================================
+// UdsTradePublisher
+// ============================================================================
+//
+// Listens on a SOCK_STREAM Unix socket; any number of subscribers connect.
+// The sender thread accepts them and writes whole batches of records (up
+// to BATCH per send()) to each. A subscriber that errors is dropped.
+//
+// Subscriber sockets are non-blocking: what one won't take right now waits
+// in that subscriber's own backlog and goes out on later passes, so a slow
+// reader never holds up the others. A subscriber whose backlog is past
+// max_backlog records and whose socket has taken nothing for stall_timeout
+// has stopped reading and is disconnected (counted in slow_disconnects()).
+// One that is still reading keeps its backlog, however briefly it trails.
+//
+
+class UdsTradePublisher : public TradeSink {
+public:
+    static constexpr size_t DEFAULT_QUEUE_CAPACITY = 1 << 16;
+    static constexpr size_t BATCH = 256;   // Records per send()
+    static constexpr size_t DEFAULT_MAX_BACKLOG = 1 << 16;
+    static constexpr std::chrono::milliseconds DEFAULT_STALL_TIMEOUT{1000};
+
+    // Listen on `path`, replacing a stale socket file
+    explicit UdsTradePublisher(std::string path, size_t queue_capacity = DEFAULT_QUEUE_CAPACITY,
+                               size_t max_backlog = DEFAULT_MAX_BACKLOG,
+                               std::chrono::milliseconds stall_timeout = DEFAULT_STALL_TIMEOUT);
+    ~UdsTradePublisher() override;
+
+    UdsTradePublisher(const UdsTradePublisher&) = delete;
+    UdsTradePublisher& operator=(const UdsTradePublisher&) = delete;
+
+    bool listening() const noexcept { return listen_fd_ >= 0; }
+    const std::string& path() const noexcept { return path_; }
+
+    // TradeSink: queue the book's trades
+    void on_trades(const OrderBook& book, const TradeRecord* records, size_t count) override;
+
+    // Queue records; returns how many fit (the rest count as dropped)
+    size_t publish(const TradeRecord* records, size_t count) noexcept;
+
+    // Block until at least `n` subscribers are connected
+    bool wait_for_subscribers(size_t n, std::chrono::milliseconds timeout);
+    size_t subscribers() const noexcept { return subscribers_.load(std::memory_order_acquire); }
+
+    // Wait until everything queued so far has left the queue (written, or
+    // waiting in a subscriber's backlog)
+    bool flush(std::chrono::milliseconds timeout);
+
+    uint64_t dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+    // Subscribers disconnected for stalling more than max_backlog behind
+    uint64_t slow_disconnects() const noexcept { return slow_disconnects_.load(std::memory_order_relaxed); }
+
+    // Stop the sender, disconnect subscribers and remove the socket file
+    void stop();
+
+private:
+    struct Subscriber {
+        int fd = -1;
+        std::vector<char> backlog;             // Bytes its socket hasn't taken yet
+        size_t backlog_sent = 0;               // Prefix of backlog already written
+        std::chrono::steady_clock::time_point progress;   // Last time its socket took bytes
+    };
+
+    void run_sender();
+    void accept_subscribers(std::vector<Subscriber>& subs);
+    bool send_to(Subscriber& sub, const char* data, size_t bytes);
+    bool flush_backlog(Subscriber& sub);
+    bool write_to(Subscriber& sub, const char*& data, size_t& bytes);
+    bool stalled(const Subscriber& sub, size_t pending) const;
+
+    std::string path_;
+    int listen_fd_ = -1;
+    size_t max_backlog_bytes_;
+    std::chrono::milliseconds stall_timeout_;
+    SpscQueue<TradeRecord> queue_;
+    std::thread sender_;
+    std::atomic<bool> running_{false};
+    std::atomic<size_t> subscribers_{0};
+    std::atomic<uint64_t> queued_{0};
+    std::atomic<uint64_t> sent_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> slow_disconnects_{0};
+};
+
+class UdsTradeSubscriber {
+public:
+    explicit UdsTradeSubscriber(std::string path);
+    ~UdsTradeSubscriber();
+
+    UdsTradeSubscriber(const UdsTradeSubscriber&) = delete;
+    UdsTradeSubscriber& operator=(const UdsTradeSubscriber&) = delete;
+
+    bool connect();
+    bool connected() const noexcept { return fd_ >= 0; }
+
+    // Wait up to timeout_ms for data, then copy up to `max` whole records
+    // into out[]. Returns the count; 0 on timeout or once disconnected.
+    size_t read(TradeRecord* out, size_t max, int timeout_ms);
+
+private:
+    std::string path_;
+    int fd_ = -1;
+    alignas(TradeRecord) char partial_[sizeof(TradeRecord)];
+    size_t partial_bytes_ = 0;                 // Start of a record split across reads
+};
+
+// ============================================================================
+// Shared-Memory Ring
+// ============================================================================
+//
+// A single-producer single-consumer ring of TradeRecords in a POSIX shared
+// memory object (/dev/shm/<name>). Same protocol as SpscQueue, with the
+// indices in the shared header so they work across processes; readers spin
+// or sleep on read() returning 0. One writer and one reader per ring: give
+// each consumer process its own.
+//
+
+class ShmTradeWriter : public TradeSink {
+public:
+    // Create the object `name` ("/orderbook.trades") with room for
+    // `capacity` records, rounded up to a power of two. An existing object
+    // of that name is unlinked, not reused: readers attached to it keep
+    // their ring and must reopen to see this one.
+    ShmTradeWriter(std::string name, size_t capacity);
+    ~ShmTradeWriter() override;
+
+    ShmTradeWriter(const ShmTradeWriter&) = delete;
+    ShmTradeWriter& operator=(const ShmTradeWriter&) = delete;
+
+    bool ok() const noexcept { return header_ != nullptr; }
+    const std::string& name() const noexcept { return name_; }
+
+    // TradeSink: copy the book's trades into the ring
+    void on_trades(const OrderBook& book, const TradeRecord* records, size_t count) override;
+
+    // Copy as many records as fit; returns the count (the rest count as dropped)
+    size_t publish(const TradeRecord* records, size_t count) noexcept;
+
+    uint64_t dropped() const noexcept { return dropped_; }
+
+    struct Header;
+
+private:
+    std::string name_;
+    Header* header_ = nullptr;
+    TradeRecord* slots_ = nullptr;
+    size_t bytes_ = 0;
+    uint64_t head_cache_ = 0;                  // Reader index as last seen
+    uint64_t dropped_ = 0;
+};
+
+class ShmTradeReader {
+public:
+    // Map the ring a ShmTradeWriter created
+    explicit ShmTradeReader(std::string name);
+    ~ShmTradeReader();
+
+    ShmTradeReader(const ShmTradeReader&) = delete;
+    ShmTradeReader& operator=(const ShmTradeReader&) = delete;
+
+    bool ok() const noexcept { return header_ != nullptr; }
+
+    // Copy up to `max` records into out[]; never blocks
+    size_t read(TradeRecord* out, size_t max) noexcept;
+
+private:
+    ShmTradeWriter::Header* header_ = nullptr;
+    const TradeRecord* slots_ = nullptr;
+    size_t bytes_ = 0;
+    uint64_t tail_cache_ = 0;                  // Writer index as last seen
+};
+
+} // namespace orderbook
+
+#endif // ORDERBOOK_LOCAL_TRANSPORT_HPP
@@ -0,0 +1,245 @@
+#ifndef ORDERBOOK_MARKET_DATA_HPP
+#define ORDERBOOK_MARKET_DATA_HPP
+
+#include "trade_sink.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace orderbook {
+
+// ============================================================================
+// Multicast Market Data
+// ============================================================================
+//
+// Trades to any number of consumers on other hosts: sequenced, batched
+// binary packets over UDP multicast, with a TCP retransmission service for
+// the packets a consumer missed.
+//
+//   engine --TradeSink--> MarketDataPublisher --UDP multicast--> receivers
+//                               | ring of recent packets
+//                               +--TCP retransmit thread <--gap requests--+
+//
+// WHY?
+//   Redis pub/sub goes through a broker and costs a TCP write per
+//   subscriber. A multicast packet is one sendto() on the matching thread
+//   however many hosts listen; the network does the fan-out.
+//
+// PACKETS:
+//   A PacketHeader followed by `count` TradeRecords, at most
+//   MAX_PACKET_BYTES so a packet fits one Ethernet frame. Sequence numbers
+//   count packets, starting at 1. A heartbeat is a header with count 0
+//   and the sequence number the next packet will get: it tells an idle
+//   receiver whether it missed the last packets.
+//
+// GAP RECOVERY:
+//   UDP may drop or reorder packets. The receiver delivers packets strictly
+//   in sequence and holds back what arrives early. A gap is first given a
+//   short reorder window (reorder_packets held back, or reorder_timeout_ms)
+//   for the late packet to turn up; only then does the receiver ask the
+//   publisher's retransmit port for the missing range. Packets too old to
+//   be in the ring are reported as lost and skipped.
+//
+//   request:  RetransmitRequest{from, count}
+//   reply:    RetransmitReply{first, count}, then `count` packets. first is
+//             later than `from` if the oldest packets were overwritten.
+//
+
+constexpr uint32_t MARKET_DATA_MAGIC = 0x444D424F;      // "OBMD" little-endian
+constexpr size_t MAX_PACKET_BYTES = 1472;               // 1500-byte MTU - IP - UDP
+
+struct PacketHeader {
+    uint32_t magic = MARKET_DATA_MAGIC;
+    uint16_t count = 0;                    // TradeRecords that follow; 0 = heartbeat
+    uint16_t reserved = 0;
+    uint64_t sequence = 0;
+};
+
+static_assert(sizeof(PacketHeader) == 16, "PacketHeader is sent bytewise");
+
+constexpr size_t RECORDS_PER_PACKET = (MAX_PACKET_BYTES - sizeof(PacketHeader)) / sizeof(TradeRecord);
+
+struct RetransmitRequest {
+    uint64_t from = 0;
+    uint32_t count = 0;
+    uint32_t reserved = 0;
+};
+
+struct RetransmitReply {
+    uint64_t first = 0;
+    uint32_t count = 0;
+    uint32_t reserved = 0;
+};
+
+struct MarketDataConfig {
+    // Multicast group and UDP port
+    std::string group = "239.255.0.1";
+    uint16_t port = 31001;
+
+    // Local interface address to send on / receive on
+    std::string interface = "127.0.0.1";
+
+    // Publisher: multicast TTL (1 = this subnet only)
+    int ttl = 1;
+
+    // Publisher: TCP port of the retransmit service on `interface`
+    // (0 = pick a free port, see MarketDataPublisher::retransmit_port()).
+    // Receiver: where to send retransmit requests.
+    std::string retransmit_host = "127.0.0.1";
+    uint16_t retransmit_port = 0;
+
+    // Publisher: packets the retransmit ring holds (rounded up to a power of two)
+    size_t retransmit_packets = 4096;
+
+    // Receiver: first packet wanted. 1 = the whole session (recovering what
+    // was sent before it joined), 0 = whatever arrives first.
+    uint64_t start_sequence = 0;
+
+    // Receiver: how long to wait on the retransmit service
+    int retransmit_timeout_ms = 1000;
+
+    // Receiver: a gap is recovered once this many packets are held back
+    // behind it, or it has been open this long; until then a reordered
+    // packet can still fill it. 0 packets = recover at once.
+    size_t reorder_packets = 4;
+    int reorder_timeout_ms = 2;
+};
+
+// ============================================================================
+// MarketDataPublisher
+// ============================================================================
+//
+// Sends on the calling thread (the matching thread as a TradeSink): one
+// non-blocking sendto() per packet. A packet the socket refuses is still in
+// the ring, so receivers recover it like any other loss. The ring is shared
+// with the retransmit thread under a mutex that either side holds only to
+// copy one packet, so a large retransmit never stalls publish().
+//
+
+class MarketDataPublisher : public TradeSink {
+public:
+    explicit MarketDataPublisher(MarketDataConfig config = {});
+    ~MarketDataPublisher() override;
+
+    MarketDataPublisher(const MarketDataPublisher&) = delete;
+    MarketDataPublisher& operator=(const MarketDataPublisher&) = delete;
+
+    // Both sockets are up
+    bool ok() const noexcept { return udp_fd_ >= 0 && listen_fd_ >= 0; }
+    uint16_t retransmit_port() const noexcept { return retransmit_port_; }
+
+    // TradeSink: publish the book's trades
+    void on_trades(const OrderBook& book, const TradeRecord* records, size_t count) override;
+
+    // Send records as ceil(count / RECORDS_PER_PACKET) packets
+    void publish(const TradeRecord* records, size_t count);
+
+    // Send a heartbeat; call from a timer while idle
+    void heartbeat();
+
+    // Sequence number of the next packet
+    uint64_t next_sequence() const noexcept { return next_sequence_; }
+    uint64_t send_failures() const noexcept { return send_failures_; }
+
+    // Stop the retransmit service and close the sockets
+    void stop();
+
+private:
+    void send_packet(const char* packet, size_t bytes);
+    void run_retransmit();
+    bool serve(int fd);
+
+    MarketDataConfig config_;
+    int udp_fd_ = -1;
+    int listen_fd_ = -1;
+    uint16_t retransmit_port_ = 0;
+    uint64_t next_sequence_ = 1;
+    uint64_t send_failures_ = 0;
+
+    // Retransmit ring: slot seq & mask_ holds packet seq
+    std::mutex ring_mutex_;
+    std::vector<char> ring_;                // capacity * MAX_PACKET_BYTES
+    std::vector<uint16_t> ring_bytes_;
+    size_t ring_mask_;
+    uint64_t ring_head_ = 1;                // Next sequence to be stored
+
+    std::thread retransmit_;
+    std::atomic<bool> running_{false};
+    int wake_fd_[2] = {-1, -1};             // Pipe that interrupts poll() on stop
+};
+
+// ============================================================================
+// MarketDataReceiver
+// ============================================================================
+
+class MarketDataHandler {
+public:
+    virtual ~MarketDataHandler() = default;
+
+    // Every packet once, in sequence order
+    virtual void on_packet(uint64_t sequence, const TradeRecord* records, size_t count) = 0;
+
+    // Packets [from, to) could not be recovered and were skipped
+    virtual void on_loss(uint64_t from, uint64_t to) { (void)from; (void)to; }
+};
+
+// Joins the group and hands packets to a handler from poll(), on the
+// caller's thread. Gap recovery happens inside poll() too: it blocks on
+// the retransmit service for up to retransmit_timeout_ms. While a gap is
+// inside its reorder window, poll() waits no longer than the window.
+class MarketDataReceiver {
+public:
+    MarketDataReceiver(MarketDataConfig config, MarketDataHandler& handler);
+    ~MarketDataReceiver();
+
+    MarketDataReceiver(const MarketDataReceiver&) = delete;
+    MarketDataReceiver& operator=(const MarketDataReceiver&) = delete;
+
+    bool ok() const noexcept { return udp_fd_ >= 0; }
+
+    // Wait up to timeout_ms for packets, then handle everything readable.
+    // Returns the number of packets delivered.
+    size_t poll(int timeout_ms);
+
+    // Next sequence number to be delivered (0 = none seen yet)
+    uint64_t expected_sequence() const noexcept { return expected_; }
+
+    uint64_t packets_received() const noexcept { return received_; }
+    uint64_t gaps_detected() const noexcept { return gaps_; }
+    uint64_t packets_recovered() const noexcept { return recovered_; }
+    uint64_t packets_lost() const noexcept { return lost_; }
+
+private:
+    size_t on_datagram(const char* data, size_t bytes);
+    size_t deliver(uint64_t sequence, const char* data, size_t bytes);
+    size_t drain_pending();
+    void note_gap(uint64_t until);
+    size_t recover_if_due();
+    size_t recover(uint64_t until);
+    bool request(uint64_t from, uint32_t count, std::vector<char>& reply, RetransmitReply& header);
+    void close_tcp();
+
+    MarketDataConfig config_;
+    MarketDataHandler& handler_;
+    int udp_fd_ = -1;
+    int tcp_fd_ = -1;
+    uint64_t expected_;
+    std::map<uint64_t, std::vector<char>> pending_;     // Arrived ahead of expected_
+    uint64_t gap_until_ = 0;                            // Open gap: [expected_, gap_until_)
+    std::chrono::steady_clock::time_point gap_since_;
+
+    uint64_t received_ = 0;
+    uint64_t gaps_ = 0;
+    uint64_t recovered_ = 0;
+    uint64_t lost_ = 0;
+};
+
+} // namespace orderbook
+
+#endif // ORDERBOOK_MARKET_DATA_HPP
@@ -0,0 +1,147 @@
+#ifndef ORDERBOOK_MATCHING_ENGINE_HPP
+#define ORDERBOOK_MATCHING_ENGINE_HPP
+
+#include "types.hpp"
+#include "order.hpp"
+#include "trade.hpp"
+#include "order_book.hpp"
+#include "trade_sink.hpp"
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace orderbook {
+
+// One leg of a spread: buy or sell `ratio` units of `symbol` per spread unit.
+struct Leg {
+    std::string symbol;
+    Side side = Side::Buy;
+    Quantity ratio = 1;
+};
+
+// All-or-nothing order across several books (calendar / basis spreads).
+//
+// limit_price is the maximum net debit per spread unit:
+//   sum(buy leg cost) - sum(sell leg proceeds), divided by quantity.
+// A negative limit means the order requires a net credit.
+// std::nullopt = no price limit (fill at whatever the books offer).
+struct MultiLegOrder {
+    OrderId id = INVALID_ORDER_ID;
+    std::vector<Leg> legs;
+    Quantity quantity = 0;
+    std::optional<Price> limit_price;
+    OrderStatus status = OrderStatus::New;
+};
+
+// Implied-in prices of a spread, derived from the outright books.
+// ask = cost of buying one spread unit at the outright touches
+// bid = proceeds of selling one spread unit at the outright touches
+struct ImpliedPrice {
+    std::optional<Price> bid;
+    std::optional<Price> ask;
+};
+
+// Owns one OrderBook per instrument and provides cross-book features.
+//
+// Threading: the engine is single-threaded and owns every book it routes to,
+// so a multi-leg order is atomic simply because no other order can touch any
+// of its books between the feasibility check and the last leg's execution.
+class MatchingEngine {
+public:
+    using SpreadId = size_t;
+    static constexpr SpreadId INVALID_SPREAD = SIZE_MAX;
+
+    // Each book created here gets its own 2^BOOK_ID_BITS range of order ids
+    // (unless its config sets id_base), so ids from OrderBook::next_order_id()
+    // are unique engine-wide.
+    static constexpr unsigned BOOK_ID_BITS = 40;
+
+    // Create (or return the existing) book for symbol. A new book without an
+    // instrument_id gets the next one, counting from 1.
+    OrderBook& add_book(const std::string& symbol);
+    OrderBook& add_book(const std::string& symbol, const OrderBookConfig& config);
+    OrderBook* book(const std::string& symbol) noexcept;
+    const OrderBook* book(const std::string& symbol) const noexcept;
+    size_t book_count() const noexcept { return books_.size(); }
+
+    // Route to the order's book. Orders for unknown symbols are rejected.
+    std::vector<Trade> add_order(Order* order);
+    ErrorCode cancel_order(const std::string& symbol, OrderId order_id);
+
+    // Combined OrderBook::state_checksum() of every book, keyed by symbol.
+    // O(books).
+    uint64_t state_checksum() const noexcept;
+
+    // Expire due GTT orders in every book; ids of the expired orders are
+    // appended to `expired` if given
+    size_t tick(Timestamp now, size_t max_expiries_per_book = OrderBook::DEFAULT_EXPIRY_BATCH,
+                std::vector<OrderId>* expired = nullptr);
+
+    // Feed `sink` every trade from now on (see trade_sink.hpp), after each
+    // order that traded. The sink must outlive the engine or be removed.
+    void add_trade_sink(TradeSink* sink);
+    void remove_trade_sink(TradeSink* sink);
+
+    // ------------------------------------------------------------------------
+    // Multi-leg orders
+    // ------------------------------------------------------------------------
+
+    // Non-mutating feasibility check: can every leg fill completely, and does
+    // the combined cost respect limit_price? Returns Success if so, and
+    // DuplicateOrderId if order.id is resting in any leg's book.
+    ErrorCode check_multi_leg(const MultiLegOrder& order) const;
+
+    // Execute every leg or none. Legs go in as market orders for
+    // quantity * ratio, which the feasibility check guarantees will fill.
+    // Should a leg still come up short, no later leg runs and the order is
+    // left PartiallyFilled (InsufficientLiquidity).
+    ErrorCode execute_multi_leg(MultiLegOrder& order, std::vector<Trade>& trades);
+
+    // ------------------------------------------------------------------------
+    // Implied-in pricing
+    // ------------------------------------------------------------------------
+
+    // Start tracking implied prices for a spread. Returns INVALID_SPREAD
+    // (and tracks nothing) if there are no legs, a leg's book doesn't exist,
+    // or a ratio is 0 or above MAX_ORDER_QUANTITY, as for multi-leg orders.
+    SpreadId register_spread(const std::vector<Leg>& legs);
+
+    // Latest implied prices; refreshed only when a leg's BBO changes. A side
+    // is unset while any of its legs has no quote, or if its sum doesn't fit
+    // in a Price.
+    const ImpliedPrice& implied_price(SpreadId spread) const { return spreads_[spread].implied; }
+
+private:
+    struct BookEntry {
+        BookEntry(const std::string& symbol, const OrderBookConfig& config) : book(symbol, config) {}
+
+        OrderBook book;
+        std::optional<Price> bid;          // BBO as of the last refresh
+        std::optional<Price> ask;
+        std::vector<SpreadId> spreads;     // Spreads with a leg on this book
+        uint64_t fed = 0;                  // Trade tape sequence the sinks have seen
+    };
+
+    struct Spread {
+        std::vector<Leg> legs;
+        std::vector<BookEntry*> books;     // Parallel to legs
+        ImpliedPrice implied;
+    };
+
+    BookEntry* entry(const std::string& symbol) noexcept;
+    const BookEntry* entry(const std::string& symbol) const noexcept;
+    void refresh_bbo(BookEntry& entry);
+    void reprice(Spread& spread);
+    void feed_sinks(BookEntry& entry, const std::vector<Trade>& trades);
+
+    // unordered_map nodes never move, so Spread can keep BookEntry pointers
+    std::unordered_map<std::string, BookEntry> books_;
+    std::vector<Spread> spreads_;
+    std::vector<TradeSink*> sinks_;
+    std::vector<TradeRecord> sink_records_;   // feed_sinks() scratch when the tape can't serve
+};
+
+} // namespace orderbook
+
+#endif // ORDERBOOK_MATCHING_ENGINE_HPP
@@ -0,0 +1,77 @@
+#ifndef ORDERBOOK_NODE_POOL_HPP
+#define ORDERBOOK_NODE_POOL_HPP
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace orderbook {
+
+// ============================================================================
+// NodePool Class
+// ============================================================================
+//
+// Free-list allocator for the fixed-size nodes of one node-based container
+// (std::map / std::list / std::unordered_map nodes).
+//
+// WHY?
+//   Every add/cancel allocates or frees exactly one node per container. The
+//   pool turns that into a pointer pop/push, and because the first chunk is
+//   sized from OrderBookConfig up front, a book that stays within its expected
+//   size never calls malloc after warm-up.
+//
+// The node size is fixed by the first allocation (the container's node type).
+// Memory goes back to the OS only when the pool is destroyed.
+//
+
+class NodePool {
+public:
+    // capacity_hint: number of nodes in the first chunk
+    explicit NodePool(size_t capacity_hint);
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    // Can this pool serve a block of `bytes`? (true until the node size is fixed)
+    bool serves(size_t bytes) const noexcept {
+        return node_size_ == 0 || round_up(bytes) == node_size_;
+    }
+
+    void* allocate(size_t bytes);
+    void deallocate(void* p) noexcept;
+
+    size_t node_size() const noexcept { return node_size_; }
+    size_t capacity() const noexcept { return capacity_; }       // Nodes carved so far
+    size_t free_nodes() const noexcept { return free_count_; }
+    size_t reserved_bytes() const noexcept { return capacity_ * node_size_; }
+    size_t free_bytes() const noexcept { return free_count_ * node_size_; }
+
+private:
+    struct FreeNode {
+        FreeNode* next;
+    };
+
+    // Nodes are pointer-aligned (CountingAllocator only routes types with
+    // alignof(T) <= alignof(void*) here)
+    static size_t round_up(size_t bytes) noexcept {
+        constexpr size_t align = alignof(void*);
+        bytes = bytes < sizeof(FreeNode) ? sizeof(FreeNode) : bytes;
+        return (bytes + align - 1) & ~(align - 1);
+    }
+
+    // Carve a new chunk of `nodes` nodes and thread them onto the free list.
+    // Writing the links touches every page, so the chunk is faulted in here
+    // rather than on the matching path.
+    void grow(size_t nodes);
+
+    size_t capacity_hint_;
+    size_t node_size_ = 0;
+    size_t capacity_ = 0;
+    size_t free_count_ = 0;
+    FreeNode* free_ = nullptr;
+    std::vector<std::unique_ptr<std::byte[]>> chunks_;
+};
+
+} // namespace orderbook
+
+#endif // ORDERBOOK_NODE_POOL_HPP
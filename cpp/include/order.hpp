@@ -2,6 +2,7 @@
 #define ORDERBOOK_ORDER_HPP
 
 #include "types.hpp"
+#include "tick_size.hpp"
 #include <string>
 
 namespace orderbook {
@@ -26,11 +27,13 @@ namespace orderbook {
 //   side:            1 byte
 //   type:            1 byte
 //   status:          1 byte
-//   (padding):       5 bytes (compiler adds to align timestamp)
+//   time_in_force:   1 byte
+//   (padding):       4 bytes (compiler adds to align timestamp)
 //   timestamp:       8 bytes
+//   expire_time:     8 bytes
 //   symbol:         32 bytes (std::string with SSO)
 //   --------------------------
-//   Total:          ~80 bytes (well under 200 byte target)
+//   Total:          ~88 bytes (well under 200 byte target)
 //
 
 struct Order {
@@ -62,6 +65,9 @@ struct Order {
     // Current status in the order lifecycle
     OrderStatus status = OrderStatus::New;
 
+    // GoodTillCancel or GoodTillTime (see expire_time)
+    TimeInForce time_in_force = TimeInForce::GoodTillCancel;
+
     // ========================================================================
     // Cold Fields (accessed less frequently)
     // ========================================================================
@@ -70,6 +76,10 @@ struct Order {
     // Used for time priority (FIFO at same price level)
     Timestamp timestamp{};
 
+    // When a GoodTillTime order leaves the book (ignored for GoodTillCancel)
+    // Expiry is driven by OrderBook::tick(), never by the client
+    Timestamp expire_time{};
+
     // Instrument identifier (e.g., "AAPL", "BTCUSDT")
     // Using std::string for flexibility; consider fixed-size char[] for ultra-low-latency
     std::string symbol;
@@ -174,6 +184,16 @@ struct Order {
         status = OrderStatus::Cancelled;
         return true;
     }
+
+    // Expire this order (GTT deadline reached)
+    // Same rules as cancel(), but records why the order left the book
+    bool expire() noexcept {
+        if (!is_active()) {
+            return false;
+        }
+        status = OrderStatus::Expired;
+        return true;
+    }
 };
 
 // ============================================================================
@@ -183,8 +203,8 @@ struct Order {
 // Check if an order is valid before submitting
 // Returns ErrorCode::Success if valid, otherwise returns the specific error
 inline ErrorCode validate_order(const Order& order) {
-    // Quantity must be positive
-    if (order.quantity == 0) {
+    // Quantity must be positive and fit a TradeRecord
+    if (order.quantity == 0 || order.quantity > MAX_ORDER_QUANTITY) {
         return ErrorCode::InvalidQuantity;
     }
 
@@ -193,6 +213,12 @@ inline ErrorCode validate_order(const Order& order) {
         return ErrorCode::InvalidPrice;
     }
 
+    // GTT orders must say when they expire
+    if (order.time_in_force == TimeInForce::GoodTillTime &&
+        order.expire_time == Timestamp{}) {
+        return ErrorCode::InvalidExpireTime;
+    }
+
     // Symbol must not be empty
     if (order.symbol.empty()) {
         return ErrorCode::BookNotFound;  // No symbol means no book
@@ -201,6 +227,21 @@ inline ErrorCode validate_order(const Order& order) {
     return ErrorCode::Success;
 }
 
+// Same checks, plus: limit prices must sit on the instrument's tick grid.
+// Tick is a TickSize (precomputed reciprocal, no division on the hot path)
+// or a FixedTickSize, whose check the compiler folds into the caller.
+template <typename Tick>
+inline ErrorCode validate_order(const Order& order, const Tick& tick) {
+    ErrorCode result = validate_order(order);
+    if (result != ErrorCode::Success) {
+        return result;
+    }
+    if (order.type == OrderType::Limit && !tick.is_aligned(order.price)) {
+        return ErrorCode::InvalidPrice;
+    }
+    return ErrorCode::Success;
+}
+
 } // namespace orderbook
 
 #endif // ORDERBOOK_ORDER_HPP
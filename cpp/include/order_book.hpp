@@ -5,8 +5,18 @@
 #include "order.hpp"
 #include "trade.hpp"
 #include "price_level.hpp"
+#include "timer_wheel.hpp"
+#include "counting_allocator.hpp"
+#include "book_view.hpp"
+#include "book_checksum.hpp"
+#include "book_listener.hpp"
+#include "handle_table.hpp"
+#include "order_index.hpp"
+#include "level_containers.hpp"
+#include "trade_tape.hpp"
 #include <map>
 #include <unordered_map>
+#include <variant>
 #include <vector>
 #include <optional>
 #include <string>
@@ -15,49 +25,322 @@ namespace orderbook {
 
 // Tracks where an order lives in the book for O(1) cancel.
 // The iterator lets us erase from std::list without searching.
+// GTT orders also link their expiry timer from here (OrderIndex entries
+// never move, so the intrusive link stays valid as the index grows).
 struct OrderLocation {
     Side side = Side::Buy;
     Price price = INVALID_PRICE;
     PriceLevel::OrderIterator iterator;
     Order* order = nullptr;
+    TimerNode expiry;
+    OrderHandle handle;           // Slot in the book's HandleTable
+    PriceLevel* level = nullptr;  // Map nodes don't move, so this stays valid while resting
+};
+
+// Result of walking one side of the book without modifying it.
+// notional is the sum of price * qty over every fill, still in fixed-point;
+// overflow is set (and notional meaningless) if that sum doesn't fit in int64.
+struct FillEstimate {
+    Quantity quantity = 0;
+    int64_t notional = 0;
+    Price worst_price = INVALID_PRICE;
+    bool overflow = false;
+};
+
+// Where a book's node-based containers get their memory.
+// System: operator new for every node (the default).
+// Pool:   per-container NodePool sized from OrderBookConfig, so steady-state
+//         adds and cancels never reach malloc.
+enum class AllocatorKind : uint8_t {
+    System = 0,
+    Pool = 1
+};
+
+// Which container holds a book's price levels (see level_containers.hpp).
+// Map:    std::map node per level. The default; no tuning needed.
+// Ladder: array slot per tick. O(1) lookups, best for tight-tick books whose
+//         levels sit close together; needs a sensible tick_size. A $0.01
+//         tick gets a ladder compiled for it (CentLadderLevels). Limit
+//         orders that would stretch a side past LadderLevels::MAX_TICKS
+//         are rejected with InvalidPrice.
+// BTree:  sorted blocks of levels. Best for wide-band books with many
+//         scattered levels.
+// Vector: one sorted array, best level at the back. Best when activity
+//         stays in the top few levels; deep inserts move every better level.
+enum class LevelBackend : uint8_t {
+    Map = 0,
+    Ladder = 1,
+    BTree = 2,
+    Vector = 3
+};
+
+// Sizing and validation settings for one book, fixed at construction.
+// Zero means "no hint" / "no limit" throughout.
+struct OrderBookConfig {
+    size_t expected_orders = 0;   // Resting orders at peak: lookup buckets + node pools
+    size_t expected_levels = 0;   // Price levels per side at peak: level pool
+    Price tick_size = 1;          // Limit prices must be a multiple of this (see TickSize)
+    Price min_price = 0;          // Price band: limit orders outside it are rejected
+    Price max_price = 0;
+    AllocatorKind allocator = AllocatorKind::System;
+    // Tick 0 of the expiry wheel; unset = construction time. Replicas must
+    // share it, or the same tick() can expire an order on one and not another.
+    std::optional<Timestamp> expiry_epoch;
+    // next_order_id() issues id_base + 1, id_base + 2, ... MatchingEngine
+    // gives each book it creates its own 2^40-id range when this is 0.
+    OrderId id_base = 0;
+    // Order ids are client-chosen and scattered rather than next_order_id()'s:
+    // expected_orders reserves overflow-map buckets instead of index pages.
+    // Either way only ids next_order_id() has issued are paged; any other id
+    // uses the overflow map.
+    bool sparse_ids = false;
+    // Empty levels kept in the map per side, for the next order at that price,
+    // instead of erasing the node and rebuilding it when the touch flickers.
+    // When the budget is full the retained level farthest from the touch is
+    // evicted in favour of a nearer one. 0 = erase every empty level.
+    size_t retain_empty_levels = 0;
+    LevelBackend levels = LevelBackend::Map;
+    // Id stamped on this book's TradeRecords. MatchingEngine numbers the
+    // books it creates 1, 2, ... when this is 0.
+    InstrumentId instrument_id = 0;
+    // TradeRecords kept in the book's trade tape (rounded up to a power of
+    // two); 0 = no tape.
+    size_t trade_tape = 1024;
+};
+
+// Heap footprint of one book, in bytes, broken down by component.
+// Container components are measured by CountingAllocators, so they include
+// node headers, padding and the unordered_map bucket array.
+struct MemoryStats {
+    size_t levels = 0;        // Level container: map nodes, ladder slots or tree leaves + PriceLevels
+    size_t queue_nodes = 0;   // std::list nodes in every PriceLevel queue
+    size_t lookup_table = 0;  // Order index pages + overflow nodes/buckets + handle slots
+    size_t expiry_wheel = 0;  // Timer wheel slot heads + expiry batch buffer
+    size_t orders = 0;        // Resting Order objects (owned by the caller)
+    size_t strings = 0;       // Heap buffers of the book's and orders' symbols
+    size_t pool_slack = 0;    // Pool memory reserved but not currently in use
+    size_t trade_tape = 0;    // TradeTape ring
+
+    size_t total() const noexcept {
+        return levels + queue_nodes + lookup_table + expiry_wheel + orders + strings + pool_slack +
+               trade_tape;
+    }
 };
 
 // Order book for a single instrument. Matches orders using price-time priority.
 //
-// Complexity: add O(log n), cancel O(1), best_bid/ask O(1)
+// Complexity: add O(log n), cancel O(1), best_bid/ask O(1), expiry O(1) per order
+//
+// Resting orders can be addressed two ways:
+//   - by OrderId: a direct page lookup for ids from next_order_id(), a hash
+//     lookup for any other id (see OrderIndex)
+//   - by OrderHandle: an array index + generation check, for in-process
+//     callers (strategies) that keep the handle add_order() gave them
+//
+// Gateways should stamp orders with next_order_id() and translate their
+// clients' own ids once, at the edge, so fills and cancels inside the book
+// never hash. SequencedEngine (and so Sequencer and AsyncEngine) does.
 class OrderBook {
 public:
+    // Default number of expiries processed by one tick() call
+    static constexpr size_t DEFAULT_EXPIRY_BATCH = 4096;
+
     explicit OrderBook(const std::string& symbol);
-    OrderBook() = default;
+    OrderBook(const std::string& symbol, const OrderBookConfig& config);
+    OrderBook() : OrderBook(std::string{}) {}
 
     // Match incoming order against resting orders, return generated trades
     std::vector<Trade> add_order(Order* order);
+
+    // Same, and set `handle` to the order's handle if it rests (null handle
+    // if it was rejected or fully filled)
+    std::vector<Trade> add_order(Order* order, OrderHandle& handle);
+
     ErrorCode cancel_order(OrderId order_id);
+    ErrorCode cancel_order(OrderHandle handle);
+
+    // Change a resting order's open quantity to new_quantity (> 0).
+    // Reducing keeps its place in the queue; increasing sends it to the back
+    // of its level, as a new order at that price would be. The order's total
+    // (filled + new_quantity) is capped at MAX_ORDER_QUANTITY, like a new
+    // order's quantity; InvalidQuantity otherwise.
+    ErrorCode modify_order(OrderId order_id, Quantity new_quantity);
+    ErrorCode modify_order(OrderHandle handle, Quantity new_quantity);
+
+    // Handle of a resting order (null handle if it isn't resting)
+    OrderHandle handle_of(OrderId order_id) const noexcept;
+
+    // Dense, increasing order id for this book (see OrderBookConfig::id_base).
+    // Only these ids (and the next one, for warm_up) get index pages.
+    OrderId next_order_id() noexcept {
+        const OrderId id = config_.id_base + ++issued_ids_;
+        if (!config_.sparse_ids) order_lookup_.set_dense_range(config_.id_base + 1, id + 1);
+        return id;
+    }
+
+    // Mass cancel: cancels every listed order that is still resting.
+    // Returns how many were cancelled; unknown IDs are skipped.
+    size_t cancel_orders(const std::vector<OrderId>& order_ids);
+
+    // Expire GTT orders whose deadline is <= now, at most max_expiries of them.
+    // Anything left over stays due and goes out on the next tick, so the caller
+    // can interleave matching with a large end-of-day expiry.
+    // Returns the number of orders expired; their ids are appended to
+    // `expired` if given.
+    size_t tick(Timestamp now, size_t max_expiries = DEFAULT_EXPIRY_BATCH,
+                std::vector<OrderId>* expired = nullptr);
+
+    // GTT orders that are due but not yet expired by tick()
+    size_t pending_expiries() const noexcept { return expiry_wheel_.due_count(); }
+
+    // Touch every pre-reserved structure before trading starts: runs one order
+    // per side through add + cancel, which carves and faults in the node pools
+    // and warms the code paths. Only valid on an empty book; returns false
+    // (and does nothing) otherwise.
+    bool warm_up();
+
+    // Publish the top `depth` levels per side to `view` after every add,
+    // cancel and expiry, for lock-free reads from other threads.
+    // Pass nullptr to detach. The view must outlive the attachment.
+    void attach_view(BookView* view, size_t depth = BookSnapshot::MAX_DEPTH) noexcept;
+
+    // Report every level change to `listener` (nullptr to detach). The
+    // listener must outlive the attachment.
+    void set_listener(BookListener* listener) noexcept { listener_ = listener; }
+
+    // Fill `out` with the current top `depth` levels (matching thread only)
+    void snapshot(BookSnapshot& out, size_t depth = BookSnapshot::MAX_DEPTH) const noexcept;
+
+    const OrderBookConfig& config() const noexcept { return config_; }
+    const TickSize& tick_size() const noexcept { return tick_; }
 
     std::optional<Price> best_bid() const noexcept;
     std::optional<Price> best_ask() const noexcept;
     std::optional<Price> spread() const noexcept;
     Quantity volume_at_price(Side side, Price price) const noexcept;
 
+    // Cumulative depth estimate: what an incoming order on `side` for `quantity`
+    // would fill right now, stopping at `limit` (INVALID_PRICE = no limit).
+    // Does not modify the book.
+    FillEstimate estimate_fill(Side side, Quantity quantity,
+                               Price limit = INVALID_PRICE) const noexcept;
+
     const std::string& symbol() const noexcept { return symbol_; }
     size_t order_count() const noexcept { return order_lookup_.size(); }
     bool empty() const noexcept { return order_lookup_.empty(); }
-    size_t bid_levels() const noexcept { return bids_.size(); }
-    size_t ask_levels() const noexcept { return asks_.size(); }
+    // Levels with resting orders (retained empty levels aren't counted)
+    size_t bid_levels() const noexcept;
+    size_t ask_levels() const noexcept;
+
+    // Rolling checksum of the resting orders (see book_checksum.hpp). O(1):
+    // maintained on every add, fill, cancel and expiry.
+    uint64_t state_checksum() const noexcept { return state_checksum_; }
+
+    // The book's recent trades as TradeRecords (see trade_tape.hpp)
+    const TradeTape& trade_tape() const noexcept { return tape_; }
+
+    // Deep copy of the resting state for verify_image(), e.g. on another
+    // thread. O(orders); matching thread only.
+    BookImage image() const;
+
+    // Full consistency check of levels, lookup table and checksum. O(orders).
+    VerifyResult verify() const { return verify_image(image()); }
+
+    // Current heap footprint. O(1): containers are tracked by their allocators
+    // and per-order string bytes are tallied as orders enter and leave.
+    MemoryStats memory_stats() const noexcept;
 
 private:
+    // Both sides' level containers, for one backend
+    template <template <typename> class Levels>
+    struct Sides {
+        Levels<std::greater<Price>> bids;          // Highest first
+        Levels<std::less<Price>> asks;             // Lowest first
+
+        Sides(const LevelAllocator& alloc, const TickSize& tick)
+            : bids(alloc, tick), asks(alloc, tick) {}
+    };
+    using LevelStore = std::variant<Sides<MapLevels>, Sides<LadderLevels>, Sides<CentLadderLevels>,
+                                    Sides<BTreeLevels>, Sides<VectorLevels>>;
+    using OrderLookup = OrderIndex<OrderLocation,
+                                   CountingAllocator<std::pair<const OrderId, OrderLocation>>>;
+
+    ErrorCode validate(const Order& order) const noexcept;
     Quantity match_order(Order* order, std::vector<Trade>& trades);
-    void add_to_book(Order* order);
+    template <Side S, typename Book>
+    Quantity match(Book& opposite_book, std::vector<Price>& retained,
+                   Order* incoming, std::vector<Trade>& trades);
+    OrderHandle add_to_book(Order* order);
     void remove_from_book(const OrderLocation& location);
+    void erase_order(OrderLocation& location);
+    ErrorCode cancel_resting(OrderLocation& location);
+    ErrorCode modify_resting(OrderLocation& location, Quantity new_quantity);
+    void publish_view() noexcept;
+    void finish_update();
+    void notify_level(Side side, Price price, const PriceLevel& level);
+    size_t cancel_batch(const OrderId* order_ids, size_t count, OrderStatus reason,
+                        std::vector<OrderId>* removed_ids = nullptr);
     PriceLevel& get_or_create_level(Side side, Price price);
+    template <typename Book>
+    typename Book::iterator retire_level(Book& book, typename Book::iterator it,
+                                         std::vector<Price>& retained);
     TradeId next_trade_id() noexcept { return ++next_trade_id_; }
-    static bool prices_cross(const Order* incoming, Price resting_price) noexcept;
+
+    static LevelStore make_levels(LevelBackend backend, const LevelAllocator& alloc,
+                                  const TickSize& tick);
+
+    // fn(bids, asks) on this book's level containers. The one runtime switch
+    // on the backend happens here; everything fn does is compiled per backend.
+    template <typename Fn>
+    decltype(auto) with_levels(Fn&& fn) {
+        return std::visit([&](auto& sides) -> decltype(auto) { return fn(sides.bids, sides.asks); },
+                          levels_);
+    }
+    template <typename Fn>
+    decltype(auto) with_levels(Fn&& fn) const {
+        return std::visit([&](const auto& sides) -> decltype(auto) { return fn(sides.bids, sides.asks); },
+                          levels_);
+    }
+
+    // First level with resting orders. Skips at most retain_empty_levels.
+    template <typename Book>
+    static auto first_live(const Book& book) noexcept {
+        auto it = book.begin();
+        while (it != book.end() && it->second.empty()) ++it;
+        return it;
+    }
+
+    // Does an incoming order on side S with this limit trade against a
+    // resting level at resting_price?
+    template <Side S>
+    static constexpr bool crosses(Price limit, Price resting_price) noexcept {
+        if constexpr (S == Side::Buy) return limit >= resting_price;
+        else return limit <= resting_price;
+    }
+    static uint64_t state_hash(const Order& order) noexcept {
+        return order_state_hash(order.id, order.side, order.price, order.remaining_quantity());
+    }
 
     std::string symbol_;
-    std::map<Price, PriceLevel, std::greater<Price>> bids_;  // Highest first
-    std::map<Price, PriceLevel, std::less<Price>> asks_;     // Lowest first
-    std::unordered_map<OrderId, OrderLocation> order_lookup_;
+    OrderBookConfig config_;
+    TickSize tick_;                                // config_.tick_size with its reciprocal
+    PriceLevel::Allocator queue_alloc_;            // Shared by every level's queue
+    LevelStore levels_;                            // Bids and asks, per config_.levels
+    std::vector<Price> retained_bids_;             // Prices of the empty bid levels kept in levels_
+    std::vector<Price> retained_asks_;
+    OrderLookup order_lookup_;
+    OrderId issued_ids_ = 0;                       // Ids handed out by next_order_id()
+    HandleTable<OrderLocation> handles_;           // OrderHandle -> lookup entry
+    size_t order_string_bytes_ = 0;                // Heap bytes of resting orders' symbols
+    TimerWheel expiry_wheel_;
+    std::vector<OrderId> expiry_batch_;  // Reused by tick() to avoid allocating
     TradeId next_trade_id_ = 0;
+    TradeTape tape_;                               // Every fill, as a TradeRecord
+    uint64_t state_checksum_ = 0;                  // Sum of state_hash() over resting orders
+    BookView* view_ = nullptr;                     // Optional seqlock view for readers
+    size_t view_depth_ = 0;
+    BookSnapshot view_scratch_;                    // Built here, then published
+    BookListener* listener_ = nullptr;             // Optional depth event stream
 };
 
 } // namespace orderbook
@@ -0,0 +1,239 @@
+#ifndef ORDERBOOK_ORDER_INDEX_HPP
+#define ORDERBOOK_ORDER_INDEX_HPP
+
+#include "types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace orderbook {
+
+// ============================================================================
+// OrderIndex Class
+// ============================================================================
+//
+// OrderId -> V map tuned for the ids OrderBook::next_order_id() hands out:
+// dense and increasing.
+//
+// HOW IT WORKS:
+//   Ids are split into pages of PAGE_SIZE consecutive values. A window of
+//   page pointers covers the live id range, so a lookup is a subtraction, a
+//   deque index and a bit test, with no hashing. Since ids only grow, the
+//   window slides forward: a page whose orders have all left the book is
+//   recycled (kept as a spare for the next range), and empty pages at the
+//   start of the window are dropped.
+//
+//   Only ids inside the dense range (set_dense_range) get pages. Any other
+//   id (client-chosen ids, sentinels, a range more than MAX_WINDOW_PAGES
+//   wide) goes to an ordinary hash map instead, so any id still works; the
+//   overflow map is only consulted when it's non-empty.
+//
+// Entries never move while present (pages are only released once empty), so
+// callers can keep pointers to them, like unordered_map nodes.
+//
+// Each page costs PAGE_SIZE * sizeof(V) up front, which only pays off when
+// most of a page's ids are live at once. Nearby but scattered ids (every
+// 1024th, or one counter shared by several books) would cost a page per
+// order, so OrderBook limits the dense range to the ids its own
+// next_order_id() has issued.
+//
+
+template <typename V, typename Alloc = std::allocator<std::pair<const OrderId, V>>>
+class OrderIndex {
+public:
+    static constexpr unsigned PAGE_BITS = 10;
+    static constexpr size_t PAGE_SIZE = size_t{1} << PAGE_BITS;
+    static constexpr size_t MAX_WINDOW_PAGES = size_t{1} << 16;   // 64M ids
+    static constexpr size_t MAX_SPARE_PAGES = 4;                   // Beyond reserve()
+
+    using allocator_type = Alloc;
+    using Overflow = std::unordered_map<OrderId, V, std::hash<OrderId>,
+                                        std::equal_to<OrderId>, Alloc>;
+
+    explicit OrderIndex(const Alloc& alloc = Alloc())
+        : overflow_(0, std::hash<OrderId>(), std::equal_to<OrderId>(), alloc) {}
+
+    // Pre-allocate pages for `dense` ids and overflow buckets for `sparse`
+    // ones. Reserve only the kind the caller issues: buckets for ids that land
+    // in pages are wasted memory.
+    void reserve(size_t dense, size_t sparse = 0) {
+        if (sparse > 0) overflow_.reserve(sparse);
+        spare_target_ = (dense + PAGE_SIZE - 1) / PAGE_SIZE;
+        while (spares_.size() < spare_target_) {
+            spares_.push_back(std::make_unique<Page>());
+        }
+    }
+
+    // Ids in [first, last] may get pages; the rest use the overflow map.
+    // Entries already in pages stay there. Default: every id.
+    void set_dense_range(OrderId first, OrderId last) noexcept {
+        dense_first_ = first;
+        dense_last_ = last;
+    }
+
+    V* find(OrderId id) noexcept {
+        if (Page* page = page_of(id)) {
+            const size_t slot = id & SLOT_MASK;
+            if (page->has(slot)) return &page->entries[slot];
+        }
+        if (overflow_.empty()) return nullptr;
+        auto it = overflow_.find(id);
+        return it == overflow_.end() ? nullptr : &it->second;
+    }
+
+    const V* find(OrderId id) const noexcept {
+        return const_cast<OrderIndex*>(this)->find(id);
+    }
+
+    // Entry for id, default-constructed if it wasn't present
+    V& operator[](OrderId id) {
+        return *try_emplace(id).first;
+    }
+
+    // Default-constructed entry for id; {existing entry, false} if id was
+    // already present
+    std::pair<V*, bool> try_emplace(OrderId id) {
+        if (V* existing = find(id)) return {existing, false};
+
+        if (Page* page = page_for_insert(id)) {
+            const size_t slot = id & SLOT_MASK;
+            page->set(slot);
+            ++dense_size_;
+            return {&page->entries[slot], true};
+        }
+        return {&overflow_.try_emplace(id).first->second, true};
+    }
+
+    // Id must be present
+    void erase(OrderId id) noexcept {
+        if (Page* page = page_of(id)) {
+            const size_t slot = id & SLOT_MASK;
+            if (page->has(slot)) {
+                page->entries[slot] = V{};
+                page->clear(slot);
+                --dense_size_;
+                if (page->live == 0) release_page(id >> PAGE_BITS);
+                return;
+            }
+        }
+        overflow_.erase(id);
+    }
+
+    size_t size() const noexcept { return dense_size_ + overflow_.size(); }
+    bool empty() const noexcept { return size() == 0; }
+    size_t overflow_size() const noexcept { return overflow_.size(); }
+
+    // fn(OrderId, const V&) for every entry, pages first
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        for (size_t p = 0; p < window_.size(); ++p) {
+            const Page* page = window_[p].get();
+            if (page == nullptr) continue;
+            const OrderId first = static_cast<OrderId>((base_page_ + p) << PAGE_BITS);
+            for (size_t w = 0; w < WORDS; ++w) {
+                for (uint64_t bits = page->present[w]; bits != 0; bits &= bits - 1) {
+                    const size_t slot = w * 64 + static_cast<size_t>(__builtin_ctzll(bits));
+                    fn(first + slot, page->entries[slot]);
+                }
+            }
+        }
+        for (const auto& [id, value] : overflow_) {
+            fn(id, value);
+        }
+    }
+
+    // Pages in use or spare, plus the window itself. The overflow map is
+    // accounted by its allocator.
+    size_t page_bytes() const noexcept {
+        size_t pages = spares_.size();
+        for (const auto& page : window_) pages += page != nullptr;
+        return pages * sizeof(Page) + window_.size() * sizeof(std::unique_ptr<Page>);
+    }
+
+    Alloc get_allocator() const noexcept { return overflow_.get_allocator(); }
+
+private:
+    static constexpr uint64_t SLOT_MASK = PAGE_SIZE - 1;
+    static constexpr size_t WORDS = PAGE_SIZE / 64;
+
+    struct Page {
+        V entries[PAGE_SIZE];
+        uint64_t present[WORDS] = {};
+        size_t live = 0;
+
+        bool has(size_t slot) const noexcept { return (present[slot / 64] >> (slot % 64)) & 1; }
+        void set(size_t slot) noexcept { present[slot / 64] |= uint64_t{1} << (slot % 64); ++live; }
+        void clear(size_t slot) noexcept { present[slot / 64] &= ~(uint64_t{1} << (slot % 64)); --live; }
+    };
+
+    Page* page_of(OrderId id) const noexcept {
+        const uint64_t page = id >> PAGE_BITS;
+        if (page < base_page_ || page - base_page_ >= window_.size()) return nullptr;
+        return window_[page - base_page_].get();
+    }
+
+    // Page for a new id, growing the window if the id is close enough;
+    // nullptr = use the overflow map
+    Page* page_for_insert(OrderId id) {
+        if (id < dense_first_ || id > dense_last_) return nullptr;
+        const uint64_t page = id >> PAGE_BITS;
+        if (window_.empty()) {
+            base_page_ = page;
+            window_.emplace_back();
+        } else if (page < base_page_) {
+            if (base_page_ - page + window_.size() > MAX_WINDOW_PAGES) return nullptr;
+            for (; base_page_ > page; --base_page_) window_.emplace_front();
+        } else if (page - base_page_ >= window_.size()) {
+            if (page - base_page_ >= MAX_WINDOW_PAGES) return nullptr;
+            window_.resize(page - base_page_ + 1);
+        }
+
+        auto& slot = window_[page - base_page_];
+        if (slot == nullptr) {
+            if (!spares_.empty()) {
+                slot = std::move(spares_.back());     // Already all-default, nothing to reset
+                spares_.pop_back();
+            } else {
+                slot = std::make_unique<Page>();
+            }
+        }
+        return slot.get();
+    }
+
+    // Last order of a page left: recycle it and slide the window's start past
+    // empty pages. The tail is left alone: ids keep arriving there, and
+    // trimming back to an old page still in use would rebuild the same empty
+    // slots on the next insert (O(window) per order, not O(1)).
+    void release_page(uint64_t page) {
+        auto& slot = window_[page - base_page_];
+        if (spares_.size() < spare_target_ + MAX_SPARE_PAGES) {
+            spares_.push_back(std::move(slot));
+        } else {
+            slot.reset();
+        }
+
+        while (!window_.empty() && window_.front() == nullptr) {
+            window_.pop_front();
+            ++base_page_;
+        }
+    }
+
+    std::deque<std::unique_ptr<Page>> window_;    // window_[i] covers page base_page_ + i
+    uint64_t base_page_ = 0;
+    size_t dense_size_ = 0;
+    std::vector<std::unique_ptr<Page>> spares_;
+    size_t spare_target_ = 0;
+    OrderId dense_first_ = 0;
+    OrderId dense_last_ = std::numeric_limits<OrderId>::max();
+    Overflow overflow_;
+};
+
+} // namespace orderbook
+
+#endif // ORDERBOOK_ORDER_INDEX_HPP
@@ -3,6 +3,7 @@
 
 #include "types.hpp"
 #include "order.hpp"
+#include "counting_allocator.hpp"
 #include <list>
 
 namespace orderbook {
@@ -36,16 +37,21 @@ namespace orderbook {
 
 class PriceLevel {
 public:
+    // Queue nodes are allocated through a CountingAllocator so OrderBook can
+    // report how much memory its queues use (see OrderBook::memory_stats)
+    using Allocator = CountingAllocator<Order*>;
+    using OrderList = std::list<Order*, Allocator>;
+
     // Iterator type for external access (used by OrderBook for O(1) cancel)
-    using OrderIterator = std::list<Order*>::iterator;
-    using ConstOrderIterator = std::list<Order*>::const_iterator;
+    using OrderIterator = OrderList::iterator;
+    using ConstOrderIterator = OrderList::const_iterator;
 
     // ========================================================================
     // Constructors
     // ========================================================================
 
     // Create a price level at the given price
-    explicit PriceLevel(Price price);
+    explicit PriceLevel(Price price, const Allocator& alloc = Allocator());
 
     // Default constructor (for map default construction)
     PriceLevel() = default;
@@ -105,7 +111,7 @@ private:
     Quantity total_quantity_ = 0;
 
     // Orders in FIFO order (front = oldest = first to match)
-    std::list<Order*> orders_;
+    OrderList orders_;
 };
 
 } // namespace orderbook
@@ -1,27 +1,231 @@
 #ifndef ORDERBOOK_REDIS_PUBLISHER_HPP
 #define ORDERBOOK_REDIS_PUBLISHER_HPP
 
+#include "bar_aggregator.hpp"
+#include "resp_writer.hpp"
+#include "spsc_queue.hpp"
 #include "trade.hpp"
-#include <hiredis.h>
+#include "trade_sink.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <variant>
+#include <vector>
 
 namespace orderbook {
 
-// Publishes trade events to a Redis pub/sub channel.
-// One job: take a Trade, send it to Redis.
-class RedisPublisher {
+// ============================================================================
+// RedisPublisher
+// ============================================================================
+//
+// Publishes trades to the Redis "trades" pub/sub channel (and closed bars to
+// "bars.<interval>"), surviving Redis outages without blocking the matching
+// thread or losing a trade.
+//
+//   matching thread --SpscQueue--> I/O thread --RespWriter--> spill log
+//                                                  (mmapped file)
+//                                      Redis <--pipelined send()--+
+//                                      Redis --replies--> advance log head
+//
+// WHY?
+//   The publisher used to throw if Redis was down at start-up, never
+//   reconnected, and dropped every trade published while disconnected.
+//
+// HOW IT WORKS:
+//   The matching thread only copies trades into a queue. The I/O thread
+//   encodes them as RESP commands and appends them to the spill log, a
+//   memory-mapped file holding every command Redis has not acknowledged
+//   yet. Commands are sent from the log, up to `drain_bytes` per send(),
+//   and each reply moves the log's head past one command.
+//
+//   While Redis keeps up, the head catches the tail and the log rewinds
+//   to the start, so only its first pages are touched. While Redis is
+//   unreachable, the log grows (the file is extended as needed); after a
+//   reconnect the backlog goes out in large pipelined writes, ahead of and
+//   in order with the live trades appended behind it.
+//
+//   Reconnects are non-blocking connects retried with exponential backoff
+//   (min_backoff doubling up to max_backoff), so the I/O thread keeps
+//   draining the queue into the log during an outage.
+//
+// DELIVERY:
+//   At least once. Commands sent but unacknowledged when a connection drops
+//   are sent again on the next one, so Redis may see a few of them twice.
+//   Error replies (-ERR ...) count as acknowledged and are not retried,
+//   except -LOADING, -BUSY, -MISCONF and -TRYAGAIN: Redis can't take the
+//   command yet, so the connection is dropped with the command still at the
+//   head of the log, and it is sent again after a backoff that keeps
+//   doubling until a reply acknowledges something.
+//
+//   The log head and tail live in the file: if the process exits with a
+//   backlog, the next publisher opened on the same spill_path sends it
+//   first. The file is removed on a clean stop with nothing left in it.
+//   A publisher holds an exclusive flock() on its file for as long as it
+//   runs; a second one on the same path, in this process or another, is
+//   not ok().
+//
+// If the log can't grow (disk full, or max_spill_bytes reached), the batch
+// that didn't fit is kept and retried with the reconnect backoff while the
+// log drains; new entries wait in the queue meanwhile. The matching thread
+// never waits: once the queue is full (that, or the I/O thread starved of
+// CPU), entries go to an in-memory overflow buffer, which the I/O thread
+// takes in order after the queue (counted in overflowed()). Past
+// max_overflow entries there, trades are dropped, counted in dropped(),
+// and last_error() says so.
+//
+
+struct RedisPublisherConfig {
+    std::string host = "127.0.0.1";
+    int port = 6379;
+
+    // Non-empty: also XADD every trade to this stream, capped at about
+    // stream_max_len entries
+    std::string stream;
+    uint64_t stream_max_len = 1'000'000;
+
+    // Memory-mapped log of unacknowledged commands, locked by one publisher
+    // at a time. Empty: orderbook.redis.<host>-<port>.spill in a directory
+    // private to this user ($XDG_RUNTIME_DIR, else /tmp/orderbook-<euid>).
+    // A file that is a symlink, owned by another user, or writable by group
+    // or others is refused.
+    std::string spill_path;
+    size_t max_spill_bytes = 0;            // File size cap; 0 = none. At least 1 MB.
+
+    size_t queue_capacity = 1 << 16;
+    size_t max_overflow = 1 << 18;         // Entries held once the queue is full
+    std::chrono::milliseconds connect_timeout{1000};
+    std::chrono::milliseconds min_backoff{50};
+    std::chrono::milliseconds max_backoff{5000};
+    size_t drain_bytes = 1 << 20;          // Most log bytes per send()
+};
+
+class RedisPublisher : public BarListener, public TradeSink {
 public:
-    RedisPublisher(const std::string& host = "127.0.0.1", int port = 6379);
-    ~RedisPublisher();
+    static constexpr size_t SYMBOL_SIZE = 32;   // Longer symbols are cut
+    static constexpr size_t BATCH = 256;        // Queue entries per pop
+
+    explicit RedisPublisher(RedisPublisherConfig config = {});
+    RedisPublisher(const std::string& host, int port = 6379);
+    ~RedisPublisher() override;
+
+    RedisPublisher(const RedisPublisher&) = delete;
+    RedisPublisher& operator=(const RedisPublisher&) = delete;
 
-    // Returns true if connected to Redis successfully
-    bool is_connected() const noexcept;
+    // False if the spill log could not be opened or is locked by another
+    // publisher (last_error() says which): nothing is published
+    bool ok() const noexcept { return running_.load(std::memory_order_acquire); }
+
+    // The spill log's path (config.spill_path, or the default for host:port)
+    const std::string& spill_path() const noexcept { return config_.spill_path; }
+
+    // Connected to Redis right now
+    bool is_connected() const noexcept { return connected_.load(std::memory_order_acquire); }
+
+    // Block until connected (or the timeout)
+    bool wait_connected(std::chrono::milliseconds timeout) const;
 
     // Publish a trade to the "trades" channel
     void publish_trade(const Trade& trade);
 
+    // Publish `count` trades of `symbol` to the "trades" channel
+    void publish_trades(const std::string& symbol, const TradeRecord* trades, size_t count);
+
+    // Publish a closed bar to the "bars.1s" / "bars.1m" / "bars.1h" channel
+    void publish_bar(const std::string& symbol, const Bar& bar);
+
+    // TradeSink
+    void on_trades(const OrderBook& book, const TradeRecord* records, size_t count) override;
+
+    // BarListener
+    void on_bar(const std::string& symbol, const Bar& bar) override { publish_bar(symbol, bar); }
+
+    // Wait until Redis has acknowledged everything published so far
+    bool flush(std::chrono::milliseconds timeout);
+
+    // Stop the I/O thread and disconnect. Unacknowledged commands stay in
+    // the spill file for the next publisher on the same path.
+    void stop();
+
+    // Unacknowledged command bytes in the spill log
+    uint64_t backlog_bytes() const noexcept { return backlog_bytes_.load(std::memory_order_acquire); }
+
+    // Commands Redis has answered
+    uint64_t acknowledged() const noexcept { return acknowledged_.load(std::memory_order_relaxed); }
+
+    // Connections made after the first
+    uint64_t reconnects() const noexcept { return reconnects_.load(std::memory_order_relaxed); }
+
+    // Entries that found the queue full and went to the overflow buffer
+    uint64_t overflowed() const noexcept { return overflowed_.load(std::memory_order_relaxed); }
+
+    // Entries dropped because the overflow buffer was full too
+    uint64_t dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+    // Error replies from Redis (the last one is kept)
+    uint64_t errors() const noexcept { return errors_.load(std::memory_order_relaxed); }
+    std::string last_error() const;
+
 private:
-    redisContext* ctx_ = nullptr;
+    class SpillLog;
+
+    struct Outgoing {
+        std::variant<TradeRecord, Bar> item;
+        char symbol[SYMBOL_SIZE];
+    };
+
+    static void set_symbol(Outgoing& entry, const std::string& symbol) noexcept;
+    bool push(const Outgoing& entry);
+    size_t take(Outgoing* out, size_t max);
+    void run_io();
+    void encode(const Outgoing& entry);
+
+    // Connection state machine, I/O thread only
+    void start_connect();
+    void finish_connect();
+    void drop_connection();
+    bool send_backlog();
+    bool read_replies();
+
+    RedisPublisherConfig config_;
+    SpscQueue<Outgoing> queue_;
+    std::unique_ptr<SpillLog> log_;
+
+    // Entries published while the queue was full, in order behind it
+    std::mutex overflow_mutex_;
+    std::vector<Outgoing> overflow_;
+    std::atomic<bool> overflow_pending_{false};
+    std::vector<Outgoing> overflow_taken_;  // I/O thread's copy
+    size_t overflow_next_ = 0;
+    RespWriter writer_;
+    RespReplyScanner replies_;
+    char reply_buffer_[16 * 1024];
+
+    int fd_ = -1;
+    bool connecting_ = false;
+    uint64_t sent_ = 0;                    // Log offset of the first unsent byte
+    uint64_t connects_ = 0;
+    std::chrono::steady_clock::time_point connect_deadline_{};
+    std::chrono::steady_clock::time_point next_attempt_{};
+    std::chrono::milliseconds backoff_;
+    std::chrono::milliseconds retry_backoff_;   // After a retryable error reply
+
+    std::thread io_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> connected_{false};
+    std::atomic<uint64_t> queued_{0};      // Entries pushed by the matching thread
+    std::atomic<uint64_t> logged_{0};      // Entries encoded into the log
+    std::atomic<uint64_t> backlog_bytes_{0};
+    std::atomic<uint64_t> acknowledged_{0};
+    std::atomic<uint64_t> reconnects_{0};
+    std::atomic<uint64_t> errors_{0};
+    std::atomic<uint64_t> overflowed_{0};
+    std::atomic<uint64_t> dropped_{0};
+    mutable std::mutex error_mutex_;
+    std::string last_error_;
 };
 
 } // namespace orderbook
@@ -0,0 +1,158 @@
+#ifndef ORDERBOOK_REPLICATION_HPP
+#define ORDERBOOK_REPLICATION_HPP
+
+#include "sequencer.hpp"
+#include "spsc_queue.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace orderbook {
+
+// ============================================================================
+// Primary / Backup Replication
+// ============================================================================
+//
+// Hot standby for a SequencedEngine over a TCP connection on the same host.
+//
+//   primary:  Sequencer --replicate()--> SpscQueue --sender thread--> socket
+//   backup:   socket --receiver thread--> SequencedEngine::apply()
+//
+// The backup applies exactly the primary's command sequence, so its books are
+// always current; failing over is promote() plus a new Sequencer, no replay.
+//
+// FAILURE DETECTION:
+//   The primary sends a Heartbeat whenever the link has been idle for
+//   heartbeat_interval. The backup declares the primary dead on EOF, on a
+//   socket error, or after failover_timeout without any bytes. With the
+//   defaults (1ms / 5ms) a crashed primary is detected within a few ms.
+//
+// DIVERGENCE:
+//   Checkpoint commands carry the primary's checksum. A backup whose checksum
+//   differs stops applying and reports diverged() - it must not be promoted.
+//
+// WHAT CAN BE LOST:
+//   Replication is asynchronous. A command is queued before the primary
+//   applies it, but only reaches the backup once the sender thread has
+//   written it; commands still queued when the primary crashes are lost,
+//   and the promoted backup is behind by that many. flush() waits the
+//   window out for callers that need it closed.
+//
+//   replicate() never blocks the matching thread for more than max_block.
+//   If the backup can't keep up the command is dropped and counted in
+//   overflowed(); the backup sees the sequence gap and reports diverged(),
+//   so it is never promoted with a hole in its stream.
+//
+
+class ReplicationPrimary {
+public:
+    static constexpr size_t DEFAULT_QUEUE_CAPACITY = 1 << 16;
+    static constexpr std::chrono::microseconds DEFAULT_MAX_BLOCK{20};
+
+    // Listen on 127.0.0.1:port (0 = pick a free port, see port())
+    explicit ReplicationPrimary(uint16_t port = 0,
+                                std::chrono::milliseconds heartbeat_interval = std::chrono::milliseconds(1),
+                                size_t queue_capacity = DEFAULT_QUEUE_CAPACITY,
+                                std::chrono::microseconds max_block = DEFAULT_MAX_BLOCK);
+    ~ReplicationPrimary();
+
+    ReplicationPrimary(const ReplicationPrimary&) = delete;
+    ReplicationPrimary& operator=(const ReplicationPrimary&) = delete;
+
+    bool listening() const noexcept { return listen_fd_ >= 0; }
+    uint16_t port() const noexcept { return port_; }
+
+    // Accept one backup and start the sender thread
+    bool wait_for_backup(std::chrono::milliseconds timeout);
+    bool connected() const noexcept { return connected_.load(std::memory_order_acquire); }
+
+    // Matching thread: queue a sequenced command. If the queue is full (the
+    // backup is too slow) waits up to max_block, then drops the command and
+    // returns false (see overflowed()). Drops silently once the backup is gone.
+    bool replicate(const Command& cmd) noexcept;
+
+    // Wait until everything queued so far has been written to the socket
+    bool flush(std::chrono::milliseconds timeout);
+
+    // Close the link; commands still queued are dropped. To the backup this
+    // is indistinguishable from a crash.
+    void stop();
+
+    uint64_t commands_sent() const noexcept { return sent_.load(std::memory_order_relaxed); }
+
+    // Commands dropped because the queue stayed full for max_block. Any
+    // non-zero value means the backup has diverged.
+    uint64_t overflowed() const noexcept { return overflowed_.load(std::memory_order_relaxed); }
+
+private:
+    void run_sender();
+    bool write_all(const void* data, size_t bytes);
+
+    int listen_fd_ = -1;
+    int conn_fd_ = -1;
+    uint16_t port_ = 0;
+    std::chrono::milliseconds heartbeat_interval_;
+    std::chrono::microseconds max_block_;
+
+    SpscQueue<Command> queue_;
+    std::thread sender_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> connected_{false};
+    std::atomic<uint64_t> queued_{0};
+    std::atomic<uint64_t> sent_{0};
+    std::atomic<uint64_t> overflowed_{0};
+};
+
+class ReplicationBackup {
+public:
+    ReplicationBackup(std::string host, uint16_t port,
+                      std::chrono::milliseconds failover_timeout = std::chrono::milliseconds(5));
+    ~ReplicationBackup();
+
+    ReplicationBackup(const ReplicationBackup&) = delete;
+    ReplicationBackup& operator=(const ReplicationBackup&) = delete;
+
+    // Connect to the primary and start applying its stream
+    bool connect();
+
+    // Block until `seq` has been applied, the primary fails, or timeout
+    bool wait_for_sequence(SequenceNumber seq, std::chrono::milliseconds timeout);
+
+    // Block until the primary is declared dead (or timeout)
+    bool wait_for_failover(std::chrono::milliseconds timeout);
+
+    bool primary_failed() const noexcept { return failed_.load(std::memory_order_acquire); }
+    bool diverged() const noexcept { return diverged_.load(std::memory_order_acquire); }
+    SequenceNumber last_sequence() const noexcept { return applied_.load(std::memory_order_acquire); }
+
+    // Stop receiving and hand over the engine. Only call after failover (or
+    // to shut the backup down); the engine is not thread-safe while receiving.
+    SequencedEngine& promote();
+
+private:
+    void run_receiver();
+    void notify_progress();
+
+    std::string host_;
+    uint16_t port_;
+    std::chrono::milliseconds failover_timeout_;
+    int fd_ = -1;
+
+    SequencedEngine engine_;
+    std::thread receiver_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> failed_{false};
+    std::atomic<bool> diverged_{false};
+    std::atomic<SequenceNumber> applied_{0};
+
+    std::mutex mutex_;
+    std::condition_variable progress_;
+};
+
+} // namespace orderbook
+
+#endif // ORDERBOOK_REPLICATION_HPP
@@ -0,0 +1,287 @@
+#ifndef ORDERBOOK_RESP_WRITER_HPP
+#define ORDERBOOK_RESP_WRITER_HPP
+
+#include "trade.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace orderbook {
+
+// ============================================================================
+// RESP Writer
+// ============================================================================
+//
+// Serialises Redis commands (RESP arrays of bulk strings) straight into one
+// preallocated buffer, so a whole batch of PUBLISH / XADD commands goes out
+// in a single socket write.
+//
+// WHY?
+//   redisCommand(ctx, "PUBLISH trades %s", msg) parses a printf format,
+//   builds the command in freshly allocated sds strings, and then blocks
+//   until Redis replies: one allocation-heavy round trip per trade. Here a
+//   trade is encoded with std::to_chars into memory that is already there,
+//   and replies are counted later (RespReplyScanner) instead of waited for.
+//
+// HOW IT WORKS:
+//   *3\r\n$7\r\nPUBLISH\r\n$6\r\ntrades\r\n$<len>\r\n<message>\r\n
+//
+//   A bulk string needs its length before its bytes. The trade message's
+//   length is computed from the digit counts of its fields, so the payload
+//   is written once, in place, after its header.
+//
+//   The buffer grows only if one batch needs more than `capacity` bytes;
+//   clear() keeps the memory for the next batch.
+//
+// The trade message is the text publish_trade() has always sent:
+//   symbol=AAPL price=101.000000 qty=100 buy=1 sell=2
+// The price is printed from the fixed-point value, which gives the same six
+// decimals std::to_string(price_to_double(price)) did.
+//
+
+class RespWriter {
+public:
+    explicit RespWriter(size_t capacity = 64 * 1024) { buffer_.resize(capacity); }
+
+    const char* data() const noexcept { return buffer_.data(); }
+    size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+    size_t capacity() const noexcept { return buffer_.size(); }
+    size_t commands() const noexcept { return commands_; }
+
+    // Forget the buffered commands, keep the memory
+    void clear() noexcept {
+        size_ = 0;
+        commands_ = 0;
+    }
+
+    // ------------------------------------------------------------------------
+    // Commands
+    // ------------------------------------------------------------------------
+
+    // PUBLISH <channel> <message>
+    void publish(std::string_view channel, std::string_view message) {
+        reserve(64 + channel.size() + message.size());
+        array(3);
+        bulk("PUBLISH");
+        bulk(channel);
+        bulk(message);
+        ++commands_;
+    }
+
+    // PUBLISH <channel> "symbol=... price=... qty=... buy=... sell=..."
+    void publish_trade(std::string_view channel, std::string_view symbol, const TradeRecord& trade) {
+        reserve(64 + channel.size() + symbol.size() + MAX_TRADE_TEXT);
+        array(3);
+        bulk("PUBLISH");
+        bulk(channel);
+        trade_text(symbol, trade);
+        ++commands_;
+    }
+
+    // XADD <stream> MAXLEN ~ <max_len> * symbol .. price .. qty .. buy .. sell ..
+    // (no MAXLEN when max_len is 0)
+    void xadd_trade(std::string_view stream, uint64_t max_len, std::string_view symbol,
+                    const TradeRecord& trade) {
+        reserve(160 + stream.size() + symbol.size() + MAX_TRADE_TEXT);
+        array(max_len > 0 ? 16 : 13);
+        bulk("XADD");
+        bulk(stream);
+        if (max_len > 0) {
+            bulk("MAXLEN");
+            bulk("~");
+            bulk(max_len);
+        }
+        bulk("*");
+        bulk("symbol");
+        bulk(symbol);
+        bulk("price");
+        bulk_price(trade.price);
+        bulk("qty");
+        bulk(trade.quantity);
+        bulk("buy");
+        bulk(trade.buy_order_id);
+        bulk("sell");
+        bulk(trade.sell_order_id);
+        ++commands_;
+    }
+
+    // ------------------------------------------------------------------------
+    // RESP elements (callers building their own commands must reserve() and
+    // count them)
+    // ------------------------------------------------------------------------
+
+    void reserve(size_t bytes) {
+        if (size_ + bytes > buffer_.size()) buffer_.resize(std::max(buffer_.size() * 2, size_ + bytes));
+    }
+
+    void array(size_t elements) {
+        put('*');
+        put_number(elements);
+        put_crlf();
+    }
+
+    void bulk(std::string_view s) {
+        put('$');
+        put_number(s.size());
+        put_crlf();
+        put(s);
+        put_crlf();
+    }
+
+    void bulk(uint64_t value) {
+        char digits[20];
+        const size_t n = static_cast<size_t>(std::to_chars(digits, digits + 20, value).ptr - digits);
+        bulk(std::string_view(digits, n));
+    }
+
+    void bulk_price(Price price) {
+        put('$');
+        put_number(price_length(price));
+        put_crlf();
+        put_price(price);
+        put_crlf();
+    }
+
+    // Upper bound of trade_text() beyond the symbol
+    static constexpr size_t MAX_TRADE_TEXT = 160;
+
+private:
+    // $<len>\r\nsymbol=AAPL price=101.000000 qty=100 buy=1 sell=2\r\n
+    void trade_text(std::string_view symbol, const TradeRecord& t) {
+        const size_t len = (7 + symbol.size()) + (7 + price_length(t.price)) +
+                           (5 + digits(t.quantity)) + (5 + digits(t.buy_order_id)) +
+                           (6 + digits(t.sell_order_id));
+        put('$');
+        put_number(len);
+        put_crlf();
+        put("symbol=");
+        put(symbol);
+        put(" price=");
+        put_price(t.price);
+        put(" qty=");
+        put_number(t.quantity);
+        put(" buy=");
+        put_number(t.buy_order_id);
+        put(" sell=");
+        put_number(t.sell_order_id);
+        put_crlf();
+    }
+
+    static constexpr uint64_t SCALE = static_cast<uint64_t>(PRICE_MULTIPLIER);
+    static_assert(SCALE == 1'000'000, "prices print with six decimal places");
+
+    static size_t digits(uint64_t v) noexcept {
+        size_t n = 1;
+        while (v >= 10) {
+            v /= 10;
+            ++n;
+        }
+        return n;
+    }
+
+    static uint64_t magnitude(Price price) noexcept {
+        return price < 0 ? 0 - static_cast<uint64_t>(price) : static_cast<uint64_t>(price);
+    }
+
+    // "-"? <whole> "." <6 decimals>
+    static size_t price_length(Price price) noexcept {
+        return (price < 0 ? 1 : 0) + digits(magnitude(price) / SCALE) + 7;
+    }
+
+    void put_price(Price price) noexcept {
+        const uint64_t m = magnitude(price);
+        if (price < 0) put('-');
+        put_number(m / SCALE);
+        put('.');
+        uint64_t frac = m % SCALE;
+        char* p = buffer_.data() + size_ + 6;
+        for (int i = 0; i < 6; ++i) {
+            *--p = static_cast<char>('0' + frac % 10);
+            frac /= 10;
+        }
+        size_ += 6;
+    }
+
+    void put_number(uint64_t value) noexcept {
+        char* p = buffer_.data() + size_;
+        size_ = static_cast<size_t>(std::to_chars(p, p + 20, value).ptr - buffer_.data());
+    }
+
+    void put(char c) noexcept { buffer_[size_++] = c; }
+
+    void put(std::string_view s) noexcept {
+        std::memcpy(buffer_.data() + size_, s.data(), s.size());
+        size_ += s.size();
+    }
+
+    void put_crlf() noexcept { put("\r\n"); }
+
+    std::vector<char> buffer_;
+    size_t size_ = 0;
+    size_t commands_ = 0;
+};
+
+// ============================================================================
+// RESP Reply Scanner
+// ============================================================================
+//
+// Counts complete replies in the byte stream Redis sends back, fed in
+// whatever pieces recv() returned. Pipelined commands are answered in order,
+// one reply each, so "replies seen" is "commands acknowledged".
+//
+// Error replies (-ERR ...) are counted and the last one kept; the values of
+// other replies are skipped, publishing never needs them.
+//
+// -LOADING, -BUSY, -MISCONF and -TRYAGAIN are different: Redis couldn't run
+// the command yet, and it should be sent again. Scanning stops in front of
+// such a reply, which is neither counted nor acknowledges anything, and
+// retry() is set until reset().
+//
+
+class RespReplyScanner {
+public:
+    RespReplyScanner() { partial_.reserve(4096); }
+
+    // Scan `n` more bytes; returns the number of replies they completed
+    size_t feed(const char* data, size_t n);
+
+    uint64_t replies() const noexcept { return replies_; }
+    uint64_t errors() const noexcept { return errors_; }
+    const std::string& last_error() const noexcept { return last_error_; }
+
+    // False once the stream stopped being RESP; the connection is unusable
+    bool ok() const noexcept { return ok_; }
+
+    // A retryable error reply arrived (last_error() has it): it and every
+    // reply after it are unread, and their commands need resending
+    bool retry() const noexcept { return retry_; }
+
+    // Drop a partial reply and a pending retry (after a reconnect)
+    void reset();
+
+    // Bytes of the complete RESP element (reply or command) at data[0, n);
+    // 0 if it is incomplete or not RESP
+    static size_t element_size(const char* data, size_t n);
+
+private:
+    // Replies in data[0, n); returns the bytes they took. A trailing partial
+    // reply is left for the next feed.
+    size_t scan(const char* data, size_t n, size_t& replies);
+
+    std::string partial_;                  // Start of a reply still arriving
+    uint64_t replies_ = 0;
+    uint64_t errors_ = 0;
+    std::string last_error_;
+    bool ok_ = true;
+    bool retry_ = false;
+};
+
+} // namespace orderbook
+
+#endif // ORDERBOOK_RESP_WRITER_HPP
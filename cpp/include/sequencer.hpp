@@ -0,0 +1,204 @@
+#ifndef ORDERBOOK_SEQUENCER_HPP
+#define ORDERBOOK_SEQUENCER_HPP
+
+#include "types.hpp"
+#include "order.hpp"
+#include "trade.hpp"
+#include "matching_engine.hpp"
+#include "order_index.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace orderbook {
+
+class ReplicationPrimary;
+
+using SequenceNumber = uint64_t;
+
+// ============================================================================
+// Command
+// ============================================================================
+//
+// Every input that can change engine state, as a fixed-size record. The
+// sequencer stamps each one with a global sequence number; an engine that
+// applies the same commands in the same order reaches the same state and
+// produces the same trades.
+//
+// Fixed size and trivially copyable so commands can be logged and sent to a
+// backup without serialisation. The layout is host-native: both ends of a
+// replication link run on the same machine.
+//
+
+enum class CommandType : uint8_t {
+    AddBook = 0,      // Create the book for `symbol`
+    NewOrder = 1,
+    Cancel = 2,
+    Tick = 3,         // Expire GTT orders due at `time_ns`
+    Checkpoint = 4,   // `checksum` = primary's checkpoint_value() before this command
+    Heartbeat = 5     // Link liveness only; not sequenced, never applied
+};
+
+struct Command {
+    static constexpr size_t SYMBOL_SIZE = 16;
+
+    SequenceNumber seq = 0;
+    CommandType type = CommandType::Heartbeat;
+    Side side = Side::Buy;
+    OrderType order_type = OrderType::Limit;
+    TimeInForce time_in_force = TimeInForce::GoodTillCancel;
+    char symbol[SYMBOL_SIZE] = {};      // NUL-padded; empty if the symbol didn't fit
+    uint32_t reserved = 0;              // Explicit padding, always zero
+    OrderId order_id = INVALID_ORDER_ID;
+    Price price = INVALID_PRICE;
+    Quantity quantity = 0;
+    int64_t time_ns = 0;                // Tick time, or expire time of a GTT order
+    uint64_t checksum = 0;
+
+    static Command add_book(const std::string& symbol);
+    static Command new_order(const Order& order);
+    static Command cancel(const std::string& symbol, OrderId order_id);
+    static Command tick(Timestamp now);
+
+    std::string symbol_string() const;
+};
+
+static_assert(std::is_trivially_copyable_v<Command>, "Commands are sent as raw bytes");
+static_assert(sizeof(Command) == 72, "Command layout is part of the replication protocol");
+
+// ============================================================================
+// SequencedEngine
+// ============================================================================
+//
+// Deterministic state machine around MatchingEngine: the same object runs on
+// the primary and on every backup.
+//
+// It owns the Order objects its commands create (the books only hold
+// pointers) and folds every trade into a running checksum. Trade timestamps
+// are wall-clock and are left out; everything else about a trade - ids,
+// price, quantity, aggressor - must match exactly. Checkpoints compare that
+// together with the books' rolling state checksums, so a replica whose
+// books drifted without producing different trades is caught too.
+//
+// ORDER IDS:
+//   Commands carry the client's order ids. This is the gateway edge: each
+//   new order is stamped with its book's next_order_id(), and only that
+//   dense id reaches the book, so its index pages it and fills and cancels
+//   inside the book never hash. A client id is looked up once per NewOrder
+//   or Cancel; trades are translated back to client ids before they are
+//   returned, through a per-book OrderIndex of the live orders. Replicas
+//   apply the same commands in the same order, so they issue the same ids.
+//
+
+class SequencedEngine {
+public:
+    SequencedEngine();
+
+    SequencedEngine(const SequencedEngine&) = delete;
+    SequencedEngine& operator=(const SequencedEngine&) = delete;
+
+    // Apply the next command. Returns SequenceGap (and changes nothing) unless
+    // cmd.seq == last_sequence() + 1, and ChecksumMismatch if a checkpoint
+    // disagrees with our checksum. Trades are appended to `trades` if given.
+    ErrorCode apply(const Command& cmd, std::vector<Trade>* trades = nullptr);
+
+    SequenceNumber last_sequence() const noexcept { return last_seq_; }
+    uint64_t checksum() const noexcept { return checksum_; }
+
+    // Trade checksum combined with every book's state checksum; this is
+    // what Checkpoint commands carry. O(books).
+    uint64_t checkpoint_value() const noexcept;
+    bool diverged() const noexcept { return diverged_; }
+
+    // Orders created by commands that are still live (resting on a book),
+    // by client id
+    size_t live_orders() const noexcept { return engine_ids_.size(); }
+    bool is_live(OrderId id) const noexcept { return engine_ids_.count(id) != 0; }
+
+    // Id the book knows a live order by (INVALID_ORDER_ID if not live)
+    OrderId engine_id(OrderId client_id) const noexcept;
+
+    // Client ids of the orders the most recent Tick expired
+    const std::vector<OrderId>& last_expired() const noexcept { return expired_; }
+
+    MatchingEngine& engine() noexcept { return engine_; }
+    const MatchingEngine& engine() const noexcept { return engine_; }
+
+private:
+    // A resting order this engine created, under its engine id
+    struct Live {
+        std::unique_ptr<Order> order;
+        OrderId client_id = INVALID_ORDER_ID;
+    };
+    using LiveIndex = OrderIndex<Live>;
+
+    ErrorCode apply_new_order(const Command& cmd, std::vector<Trade>& trades);
+    LiveIndex& index_for(const OrderBook& book);
+    LiveIndex* index_of(OrderId engine_id) noexcept;
+    void release(LiveIndex& index, OrderId engine_id);
+    void fold(uint64_t value) noexcept;
+    void fold(const Trade& trade) noexcept;
+
+    MatchingEngine engine_;
+    // One per book, at its id range's index (id >> MatchingEngine::BOOK_ID_BITS)
+    std::vector<std::unique_ptr<LiveIndex>> live_;
+    std::unordered_map<OrderId, OrderId> engine_ids_;   // Client id -> engine id
+    std::vector<Trade> scratch_;
+    std::vector<OrderId> expired_;      // Reused by Tick
+    SequenceNumber last_seq_ = 0;
+    uint64_t checksum_;
+    bool diverged_ = false;
+};
+
+// ============================================================================
+// Sequencer
+// ============================================================================
+//
+// Front of the primary engine: stamps each command with the next sequence
+// number, hands it to the replication link (if any), then applies it.
+//
+// Commands are queued for replication BEFORE they are applied, so the
+// backup's stream is never missing a command ahead of one it has. replicate()
+// is a push into an in-memory ring - the socket write happens on the link's
+// own thread, off the matching path - so a primary crash loses whatever the
+// link hadn't sent yet (see ReplicationPrimary, "WHAT CAN BE LOST").
+//
+// Every `checkpoint_interval` commands the sequencer injects a Checkpoint
+// carrying the primary's checkpoint_value(), which each backup compares
+// against its own.
+//
+// After a failover, build a new Sequencer over the promoted backup's
+// SequencedEngine; numbering continues from its last applied command.
+//
+
+class Sequencer {
+public:
+    static constexpr size_t DEFAULT_CHECKPOINT_INTERVAL = 1024;
+
+    explicit Sequencer(SequencedEngine& engine,
+                       ReplicationPrimary* link = nullptr,
+                       size_t checkpoint_interval = DEFAULT_CHECKPOINT_INTERVAL);
+
+    // Stamp, replicate and apply. cmd.seq is overwritten. A book command
+    // whose symbol is empty (or was longer than SYMBOL_SIZE) is rejected with
+    // InvalidSymbol before it gets a sequence number.
+    ErrorCode submit(Command cmd, std::vector<Trade>* trades = nullptr);
+
+    SequenceNumber last_sequence() const noexcept { return engine_.last_sequence(); }
+    SequencedEngine& engine() noexcept { return engine_; }
+
+private:
+    ErrorCode sequence(Command& cmd, std::vector<Trade>* trades);
+
+    SequencedEngine& engine_;
+    ReplicationPrimary* link_;
+    size_t checkpoint_interval_;
+    size_t since_checkpoint_ = 0;
+};
+
+} // namespace orderbook
+
+#endif // ORDERBOOK_SEQUENCER_HPP
@@ -0,0 +1,94 @@
+#ifndef ORDERBOOK_SPSC_QUEUE_HPP
+#define ORDERBOOK_SPSC_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace orderbook {
+
+// ============================================================================
+// SpscQueue
+// ============================================================================
+//
+// Bounded single-producer / single-consumer ring for handing trivially
+// copyable records from the matching thread to a helper thread.
+//
+// WHY?
+//   The matching thread must never block on I/O. Pushing into the ring is a
+//   copy plus one release store; the helper thread does the slow part.
+//
+// Each side keeps a cached copy of the other side's index, so the shared
+// cache line is only read when the ring looks full (producer) or empty
+// (consumer).
+//
+
+template <typename T>
+class SpscQueue {
+    static_assert(std::is_trivially_copyable_v<T>, "SpscQueue copies records bytewise");
+
+public:
+    // capacity is rounded up to a power of two
+    explicit SpscQueue(size_t capacity)
+        : mask_(round_up_pow2(capacity < 2 ? 2 : capacity) - 1)
+        , slots_(new T[mask_ + 1])
+    {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer side
+    bool try_push(const T& value) noexcept {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_cache_ > mask_) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ > mask_) return false;
+        }
+        slots_[tail & mask_] = value;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: pop up to `max` records into out[], returns the count
+    size_t try_pop(T* out, size_t max) noexcept {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (tail_cache_ == head) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (tail_cache_ == head) return 0;
+        }
+        const size_t available = tail_cache_ - head;
+        const size_t n = available < max ? available : max;
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = slots_[(head + i) & mask_];
+        }
+        head_.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+    bool empty() const noexcept {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const noexcept { return mask_ + 1; }
+
+private:
+    static size_t round_up_pow2(size_t n) noexcept {
+        size_t p = 1;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    const size_t mask_;
+    std::unique_ptr<T[]> slots_;
+
+    alignas(64) std::atomic<size_t> tail_{0};   // Written by producer
+    size_t head_cache_ = 0;                     // Producer's view of head_
+
+    alignas(64) std::atomic<size_t> head_{0};   // Written by consumer
+    size_t tail_cache_ = 0;                     // Consumer's view of tail_
+};
+
+} // namespace orderbook
+
+#endif // ORDERBOOK_SPSC_QUEUE_HPP
@@ -0,0 +1,114 @@
+#ifndef ORDERBOOK_TICK_SIZE_HPP
+#define ORDERBOOK_TICK_SIZE_HPP
+
+#include "types.hpp"
+#include <cstdint>
+
+namespace orderbook {
+
+// ============================================================================
+// TickSize Class
+// ============================================================================
+//
+// Per-instrument tick size with a precomputed reciprocal, so converting a
+// price to a tick index (and checking that a price is on-tick) needs no
+// hardware divide.
+//
+// WHY?
+//   A 64-bit `div` costs 25-40 cycles and can't be pipelined; validation runs
+//   on every order. Division by a constant known only at runtime can instead
+//   be done as a 64x64->128 multiply, keep the high half, shift
+//   (Granlund & Montgomery, as implemented by libdivide):
+//
+//     index = mulhi(price, magic) >> shift             (most divisors)
+//     index = (((price - q) >> 1) + q) >> shift        (divisors needing 65 bits)
+//
+//   Power-of-two ticks skip the multiply and are a single shift.
+//
+// Prices are assumed non-negative (validate_order() rejects the rest).
+//
+
+class TickSize {
+public:
+    // Tick of 1 = every fixed-point price is valid
+    constexpr TickSize() noexcept = default;
+    explicit TickSize(Price tick) noexcept;
+
+    Price tick() const noexcept { return static_cast<Price>(tick_); }
+
+    // price / tick, rounded down
+    uint64_t to_index(Price price) const noexcept {
+        const uint64_t n = static_cast<uint64_t>(price);
+        if (magic_ == 0) {
+            return n >> shift_;
+        }
+        const uint64_t q = static_cast<uint64_t>(
+            (static_cast<unsigned __int128>(n) * magic_) >> 64);
+        if (add_) {
+            return (((n - q) >> 1) + q) >> shift_;
+        }
+        return q >> shift_;
+    }
+
+    Price from_index(uint64_t index) const noexcept {
+        return static_cast<Price>(index * tick_);
+    }
+
+    // True if price is a non-negative multiple of the tick
+    bool is_aligned(Price price) const noexcept {
+        return price >= 0 && from_index(to_index(price)) == price;
+    }
+
+private:
+    uint64_t tick_ = 1;
+    uint64_t magic_ = 0;    // 0 = power-of-two tick, divide by shifting
+    uint8_t shift_ = 0;
+    bool add_ = false;      // Divisor needs the 65-bit magic fix-up
+};
+
+// ============================================================================
+// FixedTickSize
+// ============================================================================
+//
+// Compile-time tick size with the same interface as TickSize. With the divisor
+// a constant, the compiler emits the shift or multiply-high itself, and the
+// whole conversion can fold into its caller.
+//
+// DecimalTick<D> is the tick for D decimal places in our 6-decimal fixed-point:
+//   DecimalTick<2> = $0.01 = 10'000,  DecimalTick<0> = $1 = 1'000'000
+//
+
+template <Price Tick>
+struct FixedTickSize {
+    static_assert(Tick > 0, "tick size must be positive");
+
+    static constexpr Price tick() noexcept { return Tick; }
+
+    static constexpr uint64_t to_index(Price price) noexcept {
+        return static_cast<uint64_t>(price) / static_cast<uint64_t>(Tick);
+    }
+
+    static constexpr Price from_index(uint64_t index) noexcept {
+        return static_cast<Price>(index * static_cast<uint64_t>(Tick));
+    }
+
+    static constexpr bool is_aligned(Price price) noexcept {
+        return price >= 0 && from_index(to_index(price)) == price;
+    }
+};
+
+constexpr Price pow10_price(int exponent) noexcept {
+    Price result = 1;
+    for (int i = 0; i < exponent; ++i) result *= 10;
+    return result;
+}
+
+template <int Decimals>
+using DecimalTick = FixedTickSize<pow10_price(6 - Decimals)>;
+
+static_assert(DecimalTick<2>::tick() == 10'000, "$0.01 tick");
+static_assert(DecimalTick<6>::tick() == 1, "smallest representable tick");
+
+} // namespace orderbook
+
+#endif // ORDERBOOK_TICK_SIZE_HPP
@@ -0,0 +1,123 @@
+#ifndef ORDERBOOK_TIMER_WHEEL_HPP
+#define ORDERBOOK_TIMER_WHEEL_HPP
+
+#include "types.hpp"
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace orderbook {
+
+// ============================================================================
+// TimerNode
+// ============================================================================
+//
+// Intrusive link for one pending expiry. The node lives inside the order's
+// OrderLocation (see order_book.hpp), so scheduling and cancelling an expiry
+// never allocates: both are a handful of pointer writes.
+//
+// Nodes are linked with plain prev/next pointers and remember which slot they
+// sit in, so the slot heads can live in a std::vector that survives moves of
+// the owning OrderBook.
+//
+
+struct TimerNode {
+    TimerNode* prev = nullptr;
+    TimerNode* next = nullptr;
+    uint64_t deadline = 0;        // Absolute wheel tick at which the order expires
+    uint32_t slot = UINT32_MAX;   // Index into TimerWheel::heads_, UINT32_MAX = unlinked
+    OrderId order_id = INVALID_ORDER_ID;
+
+    bool linked() const noexcept { return slot != UINT32_MAX; }
+};
+
+// ============================================================================
+// TimerWheel Class
+// ============================================================================
+//
+// Hierarchical timing wheel (4 levels x 256 slots) used for GTT order expiry.
+//
+// WHY a wheel instead of a heap?
+//   - schedule/cancel are O(1): link/unlink one node, no sift-up/sift-down
+//   - Most orders are cancelled long before they expire, and a heap would pay
+//     O(log n) twice for every one of them
+//
+// HOW IT WORKS:
+//   Level 0 has one slot per tick (default tick = 1ms, covers 256ms).
+//   Level L covers 256^(L+1) ticks; a timer is placed at the lowest level whose
+//   span contains its deadline. When level L-1 wraps around, the matching
+//   slot of level L is "cascaded": its timers are re-placed at lower levels.
+//   With 4 levels and 1ms ticks the wheel reaches ~49 days; anything further
+//   out is parked in the top level and re-placed until it comes into range.
+//
+// Due timers are not fired directly. advance() moves them onto a "due" list
+// and the caller drains it with pop_due() at whatever batch size it can
+// afford, so a million orders expiring at the same instant never turn into
+// one long stall.
+//
+
+class TimerWheel {
+public:
+    static constexpr uint32_t LEVELS = 4;
+    static constexpr uint32_t SLOT_BITS = 8;
+    static constexpr uint32_t SLOTS = 1u << SLOT_BITS;
+    static constexpr uint64_t SLOT_MASK = SLOTS - 1;
+
+    // start: time corresponding to tick 0. resolution: length of one tick.
+    explicit TimerWheel(Timestamp start = Timestamp{},
+                        std::chrono::nanoseconds resolution = std::chrono::milliseconds(1));
+
+    // Link node so it becomes due once advance() reaches deadline.
+    // A deadline at or before the current tick goes straight to the due list.
+    void schedule(TimerNode& node, Timestamp deadline);
+
+    // Unlink node from wherever it is (wheel slot or due list). O(1).
+    // Safe to call on a node that is not linked.
+    void cancel(TimerNode& node) noexcept;
+
+    // Move every timer whose deadline is <= now onto the due list.
+    // Skips over empty stretches of the wheel instead of stepping tick by tick.
+    void advance(Timestamp now);
+
+    // Pop one due timer (nullptr when none are due). The node is unlinked.
+    TimerNode* pop_due() noexcept;
+
+    bool has_due() const noexcept { return heads_[DUE_SLOT] != nullptr; }
+    size_t due_count() const noexcept { return due_count_; }
+
+    // Number of linked timers, including those already due.
+    size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+    // Heap bytes used by the slot heads (nodes live in their owners)
+    size_t memory_bytes() const noexcept { return heads_.capacity() * sizeof(TimerNode*); }
+
+private:
+    static constexpr uint32_t DUE_SLOT = LEVELS * SLOTS;
+
+    uint64_t deadline_tick(Timestamp ts) const noexcept;
+    uint64_t floor_tick(Timestamp ts) const noexcept;
+
+    void place(TimerNode& node) noexcept;
+    void link(TimerNode& node, uint32_t slot) noexcept;
+    void unlink(TimerNode& node) noexcept;
+    void cascade(uint32_t level) noexcept;
+    void expire_slot(uint32_t slot) noexcept;
+
+    // Slot list heads: LEVELS * SLOTS wheel slots followed by the due list
+    std::vector<TimerNode*> heads_;
+
+    int64_t origin_ns_ = 0;
+    int64_t resolution_ns_ = 1;
+
+    // Next tick to be processed. Every timer still in the wheel has deadline >= current_.
+    uint64_t current_ = 0;
+
+    size_t level_count_[LEVELS] = {};
+    size_t due_count_ = 0;
+    size_t size_ = 0;
+};
+
+} // namespace orderbook
+
+#endif // ORDERBOOK_TIMER_WHEEL_HPP
@@ -3,6 +3,7 @@
 
 #include "types.hpp"
 #include <string>
+#include <type_traits>
 
 namespace orderbook {
 
@@ -103,6 +104,52 @@ struct Trade {
     }
 };
 
+// ============================================================================
+// TradeRecord
+// ============================================================================
+//
+// The same execution as a Trade, as 48 bytes of plain data: the instrument
+// is a numeric id instead of a std::string and the time is nanoseconds.
+//
+// WHY?
+//   Trade owns a heap string, so copying it allocates and it can't be
+//   written to a file, socket or shared mapping as-is. A TradeRecord is
+//   trivially copyable: rings, journals and wire formats move it with
+//   memcpy, and a reader on the other side can map it straight back.
+//
+// Layout is fixed (see the static_asserts); the last byte is reserved and
+// always zero.
+//
+
+struct TradeRecord {
+    TradeId id = INVALID_TRADE_ID;
+    OrderId buy_order_id = INVALID_ORDER_ID;
+    OrderId sell_order_id = INVALID_ORDER_ID;
+    Price price = INVALID_PRICE;
+    int64_t timestamp_ns = 0;              // timestamp_to_nanos(Trade::timestamp)
+    uint32_t quantity = 0;                 // Fits: orders are capped at MAX_ORDER_QUANTITY
+    InstrumentId instrument = 0;           // OrderBookConfig::instrument_id of the book
+    Side aggressor_side = Side::Buy;
+    uint8_t reserved = 0;
+};
+
+static_assert(sizeof(TradeRecord) == 48, "TradeRecord is a fixed 48-byte record");
+static_assert(std::is_trivially_copyable_v<TradeRecord>, "TradeRecord is copied bytewise");
+static_assert(std::is_standard_layout_v<TradeRecord>, "TradeRecord is mapped by other readers");
+
+inline TradeRecord to_record(const Trade& trade, InstrumentId instrument) noexcept {
+    TradeRecord record;
+    record.id = trade.id;
+    record.buy_order_id = trade.buy_order_id;
+    record.sell_order_id = trade.sell_order_id;
+    record.price = trade.price;
+    record.timestamp_ns = timestamp_to_nanos(trade.timestamp);
+    record.quantity = static_cast<uint32_t>(trade.quantity);
+    record.instrument = instrument;
+    record.aggressor_side = trade.aggressor_side;
+    return record;
+}
+
 } // namespace orderbook
 
 #endif // ORDERBOOK_TRADE_HPP
@@ -0,0 +1,50 @@
+#ifndef ORDERBOOK_TRADE_SINK_HPP
+#define ORDERBOOK_TRADE_SINK_HPP
+
+#include "trade_tape.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace orderbook {
+
+class OrderBook;
+
+// ============================================================================
+// TradeSink
+// ============================================================================
+//
+// Consumer of the trade stream: storage, bar building, market-data
+// publishing. MatchingEngine::add_trade_sink() feeds every sink the trades of
+// each order it routes, synchronously on the matching thread: straight from
+// the book's TradeTape when the tape still holds them all, otherwise from
+// the order's own fills (a tape smaller than one order's fills, or none).
+//
+// The records point into the tape or a scratch buffer: a sink that keeps
+// them must copy them before returning. Like BookListener, sinks run inside the matching path
+// and should leave anything slow to another thread.
+//
+
+class TradeSink {
+public:
+    virtual ~TradeSink() = default;
+
+    // New trades of `book`, in sequence order
+    virtual void on_trades(const OrderBook& book, const TradeRecord* records, size_t count) = 0;
+};
+
+// Hand `sink` every record of `tape` from `cursor` on (one call per
+// contiguous run) and return the cursor to resume from. Records overwritten
+// before they could be fed are gone; their count is stored in `lost` if given,
+// so a caller that expects none can tell.
+inline uint64_t feed_trades(TradeSink& sink, const OrderBook& book, const TradeTape& tape,
+                            uint64_t cursor, uint64_t* lost = nullptr) {
+    const TradeTape::Range range = tape.since(cursor);
+    if (lost) *lost = range.begin > cursor ? range.begin - cursor : 0;
+    if (range.first.size > 0) sink.on_trades(book, range.first.data, range.first.size);
+    if (range.second.size > 0) sink.on_trades(book, range.second.data, range.second.size);
+    return range.end;
+}
+
+} // namespace orderbook
+
+#endif // ORDERBOOK_TRADE_SINK_HPP
@@ -0,0 +1,132 @@
+#ifndef ORDERBOOK_TRADE_STORE_HPP
+#define ORDERBOOK_TRADE_STORE_HPP
+
+#include "trade_sink.hpp"
+#include "types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace orderbook {
+
+// ============================================================================
+// TradeStore
+// ============================================================================
+//
+// Every execution of the engine, on disk, as columns: one directory per
+// instrument and UTC day, holding one memory-mapped array per field.
+//
+//   <root>/<symbol>/<YYYY-MM-DD>/header          DayHeader (row count, ...)
+//                                timestamp_ns    int64   wall clock, UTC
+//                                price           int64   fixed point
+//                                quantity        uint32
+//                                side            uint8   aggressor (Side)
+//                                index           int64   timestamp of every
+//                                                        INDEX_STRIDE-th row
+//
+// WHY?
+//   Research wants "all AAPL trades between 14:30 and 15:00" without a
+//   database or a parse step. A query is two index lookups and returns
+//   pointers straight into the mapped columns (TradeColumns), so scanning a
+//   day of trades runs at memory bandwidth; the Python bindings wrap the
+//   same pointers as NumPy arrays.
+//
+// HOW IT WORKS:
+//   Each column file is created at its full day capacity as a sparse file,
+//   so it is mapped once at a fixed address: appends never remap, and
+//   slices handed out earlier stay valid while the store is open. Disk
+//   blocks are only allocated as rows are written. The row count lives in
+//   the mapped header and is published after the row, so a reader process
+//   mapping the same day sees only complete rows.
+//
+//   Timestamps are sorted within a day: TradeRecords carry steady-clock
+//   time, which the store converts to wall-clock time with one offset taken
+//   at construction, and a row older than its predecessor (a restart with a
+//   different offset) is stored with the predecessor's timestamp.
+//
+// The symbol becomes a directory name with '/' and '%' (and a leading '.')
+// percent-encoded, so "BRK/B" is stored as BRK%2FB and no symbol can reach
+// outside <root> or collide with "." and "..".
+//
+// One writer per day directory. A store opened read-only never creates or
+// modifies anything and can run alongside the writer.
+//
+
+// Zero-copy slice of one instrument-day; valid while the store is open
+struct TradeColumns {
+    int64_t day = 0;                       // Days since 1970-01-01
+    const int64_t* timestamp_ns = nullptr;
+    const Price* price = nullptr;
+    const uint32_t* quantity = nullptr;
+    const Side* side = nullptr;
+    size_t size = 0;
+};
+
+class TradeStore : public TradeSink {
+public:
+    // Rows per instrument-day. Reserved as address space and sparse file
+    // length, not memory: 16M rows = 400 MiB of address space per day.
+    static constexpr size_t DEFAULT_DAY_CAPACITY = size_t(1) << 24;
+    // Rows per sparse index entry
+    static constexpr size_t INDEX_STRIDE = 4096;
+    static constexpr int64_t NANOS_PER_DAY = 86'400'000'000'000;
+
+    explicit TradeStore(std::string root, bool read_only = false,
+                        size_t day_capacity = DEFAULT_DAY_CAPACITY);
+    ~TradeStore() override;
+
+    TradeStore(const TradeStore&) = delete;
+    TradeStore& operator=(const TradeStore&) = delete;
+
+    // TradeSink: append the book's trades under its symbol. Trades that
+    // can't be stored are counted in dropped().
+    void on_trades(const OrderBook& book, const TradeRecord* records, size_t count) override;
+
+    // Append records (steady-clock timestamps, as in a TradeTape). Returns
+    // how many were stored: fewer if a day is full, the directory can't be
+    // written, the symbol is empty or the store is read-only.
+    size_t append(const std::string& symbol, const TradeRecord* records, size_t count);
+
+    // Trades append() couldn't store, since construction. Anything but zero
+    // means the store is missing executions.
+    uint64_t dropped() const noexcept { return dropped_; }
+
+    // Trades of `symbol` with from_ns <= timestamp_ns < to_ns (wall clock),
+    // one slice per day that has any, oldest first
+    std::vector<TradeColumns> query(const std::string& symbol, int64_t from_ns, int64_t to_ns);
+
+    // msync every open day: everything appended so far survives a crash
+    bool flush();
+
+    // Wall-clock nanoseconds of a TradeRecord's steady-clock timestamp
+    int64_t wall_time(int64_t steady_ns) const noexcept { return steady_ns + clock_offset_ns_; }
+
+    const std::string& root() const noexcept { return root_; }
+    bool read_only() const noexcept { return read_only_; }
+
+    // "YYYY-MM-DD" of a day number (days since 1970-01-01)
+    static std::string day_name(int64_t day);
+
+private:
+    class DayFile;
+
+    // The day's file, mapped on first use; nullptr if it doesn't exist and
+    // can't (or mustn't) be created
+    DayFile* day_file(const std::string& symbol, int64_t day, bool create);
+
+    std::string root_;
+    bool read_only_;
+    size_t day_capacity_;
+    int64_t clock_offset_ns_;              // Wall clock - steady clock
+    std::map<std::pair<std::string, int64_t>, std::unique_ptr<DayFile>> days_;
+    DayFile* last_ = nullptr;              // Most recently appended day
+    uint64_t dropped_ = 0;
+};
+
+} // namespace orderbook
+
+#endif // ORDERBOOK_TRADE_STORE_HPP
@@ -0,0 +1,108 @@
+#ifndef ORDERBOOK_TRADE_TAPE_HPP
+#define ORDERBOOK_TRADE_TAPE_HPP
+
+#include "trade.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace orderbook {
+
+// ============================================================================
+// TradeTape
+// ============================================================================
+//
+// The most recent trades of one book as TradeRecords, in a fixed ring that
+// the book appends to on every fill.
+//
+// WHY?
+//   Publishers, journals and the Python bindings all want the same trades.
+//   Instead of each taking its own copy of the std::vector<Trade> that
+//   add_order() returns, they keep a sequence number and read the records
+//   in place from the tape.
+//
+// HOW IT WORKS:
+//   Every record gets a sequence number: 0 for the book's first trade, then
+//   1, 2, ... head() is the next one to be written. The ring holds the last
+//   capacity() of them, [tail(), head()); older records are overwritten.
+//   since(seq) returns the records from seq onwards as at most two
+//   contiguous runs (the ring may wrap), with no copying. A reader that
+//   fell more than capacity() behind gets a range starting later than it
+//   asked for; the difference is what it missed.
+//
+// Like snapshot() and image(), the tape belongs to the matching thread:
+// read it there, or while the book is not matching. A zero capacity
+// disables it (push is a no-op).
+//
+
+class TradeTape {
+public:
+    // One contiguous run of records
+    struct Span {
+        const TradeRecord* data = nullptr;
+        size_t size = 0;
+    };
+
+    // Records [begin, end) in sequence order: first, then second
+    struct Range {
+        uint64_t begin = 0;
+        uint64_t end = 0;
+        Span first;
+        Span second;
+
+        size_t size() const noexcept { return first.size + second.size; }
+    };
+
+    // capacity is rounded up to a power of two; 0 = no tape
+    explicit TradeTape(size_t capacity = 0)
+        : slots_(capacity == 0 ? 0 : round_up_pow2(capacity))
+        , mask_(slots_.empty() ? 0 : slots_.size() - 1)
+    {}
+
+    void push(const TradeRecord& record) noexcept {
+        if (slots_.empty()) return;
+        slots_[head_ & mask_] = record;
+        ++head_;
+    }
+
+    uint64_t head() const noexcept { return head_; }
+    uint64_t tail() const noexcept { return head_ > slots_.size() ? head_ - slots_.size() : 0; }
+    size_t size() const noexcept { return static_cast<size_t>(head_ - tail()); }
+    size_t capacity() const noexcept { return slots_.size(); }
+
+    // Record with sequence number seq; must be in [tail(), head())
+    const TradeRecord& at(uint64_t seq) const noexcept { return slots_[seq & mask_]; }
+
+    // Everything still held from seq onwards (clamped to tail())
+    Range since(uint64_t seq) const noexcept {
+        Range range;
+        range.begin = seq < tail() ? tail() : (seq > head_ ? head_ : seq);
+        range.end = head_;
+        if (range.begin == range.end) return range;
+
+        const size_t start = static_cast<size_t>(range.begin & mask_);
+        const size_t count = static_cast<size_t>(range.end - range.begin);
+        const size_t run = slots_.size() - start < count ? slots_.size() - start : count;
+        range.first = {slots_.data() + start, run};
+        range.second = {slots_.data(), count - run};
+        return range;
+    }
+
+    // Heap bytes held by the ring
+    size_t bytes() const noexcept { return slots_.capacity() * sizeof(TradeRecord); }
+
+private:
+    static size_t round_up_pow2(size_t n) noexcept {
+        size_t p = 1;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    std::vector<TradeRecord> slots_;
+    size_t mask_;
+    uint64_t head_ = 0;                // Sequence number of the next record
+};
+
+} // namespace orderbook
+
+#endif // ORDERBOOK_TRADE_TAPE_HPP
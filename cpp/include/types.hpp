@@ -19,6 +19,10 @@ namespace orderbook {
 using OrderId = uint64_t;
 using TradeId = uint64_t;
 
+// Small numeric id for an instrument (book), carried in every TradeRecord
+// instead of the symbol string. 0 = unassigned.
+using InstrumentId = uint16_t;
+
 // Price is stored as a fixed-point integer
 // WHY NOT double?
 //   double has precision issues: 0.1 + 0.2 != 0.3 in floating point!
@@ -56,6 +60,10 @@ constexpr OrderId INVALID_ORDER_ID = 0;
 constexpr TradeId INVALID_TRADE_ID = 0;
 constexpr Price INVALID_PRICE = 0;
 
+// Largest order quantity accepted. Capping orders at 32 bits means every
+// fill fits the 32-bit quantity field of a TradeRecord.
+constexpr Quantity MAX_ORDER_QUANTITY = UINT32_MAX;
+
 // ============================================================================
 // Enums
 // ============================================================================
@@ -75,6 +83,15 @@ enum class OrderType : uint8_t {
     Market = 1
 };
 
+// Time in force: how long a limit order may rest on the book
+// GoodTillCancel: rests until filled or cancelled
+// GoodTillTime:   also expires at Order::expire_time (covers GTD and day
+//                 orders - a day order is GTT with the session close as deadline)
+enum class TimeInForce : uint8_t {
+    GoodTillCancel = 0,
+    GoodTillTime = 1
+};
+
 // Order status (lifecycle states)
 //
 // State diagram:
@@ -83,13 +100,15 @@ enum class OrderType : uint8_t {
 //   New -> Cancelled
 //   PartiallyFilled -> Cancelled
 //   New -> Rejected (if invalid)
+//   New/PartiallyFilled -> Expired (GTT deadline reached)
 //
 enum class OrderStatus : uint8_t {
     New = 0,              // Just created, not yet processed
     PartiallyFilled = 1,  // Some quantity executed, rest on book
     Filled = 2,           // Fully executed
     Cancelled = 3,        // Removed before full execution
-    Rejected = 4          // Invalid order, never placed on book
+    Rejected = 4,         // Invalid order, never placed on book
+    Expired = 5           // GTT order removed when its deadline passed
 };
 
 // Error codes for operations
@@ -107,7 +126,15 @@ enum class ErrorCode : uint8_t {
     BookNotFound = 6,
     InsufficientLiquidity = 7,  // Market order can't be fully filled
     OrderAlreadyCancelled = 8,
-    OrderAlreadyFilled = 9
+    OrderAlreadyFilled = 9,
+    InvalidExpireTime = 10,     // GTT order without an expire_time
+    PriceLimitExceeded = 11,    // Multi-leg order can't fill within its net limit
+    SequenceGap = 12,           // Replicated command arrived out of order
+    ChecksumMismatch = 13,      // Backup's trades differ from the primary's
+    DuplicateOrderId = 14,      // Order id is already live in the engine
+    InvalidSymbol = 15,         // Symbol missing, or too long for a sequenced Command
+    EngineStopped = 16,         // AsyncEngine stopped before serving the command; it was not applied
+    AckPending = 17             // AsyncEngine isn't running and hasn't served the command yet
 };
 
 // ============================================================================
@@ -142,6 +169,15 @@ inline int64_t timestamp_to_nanos(Timestamp ts) {
     ).count();
 }
 
+// Wall clock minus steady clock, in nanoseconds: added to a
+// timestamp_to_nanos() value it gives UTC nanoseconds since 1970
+inline int64_t wall_clock_offset_ns() {
+    const int64_t wall = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()
+    ).count();
+    return wall - timestamp_to_nanos(now());
+}
+
 // String conversions for debugging/logging
 inline const char* to_string(Side side) {
     return side == Side::Buy ? "BUY" : "SELL";
@@ -155,6 +191,14 @@ inline const char* to_string(OrderType type) {
     }
 }
 
+inline const char* to_string(TimeInForce tif) {
+    switch (tif) {
+        case TimeInForce::GoodTillCancel: return "GTC";
+        case TimeInForce::GoodTillTime:   return "GTT";
+        default:                          return "UNKNOWN";
+    }
+}
+
 inline const char* to_string(OrderStatus status) {
     switch (status) {
         case OrderStatus::New:             return "NEW";
@@ -162,6 +206,7 @@ inline const char* to_string(OrderStatus status) {
         case OrderStatus::Filled:          return "FILLED";
         case OrderStatus::Cancelled:       return "CANCELLED";
         case OrderStatus::Rejected:        return "REJECTED";
+        case OrderStatus::Expired:         return "EXPIRED";
         default:                           return "UNKNOWN";
     }
 }
@@ -178,6 +223,14 @@ inline const char* to_string(ErrorCode error) {
         case ErrorCode::InsufficientLiquidity: return "INSUFFICIENT_LIQUIDITY";
         case ErrorCode::OrderAlreadyCancelled: return "ORDER_ALREADY_CANCELLED";
         case ErrorCode::OrderAlreadyFilled:   return "ORDER_ALREADY_FILLED";
+        case ErrorCode::InvalidExpireTime:    return "INVALID_EXPIRE_TIME";
+        case ErrorCode::PriceLimitExceeded:   return "PRICE_LIMIT_EXCEEDED";
+        case ErrorCode::SequenceGap:          return "SEQUENCE_GAP";
+        case ErrorCode::ChecksumMismatch:     return "CHECKSUM_MISMATCH";
+        case ErrorCode::DuplicateOrderId:     return "DUPLICATE_ORDER_ID";
+        case ErrorCode::InvalidSymbol:        return "INVALID_SYMBOL";
+        case ErrorCode::EngineStopped:        return "ENGINE_STOPPED";
+        case ErrorCode::AckPending:           return "ACK_PENDING";
         default:                              return "UNKNOWN_ERROR";
     }
 }
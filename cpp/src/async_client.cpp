@@ -0,0 +1,425 @@
+#include "async_client.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace orderbook {
+
+namespace {
+
+constexpr size_t BATCH = 64;   // Requests taken from one client per pass
+
+} // namespace
+
+// ============================================================================
+// AckFuture
+// ============================================================================
+
+AckFuture::AckFuture(AckFuture&& other) noexcept
+    : client_(other.client_)
+    , request_id_(other.request_id_)
+{
+    other.client_ = nullptr;
+}
+
+AckFuture& AckFuture::operator=(AckFuture&& other) noexcept {
+    if (this != &other) {
+        release();
+        client_ = other.client_;
+        request_id_ = other.request_id_;
+        other.client_ = nullptr;
+    }
+    return *this;
+}
+
+AckFuture::~AckFuture() {
+    release();
+}
+
+bool AckFuture::ready() const noexcept {
+    if (client_ == nullptr) return false;
+    const AsyncClient::Slot* slot = client_->slot_for(request_id_);
+    return slot != nullptr && slot->state == AsyncClient::SlotState::Ready;
+}
+
+OrderAck AckFuture::get() {
+    while (!ready()) {
+        if (!client_->serving_.load(std::memory_order_acquire)) {
+            client_->poll();          // Acks pushed before the engine thread exited
+            if (ready()) break;
+
+            // Submitted after stop() drained the queue: it runs on the next
+            // start(), so keep the slot
+            OrderAck pending;
+            pending.request_id = request_id_;
+            pending.result = ErrorCode::AckPending;
+            return pending;
+        }
+        client_->wait();
+    }
+    AsyncClient::Slot* slot = client_->slot_for(request_id_);
+    OrderAck ack = slot->ack;
+    client_->free_slot(*slot);
+    client_ = nullptr;
+    return ack;
+}
+
+void AckFuture::release() noexcept {
+    if (client_ == nullptr) return;
+
+    AsyncClient::Slot* slot = client_->slot_for(request_id_);
+    if (slot != nullptr) {
+        if (slot->state == AsyncClient::SlotState::Ready) {
+            client_->free_slot(*slot);
+        } else {
+            slot->state = AsyncClient::SlotState::Detached;   // Freed when the ack lands
+        }
+    }
+    client_ = nullptr;
+}
+
+// ============================================================================
+// AsyncClient
+// ============================================================================
+
+AsyncClient::AsyncClient(size_t max_in_flight, size_t fill_capacity,
+                         const std::atomic<bool>& serving)
+    : slots_(std::max<size_t>(max_in_flight, 1))
+    , requests_(slots_.size())
+    , completions_(slots_.size() + fill_capacity)
+    , batch_(completions_.capacity())
+    , event_fd_(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+    , serving_(serving)
+{
+    free_slots_.reserve(slots_.size());
+    for (size_t i = slots_.size(); i > 0; --i) {
+        free_slots_.push_back(static_cast<uint32_t>(i - 1));
+    }
+}
+
+AsyncClient::~AsyncClient() {
+    if (event_fd_ >= 0) {
+        ::close(event_fd_);
+    }
+}
+
+bool AsyncClient::submit(const Command& cmd, Callback callback) {
+    const int64_t index = acquire_slot(SlotState::Callback);
+    if (index < 0) {
+        return false;
+    }
+
+    Slot& slot = slots_[static_cast<size_t>(index)];
+    slot.callback = std::move(callback);
+    const uint64_t request_id = (uint64_t{slot.generation} << 32) | static_cast<uint64_t>(index);
+    return push_request(request_id, cmd);
+}
+
+AckFuture AsyncClient::submit(const Command& cmd) {
+    int64_t index = acquire_slot(SlotState::Future);
+    while (index < 0) {
+        wait();
+        index = acquire_slot(SlotState::Future);
+    }
+
+    const Slot& slot = slots_[static_cast<size_t>(index)];
+    const uint64_t request_id = (uint64_t{slot.generation} << 32) | static_cast<uint64_t>(index);
+    push_request(request_id, cmd);
+    return AckFuture(this, request_id);
+}
+
+size_t AsyncClient::poll() {
+    size_t n = completions_.try_pop(batch_.data(), batch_.size());
+    for (size_t i = 0; i < n; ++i) {
+        deliver(batch_[i]);
+    }
+
+    // Once the engine thread has exited nothing else touches the backlog:
+    // take what it couldn't push, after the ring it queued behind
+    if (!serving_.load(std::memory_order_acquire)) {
+        for (; !backlog_.empty(); ++n) {
+            const Completion completion = backlog_.front();
+            backlog_.pop_front();
+            deliver(completion);
+        }
+    }
+    return n;
+}
+
+size_t AsyncClient::wait(std::chrono::microseconds timeout) {
+    size_t n = poll();
+    if (n > 0 || (in_flight_ == 0 && !fill_handler_)) {
+        return n;
+    }
+
+    // Announce the sleep, then re-check: an ack pushed before the engine saw
+    // sleeping_ would otherwise never be signalled
+    sleeping_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (completions_.empty()) {
+        pollfd pfd{event_fd_, POLLIN, 0};
+        const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(timeout).count();
+        ::poll(&pfd, 1, static_cast<int>(std::max<int64_t>(ms, 1)));
+
+        uint64_t counter;
+        while (::read(event_fd_, &counter, sizeof(counter)) < 0 && errno == EINTR) {}
+    }
+    sleeping_.store(false, std::memory_order_relaxed);
+
+    return poll();
+}
+
+AsyncClient::Slot* AsyncClient::slot_for(uint64_t request_id) noexcept {
+    const size_t index = static_cast<uint32_t>(request_id);
+    if (index >= slots_.size()) return nullptr;
+
+    Slot& slot = slots_[index];
+    if (slot.generation != static_cast<uint32_t>(request_id >> 32) || slot.state == SlotState::Free) {
+        return nullptr;
+    }
+    return &slot;
+}
+
+int64_t AsyncClient::acquire_slot(SlotState state) noexcept {
+    if (free_slots_.empty()) return -1;
+
+    const uint32_t index = free_slots_.back();
+    free_slots_.pop_back();
+    slots_[index].state = state;
+    ++in_flight_;
+    return index;
+}
+
+void AsyncClient::free_slot(Slot& slot) noexcept {
+    slot.state = SlotState::Free;
+    slot.callback = nullptr;
+    ++slot.generation;         // Stale request ids no longer match
+    free_slots_.push_back(static_cast<uint32_t>(&slot - slots_.data()));
+    --in_flight_;
+}
+
+bool AsyncClient::push_request(uint64_t request_id, const Command& cmd) noexcept {
+    // Can't fail: the ring has a slot for every possible in-flight request
+    return requests_.try_push(Request{request_id, cmd});
+}
+
+void AsyncClient::deliver(const Completion& completion) {
+    if (const OrderAck* ack = std::get_if<OrderAck>(&completion)) {
+        deliver(*ack);
+    } else if (fill_handler_) {
+        fill_handler_(std::get<FillEvent>(completion));
+    }
+}
+
+void AsyncClient::deliver(const OrderAck& ack) {
+    Slot* slot = slot_for(ack.request_id);
+    if (slot == nullptr) return;
+
+    switch (slot->state) {
+        case SlotState::Callback: {
+            // Free first so the callback can submit again
+            Callback callback = std::move(slot->callback);
+            free_slot(*slot);
+            callback(ack);
+            break;
+        }
+        case SlotState::Future:
+            slot->ack = ack;
+            slot->state = SlotState::Ready;
+            break;
+        case SlotState::Detached:
+            free_slot(*slot);
+            break;
+        case SlotState::Free:
+        case SlotState::Ready:
+            break;
+    }
+}
+
+void AsyncClient::push_completion(const Completion& completion) {
+    if (!backlog_.empty() || !completions_.try_push(completion)) {
+        backlog_.push_back(completion);          // Keeps its place behind earlier ones
+    }
+}
+
+size_t AsyncClient::flush_backlog() noexcept {
+    size_t moved = 0;
+    while (!backlog_.empty() && completions_.try_push(backlog_.front())) {
+        backlog_.pop_front();
+        ++moved;
+    }
+    return moved;
+}
+
+void AsyncClient::notify() noexcept {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_relaxed) &&
+        sleeping_.exchange(false, std::memory_order_relaxed)) {
+        const uint64_t one = 1;
+        while (::write(event_fd_, &one, sizeof(one)) < 0 && errno == EINTR) {}
+    }
+}
+
+// ============================================================================
+// AsyncEngine
+// ============================================================================
+
+AsyncEngine::AsyncEngine(Sequencer& sequencer)
+    : sequencer_(sequencer)
+{}
+
+AsyncEngine::~AsyncEngine() {
+    stop();
+}
+
+AsyncClient& AsyncEngine::connect(size_t max_in_flight, size_t fill_capacity) {
+    clients_.push_back(std::unique_ptr<AsyncClient>(
+        new AsyncClient(max_in_flight, fill_capacity, serving_)));
+    return *clients_.back();
+}
+
+void AsyncEngine::start() {
+    if (running()) return;
+    running_.store(true, std::memory_order_release);
+    serving_.store(true, std::memory_order_release);
+    thread_ = std::thread(&AsyncEngine::run, this);
+}
+
+void AsyncEngine::stop() {
+    running_.store(false, std::memory_order_release);
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    // The engine thread is gone, so this thread is the rings' only consumer
+    for (auto& client : clients_) {
+        reject_queued(*client);
+    }
+    serving_.store(false, std::memory_order_release);
+}
+
+// Answer every request nobody will serve now, so an EngineStopped ack always
+// means the command was not applied
+void AsyncEngine::reject_queued(AsyncClient& client) {
+    AsyncClient::Request batch[BATCH];
+    size_t rejected = 0;
+    for (size_t n; (n = client.requests_.try_pop(batch, BATCH)) > 0; rejected += n) {
+        for (size_t i = 0; i < n; ++i) {
+            OrderAck ack;
+            ack.request_id = batch[i].request_id;
+            ack.order_id = batch[i].cmd.order_id;
+            ack.result = ErrorCode::EngineStopped;
+            client.push_completion(ack);
+        }
+    }
+    if (rejected > 0) {
+        client.notify();
+    }
+}
+
+void AsyncEngine::run() {
+    std::vector<Trade> trades;
+    unsigned idle_spins = 0;
+
+    while (running_.load(std::memory_order_acquire)) {
+        size_t served = 0;
+        for (auto& client : clients_) {
+            if (client->flush_backlog() > 0) {
+                client->notify();
+            }
+            served += serve(*client, trades);
+        }
+        for (AsyncClient* client : to_notify_) {
+            client->notify();
+        }
+        to_notify_.clear();
+
+        if (served > 0) {
+            idle_spins = 0;
+        } else if (++idle_spins < 1024) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+}
+
+size_t AsyncEngine::serve(AsyncClient& client, std::vector<Trade>& trades) {
+    AsyncClient::Request batch[BATCH];
+    const size_t n = client.requests_.try_pop(batch, BATCH);
+
+    for (size_t i = 0; i < n; ++i) {
+        trades.clear();
+        OrderAck ack;
+        ack.request_id = batch[i].request_id;
+        ack.order_id = batch[i].cmd.order_id;
+        const SequenceNumber before = sequencer_.last_sequence();
+        ack.result = sequencer_.submit(batch[i].cmd, &trades);
+        // 0 if rejected before it was sequenced (e.g. InvalidSymbol)
+        ack.seq = sequencer_.last_sequence() != before ? sequencer_.last_sequence() : 0;
+        for (const Trade& trade : trades) {
+            ack.filled_quantity += trade.quantity;
+            ack.notional += trade.trade_value();
+        }
+        ack.trade_count = static_cast<uint32_t>(trades.size());
+
+        client.push_completion(ack);
+        track(client, batch[i].cmd, ack, trades);
+    }
+
+    if (n > 0) {
+        client.notify();   // One wakeup per batch, not per ack
+    }
+    return n;
+}
+
+void AsyncEngine::track(AsyncClient& client, const Command& cmd, const OrderAck& ack,
+                        const std::vector<Trade>& trades) {
+    if (ack.result != ErrorCode::Success) return;
+
+    // Passive fills go to whichever client entered the resting order
+    for (const Trade& trade : trades) {
+        auto it = resting_.find(trade.passive_order_id());
+        if (it == resting_.end()) continue;
+
+        Resting& resting = it->second;
+        resting.leaves -= std::min(resting.leaves, trade.quantity);
+
+        FillEvent fill;
+        fill.order_id = it->first;
+        fill.seq = ack.seq;
+        fill.trade_id = trade.id;
+        fill.price = trade.price;
+        fill.quantity = trade.quantity;
+        fill.leaves_quantity = resting.leaves;
+        resting.client->push_completion(fill);
+        if (std::find(to_notify_.begin(), to_notify_.end(), resting.client) == to_notify_.end()) {
+            to_notify_.push_back(resting.client);
+        }
+        if (resting.leaves == 0) {
+            resting_.erase(it);
+        }
+    }
+
+    const SequencedEngine& engine = sequencer_.engine();
+    switch (cmd.type) {
+        case CommandType::NewOrder:
+            if (engine.is_live(cmd.order_id)) {
+                resting_[cmd.order_id] = Resting{&client, cmd.quantity - ack.filled_quantity};
+            }
+            break;
+        case CommandType::Cancel:
+            resting_.erase(cmd.order_id);
+            break;
+        case CommandType::Tick:
+            for (OrderId id : engine.last_expired()) {
+                resting_.erase(id);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+} // namespace orderbook
@@ -0,0 +1,85 @@
+#include "bar_aggregator.hpp"
+#include "order_book.hpp"
+#include <algorithm>
+
+namespace orderbook {
+
+BarAggregator::BarAggregator()
+    : clock_offset_ns_(wall_clock_offset_ns())
+{}
+
+void BarAggregator::add_listener(BarListener* listener) {
+    if (std::find(listeners_.begin(), listeners_.end(), listener) != listeners_.end()) return;
+    listeners_.push_back(listener);
+}
+
+void BarAggregator::remove_listener(BarListener* listener) {
+    listeners_.erase(std::remove(listeners_.begin(), listeners_.end(), listener), listeners_.end());
+}
+
+BarAggregator::Instrument& BarAggregator::instrument(const std::string& symbol) {
+    auto it = by_symbol_.find(symbol);
+    if (it != by_symbol_.end()) return instruments_[it->second];
+
+    by_symbol_.emplace(symbol, instruments_.size());
+    Instrument& inst = instruments_.emplace_back();
+    inst.symbol = symbol;
+    for (size_t i = 0; i < BAR_INTERVALS; ++i) {
+        inst.bars[i].interval = static_cast<BarInterval>(i);
+    }
+    return inst;
+}
+
+void BarAggregator::on_trades(const OrderBook& book, const TradeRecord* records, size_t count) {
+    Instrument& inst = instrument(book.symbol());
+    for (size_t i = 0; i < count; ++i) {
+        update(inst, wall_time(records[i].timestamp_ns), records[i].price, records[i].quantity);
+    }
+}
+
+void BarAggregator::add(const std::string& symbol, int64_t wall_ns, Price price, uint64_t quantity) {
+    update(instrument(symbol), wall_ns, price, quantity);
+}
+
+void BarAggregator::roll(const Instrument& inst, Bar& bar, int64_t wall_ns, Price open) {
+    if (bar.trades > 0) emit(inst, bar);
+    const int64_t length = BAR_INTERVAL_NS[static_cast<size_t>(bar.interval)];
+    const int64_t into = wall_ns % length;
+    bar.start_ns = wall_ns - (into < 0 ? into + length : into);
+    bar.open = bar.high = bar.low = bar.close = open;
+    bar.volume = 0;
+    bar.notional = 0.0;
+    bar.trades = 0;
+}
+
+void BarAggregator::emit(const Instrument& inst, Bar& bar) {
+    for (BarListener* listener : listeners_) {
+        listener->on_bar(inst.symbol, bar);
+    }
+    bar.trades = 0;
+}
+
+void BarAggregator::advance(int64_t wall_ns) {
+    for (Instrument& inst : instruments_) {
+        for (Bar& bar : inst.bars) {
+            if (bar.trades > 0 && wall_ns >= bar.end_ns()) emit(inst, bar);
+        }
+    }
+}
+
+void BarAggregator::close_all() {
+    for (Instrument& inst : instruments_) {
+        for (Bar& bar : inst.bars) {
+            if (bar.trades > 0) emit(inst, bar);
+        }
+    }
+}
+
+const Bar* BarAggregator::current(const std::string& symbol, BarInterval interval) const {
+    auto it = by_symbol_.find(symbol);
+    if (it == by_symbol_.end()) return nullptr;
+    const Bar& bar = instruments_[it->second].bars[static_cast<size_t>(interval)];
+    return bar.trades > 0 ? &bar : nullptr;
+}
+
+} // namespace orderbook
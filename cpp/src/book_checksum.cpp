@@ -0,0 +1,108 @@
+#include "book_checksum.hpp"
+#include <optional>
+#include <unordered_map>
+
+namespace orderbook {
+
+const char* to_string(BookInvariant invariant) noexcept {
+    switch (invariant) {
+        case BookInvariant::Ok:               return "OK";
+        case BookInvariant::EmptyLevel:       return "EMPTY_LEVEL";
+        case BookInvariant::LevelQuantity:    return "LEVEL_QUANTITY";
+        case BookInvariant::LevelCount:       return "LEVEL_COUNT";
+        case BookInvariant::LevelOrdering:    return "LEVEL_ORDERING";
+        case BookInvariant::MisplacedOrder:   return "MISPLACED_ORDER";
+        case BookInvariant::InactiveOrder:    return "INACTIVE_ORDER";
+        case BookInvariant::LookupMismatch:   return "LOOKUP_MISMATCH";
+        case BookInvariant::ChecksumMismatch: return "CHECKSUM_MISMATCH";
+        default:                              return "UNKNOWN";
+    }
+}
+
+uint64_t image_checksum(const BookImage& image) noexcept {
+    uint64_t sum = 0;
+    for (const auto& level : image.levels) {
+        for (const auto& order : level.queue) {
+            sum += order_state_hash(order.id, order.side, order.price, order.remaining);
+        }
+    }
+    return sum;
+}
+
+VerifyResult verify_image(const BookImage& image) {
+    auto fail = [](BookInvariant what, Price price = INVALID_PRICE, OrderId id = INVALID_ORDER_ID) {
+        return VerifyResult{what, price, id};
+    };
+
+    struct Where {
+        Side side;
+        Price price;
+    };
+    std::unordered_map<OrderId, Where> queued;
+
+    const BookImage::Level* prev = nullptr;
+    std::optional<Price> best_bid;
+    std::optional<Price> best_ask;
+
+    for (const auto& level : image.levels) {
+        // Bids best (highest) first, then asks best (lowest) first
+        if (prev != nullptr) {
+            bool in_order = (prev->side == level.side)
+                ? (level.side == Side::Buy ? level.price < prev->price : level.price > prev->price)
+                : (prev->side == Side::Buy && level.side == Side::Sell);
+            if (!in_order) return fail(BookInvariant::LevelOrdering, level.price);
+        }
+        prev = &level;
+        if (level.side == Side::Buy && !best_bid) best_bid = level.price;
+        if (level.side == Side::Sell && !best_ask) best_ask = level.price;
+
+        if (level.queue.empty()) {
+            return fail(BookInvariant::EmptyLevel, level.price);
+        }
+        if (level.order_count != level.queue.size()) {
+            return fail(BookInvariant::LevelCount, level.price);
+        }
+
+        Quantity sum = 0;
+        for (const auto& order : level.queue) {
+            if (order.side != level.side || order.price != level.price) {
+                return fail(BookInvariant::MisplacedOrder, level.price, order.id);
+            }
+            bool live = order.status == OrderStatus::New ||
+                        order.status == OrderStatus::PartiallyFilled;
+            if (!live || order.remaining == 0) {
+                return fail(BookInvariant::InactiveOrder, level.price, order.id);
+            }
+            if (!queued.emplace(order.id, Where{order.side, order.price}).second) {
+                return fail(BookInvariant::LookupMismatch, level.price, order.id);  // Queued twice
+            }
+            sum += order.remaining;
+        }
+        if (sum != level.total_quantity) {
+            return fail(BookInvariant::LevelQuantity, level.price);
+        }
+    }
+
+    if (best_bid && best_ask && *best_bid >= *best_ask) {
+        return fail(BookInvariant::LevelOrdering, *best_bid);
+    }
+
+    // Lookup table <-> queues: same set of orders, same locations
+    if (image.lookup.size() != queued.size()) {
+        return fail(BookInvariant::LookupMismatch);
+    }
+    for (const auto& entry : image.lookup) {
+        auto it = queued.find(entry.id);
+        if (it == queued.end() || it->second.side != entry.side ||
+            it->second.price != entry.price || !entry.iterator_matches) {
+            return fail(BookInvariant::LookupMismatch, entry.price, entry.id);
+        }
+    }
+
+    if (image.checksum != image_checksum(image)) {
+        return fail(BookInvariant::ChecksumMismatch);
+    }
+    return VerifyResult{};
+}
+
+} // namespace orderbook
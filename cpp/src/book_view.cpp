@@ -0,0 +1,76 @@
+#include "book_view.hpp"
+#include <cstddef>
+#include <cstring>
+
+namespace orderbook {
+
+// ============================================================================
+// BookSnapshot
+// ============================================================================
+
+double BookSnapshot::imbalance() const noexcept {
+    double bid_qty = 0.0;
+    double ask_qty = 0.0;
+    for (uint64_t i = 0; i < bid_depth; ++i) bid_qty += static_cast<double>(bids[i].quantity);
+    for (uint64_t i = 0; i < ask_depth; ++i) ask_qty += static_cast<double>(asks[i].quantity);
+
+    const double total = bid_qty + ask_qty;
+    return total > 0.0 ? (bid_qty - ask_qty) / total : 0.0;
+}
+
+// ============================================================================
+// BookView
+// ============================================================================
+
+BookView::BookView() noexcept {
+    for (auto& word : words_) {
+        word.store(0, std::memory_order_relaxed);
+    }
+}
+
+void BookView::publish(const BookSnapshot& snapshot) noexcept {
+    uint64_t buffer[WORDS] = {};
+    std::memcpy(buffer, &snapshot, sizeof(BookSnapshot));
+
+    const uint64_t seq = seq_.load(std::memory_order_relaxed);
+    seq_.store(seq + 1, std::memory_order_relaxed);        // Odd: write in progress
+    std::atomic_thread_fence(std::memory_order_release);
+
+    static_assert(offsetof(BookSnapshot, version) == 0, "version is the first word");
+    buffer[0] = seq / 2 + 1;
+    for (size_t i = 0; i < WORDS; ++i) {
+        words_[i].store(buffer[i], std::memory_order_relaxed);
+    }
+
+    seq_.store(seq + 2, std::memory_order_release);        // Even: published
+}
+
+bool BookView::try_read(BookSnapshot& out) const noexcept {
+    const uint64_t before = seq_.load(std::memory_order_acquire);
+    if (before & 1) {
+        return false;
+    }
+
+    uint64_t buffer[WORDS];
+    for (size_t i = 0; i < WORDS; ++i) {
+        buffer[i] = words_[i].load(std::memory_order_relaxed);
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (seq_.load(std::memory_order_relaxed) != before) {
+        return false;
+    }
+
+    std::memcpy(&out, buffer, sizeof(BookSnapshot));
+    return true;
+}
+
+BookSnapshot BookView::read() const noexcept {
+    BookSnapshot snapshot;
+    while (!try_read(snapshot)) {
+        // Writer was mid-publish; the window is a few dozen stores long
+    }
+    return snapshot;
+}
+
+} // namespace orderbook
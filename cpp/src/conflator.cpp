@@ -0,0 +1,261 @@
+#include "conflator.hpp"
+#include "book_checksum.hpp"
+#include "order_book.hpp"
+#include <cstring>
+
+namespace orderbook {
+
+// ============================================================================
+// Feed: BookListener adapter for one instrument
+// ============================================================================
+
+class Conflator::Feed : public BookListener {
+public:
+    Feed(Conflator& owner, uint32_t instrument, size_t bbo_key) noexcept
+        : owner_(owner), instrument_(instrument), bbo_key_(bbo_key) {
+        bbo_.instrument = instrument;
+        bbo_.kind = UpdateKind::Bbo;
+    }
+
+    void on_level(const OrderBook&, const LevelChange& change) override {
+        // A level that never got a key was never shown to anyone: its
+        // removal needs no key either
+        const bool live = change.quantity > 0;
+        const size_t key = owner_.level_key(instrument_, change.side, change.price, live);
+        if (key == NO_KEY) {
+            if (live) owner_.dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        ConflatedUpdate update;
+        update.instrument = instrument_;
+        update.kind = UpdateKind::Level;
+        update.side = change.side;
+        update.price = change.price;
+        update.quantity = change.quantity;
+        update.order_count = change.order_count;
+        owner_.write_level(key, update);
+    }
+
+    // The BBO only goes out when it actually moved
+    void on_update_end(const OrderBook& book) override {
+        const Price bid = book.best_bid().value_or(INVALID_PRICE);
+        const Price ask = book.best_ask().value_or(INVALID_PRICE);
+        const Quantity bid_qty = bid != INVALID_PRICE ? book.volume_at_price(Side::Buy, bid) : 0;
+        const Quantity ask_qty = ask != INVALID_PRICE ? book.volume_at_price(Side::Sell, ask) : 0;
+
+        if (bid == bbo_.price && bid_qty == bbo_.quantity &&
+            ask == bbo_.ask_price && ask_qty == bbo_.ask_quantity) {
+            return;
+        }
+        bbo_.price = bid;
+        bbo_.quantity = bid_qty;
+        bbo_.ask_price = ask;
+        bbo_.ask_quantity = ask_qty;
+        owner_.write(bbo_key_, bbo_);
+    }
+
+    // Initial (empty) BBO so the key exists from registration on
+    void publish_initial() noexcept { owner_.write(bbo_key_, bbo_); }
+
+private:
+    Conflator& owner_;
+    uint32_t instrument_;
+    size_t bbo_key_;
+    ConflatedUpdate bbo_;       // Last BBO written
+};
+
+// ============================================================================
+// Conflator
+// ============================================================================
+
+size_t Conflator::LevelKeyHash::operator()(const LevelKey& key) const noexcept {
+    return static_cast<size_t>(mix64(key.first * 0x9e3779b97f4a7c15ULL ^
+                                     static_cast<uint64_t>(key.second)));
+}
+
+Conflator::Conflator(size_t max_keys, size_t max_consumers)
+    : max_keys_(max_keys > 0 ? max_keys : 1)
+    , max_consumers_(max_consumers)
+    , words_per_bitset_((max_keys_ + 63) / 64)
+    , slots_(new Slot[max_keys_])
+    , consumers_(new Consumer[max_consumers_])
+    , key_levels_(max_keys_)
+    , key_state_(max_keys_, 0)
+    , versions_(max_keys_, 0) {
+    for (size_t i = 0; i < max_keys_; ++i) {
+        for (auto& word : slots_[i].words) {
+            word.store(0, std::memory_order_relaxed);
+        }
+    }
+    for (size_t c = 0; c < max_consumers_; ++c) {
+        consumers_[c].dirty.reset(new std::atomic<uint64_t>[words_per_bitset_]);
+        consumers_[c].last_version.reset(new std::atomic<uint64_t>[max_keys_]);
+        for (size_t w = 0; w < words_per_bitset_; ++w) {
+            consumers_[c].dirty[w].store(0, std::memory_order_relaxed);
+        }
+        for (size_t key = 0; key < max_keys_; ++key) {
+            consumers_[c].last_version[key].store(0, std::memory_order_relaxed);
+        }
+    }
+    level_keys_.reserve(max_keys_);
+    retired_.reserve(max_keys_);
+}
+
+Conflator::~Conflator() = default;
+
+uint32_t Conflator::add_instrument(const std::string& symbol) {
+    const auto instrument = static_cast<uint32_t>(symbols_.size());
+    symbols_.push_back(symbol);
+
+    const size_t bbo_key = new_key();
+    feeds_.push_back(std::make_unique<Feed>(*this, instrument, bbo_key));
+    if (bbo_key != NO_KEY) {
+        feeds_.back()->publish_initial();
+    }
+    return instrument;
+}
+
+BookListener& Conflator::feed(uint32_t instrument) {
+    return *feeds_[instrument];
+}
+
+Conflator::ConsumerId Conflator::subscribe() {
+    size_t id = consumer_count_.load(std::memory_order_relaxed);
+    do {
+        if (id >= max_consumers_) return max_consumers_;
+    } while (!consumer_count_.compare_exchange_weak(id, id + 1, std::memory_order_seq_cst));
+
+    // Every key published so far starts dirty. Keys the producer adds from
+    // here on are marked by the producer itself: it publishes keys_used_
+    // before loading consumer_count_, we bumped consumer_count_ before loading
+    // keys_used_ (both seq_cst), so at least one of us sees the other.
+    const size_t keys = keys_used_.load(std::memory_order_seq_cst);
+    Consumer& c = consumers_[id];
+    for (size_t key = 0; key < keys; ++key) {
+        c.dirty[key / 64].fetch_or(uint64_t{1} << (key % 64), std::memory_order_relaxed);
+    }
+    return id;
+}
+
+uint64_t Conflator::coalesced(ConsumerId consumer) const noexcept {
+    return consumers_[consumer].coalesced.load(std::memory_order_relaxed);
+}
+
+size_t Conflator::new_key() noexcept {
+    if (next_key_ >= max_keys_) return NO_KEY;
+    return next_key_++;
+}
+
+size_t Conflator::level_key(uint32_t instrument, Side side, Price price, bool allocate) {
+    const LevelKey key{uint64_t{instrument} * 2 + static_cast<uint64_t>(side), price};
+    auto it = level_keys_.find(key);
+    if (it != level_keys_.end()) return it->second;
+    if (!allocate) return NO_KEY;
+
+    size_t id = new_key();
+    if (id == NO_KEY) {
+        id = recycle_key();
+    }
+    if (id != NO_KEY) {
+        level_keys_.emplace(key, id);
+        key_levels_[id] = key;
+    }
+    return id;
+}
+
+size_t Conflator::recycle_key() {
+    // Oldest removals first: consumers have most likely caught up on them.
+    // Entries for levels that came back are dropped on the way.
+    for (size_t i = 0; i < retired_.size();) {
+        const size_t key = retired_[i];
+        if (!(key_state_[key] & KEY_REMOVED)) {
+            key_state_[key] = 0;
+            retired_.erase(retired_.begin() + static_cast<std::ptrdiff_t>(i));
+            continue;
+        }
+        if (drained_by_all(key)) {
+            key_state_[key] = 0;
+            retired_.erase(retired_.begin() + static_cast<std::ptrdiff_t>(i));
+            level_keys_.erase(key_levels_[key]);
+            recycled_.fetch_add(1, std::memory_order_relaxed);
+            return key;
+        }
+        ++i;
+    }
+    return NO_KEY;
+}
+
+bool Conflator::drained_by_all(size_t key) const noexcept {
+    const size_t consumers = consumer_count_.load(std::memory_order_seq_cst);
+    for (size_t c = 0; c < consumers; ++c) {
+        if (consumers_[c].last_version[key].load(std::memory_order_acquire) < versions_[key]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Conflator::write_level(size_t key, ConflatedUpdate& update) {
+    write(key, update);
+    if (update.quantity > 0) {
+        key_state_[key] &= ~KEY_REMOVED;   // Back before it was recycled
+        return;
+    }
+    key_state_[key] |= KEY_REMOVED;
+    if (!(key_state_[key] & KEY_RETIRED)) {
+        key_state_[key] |= KEY_RETIRED;
+        retired_.push_back(key);
+    }
+}
+
+void Conflator::write(size_t key, ConflatedUpdate& update) noexcept {
+    update.version = ++versions_[key];
+
+    uint64_t buffer[PAYLOAD_WORDS];
+    std::memcpy(buffer, &update, sizeof(ConflatedUpdate));
+
+    // Seqlock write, as in BookView::publish()
+    Slot& slot = slots_[key];
+    const uint64_t seq = slot.seq.load(std::memory_order_relaxed);
+    slot.seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < PAYLOAD_WORDS; ++i) {
+        slot.words[i].store(buffer[i], std::memory_order_relaxed);
+    }
+    slot.seq.store(seq + 2, std::memory_order_release);
+
+    if (key >= keys_used_.load(std::memory_order_relaxed)) {
+        keys_used_.store(key + 1, std::memory_order_seq_cst);    // First write: key now exists
+    }
+    updates_.fetch_add(1, std::memory_order_relaxed);
+
+    // Release pairs with drain()'s acquire exchange. A bit that was already
+    // set means the consumer hadn't collected the previous value yet.
+    const uint64_t bit = uint64_t{1} << (key % 64);
+    const size_t consumers = consumer_count_.load(std::memory_order_seq_cst);
+    for (size_t c = 0; c < consumers; ++c) {
+        Consumer& consumer = consumers_[c];
+        if (consumer.dirty[key / 64].fetch_or(bit, std::memory_order_release) & bit) {
+            consumer.coalesced.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+void Conflator::read(size_t key, ConflatedUpdate& out) const noexcept {
+    const Slot& slot = slots_[key];
+    uint64_t buffer[PAYLOAD_WORDS];
+    for (;;) {
+        const uint64_t before = slot.seq.load(std::memory_order_acquire);
+        if (before & 1) continue;
+
+        for (size_t i = 0; i < PAYLOAD_WORDS; ++i) {
+            buffer[i] = slot.words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.seq.load(std::memory_order_relaxed) == before) break;
+    }
+    std::memcpy(&out, buffer, sizeof(ConflatedUpdate));
+}
+
+} // namespace orderbook
@@ -0,0 +1,424 @@
+#include "local_transport.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <utility>
+
+namespace orderbook {
+
+namespace {
+
+constexpr uint64_t SHM_MAGIC = 0x3147524D4853424FULL;  // "OBSHMRG1" little-endian
+
+void close_fd(int& fd) {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+bool make_addr(const std::string& path, sockaddr_un& addr) {
+    addr = {};
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) return false;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+// Write as much as a non-blocking socket takes now; -1 on a real error
+ssize_t write_some(int fd, const char* data, size_t bytes) {
+    size_t written = 0;
+    while (written < bytes) {
+        ssize_t n = ::send(fd, data + written, bytes - written, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            return -1;
+        }
+        written += static_cast<size_t>(n);
+    }
+    return static_cast<ssize_t>(written);
+}
+
+size_t round_up_pow2(size_t n) noexcept {
+    size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+} // namespace
+
+// ============================================================================
+// UdsTradePublisher
+// ============================================================================
+
+UdsTradePublisher::UdsTradePublisher(std::string path, size_t queue_capacity, size_t max_backlog,
+                                     std::chrono::milliseconds stall_timeout)
+    : path_(std::move(path))
+    , max_backlog_bytes_(max_backlog * sizeof(TradeRecord))
+    , stall_timeout_(stall_timeout)
+    , queue_(queue_capacity)
+{
+    sockaddr_un addr;
+    if (!make_addr(path_, addr)) return;
+    ::unlink(path_.c_str());
+
+    listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) return;
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(listen_fd_, 16) != 0) {
+        close_fd(listen_fd_);
+        return;
+    }
+
+    running_.store(true, std::memory_order_release);
+    sender_ = std::thread(&UdsTradePublisher::run_sender, this);
+}
+
+UdsTradePublisher::~UdsTradePublisher() {
+    stop();
+}
+
+void UdsTradePublisher::stop() {
+    running_.store(false, std::memory_order_release);
+    if (sender_.joinable()) {
+        sender_.join();
+    }
+    if (listen_fd_ >= 0) {
+        close_fd(listen_fd_);
+        ::unlink(path_.c_str());
+    }
+}
+
+void UdsTradePublisher::on_trades(const OrderBook&, const TradeRecord* records, size_t count) {
+    publish(records, count);
+}
+
+size_t UdsTradePublisher::publish(const TradeRecord* records, size_t count) noexcept {
+    size_t pushed = 0;
+    while (pushed < count && queue_.try_push(records[pushed])) {
+        ++pushed;
+    }
+    queued_.store(queued_.load(std::memory_order_relaxed) + pushed, std::memory_order_relaxed);
+    if (pushed < count) {
+        dropped_.store(dropped_.load(std::memory_order_relaxed) + (count - pushed),
+                       std::memory_order_relaxed);
+    }
+    return pushed;
+}
+
+bool UdsTradePublisher::wait_for_subscribers(size_t n, std::chrono::milliseconds timeout) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (subscribers() < n) {
+        if (!running_.load(std::memory_order_acquire) || std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    return true;
+}
+
+bool UdsTradePublisher::flush(std::chrono::milliseconds timeout) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    const uint64_t target = queued_.load(std::memory_order_relaxed);
+
+    while (sent_.load(std::memory_order_acquire) < target) {
+        if (!running_.load(std::memory_order_acquire) || std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    return true;
+}
+
+void UdsTradePublisher::accept_subscribers(std::vector<Subscriber>& subs) {
+    pollfd pfd{listen_fd_, POLLIN, 0};
+    while (::poll(&pfd, 1, 0) > 0) {
+        int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) break;
+        subs.push_back(Subscriber{fd, {}, 0, std::chrono::steady_clock::now()});
+    }
+    subscribers_.store(subs.size(), std::memory_order_release);
+}
+
+// Write as much of data as the socket takes now, advancing past it. False on
+// a socket error.
+bool UdsTradePublisher::write_to(Subscriber& sub, const char*& data, size_t& bytes) {
+    const ssize_t n = write_some(sub.fd, data, bytes);
+    if (n < 0) return false;
+    if (n > 0) sub.progress = std::chrono::steady_clock::now();
+    data += n;
+    bytes -= static_cast<size_t>(n);
+    return true;
+}
+
+// Past max_backlog with `pending` bytes waiting, and nothing taken for
+// stall_timeout: the subscriber stopped reading. A reader that is only
+// trailing keeps taking bytes and is never cut off.
+bool UdsTradePublisher::stalled(const Subscriber& sub, size_t pending) const {
+    return pending > max_backlog_bytes_ &&
+           std::chrono::steady_clock::now() - sub.progress >= stall_timeout_;
+}
+
+// Send what the socket takes now, after anything already waiting for it, and
+// keep the rest. False: the subscriber errored or stopped reading.
+bool UdsTradePublisher::send_to(Subscriber& sub, const char* data, size_t bytes) {
+    if (!flush_backlog(sub)) return false;
+    if (sub.backlog.empty() && !write_to(sub, data, bytes)) return false;
+    if (bytes == 0) return true;
+
+    if (stalled(sub, sub.backlog.size() - sub.backlog_sent + bytes)) {
+        slow_disconnects_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    sub.backlog.erase(sub.backlog.begin(),
+                      sub.backlog.begin() + static_cast<std::ptrdiff_t>(sub.backlog_sent));
+    sub.backlog_sent = 0;
+    sub.backlog.insert(sub.backlog.end(), data, data + bytes);
+    return true;
+}
+
+bool UdsTradePublisher::flush_backlog(Subscriber& sub) {
+    if (sub.backlog.empty()) return true;
+    const char* data = sub.backlog.data() + sub.backlog_sent;
+    size_t bytes = sub.backlog.size() - sub.backlog_sent;
+    if (!write_to(sub, data, bytes)) return false;
+    if (bytes == 0) {
+        sub.backlog.clear();
+        sub.backlog_sent = 0;
+        return true;
+    }
+    sub.backlog_sent = sub.backlog.size() - bytes;
+
+    // Also checked here, so a stalled subscriber goes once traffic stops
+    if (stalled(sub, bytes)) {
+        slow_disconnects_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+void UdsTradePublisher::run_sender() {
+    std::vector<TradeRecord> batch(BATCH);
+    std::vector<Subscriber> subs;
+    unsigned idle_spins = 0;
+
+    auto for_each_subscriber = [&](auto&& send) {
+        for (size_t i = subs.size(); i-- > 0;) {
+            if (!send(subs[i])) {
+                ::close(subs[i].fd);
+                subs.erase(subs.begin() + static_cast<std::ptrdiff_t>(i));
+                subscribers_.store(subs.size(), std::memory_order_release);
+            }
+        }
+    };
+
+    while (running_.load(std::memory_order_acquire)) {
+        const size_t n = queue_.try_pop(batch.data(), BATCH);
+        if (n > 0) {
+            const char* bytes = reinterpret_cast<const char*>(batch.data());
+            for_each_subscriber([&](Subscriber& sub) {
+                return send_to(sub, bytes, n * sizeof(TradeRecord));
+            });
+            sent_.fetch_add(n, std::memory_order_release);
+            idle_spins = 0;
+            if (n == BATCH) continue;                  // Keep draining a backlog
+        }
+
+        accept_subscribers(subs);
+        for_each_subscriber([&](Subscriber& sub) { return flush_backlog(sub); });
+        if (n > 0) continue;
+
+        // Stay hot briefly after traffic, then back off to a short sleep
+        if (++idle_spins < 256) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+
+    for (const Subscriber& sub : subs) {
+        ::close(sub.fd);
+    }
+    subscribers_.store(0, std::memory_order_release);
+}
+
+// ============================================================================
+// UdsTradeSubscriber
+// ============================================================================
+
+UdsTradeSubscriber::UdsTradeSubscriber(std::string path)
+    : path_(std::move(path))
+{}
+
+UdsTradeSubscriber::~UdsTradeSubscriber() {
+    close_fd(fd_);
+}
+
+bool UdsTradeSubscriber::connect() {
+    sockaddr_un addr;
+    if (!make_addr(path_, addr)) return false;
+    fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd_ < 0) return false;
+    if (::connect(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        close_fd(fd_);
+        return false;
+    }
+    return true;
+}
+
+size_t UdsTradeSubscriber::read(TradeRecord* out, size_t max, int timeout_ms) {
+    if (fd_ < 0 || max == 0) return 0;
+    pollfd pfd{fd_, POLLIN, 0};
+    if (::poll(&pfd, 1, timeout_ms) <= 0) return 0;
+
+    // Finish off a record split by the previous read first
+    char* dst = reinterpret_cast<char*>(out);
+    std::memcpy(dst, partial_, partial_bytes_);
+    const size_t capacity = max * sizeof(TradeRecord);
+
+    ssize_t n;
+    do {
+        n = ::recv(fd_, dst + partial_bytes_, capacity - partial_bytes_, MSG_DONTWAIT);
+    } while (n < 0 && errno == EINTR);
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return 0;
+    if (n <= 0) {                                      // Publisher gone
+        close_fd(fd_);
+        return 0;
+    }
+
+    const size_t bytes = partial_bytes_ + static_cast<size_t>(n);
+    const size_t whole = bytes / sizeof(TradeRecord);
+    partial_bytes_ = bytes - whole * sizeof(TradeRecord);
+    std::memcpy(partial_, dst + whole * sizeof(TradeRecord), partial_bytes_);
+    return whole;
+}
+
+// ============================================================================
+// Shared-Memory Ring
+// ============================================================================
+
+struct ShmTradeWriter::Header {
+    std::atomic<uint64_t> magic;               // Stored last (release): the rest is set up
+    uint64_t capacity;                         // Slots; a power of two
+    alignas(64) std::atomic<uint64_t> tail;    // Next slot to write; writer only
+    alignas(64) std::atomic<uint64_t> head;    // Next slot to read; reader only
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "ring indices must be lock-free to be shared between processes");
+static_assert(sizeof(ShmTradeWriter::Header) % alignof(TradeRecord) == 0,
+              "records follow the header");
+
+ShmTradeWriter::ShmTradeWriter(std::string name, size_t capacity)
+    : name_(std::move(name))
+{
+    const size_t slots = round_up_pow2(std::max<size_t>(capacity, 2));
+    const size_t bytes = sizeof(Header) + slots * sizeof(TradeRecord);
+
+    // A fresh object rather than O_TRUNC: a reader still mapping an old ring
+    // keeps it intact instead of seeing it zeroed under its feet
+    ::shm_unlink(name_.c_str());
+    int fd = ::shm_open(name_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) return;
+    void* data = MAP_FAILED;
+    if (::ftruncate(fd, static_cast<off_t>(bytes)) == 0) {
+        data = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        ::shm_unlink(name_.c_str());
+        return;
+    }
+
+    bytes_ = bytes;
+    header_ = new (data) Header{{0}, slots, {0}, {0}};
+    slots_ = reinterpret_cast<TradeRecord*>(static_cast<char*>(data) + sizeof(Header));
+    header_->magic.store(SHM_MAGIC, std::memory_order_release);   // Readers may attach from here
+}
+
+ShmTradeWriter::~ShmTradeWriter() {
+    if (header_ != nullptr) {
+        ::munmap(header_, bytes_);
+        ::shm_unlink(name_.c_str());
+    }
+}
+
+void ShmTradeWriter::on_trades(const OrderBook&, const TradeRecord* records, size_t count) {
+    publish(records, count);
+}
+
+size_t ShmTradeWriter::publish(const TradeRecord* records, size_t count) noexcept {
+    if (header_ == nullptr) return 0;
+    const uint64_t capacity = header_->capacity;
+    const uint64_t tail = header_->tail.load(std::memory_order_relaxed);
+    if (tail + count - head_cache_ > capacity) {
+        head_cache_ = header_->head.load(std::memory_order_acquire);
+    }
+    const size_t n = static_cast<size_t>(std::min<uint64_t>(count, capacity - (tail - head_cache_)));
+    const uint64_t mask = capacity - 1;
+    for (size_t i = 0; i < n; ++i) {
+        slots_[(tail + i) & mask] = records[i];
+    }
+    header_->tail.store(tail + n, std::memory_order_release);
+    dropped_ += count - n;
+    return n;
+}
+
+ShmTradeReader::ShmTradeReader(std::string name) {
+    int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) return;
+    struct stat st {};
+    void* data = MAP_FAILED;
+    if (::fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(ShmTradeWriter::Header)) {
+        data = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ | PROT_WRITE,
+                      MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (data == MAP_FAILED) return;
+
+    auto* header = static_cast<ShmTradeWriter::Header*>(data);
+    const size_t bytes = static_cast<size_t>(st.st_size);
+    // Acquire pairs with the writer's release: capacity is valid once magic is
+    if (header->magic.load(std::memory_order_acquire) != SHM_MAGIC ||
+        bytes < sizeof(ShmTradeWriter::Header) + header->capacity * sizeof(TradeRecord)) {
+        ::munmap(data, bytes);
+        return;
+    }
+    header_ = header;
+    bytes_ = bytes;
+    slots_ = reinterpret_cast<const TradeRecord*>(static_cast<char*>(data) + sizeof(ShmTradeWriter::Header));
+    tail_cache_ = header_->head.load(std::memory_order_relaxed);
+}
+
+ShmTradeReader::~ShmTradeReader() {
+    if (header_ != nullptr) {
+        ::munmap(header_, bytes_);
+    }
+}
+
+size_t ShmTradeReader::read(TradeRecord* out, size_t max) noexcept {
+    if (header_ == nullptr) return 0;
+    const uint64_t head = header_->head.load(std::memory_order_relaxed);
+    if (tail_cache_ == head) {
+        tail_cache_ = header_->tail.load(std::memory_order_acquire);
+        if (tail_cache_ == head) return 0;
+    }
+    const size_t n = static_cast<size_t>(std::min<uint64_t>(tail_cache_ - head, max));
+    const uint64_t mask = header_->capacity - 1;
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = slots_[(head + i) & mask];
+    }
+    header_->head.store(head + n, std::memory_order_release);
+    return n;
+}
+
+} // namespace orderbook
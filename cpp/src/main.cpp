@@ -1,18 +1,29 @@
+#include "bar_aggregator.hpp"
+#include "local_transport.hpp"
 #include "order_book.hpp"
 #include "redis_publisher.hpp"
 #include "order.hpp"
+#include <chrono>
+#include <cstring>
 #include <iostream>
+#include <string>
 
 using namespace orderbook;
 
-int main() {
-    // Connect to Redis
-    RedisPublisher publisher;
-    if (!publisher.is_connected()) {
-        std::cerr << "Could not connect to Redis\n";
+// Usage: orderbook_demo [--transport redis|uds] [--uds-path PATH]
+//   redis (default): trades and bars to Redis pub/sub
+//   uds:             raw TradeRecords to subscribers of a Unix socket
+int main(int argc, char** argv) {
+    std::string transport = "redis";
+    std::string uds_path = "/tmp/orderbook.trades";
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (std::strcmp(argv[i], "--transport") == 0) transport = argv[i + 1];
+        else if (std::strcmp(argv[i], "--uds-path") == 0) uds_path = argv[i + 1];
+    }
+    if (transport != "redis" && transport != "uds") {
+        std::cerr << "Unknown transport: " << transport << " (redis or uds)\n";
         return 1;
     }
-    std::cout << "Connected to Redis.\n";
 
     // Create an order book for AAPL
     OrderBook book("AAPL");
@@ -30,6 +41,37 @@ int main() {
     auto trades = book.add_order(&buy);
     std::cout << "Added BUY  100 @ $102.00 (crosses spread)\n";
 
+    if (transport == "uds") {
+        // Ship the book's trade tape to the first subscriber that connects
+        UdsTradePublisher publisher(uds_path);
+        if (!publisher.listening()) {
+            std::cerr << "Could not listen on " << uds_path << "\n";
+            return 1;
+        }
+        std::cout << "Waiting for a subscriber on " << uds_path << " ...\n";
+        if (!publisher.wait_for_subscribers(1, std::chrono::seconds(30))) {
+            std::cerr << "No subscriber connected\n";
+            return 1;
+        }
+        feed_trades(publisher, book, book.trade_tape(), 0);
+        publisher.flush(std::chrono::seconds(1));
+        std::cout << "Published " << trades.size() << " trade(s) over " << uds_path << "\n";
+        return 0;
+    }
+
+    // Connect to Redis; until it is reachable, trades wait in the spill log
+    RedisPublisherConfig config;
+    RedisPublisher publisher(config);
+    if (!publisher.ok()) {
+        std::cerr << publisher.last_error() << "\n";
+        return 1;
+    }
+    if (publisher.wait_connected(std::chrono::seconds(1))) {
+        std::cout << "Connected to Redis.\n";
+    } else {
+        std::cout << "Redis not reachable yet; spilling to " << publisher.spill_path() << "\n";
+    }
+
     // Publish each trade to Redis
     for (const auto& trade : trades) {
         publisher.publish_trade(trade);
@@ -39,5 +81,17 @@ int main() {
                   << price_to_double(trade.price) << "\n";
     }
 
+    // Build bars from the book's trade tape and publish them as they close
+    BarAggregator bars;
+    bars.add_listener(&publisher);
+    feed_trades(bars, book, book.trade_tape(), 0);
+    bars.close_all();
+    std::cout << "Published 1s/1m/1h bars\n";
+
+    if (!publisher.flush(std::chrono::seconds(5))) {
+        std::cerr << "Redis has not acknowledged everything; the rest stays in "
+                  << publisher.spill_path() << " for the next run\n";
+    }
+
     return 0;
 }
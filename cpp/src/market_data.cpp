@@ -0,0 +1,466 @@
+#include "market_data.hpp"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <utility>
+
+namespace orderbook {
+
+namespace {
+
+void close_fd(int& fd) {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+void set_nodelay(int fd) {
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+bool make_addr(const std::string& host, uint16_t port, sockaddr_in& addr) {
+    addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    return ::inet_pton(AF_INET, host.c_str(), &addr.sin_addr) == 1;
+}
+
+bool write_all(int fd, const void* data, size_t bytes) {
+    const char* p = static_cast<const char*>(data);
+    while (bytes > 0) {
+        ssize_t n = ::send(fd, p, bytes, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        p += n;
+        bytes -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool read_all(int fd, void* data, size_t bytes) {
+    char* p = static_cast<char*>(data);
+    while (bytes > 0) {
+        ssize_t n = ::recv(fd, p, bytes, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;                      // EOF, error or timeout
+        p += n;
+        bytes -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+size_t packet_bytes(const PacketHeader& header) noexcept {
+    return sizeof(PacketHeader) + header.count * sizeof(TradeRecord);
+}
+
+size_t round_up_pow2(size_t n) noexcept {
+    size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+} // namespace
+
+// ============================================================================
+// MarketDataPublisher
+// ============================================================================
+
+MarketDataPublisher::MarketDataPublisher(MarketDataConfig config)
+    : config_(std::move(config))
+    , ring_mask_(round_up_pow2(std::max<size_t>(config_.retransmit_packets, 1)) - 1)
+{
+    ring_.resize((ring_mask_ + 1) * MAX_PACKET_BYTES);
+    ring_bytes_.resize(ring_mask_ + 1);
+
+    // UDP: connected to the group, sending on the configured interface
+    sockaddr_in group{};
+    in_addr local{};
+    if (!make_addr(config_.group, config_.port, group) ||
+        ::inet_pton(AF_INET, config_.interface.c_str(), &local) != 1) {
+        return;
+    }
+    udp_fd_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (udp_fd_ < 0) return;
+    const unsigned char ttl = static_cast<unsigned char>(config_.ttl);
+    const unsigned char loop = 1;                      // Local receivers too
+    if (setsockopt(udp_fd_, IPPROTO_IP, IP_MULTICAST_IF, &local, sizeof(local)) != 0 ||
+        setsockopt(udp_fd_, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl)) != 0 ||
+        setsockopt(udp_fd_, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop)) != 0 ||
+        ::connect(udp_fd_, reinterpret_cast<sockaddr*>(&group), sizeof(group)) != 0) {
+        close_fd(udp_fd_);
+        return;
+    }
+
+    // TCP retransmit service
+    sockaddr_in addr{};
+    if (!make_addr(config_.interface, config_.retransmit_port, addr)) return;
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) return;
+    int one = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    socklen_t len = sizeof(addr);
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(listen_fd_, 16) != 0 ||
+        ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len) != 0 ||
+        ::pipe(wake_fd_) != 0) {
+        close_fd(listen_fd_);
+        return;
+    }
+    retransmit_port_ = ntohs(addr.sin_port);
+
+    running_.store(true, std::memory_order_release);
+    retransmit_ = std::thread(&MarketDataPublisher::run_retransmit, this);
+}
+
+MarketDataPublisher::~MarketDataPublisher() {
+    stop();
+}
+
+void MarketDataPublisher::stop() {
+    running_.store(false, std::memory_order_release);
+    if (wake_fd_[1] >= 0) {
+        const char byte = 0;
+        (void)!::write(wake_fd_[1], &byte, 1);
+    }
+    if (retransmit_.joinable()) {
+        retransmit_.join();
+    }
+    close_fd(wake_fd_[0]);
+    close_fd(wake_fd_[1]);
+    close_fd(listen_fd_);
+    close_fd(udp_fd_);
+}
+
+void MarketDataPublisher::on_trades(const OrderBook&, const TradeRecord* records, size_t count) {
+    publish(records, count);
+}
+
+void MarketDataPublisher::publish(const TradeRecord* records, size_t count) {
+    alignas(TradeRecord) char packet[MAX_PACKET_BYTES];
+    while (count > 0) {
+        const size_t n = std::min(count, RECORDS_PER_PACKET);
+        PacketHeader header;
+        header.count = static_cast<uint16_t>(n);
+        header.sequence = next_sequence_++;
+        const size_t bytes = packet_bytes(header);
+        std::memcpy(packet, &header, sizeof(header));
+        std::memcpy(packet + sizeof(header), records, n * sizeof(TradeRecord));
+
+        {
+            std::lock_guard<std::mutex> lock(ring_mutex_);
+            const size_t slot = static_cast<size_t>(header.sequence & ring_mask_);
+            std::memcpy(ring_.data() + slot * MAX_PACKET_BYTES, packet, bytes);
+            ring_bytes_[slot] = static_cast<uint16_t>(bytes);
+            ring_head_ = header.sequence + 1;
+        }
+        send_packet(packet, bytes);
+
+        records += n;
+        count -= n;
+    }
+}
+
+void MarketDataPublisher::heartbeat() {
+    PacketHeader header;
+    header.sequence = next_sequence_;
+    send_packet(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+void MarketDataPublisher::send_packet(const char* packet, size_t bytes) {
+    if (udp_fd_ < 0 || ::send(udp_fd_, packet, bytes, MSG_DONTWAIT) != static_cast<ssize_t>(bytes)) {
+        ++send_failures_;
+    }
+}
+
+void MarketDataPublisher::run_retransmit() {
+    std::vector<pollfd> fds{{wake_fd_[0], POLLIN, 0}, {listen_fd_, POLLIN, 0}};
+
+    while (running_.load(std::memory_order_acquire)) {
+        if (::poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (fds[0].revents != 0) break;                // stop()
+
+        for (size_t i = fds.size(); i-- > 2;) {
+            if (fds[i].revents == 0) continue;
+            if (!serve(fds[i].fd)) {
+                ::close(fds[i].fd);
+                fds.erase(fds.begin() + static_cast<std::ptrdiff_t>(i));
+            }
+        }
+        if (fds[1].revents & POLLIN) {
+            int fd = ::accept(listen_fd_, nullptr, nullptr);
+            if (fd >= 0) {
+                set_nodelay(fd);
+                fds.push_back({fd, POLLIN, 0});
+            }
+        }
+    }
+
+    for (size_t i = 2; i < fds.size(); ++i) {
+        ::close(fds[i].fd);
+    }
+}
+
+bool MarketDataPublisher::serve(int fd) {
+    RetransmitRequest request;
+    if (!read_all(fd, &request, sizeof(request))) return false;
+
+    const uint64_t capacity = ring_mask_ + 1;
+    uint64_t end;
+    RetransmitReply reply;
+    {
+        std::lock_guard<std::mutex> lock(ring_mutex_);
+        const uint64_t tail = ring_head_ > capacity ? ring_head_ - capacity : 1;
+        end = std::min(request.from + request.count, ring_head_);
+        reply.first = std::min(std::max(request.from, tail), end);
+    }
+
+    // One packet per lock: publish() waits for at most one copy, however
+    // much was asked for. A packet overwritten meanwhile ends the reply
+    // early, and the receiver reports the rest as lost.
+    std::vector<char> out(sizeof(reply));
+    uint64_t seq = reply.first;
+    for (; seq < end; ++seq) {
+        std::lock_guard<std::mutex> lock(ring_mutex_);
+        if (ring_head_ > capacity && seq < ring_head_ - capacity) break;
+        const size_t slot = static_cast<size_t>(seq & ring_mask_);
+        const char* packet = ring_.data() + slot * MAX_PACKET_BYTES;
+        out.insert(out.end(), packet, packet + ring_bytes_[slot]);
+    }
+    reply.count = static_cast<uint32_t>(seq - reply.first);
+    std::memcpy(out.data(), &reply, sizeof(reply));
+    return write_all(fd, out.data(), out.size());
+}
+
+// ============================================================================
+// MarketDataReceiver
+// ============================================================================
+
+MarketDataReceiver::MarketDataReceiver(MarketDataConfig config, MarketDataHandler& handler)
+    : config_(std::move(config))
+    , handler_(handler)
+    , expected_(config_.start_sequence)
+{
+    sockaddr_in group{};
+    ip_mreq membership{};
+    if (!make_addr(config_.group, config_.port, group) ||
+        ::inet_pton(AF_INET, config_.interface.c_str(), &membership.imr_interface) != 1) {
+        return;
+    }
+    membership.imr_multiaddr = group.sin_addr;
+
+    udp_fd_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (udp_fd_ < 0) return;
+    int one = 1;
+    int buffer = 4 << 20;                              // Ride out bursts while recovering
+    setsockopt(udp_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    setsockopt(udp_fd_, SOL_SOCKET, SO_RCVBUF, &buffer, sizeof(buffer));
+    if (::bind(udp_fd_, reinterpret_cast<sockaddr*>(&group), sizeof(group)) != 0 ||
+        setsockopt(udp_fd_, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) != 0) {
+        close_fd(udp_fd_);
+    }
+}
+
+MarketDataReceiver::~MarketDataReceiver() {
+    close_tcp();
+    close_fd(udp_fd_);
+}
+
+size_t MarketDataReceiver::poll(int timeout_ms) {
+    if (udp_fd_ < 0) return 0;
+    if (gap_until_ != 0) {
+        // Wake up when the gap's reorder window closes
+        const auto left = std::chrono::ceil<std::chrono::milliseconds>(
+            gap_since_ + std::chrono::milliseconds(config_.reorder_timeout_ms) -
+            std::chrono::steady_clock::now());
+        const int64_t until_window = std::max<int64_t>(left.count(), 0);
+        timeout_ms = static_cast<int>(timeout_ms < 0 ? until_window
+                                                     : std::min<int64_t>(until_window, timeout_ms));
+    }
+    pollfd pfd{udp_fd_, POLLIN, 0};
+    size_t delivered = 0;
+    if (::poll(&pfd, 1, timeout_ms) > 0) {
+        alignas(TradeRecord) char buffer[MAX_PACKET_BYTES];
+        for (;;) {
+            ssize_t n = ::recv(udp_fd_, buffer, sizeof(buffer), MSG_DONTWAIT);
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0) break;                          // Drained
+            delivered += on_datagram(buffer, static_cast<size_t>(n));
+        }
+    }
+    return delivered + recover_if_due();
+}
+
+size_t MarketDataReceiver::on_datagram(const char* data, size_t bytes) {
+    PacketHeader header;
+    if (bytes < sizeof(header)) return 0;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != MARKET_DATA_MAGIC || bytes != packet_bytes(header)) return 0;
+    ++received_;
+
+    const uint64_t seq = header.sequence;
+    if (header.count == 0) {                           // Heartbeat: seq is the next packet
+        if (expected_ == 0) expected_ = seq;
+        if (seq > expected_) note_gap(seq);
+        return recover_if_due();
+    }
+
+    if (expected_ == 0) expected_ = seq;
+    if (seq < expected_) return 0;                     // Duplicate
+    if (seq > expected_) {
+        pending_.emplace(seq, std::vector<char>(data, data + bytes));
+        note_gap(seq);
+        return recover_if_due();
+    }
+    return deliver(seq, data, bytes) + drain_pending();
+}
+
+size_t MarketDataReceiver::deliver(uint64_t sequence, const char* data, size_t bytes) {
+    const size_t count = (bytes - sizeof(PacketHeader)) / sizeof(TradeRecord);
+    handler_.on_packet(sequence, reinterpret_cast<const TradeRecord*>(data + sizeof(PacketHeader)),
+                       count);
+    expected_ = sequence + 1;
+    return 1;
+}
+
+size_t MarketDataReceiver::drain_pending() {
+    size_t delivered = 0;
+    while (!pending_.empty() && pending_.begin()->first <= expected_) {
+        auto it = pending_.begin();
+        if (it->first == expected_) {
+            delivered += deliver(it->first, it->second.data(), it->second.size());
+        }
+        pending_.erase(it);
+    }
+    return delivered;
+}
+
+void MarketDataReceiver::note_gap(uint64_t until) {
+    if (gap_until_ == 0) gap_since_ = std::chrono::steady_clock::now();
+    gap_until_ = std::max(gap_until_, until);
+}
+
+// Recover the open gap once its reorder window is over: enough packets held
+// back behind it, or open long enough. A gap the late packets filled on their
+// own just closes. Each hole between held-back packets is its own request,
+// so a failed one never writes off packets already held.
+size_t MarketDataReceiver::recover_if_due() {
+    if (gap_until_ == 0) return 0;
+    if (expected_ >= gap_until_) {
+        gap_until_ = 0;
+        return 0;
+    }
+    const bool waited = std::chrono::steady_clock::now() - gap_since_ >=
+                        std::chrono::milliseconds(config_.reorder_timeout_ms);
+    if (pending_.size() < config_.reorder_packets && !waited) return 0;
+
+    const uint64_t target = gap_until_;
+    gap_until_ = 0;
+    size_t delivered = 0;
+    while (expected_ < target) {                       // recover() always moves expected_ on
+        const uint64_t until = pending_.empty() ? target : std::min(target, pending_.begin()->first);
+        delivered += recover(until);
+    }
+    return delivered;
+}
+
+size_t MarketDataReceiver::recover(uint64_t until) {
+    ++gaps_;
+    size_t delivered = 0;
+
+    std::vector<char> packets;
+    RetransmitReply reply;
+    const uint64_t missing = until - expected_;
+    if (request(expected_, static_cast<uint32_t>(std::min<uint64_t>(missing, UINT32_MAX)), packets, reply)) {
+        if (reply.first > expected_) {
+            lost_ += reply.first - expected_;
+            handler_.on_loss(expected_, reply.first);
+            expected_ = reply.first;
+        }
+        size_t offset = 0;
+        for (uint32_t i = 0; i < reply.count; ++i) {
+            PacketHeader header;
+            std::memcpy(&header, packets.data() + offset, sizeof(header));
+            const size_t bytes = packet_bytes(header);
+            if (header.sequence == expected_) {
+                delivered += deliver(header.sequence, packets.data() + offset, bytes);
+                ++recovered_;
+            }
+            offset += bytes;
+        }
+    }
+
+    // Whatever the service could not supply is gone
+    if (expected_ < until) {
+        lost_ += until - expected_;
+        handler_.on_loss(expected_, until);
+        expected_ = until;
+    }
+    return delivered + drain_pending();
+}
+
+bool MarketDataReceiver::request(uint64_t from, uint32_t count, std::vector<char>& packets,
+                                 RetransmitReply& reply) {
+    if (tcp_fd_ < 0) {
+        sockaddr_in addr{};
+        if (!make_addr(config_.retransmit_host, config_.retransmit_port, addr)) return false;
+        tcp_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (tcp_fd_ < 0) return false;
+
+        timeval timeout{};
+        timeout.tv_sec = config_.retransmit_timeout_ms / 1000;
+        timeout.tv_usec = (config_.retransmit_timeout_ms % 1000) * 1000;
+        setsockopt(tcp_fd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(tcp_fd_, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        if (::connect(tcp_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            close_tcp();
+            return false;
+        }
+        set_nodelay(tcp_fd_);
+    }
+
+    RetransmitRequest req;
+    req.from = from;
+    req.count = count;
+    if (!write_all(tcp_fd_, &req, sizeof(req)) || !read_all(tcp_fd_, &reply, sizeof(reply))) {
+        close_tcp();
+        return false;
+    }
+
+    packets.clear();
+    for (uint32_t i = 0; i < reply.count; ++i) {
+        PacketHeader header;
+        if (!read_all(tcp_fd_, &header, sizeof(header)) || header.magic != MARKET_DATA_MAGIC) {
+            close_tcp();
+            return false;
+        }
+        const size_t offset = packets.size();
+        packets.resize(offset + packet_bytes(header));
+        std::memcpy(packets.data() + offset, &header, sizeof(header));
+        if (!read_all(tcp_fd_, packets.data() + offset + sizeof(header),
+                      packet_bytes(header) - sizeof(header))) {
+            close_tcp();
+            return false;
+        }
+    }
+    return true;
+}
+
+void MarketDataReceiver::close_tcp() {
+    close_fd(tcp_fd_);
+}
+
+} // namespace orderbook
@@ -0,0 +1,319 @@
+#include "matching_engine.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace orderbook {
+
+// ============================================================================
+// Books
+// ============================================================================
+
+OrderBook& MatchingEngine::add_book(const std::string& symbol) {
+    return add_book(symbol, OrderBookConfig{});
+}
+
+OrderBook& MatchingEngine::add_book(const std::string& symbol, const OrderBookConfig& config) {
+    if (BookEntry* existing = entry(symbol)) {
+        return existing->book;
+    }
+
+    OrderBookConfig book_config = config;
+    if (book_config.id_base == 0) {
+        // Disjoint id ranges: next_order_id() is unique across the engine
+        book_config.id_base = static_cast<OrderId>(books_.size()) << BOOK_ID_BITS;
+    }
+    if (book_config.instrument_id == 0) {
+        book_config.instrument_id = static_cast<InstrumentId>(books_.size() + 1);
+    }
+    auto it = books_.try_emplace(symbol, symbol, book_config).first;
+    return it->second.book;
+}
+
+OrderBook* MatchingEngine::book(const std::string& symbol) noexcept {
+    BookEntry* e = entry(symbol);
+    return e ? &e->book : nullptr;
+}
+
+const OrderBook* MatchingEngine::book(const std::string& symbol) const noexcept {
+    const BookEntry* e = entry(symbol);
+    return e ? &e->book : nullptr;
+}
+
+std::vector<Trade> MatchingEngine::add_order(Order* order) {
+    BookEntry* e = entry(order->symbol);
+    if (e == nullptr) {
+        order->status = OrderStatus::Rejected;
+        return {};
+    }
+
+    auto trades = e->book.add_order(order);
+    refresh_bbo(*e);
+    feed_sinks(*e, trades);
+    return trades;
+}
+
+ErrorCode MatchingEngine::cancel_order(const std::string& symbol, OrderId order_id) {
+    BookEntry* e = entry(symbol);
+    if (e == nullptr) {
+        return ErrorCode::BookNotFound;
+    }
+
+    ErrorCode result = e->book.cancel_order(order_id);
+    refresh_bbo(*e);
+    return result;
+}
+
+uint64_t MatchingEngine::state_checksum() const noexcept {
+    // Summed, so the result doesn't depend on hash-map iteration order
+    uint64_t sum = 0;
+    for (const auto& [symbol, e] : books_) {
+        sum += mix64(std::hash<std::string>{}(symbol) ^ e.book.state_checksum());
+    }
+    return sum;
+}
+
+size_t MatchingEngine::tick(Timestamp now, size_t max_expiries_per_book,
+                           std::vector<OrderId>* expired) {
+    size_t total = 0;
+    for (auto& [symbol, e] : books_) {
+        size_t n = e.book.tick(now, max_expiries_per_book, expired);
+        if (n > 0) {
+            refresh_bbo(e);
+            total += n;
+        }
+    }
+    return total;
+}
+
+void MatchingEngine::add_trade_sink(TradeSink* sink) {
+    if (std::find(sinks_.begin(), sinks_.end(), sink) != sinks_.end()) return;
+    // Sinks see trades from now on, not what the tapes still hold
+    for (auto& [symbol, e] : books_) {
+        e.fed = e.book.trade_tape().head();
+    }
+    sinks_.push_back(sink);
+}
+
+void MatchingEngine::remove_trade_sink(TradeSink* sink) {
+    sinks_.erase(std::remove(sinks_.begin(), sinks_.end(), sink), sinks_.end());
+}
+
+// `trades` are the fills of the order just routed. The tape is the cheap
+// source (records already built, and it also carries trades of orders added
+// to the book directly), but only while it still holds everything since the
+// last feed; otherwise the records are rebuilt from `trades`, so a tape
+// smaller than one order's fills, or no tape, loses nothing.
+void MatchingEngine::feed_sinks(BookEntry& e, const std::vector<Trade>& trades) {
+    if (sinks_.empty()) return;
+    const TradeTape& tape = e.book.trade_tape();
+    const uint64_t cursor = e.fed;
+    e.fed = tape.head();
+
+    if (tape.capacity() > 0 && tape.since(cursor).begin == cursor) {
+        for (TradeSink* sink : sinks_) {
+            feed_trades(*sink, e.book, tape, cursor);
+        }
+        return;
+    }
+    if (trades.empty()) return;
+
+    const InstrumentId instrument = e.book.config().instrument_id;
+    sink_records_.clear();
+    for (const Trade& trade : trades) {
+        sink_records_.push_back(to_record(trade, instrument));
+    }
+    for (TradeSink* sink : sinks_) {
+        sink->on_trades(e.book, sink_records_.data(), sink_records_.size());
+    }
+}
+
+// ============================================================================
+// Multi-leg Orders
+// ============================================================================
+
+ErrorCode MatchingEngine::check_multi_leg(const MultiLegOrder& order) const {
+    if (order.quantity == 0 || order.quantity > MAX_ORDER_QUANTITY) {
+        return ErrorCode::InvalidQuantity;
+    }
+    if (order.legs.empty()) {
+        return ErrorCode::InvalidOrderType;
+    }
+
+    // Net debit in fixed-point price units across all legs. 128 bits: a leg's
+    // notional and limit * quantity can each use all of int64.
+    __int128 net_cost = 0;
+    bool overflow = false;
+
+    for (size_t i = 0; i < order.legs.size(); ++i) {
+        const Leg& leg = order.legs[i];
+        if (leg.ratio == 0) {
+            return ErrorCode::InvalidQuantity;
+        }
+        // Two legs on the same book would each be estimated against the
+        // untouched book and could both claim the same liquidity
+        for (size_t j = 0; j < i; ++j) {
+            if (order.legs[j].symbol == leg.symbol) {
+                return ErrorCode::InvalidOrderType;
+            }
+        }
+
+        const BookEntry* e = entry(leg.symbol);
+        if (e == nullptr) {
+            return ErrorCode::BookNotFound;
+        }
+        // Legs go in under order.id; the book would refuse one that's resting
+        if (!e->book.handle_of(order.id).is_null()) {
+            return ErrorCode::DuplicateOrderId;
+        }
+
+        Quantity needed;
+        if (__builtin_mul_overflow(order.quantity, leg.ratio, &needed) || needed > MAX_ORDER_QUANTITY) {
+            return ErrorCode::InvalidQuantity;
+        }
+        FillEstimate estimate = e->book.estimate_fill(leg.side, needed);
+        if (estimate.quantity < needed) {
+            return ErrorCode::InsufficientLiquidity;
+        }
+        overflow = overflow || estimate.overflow;
+        net_cost += (leg.side == Side::Buy) ? estimate.notional : -static_cast<__int128>(estimate.notional);
+    }
+
+    // A leg notional too large to add up can't be shown to be within the limit
+    if (order.limit_price &&
+        (overflow || net_cost > static_cast<__int128>(*order.limit_price) * order.quantity)) {
+        return ErrorCode::PriceLimitExceeded;
+    }
+    return ErrorCode::Success;
+}
+
+ErrorCode MatchingEngine::execute_multi_leg(MultiLegOrder& order, std::vector<Trade>& trades) {
+    ErrorCode feasible = check_multi_leg(order);
+    if (feasible != ErrorCode::Success) {
+        order.status = OrderStatus::Rejected;
+        return feasible;
+    }
+
+    bool traded = false;
+    for (const Leg& leg : order.legs) {
+        BookEntry* e = entry(leg.symbol);
+        Order leg_order(order.id, leg.symbol, leg.side, OrderType::Market,
+                        order.quantity * leg.ratio);
+        auto leg_trades = e->book.add_order(&leg_order);
+        trades.insert(trades.end(), leg_trades.begin(), leg_trades.end());
+        refresh_bbo(*e);
+        feed_sinks(*e, leg_trades);
+        traded = traded || !leg_trades.empty();
+
+        // The check guarantees a full fill; anything less means the check
+        // and the book disagree, and the remaining legs must not run
+        if (!leg_order.is_filled()) {
+            order.status = traded ? OrderStatus::PartiallyFilled : OrderStatus::Rejected;
+            return ErrorCode::InsufficientLiquidity;
+        }
+    }
+
+    order.status = OrderStatus::Filled;
+    return ErrorCode::Success;
+}
+
+// ============================================================================
+// Implied-in Pricing
+// ============================================================================
+
+MatchingEngine::SpreadId MatchingEngine::register_spread(const std::vector<Leg>& legs) {
+    if (legs.empty()) {
+        return INVALID_SPREAD;
+    }
+    for (const Leg& leg : legs) {
+        if (leg.ratio == 0 || leg.ratio > MAX_ORDER_QUANTITY || entry(leg.symbol) == nullptr) {
+            return INVALID_SPREAD;
+        }
+    }
+
+    SpreadId id = spreads_.size();
+    Spread spread;
+    spread.legs = legs;
+    for (const Leg& leg : legs) {
+        BookEntry& e = books_.at(leg.symbol);
+        spread.books.push_back(&e);
+        if (std::find(e.spreads.begin(), e.spreads.end(), id) == e.spreads.end()) {
+            e.spreads.push_back(id);
+        }
+        e.bid = e.book.best_bid();
+        e.ask = e.book.best_ask();
+    }
+    spreads_.push_back(std::move(spread));
+    reprice(spreads_.back());
+    return id;
+}
+
+void MatchingEngine::refresh_bbo(BookEntry& e) {
+    if (e.spreads.empty()) return;
+
+    auto bid = e.book.best_bid();
+    auto ask = e.book.best_ask();
+    if (bid == e.bid && ask == e.ask) return;
+
+    e.bid = bid;
+    e.ask = ask;
+    for (SpreadId id : e.spreads) {
+        reprice(spreads_[id]);
+    }
+}
+
+void MatchingEngine::reprice(Spread& spread) {
+    // Buying the spread lifts the ask of every buy leg and hits the bid of
+    // every sell leg; selling it does the opposite.
+    //
+    // Summed in 128 bits, like check_multi_leg: ratio * price needs up to 96.
+    // A running total outside int64 leaves that side unset; each term is
+    // below 2^96, so the total can't overflow 128 bits before it's caught.
+    constexpr __int128 LIMIT = std::numeric_limits<Price>::max();
+    struct Total {
+        __int128 value = 0;
+        bool valid = true;
+
+        void add(const std::optional<Price>& price, __int128 signed_ratio) {
+            if (!valid) return;
+            if (!price) {
+                valid = false;
+                return;
+            }
+            value += signed_ratio * *price;
+            valid = value <= LIMIT && value >= -LIMIT;
+        }
+        std::optional<Price> get() const {
+            return valid ? std::optional<Price>(static_cast<Price>(value)) : std::nullopt;
+        }
+    };
+    Total ask;
+    Total bid;
+
+    for (size_t i = 0; i < spread.legs.size(); ++i) {
+        const Leg& leg = spread.legs[i];
+        const BookEntry& e = *spread.books[i];
+        const __int128 ratio = (leg.side == Side::Buy) ? static_cast<__int128>(leg.ratio)
+                                                       : -static_cast<__int128>(leg.ratio);
+        ask.add((leg.side == Side::Buy) ? e.ask : e.bid, ratio);
+        bid.add((leg.side == Side::Buy) ? e.bid : e.ask, ratio);
+    }
+
+    spread.implied.ask = ask.get();
+    spread.implied.bid = bid.get();
+}
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+MatchingEngine::BookEntry* MatchingEngine::entry(const std::string& symbol) noexcept {
+    auto it = books_.find(symbol);
+    return it != books_.end() ? &it->second : nullptr;
+}
+
+const MatchingEngine::BookEntry* MatchingEngine::entry(const std::string& symbol) const noexcept {
+    auto it = books_.find(symbol);
+    return it != books_.end() ? &it->second : nullptr;
+}
+
+} // namespace orderbook
@@ -0,0 +1,51 @@
+#include "node_pool.hpp"
+#include <algorithm>
+
+namespace orderbook {
+
+// Smallest chunk we carve, so a pool with no hint doesn't grow one node at a time
+static constexpr size_t MIN_CHUNK_NODES = 256;
+
+NodePool::NodePool(size_t capacity_hint)
+    : capacity_hint_(std::max(capacity_hint, MIN_CHUNK_NODES))
+{}
+
+void* NodePool::allocate(size_t bytes) {
+    if (node_size_ == 0) {
+        node_size_ = round_up(bytes);
+    }
+    if (free_ == nullptr) {
+        // First chunk honours the hint; later ones double the pool
+        grow(capacity_ == 0 ? capacity_hint_ : capacity_);
+    }
+
+    FreeNode* node = free_;
+    free_ = node->next;
+    --free_count_;
+    return node;
+}
+
+void NodePool::deallocate(void* p) noexcept {
+    auto* node = static_cast<FreeNode*>(p);
+    node->next = free_;
+    free_ = node;
+    ++free_count_;
+}
+
+void NodePool::grow(size_t nodes) {
+    auto chunk = std::make_unique<std::byte[]>(nodes * node_size_);
+    std::byte* base = chunk.get();
+
+    // Thread back to front so allocation walks the chunk in address order
+    for (size_t i = nodes; i-- > 0;) {
+        auto* node = reinterpret_cast<FreeNode*>(base + i * node_size_);
+        node->next = free_;
+        free_ = node;
+    }
+
+    chunks_.push_back(std::move(chunk));
+    capacity_ += nodes;
+    free_count_ += nodes;
+}
+
+} // namespace orderbook
@@ -1,16 +1,89 @@
 #include "order_book.hpp"
 #include <algorithm>
+#include <iterator>
+#include <limits>
 
 namespace orderbook {
 
+// Counter for one component, with a NodePool of `capacity` nodes when pooling.
+// `node_based`: the component allocates one fixed-size node at a time, the
+// only pattern a NodePool can serve.
+static std::shared_ptr<AllocationCounter> make_counter(const OrderBookConfig& config,
+                                                       size_t capacity, bool node_based = true) {
+    auto counter = std::make_shared<AllocationCounter>();
+    if (config.allocator == AllocatorKind::Pool && node_based) {
+        counter->pool = std::make_unique<NodePool>(capacity);
+    }
+    return counter;
+}
+
 OrderBook::OrderBook(const std::string& symbol)
-    : symbol_(symbol)
+    : OrderBook(symbol, OrderBookConfig{})
 {}
 
+OrderBook::OrderBook(const std::string& symbol, const OrderBookConfig& config)
+    : symbol_(symbol)
+    , config_(config)
+    , tick_(config.tick_size)
+    , queue_alloc_(make_counter(config, config.expected_orders))
+    , levels_(make_levels(config.levels,
+                          LevelAllocator(make_counter(config, 2 * config.expected_levels,
+                                                      config.levels == LevelBackend::Map)),
+                          tick_))                 // One counter shared by both sides
+    , order_lookup_(OrderLookup::allocator_type(make_counter(config, config.expected_orders)))
+    , expiry_wheel_(config.expiry_epoch.value_or(now()))
+    , tape_(config.trade_tape)
+{
+    config_.tick_size = tick_.tick();  // TickSize clamps invalid ticks to 1
+    // Pages only for ids next_order_id() issues; nothing issued yet but the
+    // first (warm_up borrows it)
+    if (config_.sparse_ids) {
+        order_lookup_.set_dense_range(1, 0);
+    } else {
+        order_lookup_.set_dense_range(config_.id_base + 1, config_.id_base + 1);
+    }
+    // Reserving up front means the lookup table never rehashes below this size
+    if (config_.expected_orders > 0) {
+        if (config_.sparse_ids) {
+            order_lookup_.reserve(0, config_.expected_orders);
+        } else {
+            order_lookup_.reserve(config_.expected_orders);
+        }
+        handles_.reserve(config_.expected_orders);
+    }
+    expiry_batch_.reserve(DEFAULT_EXPIRY_BATCH);
+    retained_bids_.reserve(config_.retain_empty_levels);
+    retained_asks_.reserve(config_.retain_empty_levels);
+}
+
+OrderBook::LevelStore OrderBook::make_levels(LevelBackend backend, const LevelAllocator& alloc,
+                                             const TickSize& tick) {
+    switch (backend) {
+    case LevelBackend::Ladder:
+        if (tick.tick() == CentTick::tick()) {
+            return LevelStore(std::in_place_type<Sides<CentLadderLevels>>, alloc, tick);
+        }
+        return LevelStore(std::in_place_type<Sides<LadderLevels>>, alloc, tick);
+    case LevelBackend::BTree:
+        return LevelStore(std::in_place_type<Sides<BTreeLevels>>, alloc, tick);
+    case LevelBackend::Vector:
+        return LevelStore(std::in_place_type<Sides<VectorLevels>>, alloc, tick);
+    case LevelBackend::Map:
+    default:
+        return LevelStore(std::in_place_type<Sides<MapLevels>>, alloc, tick);
+    }
+}
+
 std::vector<Trade> OrderBook::add_order(Order* order) {
+    OrderHandle ignored;
+    return add_order(order, ignored);
+}
+
+std::vector<Trade> OrderBook::add_order(Order* order, OrderHandle& handle) {
     std::vector<Trade> trades;
+    handle = OrderHandle{};
 
-    if (validate_order(*order) != ErrorCode::Success) {
+    if (validate(*order) != ErrorCode::Success) {
         order->status = OrderStatus::Rejected;
         return trades;
     }
@@ -19,19 +92,30 @@ std::vector<Trade> OrderBook::add_order(Order* order) {
 
     // Limit orders with remaining qty rest on the book
     if (order->remaining_quantity() > 0 && order->is_limit()) {
-        add_to_book(order);
+        handle = add_to_book(order);
     }
 
+    finish_update();
     return trades;
 }
 
 ErrorCode OrderBook::cancel_order(OrderId order_id) {
-    auto it = order_lookup_.find(order_id);
-    if (it == order_lookup_.end()) {
+    OrderLocation* location = order_lookup_.find(order_id);
+    if (location == nullptr) {
+        return ErrorCode::OrderNotFound;
+    }
+    return cancel_resting(*location);
+}
+
+ErrorCode OrderBook::cancel_order(OrderHandle handle) {
+    OrderLocation* location = handles_.resolve(handle);
+    if (location == nullptr) {
         return ErrorCode::OrderNotFound;
     }
+    return cancel_resting(*location);
+}
 
-    OrderLocation& location = it->second;
+ErrorCode OrderBook::cancel_resting(OrderLocation& location) {
     Order* order = location.order;
 
     if (order->status == OrderStatus::Cancelled) {
@@ -42,20 +126,107 @@ ErrorCode OrderBook::cancel_order(OrderId order_id) {
     }
 
     order->cancel();
-    remove_from_book(location);
-    order_lookup_.erase(it);
+    erase_order(location);
+    finish_update();
+
+    return ErrorCode::Success;
+}
+
+ErrorCode OrderBook::modify_order(OrderId order_id, Quantity new_quantity) {
+    OrderLocation* location = order_lookup_.find(order_id);
+    if (location == nullptr) {
+        return ErrorCode::OrderNotFound;
+    }
+    return modify_resting(*location, new_quantity);
+}
+
+ErrorCode OrderBook::modify_order(OrderHandle handle, Quantity new_quantity) {
+    OrderLocation* location = handles_.resolve(handle);
+    if (location == nullptr) {
+        return ErrorCode::OrderNotFound;
+    }
+    return modify_resting(*location, new_quantity);
+}
+
+ErrorCode OrderBook::modify_resting(OrderLocation& location, Quantity new_quantity) {
+    if (new_quantity == 0) {
+        return ErrorCode::InvalidQuantity;     // Use cancel_order()
+    }
+    Order* order = location.order;
+    // Fills are sized from the order's quantity, so the cap add_order()
+    // enforces must hold after the change too
+    if (new_quantity > MAX_ORDER_QUANTITY - order->filled_quantity) {
+        return ErrorCode::InvalidQuantity;
+    }
+    const Quantity remaining = order->remaining_quantity();
+    if (new_quantity == remaining) {
+        return ErrorCode::Success;
+    }
+
+    PriceLevel& level = *location.level;
+    state_checksum_ -= state_hash(*order);
+    if (new_quantity < remaining) {
+        order->quantity -= remaining - new_quantity;
+        level.reduce_quantity(remaining - new_quantity);
+    } else {
+        // More size loses time priority: requeue at the back
+        level.remove_order(location.iterator);
+        order->quantity += new_quantity - remaining;
+        location.iterator = level.add_order(order);
+    }
+    notify_level(location.side, location.price, level);
+    state_checksum_ += state_hash(*order);
+    finish_update();
 
     return ErrorCode::Success;
 }
 
+OrderHandle OrderBook::handle_of(OrderId order_id) const noexcept {
+    const OrderLocation* location = order_lookup_.find(order_id);
+    return location == nullptr ? OrderHandle{} : location->handle;
+}
+
+size_t OrderBook::cancel_orders(const std::vector<OrderId>& order_ids) {
+    return cancel_batch(order_ids.data(), order_ids.size(), OrderStatus::Cancelled);
+}
+
+size_t OrderBook::tick(Timestamp now, size_t max_expiries, std::vector<OrderId>* expired) {
+    expiry_wheel_.advance(now);
+
+    expiry_batch_.clear();
+    while (expiry_batch_.size() < max_expiries) {
+        TimerNode* node = expiry_wheel_.pop_due();
+        if (node == nullptr) break;
+        expiry_batch_.push_back(node->order_id);
+    }
+
+    return cancel_batch(expiry_batch_.data(), expiry_batch_.size(), OrderStatus::Expired, expired);
+}
+
 std::optional<Price> OrderBook::best_bid() const noexcept {
-    if (bids_.empty()) return std::nullopt;
-    return bids_.begin()->first;
+    return with_levels([](const auto& bids, const auto&) -> std::optional<Price> {
+        auto it = first_live(bids);
+        if (it == bids.end()) return std::nullopt;
+        return it->first;
+    });
 }
 
 std::optional<Price> OrderBook::best_ask() const noexcept {
-    if (asks_.empty()) return std::nullopt;
-    return asks_.begin()->first;
+    return with_levels([](const auto&, const auto& asks) -> std::optional<Price> {
+        auto it = first_live(asks);
+        if (it == asks.end()) return std::nullopt;
+        return it->first;
+    });
+}
+
+size_t OrderBook::bid_levels() const noexcept {
+    return with_levels([](const auto& bids, const auto&) { return bids.size(); }) -
+           retained_bids_.size();
+}
+
+size_t OrderBook::ask_levels() const noexcept {
+    return with_levels([](const auto&, const auto& asks) { return asks.size(); }) -
+           retained_asks_.size();
 }
 
 std::optional<Price> OrderBook::spread() const noexcept {
@@ -65,122 +236,452 @@ std::optional<Price> OrderBook::spread() const noexcept {
     return *ask - *bid;
 }
 
-Quantity OrderBook::volume_at_price(Side side, Price price) const noexcept {
-    if (side == Side::Buy) {
-        auto it = bids_.find(price);
-        return (it != bids_.end()) ? it->second.total_quantity() : 0;
-    } else {
-        auto it = asks_.find(price);
-        return (it != asks_.end()) ? it->second.total_quantity() : 0;
+bool OrderBook::warm_up() {
+    if (!empty()) {
+        return false;
+    }
+
+    // The next id the book would issue, so the order lands where real ones
+    // will (index pages, or the overflow map for sparse ids), and a price
+    // inside the band; the orders never meet because each one is cancelled
+    // before the next is added
+    const OrderId WARM_UP_ID = config_.sparse_ids ? std::numeric_limits<OrderId>::max()
+                                                  : config_.id_base + issued_ids_ + 1;
+    const std::string& symbol = symbol_.empty() ? std::string("WARMUP") : symbol_;
+    Price price = config_.min_price > 0 ? config_.min_price : tick_.tick();
+    if (!tick_.is_aligned(price)) {
+        price = tick_.from_index(tick_.to_index(price) + 1);  // Round up onto the grid
+    }
+
+    for (Side side : {Side::Buy, Side::Sell}) {
+        Order order(WARM_UP_ID, symbol, side, OrderType::Limit, 1, price);
+        add_order(&order);
+        cancel_order(WARM_UP_ID);
     }
+
+    // With retention on, the cancels left the warm-up level in place; it
+    // would hold a retention slot and memory until something evicted it
+    with_levels([&](auto& bids, auto& asks) {
+        auto drop = [price](auto& book, std::vector<Price>& retained) {
+            auto it = std::find(retained.begin(), retained.end(), price);
+            if (it == retained.end()) return;
+            *it = retained.back();
+            retained.pop_back();
+            book.erase(price);
+        };
+        drop(bids, retained_bids_);
+        drop(asks, retained_asks_);
+    });
+    next_trade_id_ = 0;
+    return true;
 }
 
-Quantity OrderBook::match_order(Order* incoming, std::vector<Trade>& trades) {
-    // bids_ and asks_ have different comparator types so we can't use a ternary.
-    // A generic lambda lets us write the matching logic once and call it with either map.
-    auto do_match = [&](auto& opposite_book) {
-        while (incoming->remaining_quantity() > 0 && !opposite_book.empty()) {
-            auto level_it = opposite_book.begin();
-            Price resting_price = level_it->first;
-            PriceLevel& level = level_it->second;
-
-            if (!prices_cross(incoming, resting_price)) {
-                break;
-            }
+MemoryStats OrderBook::memory_stats() const noexcept {
+    MemoryStats stats;
+    const LevelAllocator level_alloc =
+        with_levels([](const auto& bids, const auto&) { return LevelAllocator(bids.get_allocator()); });
+    stats.levels = level_alloc.bytes();             // Both sides share a counter
+    stats.queue_nodes = queue_alloc_.bytes();
+    stats.lookup_table = order_lookup_.get_allocator().bytes() + order_lookup_.page_bytes() +
+                         handles_.memory_bytes();
+    stats.expiry_wheel = expiry_wheel_.memory_bytes() + expiry_batch_.capacity() * sizeof(OrderId);
+    stats.orders = order_lookup_.size() * sizeof(Order);
+    stats.strings = string_heap_bytes(symbol_) + order_string_bytes_;
+    stats.trade_tape = tape_.bytes();
+
+    for (const auto* counter : {queue_alloc_.counter().get(),
+                                level_alloc.counter().get(),
+                                order_lookup_.get_allocator().counter().get()}) {
+        if (counter && counter->pool) {
+            stats.pool_slack += counter->pool->free_bytes();
+        }
+    }
+    return stats;
+}
 
-            while (incoming->remaining_quantity() > 0 && !level.empty()) {
-                Order* resting = level.front();
-                Quantity fill_qty = std::min(incoming->remaining_quantity(),
-                                             resting->remaining_quantity());
-
-                incoming->fill(fill_qty);
-                resting->fill(fill_qty);
-                level.reduce_quantity(fill_qty);
-
-                trades.emplace_back(
-                    next_trade_id(),
-                    incoming->is_buy() ? incoming->id : resting->id,
-                    incoming->is_sell() ? incoming->id : resting->id,
-                    symbol_,
-                    resting_price,
-                    fill_qty,
-                    incoming->side
-                );
-
-                if (resting->is_filled()) {
-                    auto order_it = order_lookup_.find(resting->id);
-                    if (order_it != order_lookup_.end()) {
-                        level.remove_order(order_it->second.iterator);
-                        order_lookup_.erase(order_it);
-                    }
-                }
+void OrderBook::attach_view(BookView* view, size_t depth) noexcept {
+    view_ = view;
+    view_depth_ = std::min(depth, BookSnapshot::MAX_DEPTH);
+    publish_view();
+}
+
+void OrderBook::snapshot(BookSnapshot& out, size_t depth) const noexcept {
+    depth = std::min(depth, BookSnapshot::MAX_DEPTH);
+
+    auto fill = [depth](const auto& book, LevelSnapshot* levels) -> uint64_t {
+        uint64_t n = 0;
+        for (auto it = book.begin(); it != book.end() && n < depth; ++it) {
+            if (it->second.empty()) continue;              // Retained
+            levels[n++] = LevelSnapshot{it->first, it->second.total_quantity(),
+                                        it->second.order_count()};
+        }
+        return n;
+    };
+
+    with_levels([&](const auto& bids, const auto& asks) {
+        out.bid_depth = fill(bids, out.bids);
+        out.ask_depth = fill(asks, out.asks);
+    });
+}
+
+void OrderBook::publish_view() noexcept {
+    if (view_ == nullptr) return;
+    snapshot(view_scratch_, view_depth_);
+    view_->publish(view_scratch_);
+}
+
+// End of every mutating public call: the book is consistent again
+void OrderBook::finish_update() {
+    publish_view();
+    if (listener_ != nullptr) {
+        listener_->on_update_end(*this);
+    }
+}
+
+void OrderBook::notify_level(Side side, Price price, const PriceLevel& level) {
+    if (listener_ != nullptr) {
+        listener_->on_level(*this, LevelChange{side, price, level.total_quantity(),
+                                               level.order_count()});
+    }
+}
+
+BookImage OrderBook::image() const {
+    BookImage image;
+    image.levels.reserve(bid_levels() + ask_levels());
+    image.lookup.reserve(order_lookup_.size());
+    image.checksum = state_checksum_;
+
+    auto capture = [&image](const auto& book, Side side) {
+        for (const auto& [price, level] : book) {
+            if (level.empty()) continue;                   // Retained
+            BookImage::Level& out = image.levels.emplace_back();
+            out.side = side;
+            out.price = price;
+            out.total_quantity = level.total_quantity();
+            out.order_count = level.order_count();
+            out.queue.reserve(level.order_count());
+            for (const Order* order : level) {
+                out.queue.push_back(BookImage::QueuedOrder{
+                    order->id, order->side, order->price,
+                    order->remaining_quantity(), order->status});
             }
+        }
+    };
+    with_levels([&](const auto& bids, const auto& asks) {
+        capture(bids, Side::Buy);
+        capture(asks, Side::Sell);
+    });
+
+    order_lookup_.for_each([&](OrderId id, const OrderLocation& location) {
+        image.lookup.push_back(BookImage::LookupEntry{
+            id, location.side, location.price,
+            location.order != nullptr && *location.iterator == location.order &&
+                location.order->id == id && handles_.resolve(location.handle) == &location});
+    });
+    return image;
+}
 
-            if (level.empty()) {
-                opposite_book.erase(level_it);
+Quantity OrderBook::volume_at_price(Side side, Price price) const noexcept {
+    auto volume = [price](const auto& book) -> Quantity {
+        auto it = book.find(price);
+        return (it != book.end()) ? it->second.total_quantity() : 0;
+    };
+    return with_levels([&](const auto& bids, const auto& asks) {
+        return side == Side::Buy ? volume(bids) : volume(asks);
+    });
+}
+
+FillEstimate OrderBook::estimate_fill(Side side, Quantity quantity, Price limit) const noexcept {
+    FillEstimate estimate;
+
+    auto do_walk = [&](const auto& opposite_book) {
+        for (const auto& [price, level] : opposite_book) {
+            if (estimate.quantity >= quantity) break;
+            if (limit != INVALID_PRICE) {
+                bool crosses = (side == Side::Buy) ? limit >= price : limit <= price;
+                if (!crosses) break;
             }
+            if (level.empty()) continue;                   // Retained
+            Quantity take = std::min(quantity - estimate.quantity, level.total_quantity());
+            estimate.quantity += take;
+            int64_t cost;
+            if (__builtin_mul_overflow(price, static_cast<int64_t>(take), &cost) ||
+                __builtin_add_overflow(estimate.notional, cost, &estimate.notional)) {
+                estimate.overflow = true;
+            }
+            estimate.worst_price = price;
         }
     };
 
-    if (incoming->is_buy()) {
-        do_match(asks_);
-    } else {
-        do_match(bids_);
+    with_levels([&](const auto& bids, const auto& asks) {
+        if (side == Side::Buy) {
+            do_walk(asks);
+        } else {
+            do_walk(bids);
+        }
+    });
+    return estimate;
+}
+
+// Start pulling *p into cache without waiting for it. A sweep is a chain of
+// dependent loads (map node -> queue node -> Order), and each miss would
+// otherwise be paid only when the loop reaches that link.
+static inline void prefetch(const void* p) noexcept {
+    __builtin_prefetch(p, 1 /* will write */, 3);
+}
+
+// The matching core, compiled once per incoming side. Which map is opposite,
+// how prices compare and which trade field gets the incoming id are all
+// fixed at compile time, so the fill loop has no side branches left.
+template <Side S, typename Book>
+Quantity OrderBook::match(Book& opposite_book, std::vector<Price>& retained,
+                          Order* incoming, std::vector<Trade>& trades) {
+    constexpr Side RESTING = (S == Side::Buy) ? Side::Sell : Side::Buy;
+
+    // A market order crosses everything: give it the most aggressive limit
+    const Price limit = incoming->is_market()
+        ? (S == Side::Buy ? std::numeric_limits<Price>::max() : std::numeric_limits<Price>::min())
+        : incoming->price;
+
+    auto level_it = opposite_book.begin();
+    while (incoming->remaining_quantity() > 0 && level_it != opposite_book.end()) {
+        Price resting_price = level_it->first;
+        PriceLevel& level = level_it->second;
+
+        if (!crosses<S>(limit, resting_price)) {
+            break;
+        }
+        if (level.empty()) {            // Retained from an earlier sweep
+            ++level_it;
+            continue;
+        }
+
+        // The next level's node: needed as soon as this one clears
+        const auto next_level = std::next(level_it);
+        if (next_level != opposite_book.end()) {
+            prefetch(&next_level->second);
+        }
+
+        while (incoming->remaining_quantity() > 0 && !level.empty()) {
+            Order* resting = level.front();
+
+            // While this fill runs, fetch whoever fills next: the next order
+            // in the queue or, if this is the last one, the next level's head
+            const auto next_in_queue = std::next(level.begin());
+            if (next_in_queue != level.end()) {
+                prefetch(*next_in_queue);
+            } else if (next_level != opposite_book.end() && !next_level->second.empty()) {
+                prefetch(next_level->second.front());
+            }
+            Quantity fill_qty = std::min(incoming->remaining_quantity(),
+                                         resting->remaining_quantity());
+
+            state_checksum_ -= state_hash(*resting);
+            incoming->fill(fill_qty);
+            resting->fill(fill_qty);
+            level.reduce_quantity(fill_qty);
+
+            const Order* buyer = (S == Side::Buy) ? incoming : resting;
+            const Order* seller = (S == Side::Buy) ? resting : incoming;
+            trades.emplace_back(
+                next_trade_id(),
+                buyer->id,
+                seller->id,
+                symbol_,
+                resting_price,
+                fill_qty,
+                S
+            );
+            tape_.push(to_record(trades.back(), config_.instrument_id));
+
+            if (!resting->is_filled()) {
+                state_checksum_ += state_hash(*resting);
+            } else {
+                if (OrderLocation* location = order_lookup_.find(resting->id)) {
+                    level.remove_order(location->iterator);
+                    expiry_wheel_.cancel(location->expiry);
+                    handles_.release(location->handle);
+                    order_string_bytes_ -= string_heap_bytes(resting->symbol);
+                    order_lookup_.erase(resting->id);
+                }
+            }
+        }
+
+        notify_level(RESTING, resting_price, level);
+        if (level.empty()) {
+            level_it = retire_level(opposite_book, level_it, retained);
+        }
     }
 
     return incoming->remaining_quantity();
 }
 
-void OrderBook::add_to_book(Order* order) {
+// One backend and one side dispatch per incoming order
+Quantity OrderBook::match_order(Order* incoming, std::vector<Trade>& trades) {
+    return with_levels([&](auto& bids, auto& asks) {
+        return incoming->is_buy() ? match<Side::Buy>(asks, retained_asks_, incoming, trades)
+                                  : match<Side::Sell>(bids, retained_bids_, incoming, trades);
+    });
+}
+
+OrderHandle OrderBook::add_to_book(Order* order) {
+    // validate() already rejects live ids; never alias another order's entry
+    auto [entry, inserted] = order_lookup_.try_emplace(order->id);
+    if (!inserted) {
+        return OrderHandle{};
+    }
+    OrderLocation& location = *entry;
+
     PriceLevel& level = get_or_create_level(order->side, order->price);
     auto it = level.add_order(order);
+    notify_level(order->side, order->price, level);
+
+    location.side = order->side;
+    location.price = order->price;
+    location.iterator = it;
+    location.order = order;
+    location.level = &level;
+    order_string_bytes_ += string_heap_bytes(order->symbol);
+    state_checksum_ += state_hash(*order);
+
+    if (order->time_in_force == TimeInForce::GoodTillTime) {
+        location.expiry.order_id = order->id;
+        expiry_wheel_.schedule(location.expiry, order->expire_time);
+    }
 
-    order_lookup_[order->id] = OrderLocation{
-        order->side,
-        order->price,
-        it,
-        order
-    };
+    // OrderIndex entries never move, so the handle can point at the entry
+    location.handle = handles_.acquire(&location);
+    return location.handle;
 }
 
 void OrderBook::remove_from_book(const OrderLocation& location) {
-    auto do_remove = [&](auto& book) {
+    auto do_remove = [&](auto& book, std::vector<Price>& retained) {
         auto level_it = book.find(location.price);
         if (level_it == book.end()) return;
         PriceLevel& level = level_it->second;
         level.remove_order(location.iterator);
+        notify_level(location.side, location.price, level);
         if (level.empty()) {
-            book.erase(level_it);
+            retire_level(book, level_it, retained);
         }
     };
 
-    if (location.side == Side::Buy) {
-        do_remove(bids_);
-    } else {
-        do_remove(asks_);
+    with_levels([&](auto& bids, auto& asks) {
+        if (location.side == Side::Buy) {
+            do_remove(bids, retained_bids_);
+        } else {
+            do_remove(asks, retained_asks_);
+        }
+    });
+}
+
+// A level just lost its last live order. Keep it in place for the next order
+// at that price if it fits the retention budget, nearest the touch first;
+// otherwise erase it. Returns the iterator after `it`.
+template <typename Book>
+typename Book::iterator OrderBook::retire_level(Book& book, typename Book::iterator it,
+                                                std::vector<Price>& retained) {
+    if (config_.retain_empty_levels > 0) {
+        const Price price = it->first;
+        if (retained.size() < config_.retain_empty_levels) {
+            retained.push_back(price);
+            return std::next(it);
+        }
+        // key_comp() orders best first, so the max is farthest from the touch
+        auto farthest = std::max_element(retained.begin(), retained.end(), book.key_comp());
+        if (book.key_comp()(price, *farthest)) {
+            const Price evicted = *farthest;
+            *farthest = price;
+            book.erase(evicted);                   // May move `it` in array-based containers
+            return std::next(book.find(price));
+        }
     }
+    return book.erase(it);
+}
+
+// Book-level checks on top of validate_order(): tick size and price band
+ErrorCode OrderBook::validate(const Order& order) const noexcept {
+    // A $0.01 tick is checked against the constant, like CentLadderLevels
+    ErrorCode result = tick_.tick() == CentTick::tick() ? validate_order(order, CentTick{})
+                                                        : validate_order(order, tick_);
+    if (result != ErrorCode::Success) {
+        return result;
+    }
+    // Reusing a live id would alias its lookup entry and handle
+    if (order_lookup_.find(order.id) != nullptr) {
+        return ErrorCode::DuplicateOrderId;
+    }
+    if (!order.is_limit()) {
+        return ErrorCode::Success;
+    }
+    if (config_.min_price > 0 && order.price < config_.min_price) {
+        return ErrorCode::InvalidPrice;
+    }
+    if (config_.max_price > 0 && order.price > config_.max_price) {
+        return ErrorCode::InvalidPrice;
+    }
+    // One far-off price would otherwise stretch the ladder to reach it
+    if (config_.levels == LevelBackend::Ladder &&
+        !with_levels([&](const auto& bids, const auto& asks) {
+            return order.side == Side::Buy ? bids.can_hold(order.price) : asks.can_hold(order.price);
+        })) {
+        return ErrorCode::InvalidPrice;
+    }
+    return ErrorCode::Success;
+}
+
+// Single exit path for a resting order that leaves the book without a fill:
+// cancel, mass cancel and expiry all end up here.
+void OrderBook::erase_order(OrderLocation& location) {
+    const Order* order = location.order;
+    expiry_wheel_.cancel(location.expiry);
+    remove_from_book(location);
+    handles_.release(location.handle);
+    order_string_bytes_ -= string_heap_bytes(order->symbol);
+    state_checksum_ -= state_hash(*order);
+    order_lookup_.erase(order->id);           // location is gone after this
+}
+
+size_t OrderBook::cancel_batch(const OrderId* order_ids, size_t count, OrderStatus reason,
+                               std::vector<OrderId>* removed_ids) {
+    size_t removed = 0;
+    for (size_t i = 0; i < count; ++i) {
+        OrderLocation* location = order_lookup_.find(order_ids[i]);
+        if (location == nullptr) continue;
+
+        Order* order = location->order;
+        bool ok = (reason == OrderStatus::Expired) ? order->expire() : order->cancel();
+        if (!ok) continue;
+
+        if (removed_ids) removed_ids->push_back(order->id);
+        erase_order(*location);
+        ++removed;
+    }
+    if (removed > 0) {
+        finish_update();
+    }
+    return removed;
 }
 
 PriceLevel& OrderBook::get_or_create_level(Side side, Price price) {
-    auto do_get = [&](auto& book) -> PriceLevel& {
-        PriceLevel& level = book[price];
-        if (level.price() == INVALID_PRICE) {
-            level = PriceLevel(price);
+    auto do_get = [&](auto& book, std::vector<Price>& retained) -> PriceLevel& {
+        // try_emplace only builds the PriceLevel (with the book's queue
+        // allocator) when the level doesn't exist yet
+        PriceLevel& level = book.try_emplace(price, price, queue_alloc_).first->second;
+        if (!retained.empty() && level.empty()) {
+            // Reviving a retained level: it's live again once this order lands
+            auto it = std::find(retained.begin(), retained.end(), price);
+            if (it != retained.end()) {
+                *it = retained.back();
+                retained.pop_back();
+            }
         }
         return level;
     };
 
-    if (side == Side::Buy) {
-        return do_get(bids_);
-    } else {
-        return do_get(asks_);
-    }
-}
-
-bool OrderBook::prices_cross(const Order* incoming, Price resting_price) noexcept {
-    if (incoming->is_market()) return true;
-    if (incoming->is_buy()) return incoming->price >= resting_price;
-    return incoming->price <= resting_price;
+    return with_levels([&](auto& bids, auto& asks) -> PriceLevel& {
+        return side == Side::Buy ? do_get(bids, retained_bids_) : do_get(asks, retained_asks_);
+    });
 }
 
 } // namespace orderbook
@@ -6,10 +6,10 @@ namespace orderbook {
 // Constructors
 // ============================================================================
 
-PriceLevel::PriceLevel(Price price)
+PriceLevel::PriceLevel(Price price, const Allocator& alloc)
     : price_(price)
     , total_quantity_(0)
-    , orders_()
+    , orders_(alloc)
 {}
 
 // ============================================================================
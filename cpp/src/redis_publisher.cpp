@@ -1,47 +1,589 @@
 #include "redis_publisher.hpp"
-#include <stdexcept>
+#include "order_book.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
 #include <string>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
 
 namespace orderbook {
 
-// Connect to Redis when the object is created
-RedisPublisher::RedisPublisher(const std::string& host, int port) {
-    ctx_ = redisConnect(host.c_str(), port);
+namespace {
 
-    if (ctx_ == nullptr || ctx_->err) {
-        std::string err = ctx_ ? ctx_->errstr : "allocation failure";
-        if (ctx_) redisFree(ctx_);
-        ctx_ = nullptr;
-        throw std::runtime_error("Redis connection failed: " + err);
+constexpr uint64_t SPILL_MAGIC = 0x314C4C495053424FULL;   // "OBSPILL1" little-endian
+constexpr size_t SPILL_INITIAL_BYTES = 1 << 20;
+
+// First 64 bytes of the spill file; the log's bytes follow
+struct SpillHeader {
+    uint64_t magic;
+    uint64_t head;                         // First unacknowledged byte
+    uint64_t tail;                         // End of the log
+    uint64_t reserved[5];
+};
+
+static_assert(sizeof(SpillHeader) == 64, "SpillHeader is one cache line");
+
+using Clock = std::chrono::steady_clock;
+
+// Owned by us and nobody else may write to it
+bool private_to_user(const struct stat& st) noexcept {
+    return st.st_uid == ::geteuid() && (st.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+}
+
+// $XDG_RUNTIME_DIR, else /tmp/orderbook-<euid> (created 0700). Empty (errno
+// set) if it isn't a real directory private to this user: the spill log
+// holds every unacknowledged trade, and a shared /tmp lets anyone plant a
+// symlink or a file of their own under a predictable name.
+std::string default_spill_dir() {
+    const char* runtime = std::getenv("XDG_RUNTIME_DIR");
+    std::string dir = (runtime != nullptr && runtime[0] == '/')
+        ? std::string(runtime)
+        : "/tmp/orderbook-" + std::to_string(::geteuid());
+    if (::mkdir(dir.c_str(), 0700) != 0 && errno != EEXIST) return {};
+    struct stat st {};
+    if (::lstat(dir.c_str(), &st) != 0) return {};
+    if (!S_ISDIR(st.st_mode) || !private_to_user(st) || (st.st_mode & S_IRWXO) != 0) {
+        errno = EPERM;
+        return {};
+    }
+    return dir;
+}
+
+} // namespace
+
+// ============================================================================
+// SpillLog: FIFO of encoded commands in a memory-mapped file
+// ============================================================================
+
+class RedisPublisher::SpillLog {
+public:
+    SpillLog() = default;
+    SpillLog(const SpillLog&) = delete;
+    SpillLog& operator=(const SpillLog&) = delete;
+    ~SpillLog() {
+        unmap();
+        if (fd_ >= 0) ::close(fd_);
+    }
+
+    // Open (or create, mode 0600) and lock the file; a valid existing log
+    // keeps its backlog. False with errno EWOULDBLOCK if another publisher
+    // holds it, ELOOP if it is a symlink, EPERM if it isn't a regular file
+    // private to this user. max_bytes caps the file (0 = no cap).
+    bool open(const std::string& path, size_t initial_bytes, size_t max_bytes) {
+        path_ = path;
+        max_bytes_ = max_bytes;
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_NOFOLLOW | O_CLOEXEC, 0600);
+        if (fd_ < 0) return false;
+        struct stat st {};
+        if (fstat(fd_, &st) != 0) return false;
+        if (!S_ISREG(st.st_mode) || !private_to_user(st)) {
+            errno = EPERM;
+            return false;
+        }
+        if (::flock(fd_, LOCK_EX | LOCK_NB) != 0) return false;
+        const size_t bytes = std::max(static_cast<size_t>(st.st_size), sizeof(SpillHeader) + initial_bytes);
+        if (!map(bytes)) return false;
+
+        SpillHeader* h = header();
+        if (h->magic != SPILL_MAGIC || h->head > h->tail || h->tail > capacity()) {
+            h->magic = SPILL_MAGIC;
+            h->head = 0;
+            h->tail = 0;
+        }
+        return true;
+    }
+
+    char* data() const noexcept { return static_cast<char*>(map_) + sizeof(SpillHeader); }
+    uint64_t head() const noexcept { return header()->head; }
+    uint64_t tail() const noexcept { return header()->tail; }
+    bool empty() const noexcept { return head() == tail(); }
+
+    // False (errno set) if the file can't grow to take the bytes; the log
+    // is then unchanged and the caller keeps them to try again
+    bool append(const char* bytes, size_t n) {
+        if (tail() + n > capacity() && !grow(tail() + n)) return false;
+        std::memcpy(data() + tail(), bytes, n);
+        header()->tail += n;                   // After the bytes: a crash never exposes a torn command
+        return true;
+    }
+
+    void consume(uint64_t n) noexcept { header()->head += n; }
+
+    // Move the unacknowledged bytes to the front when that is cheap: always
+    // once empty, and once the head is past half the file with little left.
+    // Returns how far the bytes moved down.
+    uint64_t compact() noexcept {
+        SpillHeader* h = header();
+        const uint64_t left = h->tail - h->head;
+        if (h->head == 0 || (left > 0 && (h->head < capacity() / 2 || left > capacity() / 8))) return 0;
+        const uint64_t shift = h->head;
+        std::memmove(data(), data() + shift, left);
+        h->head = 0;
+        h->tail = left;
+        return shift;
+    }
+
+    // Unlinked while still locked: a publisher opening the path meanwhile
+    // gets the old file and fails to lock it
+    void remove() {
+        unmap();
+        ::unlink(path_.c_str());
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+    }
+
+private:
+    SpillHeader* header() const noexcept { return static_cast<SpillHeader*>(map_); }
+    size_t capacity() const noexcept { return bytes_ - sizeof(SpillHeader); }
+
+    bool map(size_t bytes) {
+        if (!reserve(bytes)) return false;
+        void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (p == MAP_FAILED) return false;
+        map_ = p;
+        bytes_ = bytes;
+        return true;
+    }
+
+    // Map the larger file before letting go of the current mapping: if any
+    // step fails, the log is still mapped and intact
+    bool grow(uint64_t needed) {
+        size_t bytes = sizeof(SpillHeader) + static_cast<size_t>(std::max<uint64_t>(2 * capacity(), needed));
+        if (max_bytes_ > 0) bytes = std::min(bytes, max_bytes_);
+        if (bytes < sizeof(SpillHeader) + needed) {
+            errno = EFBIG;
+            return false;
+        }
+        if (!reserve(bytes)) return false;
+        void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (p == MAP_FAILED) return false;
+        munmap(map_, bytes_);
+        map_ = p;
+        bytes_ = bytes;
+        return true;
+    }
+
+    // Make the file at least `bytes` long with its blocks allocated, so a
+    // full disk fails here instead of as SIGBUS on a store into the mapping
+    bool reserve(size_t bytes) {
+        struct stat st {};
+        if (fstat(fd_, &st) != 0) return false;
+        if (static_cast<size_t>(st.st_size) >= bytes) return true;
+#if defined(__linux__)
+        const int rc = ::posix_fallocate(fd_, 0, static_cast<off_t>(bytes));
+        if (rc != 0) {
+            errno = rc;
+            return false;
+        }
+        return true;
+#else
+        return ftruncate(fd_, static_cast<off_t>(bytes)) == 0;
+#endif
+    }
+
+    void unmap() noexcept {
+        if (map_ != nullptr) munmap(map_, bytes_);
+        map_ = nullptr;
+        bytes_ = 0;
+    }
+
+    std::string path_;
+    int fd_ = -1;
+    void* map_ = nullptr;
+    size_t bytes_ = 0;
+    size_t max_bytes_ = 0;
+};
+
+// ============================================================================
+// RedisPublisher: matching thread side
+// ============================================================================
+
+RedisPublisher::RedisPublisher(RedisPublisherConfig config)
+    : config_(std::move(config))
+    , queue_(config_.queue_capacity)
+    , log_(std::make_unique<SpillLog>())
+    , backoff_(config_.min_backoff)
+    , retry_backoff_(config_.min_backoff)
+{
+    if (config_.spill_path.empty()) {
+        const std::string dir = default_spill_dir();
+        if (dir.empty()) {
+            last_error_ = "no private spill directory: " + std::string(std::strerror(errno));
+            return;
+        }
+        config_.spill_path = dir + "/orderbook.redis." + config_.host + "-" +
+                             std::to_string(config_.port) + ".spill";
+    }
+    if (config_.max_spill_bytes > 0) {
+        config_.max_spill_bytes = std::max(config_.max_spill_bytes, sizeof(SpillHeader) + SPILL_INITIAL_BYTES);
     }
+    if (!log_->open(config_.spill_path, SPILL_INITIAL_BYTES, config_.max_spill_bytes)) {
+        last_error_ = errno == EWOULDBLOCK ? "spill log in use by another publisher: "
+                    : errno == EPERM       ? "spill log not private to this user: "
+                                           : "cannot open spill log (" + std::string(std::strerror(errno)) + "): ";
+        last_error_ += config_.spill_path;
+        return;
+    }
+    backlog_bytes_.store(log_->tail() - log_->head(), std::memory_order_release);
+    running_.store(true, std::memory_order_release);
+    io_ = std::thread(&RedisPublisher::run_io, this);
 }
 
-// Disconnect when the object is destroyed
+RedisPublisher::RedisPublisher(const std::string& host, int port)
+    : RedisPublisher([&] {
+          RedisPublisherConfig config;
+          config.host = host;
+          config.port = port;
+          return config;
+      }())
+{}
+
 RedisPublisher::~RedisPublisher() {
-    if (ctx_) {
-        redisFree(ctx_);
-        ctx_ = nullptr;
+    stop();
+}
+
+void RedisPublisher::stop() {
+    if (!io_.joinable()) return;
+    running_.store(false, std::memory_order_release);
+    io_.join();                                    // Drains the queue into the log first
+    if (fd_ >= 0) ::close(fd_);
+    fd_ = -1;
+    connected_.store(false, std::memory_order_release);
+    if (log_->empty()) log_->remove();
+}
+
+bool RedisPublisher::wait_connected(std::chrono::milliseconds timeout) const {
+    const auto deadline = Clock::now() + timeout;
+    while (!is_connected()) {
+        if (!ok() || Clock::now() >= deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
+    return true;
 }
 
-bool RedisPublisher::is_connected() const noexcept {
-    return ctx_ != nullptr;
+// Never waits. While anything is in the overflow buffer, new entries go
+// there too, so the I/O thread sees them in publish order. False: dropped.
+bool RedisPublisher::push(const Outgoing& entry) {
+    if (!overflow_pending_.load(std::memory_order_acquire) && queue_.try_push(entry)) return true;
+
+    // Only full if the I/O thread is starved or the spill log can't take more
+    std::lock_guard<std::mutex> lock(overflow_mutex_);
+    if (!overflow_pending_.load(std::memory_order_relaxed) && queue_.try_push(entry)) return true;
+    if (overflow_.size() >= config_.max_overflow) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> error_lock(error_mutex_);
+        last_error_ = "publish queue and overflow buffer full: dropping trades";
+        return false;
+    }
+    overflow_.push_back(entry);
+    overflow_pending_.store(true, std::memory_order_release);
+    overflowed_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+// Copy the symbol, cut at SYMBOL_SIZE; the rest of the field is zeroed so
+// encode() finds its end with strnlen
+void RedisPublisher::set_symbol(Outgoing& entry, const std::string& symbol) noexcept {
+    const size_t n = std::min(symbol.size(), SYMBOL_SIZE);
+    std::memcpy(entry.symbol, symbol.data(), n);
+    std::memset(entry.symbol + n, 0, SYMBOL_SIZE - n);
 }
 
 void RedisPublisher::publish_trade(const Trade& trade) {
-    if (!is_connected()) return;
+    const TradeRecord record = to_record(trade, 0);
+    publish_trades(trade.symbol, &record, 1);
+}
 
-    // Build the message string:
-    // "symbol=AAPL price=101.000000 qty=100 buy=1 sell=2"
+void RedisPublisher::publish_trades(const std::string& symbol, const TradeRecord* trades, size_t count) {
+    if (!ok()) return;
+    Outgoing entry{};
+    set_symbol(entry, symbol);
+    size_t accepted = 0;
+    for (size_t i = 0; i < count; ++i) {
+        entry.item = trades[i];
+        accepted += push(entry) ? 1 : 0;
+    }
+    queued_.fetch_add(accepted, std::memory_order_release);
+}
+
+void RedisPublisher::on_trades(const OrderBook& book, const TradeRecord* records, size_t count) {
+    publish_trades(book.symbol(), records, count);
+}
+
+void RedisPublisher::publish_bar(const std::string& symbol, const Bar& bar) {
+    if (!ok()) return;
+    Outgoing entry{};
+    set_symbol(entry, symbol);
+    entry.item = bar;
+    if (push(entry)) queued_.fetch_add(1, std::memory_order_release);
+}
+
+bool RedisPublisher::flush(std::chrono::milliseconds timeout) {
+    const uint64_t target = queued_.load(std::memory_order_acquire);
+    const auto deadline = Clock::now() + timeout;
+    while (logged_.load(std::memory_order_acquire) < target || backlog_bytes() > 0) {
+        if (!ok() || Clock::now() >= deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+std::string RedisPublisher::last_error() const {
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    return last_error_;
+}
+
+// ============================================================================
+// RedisPublisher: I/O thread
+// ============================================================================
+
+void RedisPublisher::encode(const Outgoing& entry) {
+    const std::string_view symbol(entry.symbol, strnlen(entry.symbol, SYMBOL_SIZE));
+
+    if (const auto* trade = std::get_if<TradeRecord>(&entry.item)) {
+        // PUBLISH trades "symbol=AAPL price=101.000000 qty=100 buy=1 sell=2"
+        // (+ XADD <stream> MAXLEN ~ <n> * symbol AAPL price 101.000000 ...)
+        writer_.publish_trade("trades", symbol, *trade);
+        if (!config_.stream.empty()) {
+            writer_.xadd_trade(config_.stream, config_.stream_max_len, symbol, *trade);
+        }
+        return;
+    }
+
+    // "symbol=AAPL start=1704153600000000000 open=101.000000 high=... low=...
+    //  close=... volume=300 vwap=101.250000 trades=4"
+    const Bar& bar = std::get<Bar>(entry.item);
     std::string msg =
-        "symbol=" + trade.symbol +
-        " price=" + std::to_string(price_to_double(trade.price)) +
-        " qty="   + std::to_string(trade.quantity) +
-        " buy="   + std::to_string(trade.buy_order_id) +
-        " sell="  + std::to_string(trade.sell_order_id);
-
-    // PUBLISH trades "<msg>"
-    redisCommand(ctx_, "PUBLISH trades %s", msg.c_str());
+        "symbol="  + std::string(symbol) +
+        " start="  + std::to_string(bar.start_ns) +
+        " open="   + std::to_string(price_to_double(bar.open)) +
+        " high="   + std::to_string(price_to_double(bar.high)) +
+        " low="    + std::to_string(price_to_double(bar.low)) +
+        " close="  + std::to_string(price_to_double(bar.close)) +
+        " volume=" + std::to_string(bar.volume) +
+        " vwap="   + std::to_string(price_to_double(bar.vwap())) +
+        " trades=" + std::to_string(bar.trades);
+
+    // PUBLISH bars.1m "<msg>"
+    writer_.publish(std::string("bars.") + to_string(bar.interval), msg);
+}
+
+// The next entries in publish order: the queue, then what overflowed while
+// it was full. Nothing is pushed to the queue while the overflow is pending,
+// so a pending overflow found with the queue empty is next in line.
+size_t RedisPublisher::take(Outgoing* out, size_t max) {
+    if (overflow_next_ == overflow_taken_.size()) {
+        const bool pending = overflow_pending_.load(std::memory_order_acquire);
+        const size_t n = queue_.try_pop(out, max);
+        if (n > 0 || !pending) return n;
+
+        std::lock_guard<std::mutex> lock(overflow_mutex_);
+        overflow_taken_.clear();
+        overflow_taken_.swap(overflow_);
+        overflow_next_ = 0;
+        overflow_pending_.store(false, std::memory_order_release);
+    }
+    const size_t n = std::min(max, overflow_taken_.size() - overflow_next_);
+    std::copy_n(overflow_taken_.begin() + static_cast<std::ptrdiff_t>(overflow_next_), n, out);
+    overflow_next_ += n;
+    return n;
+}
+
+void RedisPublisher::run_io() {
+    std::vector<Outgoing> batch(BATCH);
+    unsigned idle_spins = 0;
+    size_t encoded = 0;                            // Entries in writer_, not yet in the log
+    std::chrono::milliseconds append_backoff = config_.min_backoff;
+    Clock::time_point next_append{};
+
+    for (;;) {
+        const bool stopping = !running_.load(std::memory_order_acquire);
+
+        // A batch the log couldn't take stays in writer_, and the rest in
+        // the queue and overflow, until a retry fits it
+        size_t n = 0;
+        if (writer_.empty()) {
+            n = take(batch.data(), BATCH);
+            for (size_t i = 0; i < n; ++i) encode(batch[i]);
+            encoded += n;
+        }
+        size_t logged = 0;
+        if (!writer_.empty() && (stopping || Clock::now() >= next_append)) {
+            bool retry = false;
+            if (log_->append(writer_.data(), writer_.size())) {
+                logged = encoded;
+                append_backoff = config_.min_backoff;
+            } else {
+                std::lock_guard<std::mutex> lock(error_mutex_);
+                last_error_ = "spill log can't grow: " + std::string(std::strerror(errno));
+                if (stopping) {
+                    // No later retry: these never reach the log
+                    errors_.fetch_add(writer_.commands(), std::memory_order_relaxed);
+                } else {
+                    retry = true;
+                    next_append = Clock::now() + append_backoff;
+                    append_backoff = std::min(append_backoff * 2, config_.max_backoff);
+                }
+            }
+            if (!retry) {
+                writer_.clear();
+                encoded = 0;
+            }
+        }
+        if (stopping && n == 0 && writer_.empty()) break;   // Everything queued is in the log
+
+        bool progress = n > 0;
+        if (fd_ < 0 && Clock::now() >= next_attempt_) start_connect();
+        if (connecting_) finish_connect();
+        if (is_connected()) {
+            progress |= send_backlog();
+            progress |= read_replies();
+        }
+        const uint64_t shift = log_->compact();
+        sent_ -= std::min(sent_, shift);
+
+        // Publish the backlog before the count, so flush() never sees the
+        // entries counted and their bytes missing
+        backlog_bytes_.store(log_->tail() - log_->head(), std::memory_order_release);
+        if (logged > 0) logged_.fetch_add(logged, std::memory_order_release);
+
+        if (progress) {
+            idle_spins = 0;
+            continue;
+        }
+        // Stay hot briefly after traffic, then back off to a short sleep
+        if (++idle_spins < 256) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+}
+
+void RedisPublisher::start_connect() {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* found = nullptr;
+    if (::getaddrinfo(config_.host.c_str(), std::to_string(config_.port).c_str(), &hints, &found) != 0) {
+        drop_connection();
+        return;
+    }
+
+    fd_ = ::socket(found->ai_family, found->ai_socktype, found->ai_protocol);
+    if (fd_ >= 0) ::fcntl(fd_, F_SETFL, ::fcntl(fd_, F_GETFL) | O_NONBLOCK);
+    const int rc = fd_ < 0 ? -1 : ::connect(fd_, found->ai_addr, found->ai_addrlen);
+    ::freeaddrinfo(found);
+    if (rc != 0 && errno != EINPROGRESS) {
+        drop_connection();
+        return;
+    }
+    connecting_ = true;
+    connect_deadline_ = Clock::now() + config_.connect_timeout;
+    finish_connect();
+}
+
+void RedisPublisher::finish_connect() {
+    pollfd pfd{fd_, POLLOUT, 0};
+    if (::poll(&pfd, 1, 0) == 0) {
+        if (Clock::now() >= connect_deadline_) drop_connection();
+        return;
+    }
+    int err = 0;
+    socklen_t len = sizeof(err);
+    if (getsockopt(fd_, SOL_SOCKET, SO_ERROR, &err, &len) != 0 || err != 0) {
+        drop_connection();
+        return;
+    }
+
+    int one = 1;
+    setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    connecting_ = false;
+    sent_ = log_->head();                          // Resend whatever was never acknowledged
+    replies_.reset();
+    backoff_ = config_.min_backoff;
+    if (connects_++ > 0) reconnects_.fetch_add(1, std::memory_order_relaxed);
+    connected_.store(true, std::memory_order_release);
+}
+
+// Close the socket (if any) and schedule the next attempt
+void RedisPublisher::drop_connection() {
+    if (fd_ >= 0) ::close(fd_);
+    fd_ = -1;
+    connecting_ = false;
+    connected_.store(false, std::memory_order_release);
+    next_attempt_ = Clock::now() + backoff_;
+    backoff_ = std::min(backoff_ * 2, config_.max_backoff);
+}
+
+// Send the next piece of the log; true if anything went out
+bool RedisPublisher::send_backlog() {
+    const uint64_t tail = log_->tail();
+    if (sent_ >= tail) return false;
+    const size_t bytes = static_cast<size_t>(std::min<uint64_t>(tail - sent_, config_.drain_bytes));
+    const ssize_t n = ::send(fd_, log_->data() + sent_, bytes, MSG_NOSIGNAL | MSG_DONTWAIT);
+    if (n > 0) {
+        sent_ += static_cast<uint64_t>(n);
+        return true;
+    }
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) return false;
+    drop_connection();
+    return false;
+}
+
+// Read the replies that have arrived; each acknowledges the command at the
+// head of the log, up to a retryable error. True if any arrived.
+bool RedisPublisher::read_replies() {
+    bool any = false;
+    while (fd_ >= 0) {
+        const ssize_t n = ::recv(fd_, reply_buffer_, sizeof(reply_buffer_), MSG_DONTWAIT);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        if (n <= 0) {
+            drop_connection();
+            break;
+        }
+
+        const uint64_t errors_before = replies_.errors();
+        const size_t replies = replies_.feed(reply_buffer_, static_cast<size_t>(n));
+        for (size_t i = 0; i < replies; ++i) {
+            log_->consume(RespReplyScanner::element_size(log_->data() + log_->head(),
+                                                         log_->tail() - log_->head()));
+        }
+        acknowledged_.fetch_add(replies, std::memory_order_relaxed);
+        if (replies > 0) retry_backoff_ = config_.min_backoff;
+        if (replies_.errors() != errors_before || replies_.retry()) {
+            errors_.fetch_add(replies_.errors() - errors_before, std::memory_order_relaxed);
+            std::lock_guard<std::mutex> lock(error_mutex_);
+            last_error_ = replies_.last_error();
+        }
+        any = true;
+        if (replies_.retry()) {
+            // The head stays put and goes out again on the next connection.
+            // Connecting resets backoff_, so a server that keeps answering
+            // -LOADING is paced by its own backoff instead.
+            drop_connection();
+            next_attempt_ = Clock::now() + retry_backoff_;
+            retry_backoff_ = std::min(retry_backoff_ * 2, config_.max_backoff);
+            break;
+        }
+        if (!replies_.ok()) {
+            drop_connection();
+            break;
+        }
+    }
+    return any;
 }
 
 } // namespace orderbook
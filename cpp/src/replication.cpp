@@ -0,0 +1,295 @@
+#include "replication.hpp"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <utility>
+
+namespace orderbook {
+
+namespace {
+
+constexpr size_t BATCH = 64;   // Commands per socket write / read
+
+void set_nodelay(int fd) {
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+void close_fd(int& fd) {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// ReplicationPrimary
+// ============================================================================
+
+ReplicationPrimary::ReplicationPrimary(uint16_t port,
+                                       std::chrono::milliseconds heartbeat_interval,
+                                       size_t queue_capacity,
+                                       std::chrono::microseconds max_block)
+    : heartbeat_interval_(heartbeat_interval)
+    , max_block_(max_block)
+    , queue_(queue_capacity)
+{
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) return;
+
+    int one = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    socklen_t len = sizeof(addr);
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(listen_fd_, 1) != 0 ||
+        ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+        close_fd(listen_fd_);
+        return;
+    }
+    port_ = ntohs(addr.sin_port);
+}
+
+ReplicationPrimary::~ReplicationPrimary() {
+    stop();
+}
+
+bool ReplicationPrimary::wait_for_backup(std::chrono::milliseconds timeout) {
+    if (listen_fd_ < 0 || connected()) return connected();
+
+    pollfd pfd{listen_fd_, POLLIN, 0};
+    if (::poll(&pfd, 1, static_cast<int>(timeout.count())) <= 0) {
+        return false;
+    }
+
+    conn_fd_ = ::accept(listen_fd_, nullptr, nullptr);
+    if (conn_fd_ < 0) return false;
+    set_nodelay(conn_fd_);
+
+    running_.store(true, std::memory_order_release);
+    connected_.store(true, std::memory_order_release);
+    sender_ = std::thread(&ReplicationPrimary::run_sender, this);
+    return true;
+}
+
+bool ReplicationPrimary::replicate(const Command& cmd) noexcept {
+    if (!connected_.load(std::memory_order_relaxed)) return false;
+
+    if (!queue_.try_push(cmd)) {
+        // Only a full queue reads the clock
+        const auto deadline = std::chrono::steady_clock::now() + max_block_;
+        do {
+            if (!connected_.load(std::memory_order_relaxed)) return false;
+            if (std::chrono::steady_clock::now() >= deadline) {
+                overflowed_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            std::this_thread::yield();
+        } while (!queue_.try_push(cmd));
+    }
+    queued_.store(queued_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    return true;
+}
+
+bool ReplicationPrimary::flush(std::chrono::milliseconds timeout) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    const uint64_t target = queued_.load(std::memory_order_relaxed);
+
+    while (sent_.load(std::memory_order_acquire) < target) {
+        if (!connected() || std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    return true;
+}
+
+void ReplicationPrimary::stop() {
+    running_.store(false, std::memory_order_release);
+    if (conn_fd_ >= 0) {
+        ::shutdown(conn_fd_, SHUT_RDWR);   // Wake a sender blocked on a stalled backup
+    }
+    if (sender_.joinable()) {
+        sender_.join();
+    }
+    connected_.store(false, std::memory_order_release);
+    close_fd(conn_fd_);
+    close_fd(listen_fd_);
+}
+
+void ReplicationPrimary::run_sender() {
+    Command batch[BATCH];
+    auto last_write = std::chrono::steady_clock::now();
+    unsigned idle_spins = 0;
+
+    while (running_.load(std::memory_order_acquire)) {
+        const size_t n = queue_.try_pop(batch, BATCH);
+        if (n > 0) {
+            if (!write_all(batch, n * sizeof(Command))) break;
+            sent_.fetch_add(n, std::memory_order_release);
+            last_write = std::chrono::steady_clock::now();
+            idle_spins = 0;
+            continue;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        if (now - last_write >= heartbeat_interval_) {
+            const Command heartbeat;
+            if (!write_all(&heartbeat, sizeof(heartbeat))) break;
+            last_write = now;
+        }
+
+        // Stay hot briefly after traffic, then back off to a short sleep
+        if (++idle_spins < 256) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+
+    connected_.store(false, std::memory_order_release);
+}
+
+bool ReplicationPrimary::write_all(const void* data, size_t bytes) {
+    const char* p = static_cast<const char*>(data);
+    while (bytes > 0) {
+        ssize_t n = ::send(conn_fd_, p, bytes, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        p += n;
+        bytes -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// ============================================================================
+// ReplicationBackup
+// ============================================================================
+
+ReplicationBackup::ReplicationBackup(std::string host, uint16_t port,
+                                     std::chrono::milliseconds failover_timeout)
+    : host_(std::move(host))
+    , port_(port)
+    , failover_timeout_(failover_timeout)
+{}
+
+ReplicationBackup::~ReplicationBackup() {
+    promote();
+}
+
+bool ReplicationBackup::connect() {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port_);
+    if (::inet_pton(AF_INET, host_.c_str(), &addr.sin_addr) != 1) {
+        return false;
+    }
+
+    fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd_ < 0) return false;
+    if (::connect(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        close_fd(fd_);
+        return false;
+    }
+    set_nodelay(fd_);
+
+    running_.store(true, std::memory_order_release);
+    receiver_ = std::thread(&ReplicationBackup::run_receiver, this);
+    return true;
+}
+
+bool ReplicationBackup::wait_for_sequence(SequenceNumber seq, std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    progress_.wait_for(lock, timeout, [&] {
+        return last_sequence() >= seq || primary_failed() || diverged();
+    });
+    return last_sequence() >= seq;
+}
+
+bool ReplicationBackup::wait_for_failover(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return progress_.wait_for(lock, timeout, [&] { return primary_failed(); });
+}
+
+SequencedEngine& ReplicationBackup::promote() {
+    running_.store(false, std::memory_order_release);
+    if (fd_ >= 0) {
+        ::shutdown(fd_, SHUT_RDWR);    // Wake the receiver out of poll()
+    }
+    if (receiver_.joinable()) {
+        receiver_.join();
+    }
+    close_fd(fd_);
+    return engine_;
+}
+
+void ReplicationBackup::notify_progress() {
+    { std::lock_guard<std::mutex> lock(mutex_); }
+    progress_.notify_all();
+}
+
+void ReplicationBackup::run_receiver() {
+    alignas(Command) char buffer[BATCH * sizeof(Command)];
+    size_t buffered = 0;
+    auto last_heard = std::chrono::steady_clock::now();
+
+    while (running_.load(std::memory_order_acquire)) {
+        pollfd pfd{fd_, POLLIN, 0};
+        int ready = ::poll(&pfd, 1, static_cast<int>(failover_timeout_.count()));
+        if (ready < 0 && errno == EINTR) continue;
+
+        if (ready == 0) {
+            if (std::chrono::steady_clock::now() - last_heard < failover_timeout_) continue;
+            break;                                     // Primary went silent
+        }
+
+        ssize_t n = ready > 0 ? ::recv(fd_, buffer + buffered, sizeof(buffer) - buffered, 0) : -1;
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;                             // EOF or socket error
+
+        last_heard = std::chrono::steady_clock::now();
+        buffered += static_cast<size_t>(n);
+
+        const size_t whole = buffered / sizeof(Command);
+        for (size_t i = 0; i < whole; ++i) {
+            Command cmd;
+            std::memcpy(&cmd, buffer + i * sizeof(Command), sizeof(Command));
+            if (cmd.type == CommandType::Heartbeat) continue;
+
+            ErrorCode result = engine_.apply(cmd);
+            if (result == ErrorCode::ChecksumMismatch || result == ErrorCode::SequenceGap) {
+                diverged_.store(true, std::memory_order_release);
+                running_.store(false, std::memory_order_release);
+                break;
+            }
+        }
+
+        buffered -= whole * sizeof(Command);
+        std::memmove(buffer, buffer + whole * sizeof(Command), buffered);
+
+        applied_.store(engine_.last_sequence(), std::memory_order_release);
+        notify_progress();
+    }
+
+    // Leaving the loop without being asked to (promote) means the primary is gone
+    if (running_.load(std::memory_order_acquire)) {
+        failed_.store(true, std::memory_order_release);
+    }
+    notify_progress();
+}
+
+} // namespace orderbook
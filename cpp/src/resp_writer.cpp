@@ -0,0 +1,113 @@
+#include "resp_writer.hpp"
+#include <initializer_list>
+
+namespace orderbook {
+
+namespace {
+
+enum class Parse { Complete, Incomplete, Invalid };
+
+// Errors meaning "not now" rather than "never": the server is loading its
+// dataset, busy running a script, refusing writes after a failed save, or
+// mid-resharding
+bool retryable(std::string_view error) {
+    for (std::string_view code : {"LOADING", "BUSY", "MISCONF", "TRYAGAIN"}) {
+        if (error.size() >= code.size() && error.compare(0, code.size(), code) == 0 &&
+            (error.size() == code.size() || error[code.size()] == ' ')) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Parse one element at `pos`: on Complete, pos is advanced past it
+Parse element(const char* data, size_t end, size_t& pos) {
+    // Every element starts with a type byte and a line ending in \r\n
+    const void* lf = std::memchr(data + pos, '\n', end - pos);
+    if (lf == nullptr) return Parse::Incomplete;
+    const size_t line_end = static_cast<size_t>(static_cast<const char*>(lf) - data) + 1;
+    if (line_end - pos < 3 || data[line_end - 2] != '\r') return Parse::Invalid;
+
+    const char type = data[pos];
+    if (type == '+' || type == '-' || type == ':') {
+        pos = line_end;
+        return Parse::Complete;
+    }
+    if (type != '$' && type != '*') return Parse::Invalid;
+
+    // $<len> / *<count>; -1 is a nil bulk string or array
+    int64_t len = 0;
+    const auto parsed = std::from_chars(data + pos + 1, data + line_end - 2, len);
+    if (parsed.ec != std::errc() || parsed.ptr != data + line_end - 2 || len < -1) {
+        return Parse::Invalid;
+    }
+    size_t p = line_end;
+    if (type == '$') {
+        if (len >= 0) {
+            if (end - p < static_cast<size_t>(len) + 2) return Parse::Incomplete;
+            p += static_cast<size_t>(len) + 2;
+        }
+    } else {
+        for (int64_t i = 0; i < len; ++i) {
+            const Parse r = element(data, end, p);
+            if (r != Parse::Complete) return r;
+        }
+    }
+    pos = p;
+    return Parse::Complete;
+}
+
+} // namespace
+
+size_t RespReplyScanner::feed(const char* data, size_t n) {
+    if (!ok_ || retry_) return 0;
+    size_t replies = 0;
+
+    // Usual case: nothing pending, scan recv()'s buffer in place and keep
+    // only a trailing partial reply
+    if (partial_.empty()) {
+        const size_t used = scan(data, n, replies);
+        if (ok_) partial_.assign(data + used, n - used);
+        return replies;
+    }
+
+    partial_.append(data, n);
+    const size_t used = scan(partial_.data(), partial_.size(), replies);
+    partial_.erase(0, used);
+    return replies;
+}
+
+void RespReplyScanner::reset() {
+    partial_.clear();
+    ok_ = true;
+    retry_ = false;
+}
+
+size_t RespReplyScanner::element_size(const char* data, size_t n) {
+    size_t pos = 0;
+    return n > 0 && element(data, n, pos) == Parse::Complete ? pos : 0;
+}
+
+size_t RespReplyScanner::scan(const char* data, size_t n, size_t& replies) {
+    size_t done = 0;
+    while (ok_ && done < n) {
+        size_t pos = done;
+        const Parse r = element(data, n, pos);
+        if (r == Parse::Invalid) ok_ = false;
+        if (r != Parse::Complete) break;
+        if (data[done] == '-') {
+            last_error_.assign(data + done + 1, pos - done - 3);
+            if (retryable(last_error_)) {
+                retry_ = true;
+                break;
+            }
+            ++errors_;
+        }
+        done = pos;
+        ++replies;
+        ++replies_;
+    }
+    return done;
+}
+
+} // namespace orderbook
@@ -0,0 +1,276 @@
+#include "sequencer.hpp"
+#include "replication.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace orderbook {
+
+namespace {
+
+// FNV-1a over 64-bit words
+constexpr uint64_t CHECKSUM_SEED = 0xcbf29ce484222325ULL;
+constexpr uint64_t CHECKSUM_PRIME = 0x100000001b3ULL;
+
+Timestamp from_nanos(int64_t nanos) {
+    return Timestamp(std::chrono::duration_cast<Timestamp::duration>(
+        std::chrono::nanoseconds(nanos)));
+}
+
+// A symbol that doesn't fit is left out rather than cut: a prefix could name
+// another book. Sequencer::submit rejects the empty symbol.
+void copy_symbol(char (&dest)[Command::SYMBOL_SIZE], const std::string& symbol) {
+    if (symbol.size() > Command::SYMBOL_SIZE) return;
+    std::memcpy(dest, symbol.data(), symbol.size());
+}
+
+} // namespace
+
+// ============================================================================
+// Command
+// ============================================================================
+
+Command Command::add_book(const std::string& symbol) {
+    Command cmd;
+    cmd.type = CommandType::AddBook;
+    copy_symbol(cmd.symbol, symbol);
+    return cmd;
+}
+
+Command Command::new_order(const Order& order) {
+    Command cmd;
+    cmd.type = CommandType::NewOrder;
+    cmd.side = order.side;
+    cmd.order_type = order.type;
+    cmd.time_in_force = order.time_in_force;
+    copy_symbol(cmd.symbol, order.symbol);
+    cmd.order_id = order.id;
+    cmd.price = order.price;
+    cmd.quantity = order.quantity;
+    cmd.time_ns = timestamp_to_nanos(order.expire_time);
+    return cmd;
+}
+
+Command Command::cancel(const std::string& symbol, OrderId order_id) {
+    Command cmd;
+    cmd.type = CommandType::Cancel;
+    copy_symbol(cmd.symbol, symbol);
+    cmd.order_id = order_id;
+    return cmd;
+}
+
+Command Command::tick(Timestamp now) {
+    Command cmd;
+    cmd.type = CommandType::Tick;
+    cmd.time_ns = timestamp_to_nanos(now);
+    return cmd;
+}
+
+std::string Command::symbol_string() const {
+    return std::string(symbol, strnlen(symbol, SYMBOL_SIZE));
+}
+
+// ============================================================================
+// SequencedEngine
+// ============================================================================
+
+SequencedEngine::SequencedEngine()
+    : checksum_(CHECKSUM_SEED)
+{}
+
+ErrorCode SequencedEngine::apply(const Command& cmd, std::vector<Trade>* trades) {
+    if (cmd.type == CommandType::Heartbeat) {
+        return ErrorCode::Success;
+    }
+    if (cmd.seq != last_seq_ + 1) {
+        return ErrorCode::SequenceGap;
+    }
+    last_seq_ = cmd.seq;
+
+    std::vector<Trade>& out = trades ? *trades : scratch_;
+    const size_t first_trade = out.size();
+    ErrorCode result = ErrorCode::Success;
+
+    switch (cmd.type) {
+        case CommandType::AddBook: {
+            // Expiry times come from commands, so the wheel must not depend
+            // on when this replica happened to start
+            OrderBookConfig config;
+            config.expiry_epoch = Timestamp{};
+            index_for(engine_.add_book(cmd.symbol_string(), config));
+            break;
+        }
+
+        case CommandType::NewOrder:
+            result = apply_new_order(cmd, out);
+            break;
+
+        case CommandType::Cancel: {
+            const OrderId id = engine_id(cmd.order_id);
+            result = engine_.cancel_order(cmd.symbol_string(), id);
+            if (result == ErrorCode::Success) {
+                release(*index_of(id), id);
+            }
+            break;
+        }
+
+        case CommandType::Tick:
+            // Release just the orders that expired, not a sweep of every live one
+            expired_.clear();
+            engine_.tick(from_nanos(cmd.time_ns), OrderBook::DEFAULT_EXPIRY_BATCH, &expired_);
+            for (OrderId& id : expired_) {
+                LiveIndex* index = index_of(id);
+                const Live* live = index != nullptr ? index->find(id) : nullptr;
+                if (live == nullptr) continue;
+                const OrderId engine_order = id;
+                id = live->client_id;
+                release(*index, engine_order);
+            }
+            break;
+
+        case CommandType::Checkpoint:
+            // Not folded: the checksum covers trades, not checkpoints
+            if (cmd.checksum != checkpoint_value()) {
+                diverged_ = true;
+                return ErrorCode::ChecksumMismatch;
+            }
+            return ErrorCode::Success;
+
+        case CommandType::Heartbeat:
+            break;
+    }
+
+    fold(cmd.seq);
+    fold(static_cast<uint64_t>(result));
+    for (size_t i = first_trade; i < out.size(); ++i) {
+        fold(out[i]);
+    }
+    if (!trades) scratch_.clear();
+
+    return result;
+}
+
+ErrorCode SequencedEngine::apply_new_order(const Command& cmd, std::vector<Trade>& trades) {
+    if (engine_ids_.count(cmd.order_id)) {
+        return ErrorCode::DuplicateOrderId;
+    }
+    OrderBook* book = engine_.book(cmd.symbol_string());
+    if (book == nullptr) {
+        return ErrorCode::BookNotFound;
+    }
+
+    auto order = std::make_unique<Order>(book->next_order_id(), cmd.symbol_string(), cmd.side,
+                                         cmd.order_type, cmd.quantity, cmd.price);
+    order->time_in_force = cmd.time_in_force;
+    order->expire_time = from_nanos(cmd.time_ns);
+
+    auto fills = engine_.add_order(order.get());
+
+    // Back to client ids. Resting orders this one filled completely are off
+    // the book now.
+    LiveIndex& index = index_for(*book);
+    for (Trade& trade : fills) {
+        const OrderId passive = trade.passive_order_id();
+        Live* resting = index.find(passive);
+        const OrderId passive_client = resting != nullptr ? resting->client_id : passive;
+        if (resting != nullptr && !resting->order->is_active()) {
+            release(index, passive);
+        }
+        trade.buy_order_id = trade.aggressor_side == Side::Buy ? cmd.order_id : passive_client;
+        trade.sell_order_id = trade.aggressor_side == Side::Sell ? cmd.order_id : passive_client;
+    }
+    trades.insert(trades.end(), fills.begin(), fills.end());
+
+    if (order->status == OrderStatus::Rejected) {
+        ErrorCode reason = validate_order(*order);
+        return reason != ErrorCode::Success ? reason : ErrorCode::InvalidPrice;  // Tick / band
+    }
+    if (order->is_active() && order->is_limit()) {
+        const OrderId id = order->id;
+        Live& live = *index.try_emplace(id).first;
+        live.order = std::move(order);
+        live.client_id = cmd.order_id;
+        engine_ids_.emplace(cmd.order_id, id);
+    }
+    return ErrorCode::Success;
+}
+
+OrderId SequencedEngine::engine_id(OrderId client_id) const noexcept {
+    auto it = engine_ids_.find(client_id);
+    return it != engine_ids_.end() ? it->second : INVALID_ORDER_ID;
+}
+
+SequencedEngine::LiveIndex& SequencedEngine::index_for(const OrderBook& book) {
+    const size_t slot = static_cast<size_t>(book.config().id_base >> MatchingEngine::BOOK_ID_BITS);
+    if (slot >= live_.size()) {
+        live_.resize(slot + 1);
+    }
+    if (live_[slot] == nullptr) {
+        live_[slot] = std::make_unique<LiveIndex>();
+    }
+    return *live_[slot];
+}
+
+SequencedEngine::LiveIndex* SequencedEngine::index_of(OrderId engine_id) noexcept {
+    const uint64_t slot = engine_id >> MatchingEngine::BOOK_ID_BITS;
+    return slot < live_.size() ? live_[slot].get() : nullptr;
+}
+
+void SequencedEngine::release(LiveIndex& index, OrderId engine_id) {
+    engine_ids_.erase(index.find(engine_id)->client_id);
+    index.erase(engine_id);
+}
+
+uint64_t SequencedEngine::checkpoint_value() const noexcept {
+    return checksum_ ^ mix64(engine_.state_checksum());
+}
+
+void SequencedEngine::fold(uint64_t value) noexcept {
+    checksum_ = (checksum_ ^ value) * CHECKSUM_PRIME;
+}
+
+void SequencedEngine::fold(const Trade& trade) noexcept {
+    fold(trade.id);
+    fold(trade.buy_order_id);
+    fold(trade.sell_order_id);
+    fold(static_cast<uint64_t>(trade.price));
+    fold(trade.quantity);
+    fold(static_cast<uint64_t>(trade.aggressor_side));
+}
+
+// ============================================================================
+// Sequencer
+// ============================================================================
+
+Sequencer::Sequencer(SequencedEngine& engine, ReplicationPrimary* link,
+                     size_t checkpoint_interval)
+    : engine_(engine)
+    , link_(link)
+    , checkpoint_interval_(std::max<size_t>(checkpoint_interval, 1))
+{}
+
+ErrorCode Sequencer::submit(Command cmd, std::vector<Trade>* trades) {
+    const bool names_book = cmd.type == CommandType::AddBook ||
+                            cmd.type == CommandType::NewOrder ||
+                            cmd.type == CommandType::Cancel;
+    if (names_book && cmd.symbol[0] == '\0') {
+        return ErrorCode::InvalidSymbol;
+    }
+    if (++since_checkpoint_ > checkpoint_interval_) {
+        Command checkpoint;
+        checkpoint.type = CommandType::Checkpoint;
+        checkpoint.checksum = engine_.checkpoint_value();
+        sequence(checkpoint, nullptr);
+        since_checkpoint_ = 1;
+    }
+    return sequence(cmd, trades);
+}
+
+ErrorCode Sequencer::sequence(Command& cmd, std::vector<Trade>* trades) {
+    cmd.seq = engine_.last_sequence() + 1;
+    if (link_ != nullptr) {
+        link_->replicate(cmd);
+    }
+    return engine_.apply(cmd, trades);
+}
+
+} // namespace orderbook
@@ -0,0 +1,42 @@
+#include "tick_size.hpp"
+
+namespace orderbook {
+
+// Precompute the reciprocal (libdivide's u64 "branchfull" generator).
+//
+// For a non-power-of-two d with L = floor(log2(d)):
+//   m = floor(2^(64+L) / d); if the rounding error is small enough, magic = m + 1
+//   and index = mulhi(n, magic) >> L. Otherwise the true magic needs 65 bits: we
+//   store its low 64 bits and recover the top bit with the (n - q) / 2 + q step.
+TickSize::TickSize(Price tick) noexcept
+    : tick_(tick > 0 ? static_cast<uint64_t>(tick) : 1)
+{
+    const uint64_t d = tick_;
+    const uint8_t floor_log2 = static_cast<uint8_t>(63 - __builtin_clzll(d));
+
+    if ((d & (d - 1)) == 0) {
+        magic_ = 0;
+        shift_ = floor_log2;
+        return;
+    }
+
+    const unsigned __int128 numerator = static_cast<unsigned __int128>(1) << (64 + floor_log2);
+    uint64_t proposed = static_cast<uint64_t>(numerator / d);
+    const uint64_t remainder = static_cast<uint64_t>(numerator % d);
+    const uint64_t error = d - remainder;
+
+    if (error < (uint64_t{1} << floor_log2)) {
+        add_ = false;
+    } else {
+        proposed += proposed;
+        const uint64_t twice_remainder = remainder + remainder;
+        if (twice_remainder >= d || twice_remainder < remainder) {
+            proposed += 1;
+        }
+        add_ = true;
+    }
+    magic_ = proposed + 1;
+    shift_ = floor_log2;
+}
+
+} // namespace orderbook
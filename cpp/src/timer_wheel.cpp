@@ -0,0 +1,185 @@
+#include "timer_wheel.hpp"
+#include <algorithm>
+
+namespace orderbook {
+
+// ============================================================================
+// Constructors
+// ============================================================================
+
+TimerWheel::TimerWheel(Timestamp start, std::chrono::nanoseconds resolution)
+    : heads_(LEVELS * SLOTS + 1, nullptr)
+    , origin_ns_(timestamp_to_nanos(start))
+    , resolution_ns_(std::max<int64_t>(1, resolution.count()))
+{}
+
+// ============================================================================
+// Scheduling
+// ============================================================================
+
+void TimerWheel::schedule(TimerNode& node, Timestamp deadline) {
+    if (node.linked()) {
+        unlink(node);
+    }
+    node.deadline = deadline_tick(deadline);
+    place(node);
+}
+
+void TimerWheel::cancel(TimerNode& node) noexcept {
+    if (node.linked()) {
+        unlink(node);
+    }
+}
+
+// ============================================================================
+// Advancing Time
+// ============================================================================
+
+void TimerWheel::advance(Timestamp now) {
+    if (timestamp_to_nanos(now) < origin_ns_) return;
+    const uint64_t target = floor_tick(now);
+
+    while (current_ <= target) {
+        if (size_ == due_count_) {
+            // Nothing left in the wheel: jump straight to the target
+            current_ = target + 1;
+            break;
+        }
+
+        const uint64_t index = current_ & SLOT_MASK;
+        if (index == 0) {
+            // Level 0 wrapped: pull the next slot of each higher level down.
+            // Level L+1 only cascades when level L itself wrapped.
+            for (uint32_t level = 1; level < LEVELS; ++level) {
+                cascade(level);
+                if (((current_ >> (SLOT_BITS * level)) & SLOT_MASK) != 0) break;
+            }
+        }
+        expire_slot(static_cast<uint32_t>(index));
+        ++current_;
+
+        // Fast-forward over stretches where the lower levels are empty.
+        // Only the next boundary of the lowest non-empty level can do anything.
+        if (level_count_[0] == 0) {
+            uint32_t level = 1;
+            while (level < LEVELS && level_count_[level] == 0) ++level;
+            if (level == LEVELS) {
+                current_ = std::max(current_, target + 1);
+                break;
+            }
+            const uint64_t span = uint64_t{1} << (SLOT_BITS * level);
+            if ((current_ & (span - 1)) != 0) {
+                current_ = std::min((current_ | (span - 1)) + 1, target + 1);
+            }
+        }
+    }
+}
+
+TimerNode* TimerWheel::pop_due() noexcept {
+    TimerNode* node = heads_[DUE_SLOT];
+    if (node != nullptr) {
+        unlink(*node);
+    }
+    return node;
+}
+
+// ============================================================================
+// Internals
+// ============================================================================
+
+uint64_t TimerWheel::deadline_tick(Timestamp ts) const noexcept {
+    // Round up: an order must never expire before its deadline
+    int64_t ns = timestamp_to_nanos(ts) - origin_ns_;
+    if (ns <= 0) return 0;
+    return static_cast<uint64_t>((ns + resolution_ns_ - 1) / resolution_ns_);
+}
+
+uint64_t TimerWheel::floor_tick(Timestamp ts) const noexcept {
+    int64_t ns = timestamp_to_nanos(ts) - origin_ns_;
+    if (ns <= 0) return 0;
+    return static_cast<uint64_t>(ns / resolution_ns_);
+}
+
+void TimerWheel::place(TimerNode& node) noexcept {
+    if (node.deadline < current_) {
+        link(node, DUE_SLOT);
+        return;
+    }
+
+    // Deadlines beyond the wheel's reach are parked at the furthest slot and
+    // re-placed (using the real deadline) once they cascade down.
+    constexpr uint64_t MAX_DELTA = (uint64_t{1} << (SLOT_BITS * LEVELS)) - 1;
+    uint64_t delta = node.deadline - current_;
+    uint64_t target = node.deadline;
+    if (delta > MAX_DELTA) {
+        delta = MAX_DELTA;
+        target = current_ + MAX_DELTA;
+    }
+
+    uint32_t level = 0;
+    while (level + 1 < LEVELS && (delta >> (SLOT_BITS * (level + 1))) != 0) {
+        ++level;
+    }
+    const uint64_t index = (target >> (SLOT_BITS * level)) & SLOT_MASK;
+    link(node, level * SLOTS + static_cast<uint32_t>(index));
+}
+
+void TimerWheel::link(TimerNode& node, uint32_t slot) noexcept {
+    TimerNode*& head = heads_[slot];
+    node.prev = nullptr;
+    node.next = head;
+    if (head != nullptr) head->prev = &node;
+    head = &node;
+    node.slot = slot;
+
+    if (slot == DUE_SLOT) {
+        ++due_count_;
+    } else {
+        ++level_count_[slot / SLOTS];
+    }
+    ++size_;
+}
+
+void TimerWheel::unlink(TimerNode& node) noexcept {
+    if (node.prev != nullptr) {
+        node.prev->next = node.next;
+    } else {
+        heads_[node.slot] = node.next;
+    }
+    if (node.next != nullptr) {
+        node.next->prev = node.prev;
+    }
+
+    if (node.slot == DUE_SLOT) {
+        --due_count_;
+    } else {
+        --level_count_[node.slot / SLOTS];
+    }
+    --size_;
+
+    node.prev = nullptr;
+    node.next = nullptr;
+    node.slot = UINT32_MAX;
+}
+
+void TimerWheel::cascade(uint32_t level) noexcept {
+    const uint64_t index = (current_ >> (SLOT_BITS * level)) & SLOT_MASK;
+    const uint32_t slot = level * SLOTS + static_cast<uint32_t>(index);
+    while (TimerNode* node = heads_[slot]) {
+        unlink(*node);
+        place(*node);
+    }
+}
+
+void TimerWheel::expire_slot(uint32_t index) noexcept {
+    while (TimerNode* node = heads_[index]) {
+        unlink(*node);
+        if (node->deadline > current_) {
+            place(*node);  // Was parked beyond the wheel's reach
+        } else {
+            link(*node, DUE_SLOT);
+        }
+    }
+}
+
+} // namespace orderbook
@@ -0,0 +1,302 @@
+#include "trade_store.hpp"
+#include "order_book.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace orderbook {
+
+namespace {
+
+constexpr uint64_t DAY_MAGIC = 0x314544415254424FULL;   // "OBTRADE1" little-endian
+constexpr uint32_t DAY_VERSION = 1;
+
+// First page of every day directory's `header` file
+struct DayHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t index_stride;
+    uint64_t capacity;                // Rows every column file has room for
+    uint64_t count;                   // Complete rows; stored with release
+    int64_t last_timestamp_ns;        // Keeps the timestamp column sorted
+};
+
+// One file mapped whole; unmapped and closed on destruction
+class Mapping {
+public:
+    Mapping() = default;
+    Mapping(const Mapping&) = delete;
+    Mapping& operator=(const Mapping&) = delete;
+    ~Mapping() {
+        if (data_ != nullptr) munmap(data_, bytes_);
+        if (fd_ >= 0) close(fd_);
+    }
+
+    // Writable: create or extend the file to `bytes` (sparse) and map it
+    // read-write. Otherwise map whatever is there, read-only.
+    bool open(const std::string& path, size_t bytes, bool writable) {
+        fd_ = ::open(path.c_str(), writable ? (O_RDWR | O_CREAT) : O_RDONLY, 0644);
+        if (fd_ < 0) return false;
+        struct stat st {};
+        if (fstat(fd_, &st) != 0) return false;
+        created_ = st.st_size == 0;
+        if (writable && static_cast<size_t>(st.st_size) < bytes) {
+            if (ftruncate(fd_, static_cast<off_t>(bytes)) != 0) return false;
+        } else {
+            bytes = static_cast<size_t>(st.st_size);
+        }
+        if (bytes == 0) return false;
+        void* data = mmap(nullptr, bytes, writable ? (PROT_READ | PROT_WRITE) : PROT_READ,
+                          MAP_SHARED, fd_, 0);
+        if (data == MAP_FAILED) return false;
+        data_ = data;
+        bytes_ = bytes;
+        return true;
+    }
+
+    bool sync() const noexcept { return data_ == nullptr || msync(data_, bytes_, MS_SYNC) == 0; }
+
+    template <typename T>
+    T* as() const noexcept { return static_cast<T*>(data_); }
+    size_t bytes() const noexcept { return bytes_; }
+    bool created() const noexcept { return created_; }   // Was empty when opened
+
+private:
+    int fd_ = -1;
+    void* data_ = nullptr;
+    size_t bytes_ = 0;
+    bool created_ = false;
+};
+
+// Days since 1970-01-01 -> civil date (H. Hinnant's days_from_civil inverse)
+void civil_from_days(int64_t z, int64_t& y, unsigned& m, unsigned& d) noexcept {
+    z += 719468;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp < 10 ? mp + 3 : mp - 9;
+    y = static_cast<int64_t>(yoe) + era * 400 + (m <= 2);
+}
+
+int64_t floor_div(int64_t a, int64_t b) noexcept {
+    return a / b - ((a % b != 0) && ((a < 0) != (b < 0)));
+}
+
+// Directory name of a symbol: '/', '%', NUL and a leading '.' are
+// percent-encoded, so the name stays one path component below the root
+std::string symbol_dir(const std::string& symbol) {
+    std::string dir;
+    dir.reserve(symbol.size());
+    for (size_t i = 0; i < symbol.size(); ++i) {
+        const char c = symbol[i];
+        if (c == '/' || c == '%' || c == '\0' || (i == 0 && c == '.')) {
+            char buf[4];
+            std::snprintf(buf, sizeof buf, "%%%02X", static_cast<unsigned char>(c));
+            dir += buf;
+        } else {
+            dir += c;
+        }
+    }
+    return dir;
+}
+
+} // namespace
+
+// ============================================================================
+// DayFile: the mapped columns of one instrument-day
+// ============================================================================
+
+class TradeStore::DayFile {
+public:
+    DayFile(std::string symbol, int64_t day) : symbol_(std::move(symbol)), day_(day) {}
+
+    bool open(const std::string& dir, size_t capacity, bool writable) {
+        if (!header_.open(dir + "/header", sizeof(DayHeader), writable)) return false;
+        if (header_.bytes() < sizeof(DayHeader)) return false;
+        DayHeader* h = header();
+        if (header_.created()) {
+            h->magic = DAY_MAGIC;
+            h->version = DAY_VERSION;
+            h->index_stride = INDEX_STRIDE;
+            h->capacity = capacity;
+            h->count = 0;
+            h->last_timestamp_ns = 0;
+        } else if (h->magic != DAY_MAGIC || h->version != DAY_VERSION ||
+                   h->index_stride != INDEX_STRIDE) {
+            return false;
+        }
+        const size_t rows = static_cast<size_t>(h->capacity);
+        return timestamps_.open(dir + "/timestamp_ns", rows * sizeof(int64_t), writable) &&
+               prices_.open(dir + "/price", rows * sizeof(Price), writable) &&
+               quantities_.open(dir + "/quantity", rows * sizeof(uint32_t), writable) &&
+               sides_.open(dir + "/side", rows * sizeof(Side), writable) &&
+               index_.open(dir + "/index", (rows / INDEX_STRIDE + 1) * sizeof(int64_t), writable) &&
+               timestamps_.bytes() >= rows * sizeof(int64_t) &&
+               prices_.bytes() >= rows * sizeof(Price) &&
+               quantities_.bytes() >= rows * sizeof(uint32_t) &&
+               sides_.bytes() >= rows * sizeof(Side);
+    }
+
+    const std::string& symbol() const noexcept { return symbol_; }
+    int64_t day() const noexcept { return day_; }
+
+    size_t size() const noexcept {
+        return static_cast<size_t>(__atomic_load_n(&header()->count, __ATOMIC_ACQUIRE));
+    }
+
+    bool append(int64_t timestamp_ns, Price price, uint32_t quantity, Side side) noexcept {
+        DayHeader* h = header();
+        const uint64_t row = h->count;
+        if (row >= h->capacity) return false;
+        timestamp_ns = std::max(timestamp_ns, h->last_timestamp_ns);
+        timestamps_.as<int64_t>()[row] = timestamp_ns;
+        prices_.as<Price>()[row] = price;
+        quantities_.as<uint32_t>()[row] = quantity;
+        sides_.as<Side>()[row] = side;
+        if (row % INDEX_STRIDE == 0) {
+            index_.as<int64_t>()[row / INDEX_STRIDE] = timestamp_ns;
+        }
+        h->last_timestamp_ns = timestamp_ns;
+        __atomic_store_n(&h->count, row + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    TradeColumns slice(int64_t from_ns, int64_t to_ns) const noexcept {
+        const size_t n = size();
+        const size_t begin = first_at_or_after(from_ns, n);
+        const size_t end = std::max(begin, first_at_or_after(to_ns, n));
+        TradeColumns columns;
+        columns.day = day_;
+        columns.timestamp_ns = timestamps_.as<const int64_t>() + begin;
+        columns.price = prices_.as<const Price>() + begin;
+        columns.quantity = quantities_.as<const uint32_t>() + begin;
+        columns.side = sides_.as<const Side>() + begin;
+        columns.size = end - begin;
+        return columns;
+    }
+
+    bool sync() const noexcept {
+        return timestamps_.sync() && prices_.sync() && quantities_.sync() && sides_.sync() &&
+               index_.sync() && header_.sync();
+    }
+
+private:
+    DayHeader* header() const noexcept { return header_.as<DayHeader>(); }
+
+    // First row (of n) with timestamp >= t: the index narrows it to one
+    // stride, then a binary search within it
+    size_t first_at_or_after(int64_t t, size_t n) const noexcept {
+        const int64_t* index = index_.as<const int64_t>();
+        const int64_t* ts = timestamps_.as<const int64_t>();
+        const size_t blocks = (n + INDEX_STRIDE - 1) / INDEX_STRIDE;
+        const size_t b = static_cast<size_t>(std::lower_bound(index, index + blocks, t) - index);
+        if (b == 0) return 0;
+        const size_t lo = (b - 1) * INDEX_STRIDE;
+        const size_t hi = std::min(b * INDEX_STRIDE, n);
+        return static_cast<size_t>(std::lower_bound(ts + lo, ts + hi, t) - ts);
+    }
+
+    std::string symbol_;
+    int64_t day_;
+    Mapping header_;
+    Mapping timestamps_;
+    Mapping prices_;
+    Mapping quantities_;
+    Mapping sides_;
+    Mapping index_;
+};
+
+// ============================================================================
+// TradeStore
+// ============================================================================
+
+TradeStore::TradeStore(std::string root, bool read_only, size_t day_capacity)
+    : root_(std::move(root))
+    , read_only_(read_only)
+    , day_capacity_(std::max<size_t>(day_capacity, 1))
+    , clock_offset_ns_(wall_clock_offset_ns())
+{}
+
+TradeStore::~TradeStore() = default;
+
+std::string TradeStore::day_name(int64_t day) {
+    int64_t y;
+    unsigned m, d;
+    civil_from_days(day, y, m, d);
+    char buf[32];
+    std::snprintf(buf, sizeof buf, "%04lld-%02u-%02u", static_cast<long long>(y), m, d);
+    return buf;
+}
+
+TradeStore::DayFile* TradeStore::day_file(const std::string& symbol, int64_t day, bool create) {
+    auto key = std::make_pair(symbol, day);
+    auto it = days_.find(key);
+    if (it != days_.end()) return it->second.get();
+
+    if (symbol.empty()) return nullptr;
+    const std::string dir = root_ + "/" + symbol_dir(symbol) + "/" + day_name(day);
+    std::error_code ec;
+    if (!std::filesystem::exists(dir + "/header", ec)) {
+        if (!create || read_only_) return nullptr;
+        std::filesystem::create_directories(dir, ec);
+        if (ec) return nullptr;
+    }
+    auto file = std::make_unique<DayFile>(symbol, day);
+    if (!file->open(dir, day_capacity_, !read_only_)) return nullptr;
+    return days_.emplace(std::move(key), std::move(file)).first->second.get();
+}
+
+void TradeStore::on_trades(const OrderBook& book, const TradeRecord* records, size_t count) {
+    append(book.symbol(), records, count);
+}
+
+size_t TradeStore::append(const std::string& symbol, const TradeRecord* records, size_t count) {
+    if (read_only_) {
+        dropped_ += count;
+        return 0;
+    }
+    size_t stored = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const TradeRecord& r = records[i];
+        const int64_t wall = wall_time(r.timestamp_ns);
+        const int64_t day = floor_div(wall, NANOS_PER_DAY);
+        if (last_ == nullptr || last_->day() != day || last_->symbol() != symbol) {
+            last_ = day_file(symbol, day, true);
+            if (last_ == nullptr) continue;
+        }
+        stored += last_->append(wall, r.price, r.quantity, r.aggressor_side);
+    }
+    dropped_ += count - stored;
+    return stored;
+}
+
+std::vector<TradeColumns> TradeStore::query(const std::string& symbol, int64_t from_ns, int64_t to_ns) {
+    std::vector<TradeColumns> slices;
+    if (to_ns <= from_ns) return slices;
+    const int64_t last_day = floor_div(to_ns - 1, NANOS_PER_DAY);
+    for (int64_t day = floor_div(from_ns, NANOS_PER_DAY); day <= last_day; ++day) {
+        DayFile* file = day_file(symbol, day, false);
+        if (file == nullptr) continue;
+        TradeColumns columns = file->slice(from_ns, to_ns);
+        if (columns.size > 0) slices.push_back(columns);
+    }
+    return slices;
+}
+
+bool TradeStore::flush() {
+    bool ok = true;
+    for (const auto& [key, file] : days_) {
+        ok = file->sync() && ok;
+    }
+    return ok;
+}
+
+} // namespace orderbook
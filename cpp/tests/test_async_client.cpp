@@ -0,0 +1,246 @@
+#include <gtest/gtest.h>
+#include "async_client.hpp"
+#include <vector>
+
+using namespace orderbook;
+
+// ============================================================================
+// Test Fixture
+// An AsyncEngine over one AAPL book. The book is created synchronously before
+// the engine thread starts.
+// ============================================================================
+
+class AsyncClientTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        sequencer.submit(Command::add_book("AAPL"));
+    }
+
+    Command limit(OrderId id, Side side, Quantity qty, double price) {
+        return Command::new_order(Order(id, "AAPL", side, OrderType::Limit, qty, price_to_fixed(price)));
+    }
+
+    SequencedEngine engine;
+    Sequencer sequencer{engine};
+    AsyncEngine async{sequencer};
+};
+
+// ============================================================================
+// Callbacks and futures
+// ============================================================================
+
+TEST_F(AsyncClientTest, CallbackReceivesAckWithFills) {
+    AsyncClient& client = async.connect(16);
+    async.start();
+
+    std::vector<OrderAck> acks;
+    auto record = [&](const OrderAck& ack) { acks.push_back(ack); };
+    ASSERT_TRUE(client.submit(limit(1, Side::Sell, 100, 101.0), record));
+    ASSERT_TRUE(client.submit(limit(2, Side::Buy, 60, 101.0), record));
+
+    while (acks.size() < 2) client.wait();
+
+    EXPECT_EQ(acks[0].order_id, 1u);
+    EXPECT_EQ(acks[0].result, ErrorCode::Success);
+    EXPECT_EQ(acks[0].filled_quantity, 0u);
+
+    EXPECT_EQ(acks[1].order_id, 2u);
+    EXPECT_EQ(acks[1].filled_quantity, 60u);
+    EXPECT_EQ(acks[1].trade_count, 1u);
+    EXPECT_EQ(acks[1].notional, price_to_fixed(101.0) * 60);
+    EXPECT_EQ(acks[1].seq, acks[0].seq + 1);
+    EXPECT_EQ(client.in_flight(), 0u);
+}
+
+TEST_F(AsyncClientTest, FutureResolvesOnGet) {
+    AsyncClient& client = async.connect(16);
+    async.start();
+
+    AckFuture rest = client.submit(limit(1, Side::Buy, 10, 99.0));
+    AckFuture bad = client.submit(limit(2, Side::Buy, 0, 99.0));
+    ASSERT_TRUE(rest.valid());
+
+    OrderAck ack = rest.get();
+    EXPECT_FALSE(rest.valid());
+    EXPECT_EQ(ack.result, ErrorCode::Success);
+    EXPECT_EQ(bad.get().result, ErrorCode::InvalidQuantity);
+    EXPECT_EQ(client.in_flight(), 0u);
+}
+
+TEST_F(AsyncClientTest, DroppedFutureReleasesItsSlot) {
+    AsyncClient& client = async.connect(4);
+    async.start();
+
+    for (OrderId id = 1; id <= 4; ++id) {
+        client.submit(limit(id, Side::Buy, 10, 90.0));    // Future discarded at once
+    }
+    while (client.in_flight() > 0) client.wait();
+
+    AckFuture f = client.submit(limit(5, Side::Buy, 10, 90.0));
+    EXPECT_EQ(f.get().order_id, 5u);
+}
+
+TEST_F(AsyncClientTest, StopRejectsWhatItDidNotServe) {
+    AsyncClient& client = async.connect(4);
+    async.start();
+    AckFuture applied = client.submit(limit(1, Side::Buy, 10, 99.0));
+    while (!applied.ready()) client.wait();
+    async.stop();
+
+    // Already acked before the stop: delivered as usual
+    EXPECT_EQ(applied.get().result, ErrorCode::Success);
+
+    // Queued while the engine isn't running, then stopped: never applied
+    std::vector<OrderAck> acks;
+    ASSERT_TRUE(client.submit(limit(2, Side::Buy, 10, 99.0), [&](const OrderAck& ack) { acks.push_back(ack); }));
+    AckFuture queued = client.submit(limit(3, Side::Buy, 10, 99.0));
+    async.stop();
+    EXPECT_EQ(queued.get().result, ErrorCode::EngineStopped);
+    client.poll();
+    ASSERT_EQ(acks.size(), 1u);
+    EXPECT_EQ(acks[0].result, ErrorCode::EngineStopped);
+    EXPECT_EQ(client.in_flight(), 0u);
+
+    // ...and a later start doesn't apply them after all
+    async.start();
+    async.stop();
+    EXPECT_EQ(engine.live_orders(), 1u);
+}
+
+TEST_F(AsyncClientTest, GetWhileStoppedLeavesTheFuturePending) {
+    AsyncClient& client = async.connect(4);
+
+    AckFuture pending = client.submit(limit(1, Side::Buy, 10, 99.0));
+    EXPECT_EQ(pending.get().result, ErrorCode::AckPending);
+    EXPECT_TRUE(pending.valid());                  // Still owns its slot
+    EXPECT_EQ(client.in_flight(), 1u);
+
+    // A started engine applies it, and the same future gets the real ack
+    async.start();
+    EXPECT_EQ(pending.get().result, ErrorCode::Success);
+    EXPECT_FALSE(pending.valid());
+    EXPECT_EQ(client.in_flight(), 0u);
+    EXPECT_EQ(engine.live_orders(), 1u);
+}
+
+TEST_F(AsyncClientTest, UnsequencedCommandAcksWithoutASequence) {
+    AsyncClient& client = async.connect(4);
+    async.start();
+    EXPECT_NE(client.submit(limit(1, Side::Buy, 10, 99.0)).get().seq, 0u);
+
+    Command nameless = limit(2, Side::Buy, 10, 99.0);
+    nameless.symbol[0] = '\0';
+    const OrderAck ack = client.submit(nameless).get();
+    EXPECT_EQ(ack.result, ErrorCode::InvalidSymbol);
+    EXPECT_EQ(ack.seq, 0u);
+}
+
+TEST_F(AsyncClientTest, CallbackSubmitRefusesBeyondInFlightLimit) {
+    AsyncClient& client = async.connect(2);   // Engine not started: nothing completes
+
+    auto ignore = [](const OrderAck&) {};
+    EXPECT_TRUE(client.submit(limit(1, Side::Buy, 10, 99.0), ignore));
+    EXPECT_TRUE(client.submit(limit(2, Side::Buy, 10, 99.0), ignore));
+    EXPECT_FALSE(client.submit(limit(3, Side::Buy, 10, 99.0), ignore));
+    EXPECT_EQ(client.in_flight(), 2u);
+
+    async.start();
+    while (client.in_flight() > 0) client.wait();
+    EXPECT_TRUE(client.submit(limit(3, Side::Buy, 10, 99.0), ignore));
+}
+
+// ============================================================================
+// Many in-flight orders, several clients
+// ============================================================================
+
+TEST_F(AsyncClientTest, ThousandsInFlightFromOneThread) {
+    AsyncClient& client = async.connect(1024);
+    async.start();
+
+    constexpr OrderId ORDERS = 20'000;
+    size_t acked = 0;
+    SequenceNumber last_seq = 0;
+    bool ordered = true;
+    auto on_ack = [&](const OrderAck& ack) {
+        ordered = ordered && ack.seq > last_seq;
+        last_seq = ack.seq;
+        ++acked;
+    };
+
+    for (OrderId id = 1; id <= ORDERS; ++id) {
+        Side side = (id % 2) ? Side::Buy : Side::Sell;
+        while (!client.submit(limit(id, side, 10, 100.0), on_ack)) {
+            client.wait();
+        }
+    }
+    while (acked < ORDERS) client.wait();
+
+    EXPECT_TRUE(ordered);
+    async.stop();
+    EXPECT_EQ(engine.engine().book("AAPL")->order_count(), 0u);   // Every pair crossed
+}
+
+TEST_F(AsyncClientTest, ClientsAreServedIndependently) {
+    AsyncClient& a = async.connect(64);
+    AsyncClient& b = async.connect(64);
+    async.start();
+
+    AckFuture fa = a.submit(limit(1, Side::Sell, 10, 100.0));
+    AckFuture fb = b.submit(limit(2, Side::Buy, 10, 100.0));
+
+    EXPECT_EQ(fa.get().result, ErrorCode::Success);
+    OrderAck ack_b = fb.get();
+    EXPECT_NE(ack_b.seq, 0u);
+    async.stop();
+    EXPECT_EQ(sequencer.last_sequence(), 3u);
+}
+
+// ============================================================================
+// Passive fills
+// ============================================================================
+
+TEST_F(AsyncClientTest, PassiveFillsReachTheOwningClient) {
+    AsyncClient& maker = async.connect(16);
+    AsyncClient& taker = async.connect(16);
+    std::vector<FillEvent> maker_fills;
+    std::vector<FillEvent> taker_fills;
+    maker.on_fill([&](const FillEvent& f) { maker_fills.push_back(f); });
+    taker.on_fill([&](const FillEvent& f) { taker_fills.push_back(f); });
+    async.start();
+
+    EXPECT_EQ(maker.submit(limit(1, Side::Sell, 100, 101.0)).get().filled_quantity, 0u);
+    OrderAck first = taker.submit(limit(2, Side::Buy, 60, 101.0)).get();
+    EXPECT_EQ(first.filled_quantity, 60u);                 // Aggressive fill: on the ack
+    taker.submit(limit(3, Side::Buy, 40, 102.0)).get();
+
+    while (maker_fills.size() < 2) maker.wait();
+    EXPECT_EQ(maker_fills[0].order_id, 1u);
+    EXPECT_EQ(maker_fills[0].quantity, 60u);
+    EXPECT_EQ(maker_fills[0].leaves_quantity, 40u);
+    EXPECT_EQ(maker_fills[0].seq, first.seq);
+    EXPECT_EQ(maker_fills[0].price, price_to_fixed(101.0));
+    EXPECT_EQ(maker_fills[1].quantity, 40u);
+    EXPECT_EQ(maker_fills[1].leaves_quantity, 0u);
+    taker.poll();
+    EXPECT_TRUE(taker_fills.empty());
+}
+
+TEST_F(AsyncClientTest, FillsBeyondTheRingWaitForTheClient) {
+    AsyncClient& maker = async.connect(16, 4);             // Ring: 16 acks + 4 fills
+    AsyncClient& taker = async.connect(1024);
+    std::vector<FillEvent> fills;
+    maker.on_fill([&](const FillEvent& f) { fills.push_back(f); });
+    async.start();
+
+    maker.submit(limit(1, Side::Sell, 1'000, 101.0)).get();
+    size_t acked = 0;
+    for (OrderId id = 2; id < 202; ++id) {                 // Maker isn't polling meanwhile
+        ASSERT_TRUE(taker.submit(limit(id, Side::Buy, 1, 101.0), [&](const OrderAck&) { ++acked; }));
+    }
+    while (acked < 200) taker.wait();
+
+    while (fills.size() < 200) maker.wait();
+    for (size_t i = 0; i < fills.size(); ++i) {
+        EXPECT_EQ(fills[i].leaves_quantity, 1'000u - i - 1);
+    }
+}
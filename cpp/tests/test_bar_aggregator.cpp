@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+#include "bar_aggregator.hpp"
+#include "matching_engine.hpp"
+#include <deque>
+
+using namespace orderbook;
+
+// ============================================================================
+// Test Fixture
+// Collects every closed bar. Times are wall-clock nanoseconds from T0, an
+// hour boundary.
+// ============================================================================
+
+class BarAggregatorTest : public ::testing::Test, public BarListener {
+protected:
+    static constexpr int64_t SEC = BAR_INTERVAL_NS[0];
+    static constexpr int64_t MIN = BAR_INTERVAL_NS[1];
+    static constexpr int64_t HOUR = BAR_INTERVAL_NS[2];
+    static constexpr int64_t T0 = 19724 * 24 * HOUR;        // 2024-01-02 00:00 UTC
+
+    void SetUp() override { bars.add_listener(this); }
+
+    void on_bar(const std::string& symbol, const Bar& bar) override {
+        closed.push_back({symbol, bar});
+    }
+
+    std::vector<const Bar*> closed_of(BarInterval interval) const {
+        std::vector<const Bar*> out;
+        for (const auto& [symbol, bar] : closed) {
+            if (bar.interval == interval) out.push_back(&bar);
+        }
+        return out;
+    }
+
+    BarAggregator bars;
+    std::vector<std::pair<std::string, Bar>> closed;
+};
+
+// ============================================================================
+// Building bars
+// ============================================================================
+
+TEST_F(BarAggregatorTest, OpenBarTracksOhlcv) {
+    bars.add("AAPL", T0 + 100, 1'000, 10);
+    bars.add("AAPL", T0 + 200, 1'030, 20);
+    bars.add("AAPL", T0 + 300, 990, 5);
+    bars.add("AAPL", T0 + 400, 1'010, 15);
+
+    const Bar* bar = bars.current("AAPL", BarInterval::Second);
+    ASSERT_NE(bar, nullptr);
+    EXPECT_EQ(bar->start_ns, T0);
+    EXPECT_EQ(bar->end_ns(), T0 + SEC);
+    EXPECT_EQ(bar->open, 1'000);
+    EXPECT_EQ(bar->high, 1'030);
+    EXPECT_EQ(bar->low, 990);
+    EXPECT_EQ(bar->close, 1'010);
+    EXPECT_EQ(bar->volume, 50u);
+    EXPECT_EQ(bar->trades, 4u);
+    // (10000 + 20600 + 4950 + 15150) / 50 = 1014
+    EXPECT_EQ(bar->vwap(), 1'014);
+    EXPECT_TRUE(closed.empty());
+}
+
+TEST_F(BarAggregatorTest, TradePastTheEndClosesTheBar) {
+    bars.add("AAPL", T0 + 100, 1'000, 10);
+    bars.add("AAPL", T0 + SEC - 1, 1'005, 10);
+    bars.add("AAPL", T0 + 3 * SEC + 7, 1'020, 1);           // Skips two empty seconds
+
+    auto seconds = closed_of(BarInterval::Second);
+    ASSERT_EQ(seconds.size(), 1u);
+    EXPECT_EQ(seconds[0]->start_ns, T0);
+    EXPECT_EQ(seconds[0]->close, 1'005);
+    EXPECT_EQ(seconds[0]->volume, 20u);
+    EXPECT_EQ(closed[0].first, "AAPL");
+
+    const Bar* open = bars.current("AAPL", BarInterval::Second);
+    ASSERT_NE(open, nullptr);
+    EXPECT_EQ(open->start_ns, T0 + 3 * SEC);
+    EXPECT_EQ(open->open, 1'020);
+    EXPECT_EQ(open->trades, 1u);
+}
+
+TEST_F(BarAggregatorTest, IntervalsRollIndependently) {
+    for (int64_t s = 0; s < 125; ++s) {
+        bars.add("AAPL", T0 + s * SEC, 1'000 + s, 1);
+    }
+    EXPECT_EQ(closed_of(BarInterval::Second).size(), 124u);
+    auto minutes = closed_of(BarInterval::Minute);
+    ASSERT_EQ(minutes.size(), 2u);
+    EXPECT_EQ(minutes[1]->start_ns, T0 + MIN);
+    EXPECT_EQ(minutes[1]->open, 1'060);
+    EXPECT_EQ(minutes[1]->close, 1'119);
+    EXPECT_EQ(minutes[1]->volume, 60u);
+    EXPECT_TRUE(closed_of(BarInterval::Hour).empty());
+
+    const Bar* hour = bars.current("AAPL", BarInterval::Hour);
+    ASSERT_NE(hour, nullptr);
+    EXPECT_EQ(hour->trades, 125u);
+    EXPECT_EQ(hour->high, 1'124);
+    EXPECT_EQ(hour->low, 1'000);
+}
+
+TEST_F(BarAggregatorTest, InstrumentsAreSeparate) {
+    bars.add("AAPL", T0, 1'000, 1);
+    bars.add("MSFT", T0, 2'000, 2);
+    bars.add("AAPL", T0 + SEC, 1'001, 1);
+
+    ASSERT_EQ(closed.size(), 1u);
+    EXPECT_EQ(closed[0].first, "AAPL");
+    EXPECT_EQ(bars.current("MSFT", BarInterval::Second)->volume, 2u);
+    EXPECT_EQ(bars.current("GOOG", BarInterval::Second), nullptr);
+}
+
+TEST_F(BarAggregatorTest, LateTradeCountsTowardsTheOpenBar) {
+    bars.add("AAPL", T0 + 2 * SEC, 1'000, 1);
+    bars.add("AAPL", T0 + SEC, 1'010, 1);
+    EXPECT_TRUE(closed.empty());
+    EXPECT_EQ(bars.current("AAPL", BarInterval::Second)->close, 1'010);
+}
+
+// ============================================================================
+// Closing on time
+// ============================================================================
+
+TEST_F(BarAggregatorTest, AdvanceClosesEndedBars) {
+    bars.add("AAPL", T0 + 10, 1'000, 1);
+    bars.advance(T0 + SEC - 1);
+    EXPECT_TRUE(closed.empty());
+
+    bars.advance(T0 + SEC);
+    ASSERT_EQ(closed.size(), 1u);
+    EXPECT_EQ(closed[0].second.interval, BarInterval::Second);
+    EXPECT_EQ(bars.current("AAPL", BarInterval::Second), nullptr);
+    EXPECT_NE(bars.current("AAPL", BarInterval::Minute), nullptr);
+
+    bars.advance(T0 + HOUR);
+    EXPECT_EQ(closed.size(), 3u);
+    bars.advance(T0 + 2 * HOUR);
+    EXPECT_EQ(closed.size(), 3u);                           // Nothing open, nothing emitted
+}
+
+TEST_F(BarAggregatorTest, CloseAllEmitsEveryOpenBar) {
+    bars.add("AAPL", T0, 1'000, 1);
+    bars.add("MSFT", T0, 2'000, 1);
+    bars.close_all();
+    EXPECT_EQ(closed.size(), 2 * BAR_INTERVALS);
+    bars.close_all();
+    EXPECT_EQ(closed.size(), 2 * BAR_INTERVALS);
+}
+
+TEST_F(BarAggregatorTest, RemovedListenerStopsReceiving) {
+    bars.remove_listener(this);
+    bars.add("AAPL", T0, 1'000, 1);
+    bars.close_all();
+    EXPECT_TRUE(closed.empty());
+}
+
+// ============================================================================
+// Fed by the engine
+// ============================================================================
+
+TEST_F(BarAggregatorTest, EngineSinkBuildsBarsFromFills) {
+    MatchingEngine engine;
+    engine.add_book("AAPL");
+    engine.add_trade_sink(&bars);
+
+    std::deque<Order> orders;
+    orders.emplace_back(1, "AAPL", Side::Sell, OrderType::Limit, 50, price_to_fixed(150.0));
+    orders.emplace_back(2, "AAPL", Side::Sell, OrderType::Limit, 50, price_to_fixed(151.0));
+    orders.emplace_back(3, "AAPL", Side::Buy, OrderType::Limit, 80, price_to_fixed(151.0));
+    for (Order& o : orders) engine.add_order(&o);
+
+    const Bar* hour = bars.current("AAPL", BarInterval::Hour);
+    ASSERT_NE(hour, nullptr);
+    EXPECT_EQ(hour->trades, 2u);
+    EXPECT_EQ(hour->open, price_to_fixed(150.0));
+    EXPECT_EQ(hour->close, price_to_fixed(151.0));
+    EXPECT_EQ(hour->volume, 80u);
+
+    const int64_t wall_now = bars.wall_time(timestamp_to_nanos(now()));
+    EXPECT_LE(hour->start_ns, wall_now);
+    EXPECT_GT(hour->end_ns(), wall_now - SEC);
+}
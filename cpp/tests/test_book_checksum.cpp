@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+#include "order_book.hpp"
+#include "book_checksum.hpp"
+#include <deque>
+#include <random>
+
+using namespace orderbook;
+
+// ============================================================================
+// Test Fixture
+// A book with a few levels on each side; orders live in a deque so their
+// addresses stay stable while resting.
+// ============================================================================
+
+class BookChecksumTest : public ::testing::Test {
+protected:
+    Order& add(Side side, Quantity qty, double price) {
+        orders.emplace_back(next_id_++, "AAPL", side, OrderType::Limit, qty, price_to_fixed(price));
+        book.add_order(&orders.back());
+        return orders.back();
+    }
+
+    void populate() {
+        add(Side::Buy, 100, 99.0);
+        add(Side::Buy, 50, 99.0);
+        add(Side::Buy, 70, 98.0);
+        add(Side::Sell, 40, 101.0);
+        add(Side::Sell, 60, 102.0);
+    }
+
+    OrderBook book{"AAPL"};
+    std::deque<Order> orders;
+    OrderId next_id_ = 1;
+};
+
+// ============================================================================
+// Rolling checksum
+// ============================================================================
+
+TEST_F(BookChecksumTest, EmptyBookChecksumIsZero) {
+    EXPECT_EQ(book.state_checksum(), 0u);
+    EXPECT_TRUE(book.verify().ok());
+}
+
+TEST_F(BookChecksumTest, TracksAddsFillsAndCancels) {
+    populate();
+    EXPECT_NE(book.state_checksum(), 0u);
+    EXPECT_EQ(book.state_checksum(), image_checksum(book.image()));
+
+    add(Side::Sell, 120, 99.0);                  // Fills 100, partially fills 50
+    EXPECT_EQ(book.state_checksum(), image_checksum(book.image()));
+
+    book.cancel_order(2);
+    EXPECT_EQ(book.state_checksum(), image_checksum(book.image()));
+    EXPECT_TRUE(book.verify().ok());
+}
+
+TEST_F(BookChecksumTest, ReturnsToZeroWhenBookEmpties) {
+    populate();
+    book.cancel_orders({1, 2, 3, 4, 5});
+    EXPECT_EQ(book.state_checksum(), 0u);
+}
+
+TEST_F(BookChecksumTest, SameRestingStateSameChecksumRegardlessOfHistory) {
+    // Book A: order 1 rests with 60 after a partial fill
+    add(Side::Buy, 100, 99.0);
+    add(Side::Sell, 40, 99.0);
+
+    // Book B: order 1 simply rests with 60
+    OrderBook other("AAPL");
+    Order direct(1, "AAPL", Side::Buy, OrderType::Limit, 60, price_to_fixed(99.0));
+    other.add_order(&direct);
+
+    EXPECT_EQ(book.state_checksum(), other.state_checksum());
+}
+
+TEST_F(BookChecksumTest, DiffersWhenAnyFieldDiffers) {
+    Order a(1, "AAPL", Side::Buy, OrderType::Limit, 60, price_to_fixed(99.0));
+    book.add_order(&a);
+
+    const Order variants[] = {
+        Order(2, "AAPL", Side::Buy, OrderType::Limit, 60, price_to_fixed(99.0)),
+        Order(1, "AAPL", Side::Buy, OrderType::Limit, 61, price_to_fixed(99.0)),
+        Order(1, "AAPL", Side::Buy, OrderType::Limit, 60, price_to_fixed(98.0)),
+        Order(1, "AAPL", Side::Sell, OrderType::Limit, 60, price_to_fixed(99.0)),
+    };
+    for (const Order& v : variants) {
+        OrderBook other("AAPL");
+        Order copy = v;
+        other.add_order(&copy);
+        EXPECT_NE(book.state_checksum(), other.state_checksum());
+    }
+}
+
+TEST_F(BookChecksumTest, RandomFlowStaysConsistent) {
+    std::mt19937_64 rng(7);
+    for (int i = 0; i < 5'000; ++i) {
+        if (i % 3 == 2 && next_id_ > 1) {
+            book.cancel_order(1 + rng() % (next_id_ - 1));
+        } else {
+            Side side = (rng() & 1) ? Side::Buy : Side::Sell;
+            add(side, 1 + rng() % 100, 95.0 + static_cast<double>(rng() % 10));
+        }
+    }
+    VerifyResult result = book.verify();
+    EXPECT_TRUE(result.ok()) << to_string(result.violation);
+}
+
+TEST_F(BookChecksumTest, ExpiryUpdatesChecksum) {
+    const Timestamp t0 = now();
+    Order expiring(1, "AAPL", Side::Buy, OrderType::Limit, 10, price_to_fixed(90.0));
+    expiring.time_in_force = TimeInForce::GoodTillTime;
+    expiring.expire_time = t0 + std::chrono::seconds(1);
+    book.add_order(&expiring);
+    ASSERT_NE(book.state_checksum(), 0u);
+
+    book.tick(t0 + std::chrono::seconds(2));
+    EXPECT_EQ(book.state_checksum(), 0u);
+}
+
+// ============================================================================
+// verify_image(): each corruption is reported
+// ============================================================================
+
+TEST_F(BookChecksumTest, VerifierCatchesLevelQuantityDrift) {
+    populate();
+    BookImage image = book.image();
+    image.levels[0].total_quantity += 1;
+
+    VerifyResult result = verify_image(image);
+    EXPECT_EQ(result.violation, BookInvariant::LevelQuantity);
+    EXPECT_EQ(result.price, price_to_fixed(99.0));
+}
+
+TEST_F(BookChecksumTest, VerifierCatchesLookupDisagreement) {
+    populate();
+
+    BookImage missing = book.image();
+    missing.lookup.pop_back();
+    EXPECT_EQ(verify_image(missing).violation, BookInvariant::LookupMismatch);
+
+    BookImage moved = book.image();
+    moved.lookup[0].price += 1;
+    EXPECT_EQ(verify_image(moved).violation, BookInvariant::LookupMismatch);
+
+    BookImage stale = book.image();
+    stale.lookup[0].iterator_matches = false;
+    EXPECT_EQ(verify_image(stale).violation, BookInvariant::LookupMismatch);
+}
+
+TEST_F(BookChecksumTest, VerifierCatchesStructuralErrors) {
+    populate();
+
+    BookImage inactive = book.image();
+    inactive.levels[0].queue[0].status = OrderStatus::Filled;
+    EXPECT_EQ(verify_image(inactive).violation, BookInvariant::InactiveOrder);
+
+    BookImage misplaced = book.image();
+    misplaced.levels[0].queue[0].price = price_to_fixed(97.0);
+    EXPECT_EQ(verify_image(misplaced).violation, BookInvariant::MisplacedOrder);
+
+    BookImage crossed = book.image();
+    crossed.levels[0].price = price_to_fixed(105.0);
+    for (auto& o : crossed.levels[0].queue) o.price = price_to_fixed(105.0);
+    EXPECT_EQ(verify_image(crossed).violation, BookInvariant::LevelOrdering);
+
+    BookImage count = book.image();
+    count.levels[1].order_count = 5;
+    EXPECT_EQ(verify_image(count).violation, BookInvariant::LevelCount);
+}
+
+TEST_F(BookChecksumTest, VerifierCatchesChecksumDrift) {
+    populate();
+    BookImage image = book.image();
+    image.checksum ^= 1;
+    EXPECT_EQ(verify_image(image).violation, BookInvariant::ChecksumMismatch);
+}
@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+#include "book_view.hpp"
+#include "order_book.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace orderbook;
+
+// ============================================================================
+// BookView: publish / read
+// ============================================================================
+
+TEST(BookViewTest, StartsEmpty) {
+    BookView view;
+    EXPECT_EQ(view.version(), 0u);
+
+    BookSnapshot snap = view.read();
+    EXPECT_EQ(snap.version, 0u);
+    EXPECT_EQ(snap.bid_depth, 0u);
+    EXPECT_FALSE(snap.best_bid().has_value());
+    EXPECT_FALSE(snap.best_ask().has_value());
+    EXPECT_DOUBLE_EQ(snap.imbalance(), 0.0);
+}
+
+TEST(BookViewTest, ReadReturnsLastPublished) {
+    BookView view;
+    BookSnapshot snap;
+    snap.bid_depth = 1;
+    snap.bids[0] = LevelSnapshot{price_to_fixed(100.0), 300, 2};
+    snap.ask_depth = 1;
+    snap.asks[0] = LevelSnapshot{price_to_fixed(101.0), 100, 1};
+
+    view.publish(snap);
+    view.publish(snap);
+
+    BookSnapshot out;
+    ASSERT_TRUE(view.try_read(out));
+    EXPECT_EQ(out.version, 2u);
+    EXPECT_EQ(view.version(), 2u);
+    EXPECT_EQ(out.best_bid(), price_to_fixed(100.0));
+    EXPECT_EQ(out.best_ask(), price_to_fixed(101.0));
+    EXPECT_EQ(out.bids[0].order_count, 2u);
+    EXPECT_DOUBLE_EQ(out.imbalance(), 0.5);   // (300 - 100) / 400
+}
+
+// ============================================================================
+// OrderBook integration
+// ============================================================================
+
+class BookViewOrderBookTest : public ::testing::Test {
+protected:
+    Order make_order(Side side, Quantity qty, double price) {
+        return Order(next_id_++, "AAPL", side, OrderType::Limit, qty, price_to_fixed(price));
+    }
+
+    OrderBook book{"AAPL"};
+    BookView view;
+    OrderId next_id_ = 1;
+};
+
+TEST_F(BookViewOrderBookTest, AttachPublishesCurrentBook) {
+    Order bid = make_order(Side::Buy, 100, 99.0);
+    book.add_order(&bid);
+
+    book.attach_view(&view);
+    BookSnapshot snap = view.read();
+    EXPECT_EQ(snap.version, 1u);
+    EXPECT_EQ(snap.best_bid(), price_to_fixed(99.0));
+    EXPECT_FALSE(snap.best_ask().has_value());
+}
+
+TEST_F(BookViewOrderBookTest, TracksAddsFillsAndCancels) {
+    book.attach_view(&view);
+
+    Order b1 = make_order(Side::Buy, 100, 99.0);
+    Order b2 = make_order(Side::Buy, 50, 99.0);
+    Order b3 = make_order(Side::Buy, 70, 98.0);
+    Order a1 = make_order(Side::Sell, 40, 101.0);
+    book.add_order(&b1);
+    book.add_order(&b2);
+    book.add_order(&b3);
+    book.add_order(&a1);
+
+    BookSnapshot snap = view.read();
+    ASSERT_EQ(snap.bid_depth, 2u);
+    EXPECT_EQ(snap.bids[0].price, price_to_fixed(99.0));
+    EXPECT_EQ(snap.bids[0].quantity, 150u);
+    EXPECT_EQ(snap.bids[0].order_count, 2u);
+    EXPECT_EQ(snap.bids[1].price, price_to_fixed(98.0));
+    ASSERT_EQ(snap.ask_depth, 1u);
+    EXPECT_EQ(snap.asks[0].quantity, 40u);
+
+    // Aggressive sell takes 120 at 99: b1 filled, b2 partially
+    Order s = make_order(Side::Sell, 120, 99.0);
+    book.add_order(&s);
+    snap = view.read();
+    EXPECT_EQ(snap.bids[0].quantity, 30u);
+    EXPECT_EQ(snap.bids[0].order_count, 1u);
+
+    book.cancel_order(b2.id);
+    snap = view.read();
+    ASSERT_EQ(snap.bid_depth, 1u);
+    EXPECT_EQ(snap.best_bid(), price_to_fixed(98.0));
+}
+
+TEST_F(BookViewOrderBookTest, DepthIsLimited) {
+    book.attach_view(&view, 3);
+
+    std::vector<Order> orders;
+    orders.reserve(8);
+    for (int i = 0; i < 8; ++i) {
+        orders.push_back(make_order(Side::Buy, 10, 90.0 + i));
+        book.add_order(&orders.back());
+    }
+
+    BookSnapshot snap = view.read();
+    ASSERT_EQ(snap.bid_depth, 3u);
+    EXPECT_EQ(snap.bids[0].price, price_to_fixed(97.0));
+    EXPECT_EQ(snap.bids[2].price, price_to_fixed(95.0));
+}
+
+TEST_F(BookViewOrderBookTest, DetachStopsPublishing) {
+    book.attach_view(&view);
+    book.attach_view(nullptr);
+
+    Order bid = make_order(Side::Buy, 100, 99.0);
+    book.add_order(&bid);
+    EXPECT_EQ(view.version(), 1u);
+}
+
+// ============================================================================
+// Concurrency: readers never see a torn snapshot
+// ============================================================================
+
+TEST(BookViewConcurrencyTest, ReadersSeeConsistentSnapshots) {
+    // Every publish writes the same value into every field, so any snapshot
+    // mixing two publishes is detectable
+    BookView view;
+    constexpr uint64_t PUBLISHES = 200'000;
+    std::atomic<bool> done{false};
+
+    std::thread writer([&] {
+        BookSnapshot snap;
+        for (uint64_t i = 1; i <= PUBLISHES; ++i) {
+            snap.bid_depth = snap.ask_depth = i % (BookSnapshot::MAX_DEPTH + 1);
+            for (size_t l = 0; l < BookSnapshot::MAX_DEPTH; ++l) {
+                snap.bids[l] = LevelSnapshot{static_cast<Price>(i), i, i};
+                snap.asks[l] = LevelSnapshot{static_cast<Price>(i), i, i};
+            }
+            view.publish(snap);
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    auto reader = [&] {
+        uint64_t last_version = 0;
+        while (!done.load(std::memory_order_acquire)) {
+            BookSnapshot snap = view.read();
+            ASSERT_GE(snap.version, last_version);
+            last_version = snap.version;
+            if (snap.version == 0) continue;
+
+            const uint64_t i = snap.version;     // Publish i wrote value i
+            ASSERT_EQ(snap.bid_depth, i % (BookSnapshot::MAX_DEPTH + 1));
+            ASSERT_EQ(snap.ask_depth, snap.bid_depth);
+            for (size_t l = 0; l < BookSnapshot::MAX_DEPTH; ++l) {
+                ASSERT_EQ(snap.bids[l].quantity, i);
+                ASSERT_EQ(snap.asks[l].order_count, i);
+                ASSERT_EQ(snap.asks[l].price, static_cast<Price>(i));
+            }
+        }
+    };
+
+    std::thread r1(reader);
+    std::thread r2(reader);
+    writer.join();
+    r1.join();
+    r2.join();
+
+    EXPECT_EQ(view.read().version, PUBLISHES);
+}
@@ -0,0 +1,312 @@
+#include <gtest/gtest.h>
+#include "conflator.hpp"
+#include "order_book.hpp"
+#include <atomic>
+#include <deque>
+#include <map>
+#include <thread>
+#include <vector>
+
+using namespace orderbook;
+
+// ============================================================================
+// Test Fixture
+// One AAPL book feeding a Conflator. Orders live in a deque so their
+// addresses stay stable while resting.
+// ============================================================================
+
+class ConflatorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        aapl = conflator.add_instrument("AAPL");
+        book.set_listener(&conflator.feed(aapl));
+    }
+
+    Order& add(Side side, Quantity qty, double price) {
+        orders.emplace_back(next_id_++, "AAPL", side, OrderType::Limit, qty, price_to_fixed(price));
+        book.add_order(&orders.back());
+        return orders.back();
+    }
+
+    std::vector<ConflatedUpdate> drain(Conflator::ConsumerId consumer, size_t max = SIZE_MAX) {
+        std::vector<ConflatedUpdate> out;
+        conflator.drain(consumer, [&](const ConflatedUpdate& u) { out.push_back(u); }, max);
+        return out;
+    }
+
+    static const ConflatedUpdate* find_level(const std::vector<ConflatedUpdate>& updates,
+                                             Side side, double price) {
+        for (const auto& u : updates) {
+            if (u.kind == UpdateKind::Level && u.side == side && u.price == price_to_fixed(price)) {
+                return &u;
+            }
+        }
+        return nullptr;
+    }
+
+    static const ConflatedUpdate* find_bbo(const std::vector<ConflatedUpdate>& updates) {
+        for (const auto& u : updates) {
+            if (u.kind == UpdateKind::Bbo) return &u;
+        }
+        return nullptr;
+    }
+
+    Conflator conflator{256, 4};
+    OrderBook book{"AAPL"};
+    uint32_t aapl = 0;
+    std::deque<Order> orders;
+    OrderId next_id_ = 1;
+};
+
+// ============================================================================
+// Book events
+// ============================================================================
+
+TEST_F(ConflatorTest, ListenerSeesAddsFillsAndCancels) {
+    struct Recorder : BookListener {
+        std::vector<LevelChange> changes;
+        size_t ends = 0;
+        void on_level(const OrderBook&, const LevelChange& c) override { changes.push_back(c); }
+        void on_update_end(const OrderBook&) override { ++ends; }
+    } recorder;
+    book.set_listener(&recorder);
+
+    add(Side::Sell, 100, 101.0);
+    add(Side::Sell, 50, 102.0);
+    add(Side::Buy, 120, 102.0);       // Clears 101, takes 20 at 102
+    book.cancel_order(2);             // Removes the rest of 102
+
+    ASSERT_EQ(recorder.changes.size(), 5u);
+    EXPECT_EQ(recorder.changes[2].price, price_to_fixed(101.0));
+    EXPECT_EQ(recorder.changes[2].quantity, 0u);
+    EXPECT_EQ(recorder.changes[3].price, price_to_fixed(102.0));
+    EXPECT_EQ(recorder.changes[3].quantity, 30u);
+    EXPECT_EQ(recorder.changes[3].order_count, 1u);
+    EXPECT_EQ(recorder.changes[4].quantity, 0u);
+    EXPECT_EQ(recorder.ends, 4u);
+}
+
+// ============================================================================
+// Fast and slow consumers
+// ============================================================================
+
+TEST_F(ConflatorTest, NewConsumerStartsWithFullSnapshot) {
+    add(Side::Buy, 10, 99.0);
+    add(Side::Sell, 20, 101.0);
+
+    auto consumer = conflator.subscribe();
+    auto updates = drain(consumer);
+    ASSERT_EQ(updates.size(), 3u);                 // Two levels + BBO
+
+    const ConflatedUpdate* bbo = find_bbo(updates);
+    ASSERT_NE(bbo, nullptr);
+    EXPECT_EQ(bbo->price, price_to_fixed(99.0));
+    EXPECT_EQ(bbo->quantity, 10u);
+    EXPECT_EQ(bbo->ask_price, price_to_fixed(101.0));
+    EXPECT_EQ(bbo->ask_quantity, 20u);
+    EXPECT_TRUE(drain(consumer).empty());
+}
+
+TEST_F(ConflatorTest, FastConsumerSeesEveryUpdate) {
+    auto consumer = conflator.subscribe();
+    drain(consumer);
+
+    for (Quantity qty = 1; qty <= 5; ++qty) {
+        add(Side::Buy, 10, 99.0);
+        auto updates = drain(consumer);
+        const ConflatedUpdate* level = find_level(updates, Side::Buy, 99.0);
+        ASSERT_NE(level, nullptr);
+        EXPECT_EQ(level->quantity, qty * 10);
+    }
+    EXPECT_EQ(conflator.coalesced(consumer), 0u);
+}
+
+TEST_F(ConflatorTest, SlowConsumerGetsLatestStateOnly) {
+    auto fast = conflator.subscribe();
+    auto slow = conflator.subscribe();
+    drain(fast);
+    drain(slow);
+
+    for (int i = 0; i < 100; ++i) {
+        add(Side::Buy, 10, 99.0);
+        drain(fast);
+    }
+
+    auto updates = drain(slow);
+    ASSERT_EQ(updates.size(), 2u);                 // One level, one BBO
+    const ConflatedUpdate* level = find_level(updates, Side::Buy, 99.0);
+    ASSERT_NE(level, nullptr);
+    EXPECT_EQ(level->quantity, 1000u);
+    EXPECT_EQ(level->order_count, 100u);
+    EXPECT_EQ(level->version, 100u);               // Gap in versions = updates skipped
+    EXPECT_EQ(conflator.coalesced(slow), 2 * 99u);
+    EXPECT_EQ(conflator.coalesced(fast), 0u);
+}
+
+TEST_F(ConflatorTest, RemovedLevelIsReportedWithZeroQuantity) {
+    auto consumer = conflator.subscribe();
+    add(Side::Sell, 10, 101.0);
+    book.cancel_order(1);
+
+    auto updates = drain(consumer);
+    const ConflatedUpdate* level = find_level(updates, Side::Sell, 101.0);
+    ASSERT_NE(level, nullptr);
+    EXPECT_EQ(level->quantity, 0u);
+    const ConflatedUpdate* bbo = find_bbo(updates);
+    ASSERT_NE(bbo, nullptr);
+    EXPECT_EQ(bbo->ask_price, INVALID_PRICE);
+}
+
+TEST_F(ConflatorTest, BoundedDrainKeepsTheRestDirty) {
+    auto consumer = conflator.subscribe();
+    for (int i = 0; i < 10; ++i) {
+        add(Side::Buy, 10, 90.0 + i);
+    }
+
+    std::map<Price, Quantity> levels;
+    size_t total = 0;
+    while (size_t n = conflator.drain(consumer, [&](const ConflatedUpdate& u) {
+               if (u.kind == UpdateKind::Level) levels[u.price] = u.quantity;
+           }, 3)) {
+        EXPECT_LE(n, 3u);
+        total += n;
+    }
+    EXPECT_EQ(total, 11u);
+    EXPECT_EQ(levels.size(), 10u);
+}
+
+TEST_F(ConflatorTest, KeysBeyondCapacityAreDropped) {
+    Conflator small(4, 1);
+    uint32_t id = small.add_instrument("AAPL");        // Takes one key for the BBO
+    OrderBook other("AAPL");
+    other.set_listener(&small.feed(id));
+
+    std::deque<Order> resting;
+    for (int i = 0; i < 5; ++i) {
+        resting.emplace_back(i + 1, "AAPL", Side::Buy, OrderType::Limit, 10,
+                             price_to_fixed(90.0 + i));
+        other.add_order(&resting.back());
+    }
+    EXPECT_EQ(small.keys(), 4u);
+    EXPECT_EQ(small.dropped_updates(), 2u);
+    EXPECT_TRUE(small.overflowed());
+}
+
+TEST_F(ConflatorTest, RemovedLevelKeyIsRecycledOnceEveryConsumerHasIt) {
+    Conflator small(4, 2);
+    uint32_t id = small.add_instrument("AAPL");        // BBO + room for 3 levels
+    OrderBook other("AAPL");
+    other.set_listener(&small.feed(id));
+    auto fast = small.subscribe();
+    auto slow = small.subscribe();
+    auto drain_small = [&](Conflator::ConsumerId c) {
+        std::vector<ConflatedUpdate> out;
+        small.drain(c, [&](const ConflatedUpdate& u) { out.push_back(u); });
+        return out;
+    };
+
+    std::deque<Order> resting;
+    auto rest = [&](double price) {
+        resting.emplace_back(resting.size() + 1, "AAPL", Side::Buy, OrderType::Limit, 10,
+                             price_to_fixed(price));
+        other.add_order(&resting.back());
+    };
+    rest(90.0);
+    rest(91.0);
+    rest(92.0);
+    other.cancel_order(1);                             // 90 removed
+    drain_small(fast);
+
+    // The slow consumer hasn't seen 90 go: its key can't be reused yet
+    rest(93.0);
+    EXPECT_TRUE(small.overflowed());
+    EXPECT_EQ(small.recycled_keys(), 0u);
+
+    const auto slow_updates = drain_small(slow);
+    const ConflatedUpdate* gone = find_level(slow_updates, Side::Buy, 90.0);
+    ASSERT_NE(gone, nullptr);
+    EXPECT_EQ(gone->quantity, 0u);
+
+    // Now it can
+    const uint64_t dropped = small.dropped_updates();
+    other.cancel_order(4);                             // 93 never had a key: nothing to report
+    rest(94.0);
+    EXPECT_EQ(small.recycled_keys(), 1u);
+    EXPECT_EQ(small.dropped_updates(), dropped);
+    for (auto c : {fast, slow}) {
+        const auto updates = drain_small(c);
+        const ConflatedUpdate* level = find_level(updates, Side::Buy, 94.0);
+        ASSERT_NE(level, nullptr);
+        EXPECT_EQ(level->quantity, 10u);
+    }
+}
+
+TEST_F(ConflatorTest, LevelThatComesBackKeepsItsKey) {
+    Conflator small(3, 1);
+    uint32_t id = small.add_instrument("AAPL");
+    OrderBook other("AAPL");
+    other.set_listener(&small.feed(id));
+    auto consumer = small.subscribe();
+
+    std::deque<Order> resting;
+    for (int round = 0; round < 50; ++round) {         // 90 flickers; 91 stays
+        resting.emplace_back(2 * round + 1, "AAPL", Side::Buy, OrderType::Limit, 10,
+                             price_to_fixed(90.0));
+        other.add_order(&resting.back());
+        if (round == 0) {
+            resting.emplace_back(1'000, "AAPL", Side::Buy, OrderType::Limit, 10,
+                                 price_to_fixed(91.0));
+            other.add_order(&resting.back());
+        }
+        other.cancel_order(2 * round + 1);
+        small.drain(consumer, [](const ConflatedUpdate&) {});
+    }
+    EXPECT_FALSE(small.overflowed());
+    EXPECT_EQ(small.recycled_keys(), 0u);
+    EXPECT_EQ(small.keys(), 3u);
+}
+
+TEST_F(ConflatorTest, SubscribeFailsWhenFull) {
+    for (size_t i = 0; i < conflator.max_consumers(); ++i) {
+        EXPECT_EQ(conflator.subscribe(), i);
+    }
+    EXPECT_EQ(conflator.subscribe(), conflator.max_consumers());
+}
+
+// ============================================================================
+// Concurrent producer and consumer
+// ============================================================================
+
+TEST_F(ConflatorTest, ConcurrentConsumerConvergesToFinalState) {
+    auto consumer = conflator.subscribe();
+    std::atomic<bool> done{false};
+    std::map<Price, Quantity> seen;
+    std::map<Price, uint64_t> last_version;
+    bool monotonic = true;
+
+    std::thread reader([&] {
+        auto apply = [&](const ConflatedUpdate& u) {
+            if (u.kind != UpdateKind::Level) return;
+            monotonic = monotonic && u.version > last_version[u.price];
+            last_version[u.price] = u.version;
+            seen[u.price] = u.quantity;
+        };
+        while (!done.load(std::memory_order_acquire)) {
+            conflator.drain(consumer, apply);
+        }
+        conflator.drain(consumer, apply);
+    });
+
+    for (int i = 0; i < 20'000; ++i) {
+        add(Side::Buy, 1 + i % 7, 90.0 + i % 16);
+        if (i % 3 == 0) book.cancel_order(next_id_ - 2);
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+
+    EXPECT_TRUE(monotonic);
+    for (int i = 0; i < 16; ++i) {
+        Price price = price_to_fixed(90.0 + i);
+        EXPECT_EQ(seen[price], book.volume_at_price(Side::Buy, price)) << i;
+    }
+}
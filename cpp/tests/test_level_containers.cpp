@@ -0,0 +1,320 @@
+#include <gtest/gtest.h>
+#include "level_containers.hpp"
+#include "order_book.hpp"
+#include <deque>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace orderbook;
+
+// ============================================================================
+// Helpers
+// Every container is checked against std::map through the shared interface,
+// on both sides (std::greater = bids, std::less = asks).
+// ============================================================================
+
+template <typename Levels>
+static std::vector<Price> prices_of(const Levels& levels) {
+    std::vector<Price> out;
+    for (auto it = levels.begin(); it != levels.end(); ++it) {
+        out.push_back(it->first);
+    }
+    return out;
+}
+
+template <typename Reference>
+static std::vector<Price> prices_of_map(const Reference& reference) {
+    std::vector<Price> out;
+    for (const auto& [price, ignored] : reference) out.push_back(price);
+    return out;
+}
+
+template <template <typename> class Levels, typename Compare>
+static void check_random_operations(uint64_t seed, Price spread) {
+    Levels<Compare> levels{LevelAllocator(), TickSize(1)};
+    std::map<Price, PriceLevel*, Compare> reference;
+    std::mt19937_64 rng(seed);
+
+    for (int i = 0; i < 20'000; ++i) {
+        const Price price = 1'000 + static_cast<Price>(rng() % static_cast<uint64_t>(spread));
+        if (rng() % 3 != 0) {
+            auto [it, inserted] = levels.try_emplace(price, price);
+            EXPECT_EQ(inserted, reference.count(price) == 0);
+            if (inserted) reference[price] = &it->second;
+            EXPECT_EQ(&it->second, reference[price]);          // Never moved
+        } else {
+            EXPECT_EQ(levels.erase(price), reference.erase(price));
+        }
+    }
+    EXPECT_EQ(levels.size(), reference.size());
+    EXPECT_EQ(prices_of(levels), prices_of_map(reference));
+    for (const auto& [price, level] : reference) {
+        auto it = levels.find(price);
+        ASSERT_NE(it, levels.end());
+        EXPECT_EQ(&it->second, level);
+        EXPECT_EQ(level->price(), price);
+    }
+}
+
+template <template <typename> class Levels>
+static void check_erase_returns_next() {
+    Levels<std::less<Price>> asks{LevelAllocator(), TickSize(1)};
+    for (Price p : {105, 101, 103, 102}) asks.try_emplace(p, p);
+
+    auto it = asks.erase(asks.find(102));
+    ASSERT_NE(it, asks.end());
+    EXPECT_EQ(it->first, 103);
+    it = asks.erase(asks.begin());
+    EXPECT_EQ(it->first, 103);
+    it = asks.erase(asks.find(105));
+    EXPECT_EQ(it, asks.end());
+    EXPECT_EQ(prices_of(asks), std::vector<Price>{103});
+}
+
+// ============================================================================
+// Containers
+// ============================================================================
+
+TEST(LevelContainersTest, MapMatchesReference) {
+    check_random_operations<MapLevels, std::greater<Price>>(1, 300);
+    check_random_operations<MapLevels, std::less<Price>>(2, 300);
+    check_erase_returns_next<MapLevels>();
+}
+
+TEST(LevelContainersTest, LadderMatchesReference) {
+    check_random_operations<LadderLevels, std::greater<Price>>(3, 300);
+    check_random_operations<LadderLevels, std::less<Price>>(4, 300);
+    check_random_operations<LadderLevels, std::less<Price>>(5, 50'000);   // Grows both ways
+    check_erase_returns_next<LadderLevels>();
+}
+
+TEST(LevelContainersTest, BTreeMatchesReference) {
+    check_random_operations<BTreeLevels, std::greater<Price>>(6, 300);
+    check_random_operations<BTreeLevels, std::less<Price>>(7, 300);
+    check_random_operations<BTreeLevels, std::less<Price>>(8, 50'000);    // Many leaves
+    check_erase_returns_next<BTreeLevels>();
+}
+
+TEST(LevelContainersTest, VectorMatchesReference) {
+    check_random_operations<VectorLevels, std::greater<Price>>(9, 300);
+    check_random_operations<VectorLevels, std::less<Price>>(10, 300);
+    check_random_operations<VectorLevels, std::less<Price>>(11, 50'000);  // Mostly binary search
+    check_erase_returns_next<VectorLevels>();
+}
+
+TEST(LevelContainersTest, LadderUsesTickIndexAndCachesBest) {
+    LadderLevels<std::greater<Price>> bids{LevelAllocator(), TickSize(100)};
+    bids.try_emplace(10'000, 10'000);
+    bids.try_emplace(10'500, 10'500);
+    bids.try_emplace(200'000, 200'000);            // Far above: array grows
+
+    EXPECT_EQ(bids.begin()->first, 200'000);
+    bids.erase(bids.begin());
+    EXPECT_EQ(bids.begin()->first, 10'500);
+    EXPECT_EQ(bids.find(10'400), bids.end());
+}
+
+TEST(LevelContainersTest, LadderSpanIsBounded) {
+    using Ladder = LadderLevels<std::less<Price>>;
+    Ladder asks{LevelAllocator(), TickSize(1)};
+    const Price touch = 1'000'000'000;
+    EXPECT_TRUE(asks.can_hold(touch));
+    asks.try_emplace(touch, touch);
+
+    EXPECT_TRUE(asks.can_hold(touch + static_cast<Price>(Ladder::MAX_TICKS) / 2));
+    EXPECT_FALSE(asks.can_hold(touch + static_cast<Price>(Ladder::MAX_TICKS)));
+    EXPECT_FALSE(asks.can_hold(touch - static_cast<Price>(Ladder::MAX_TICKS)));
+
+    // Emptied, it re-centres on the next price instead of spanning both
+    asks.erase(touch);
+    const Price far = 4 * touch;
+    EXPECT_TRUE(asks.can_hold(far));
+    asks.try_emplace(far, far);
+    EXPECT_EQ(asks.begin()->first, far);
+    EXPECT_TRUE(asks.can_hold(far + 1));
+    EXPECT_FALSE(asks.can_hold(touch));
+}
+
+TEST(LevelContainersTest, LadderBookRejectsOutlierPrice) {
+    OrderBookConfig config;
+    config.levels = LevelBackend::Ladder;
+    OrderBook book("AAPL", config);
+    Order near(1, "AAPL", Side::Sell, OrderType::Limit, 10, price_to_fixed(100.0));
+    Order outlier(2, "AAPL", Side::Sell, OrderType::Limit, 10, price_to_fixed(1'000'000.0));
+    book.add_order(&near);
+    book.add_order(&outlier);
+
+    EXPECT_EQ(outlier.status, OrderStatus::Rejected);
+    EXPECT_LT(book.memory_stats().levels, size_t{1} << 20);
+
+    config.levels = LevelBackend::Map;              // No span to protect
+    OrderBook map_book("AAPL", config);
+    Order map_near(3, "AAPL", Side::Sell, OrderType::Limit, 10, price_to_fixed(100.0));
+    Order map_outlier(4, "AAPL", Side::Sell, OrderType::Limit, 10, price_to_fixed(1'000'000.0));
+    map_book.add_order(&map_near);
+    map_book.add_order(&map_outlier);
+    EXPECT_NE(map_outlier.status, OrderStatus::Rejected);
+}
+
+TEST(LevelContainersTest, CentLadderMatchesRuntimeTickLadder) {
+    const TickSize cent(CentTick::tick());
+    CentLadderLevels<std::less<Price>> fixed{LevelAllocator(), cent};
+    LadderLevels<std::less<Price>> runtime{LevelAllocator(), cent};
+    std::mt19937_64 rng(12);
+
+    for (int i = 0; i < 20'000; ++i) {
+        const Price price = price_to_fixed(100.0) + CentTick::tick() * static_cast<Price>(rng() % 3'000);
+        if (rng() % 3 != 0) {
+            EXPECT_EQ(fixed.try_emplace(price, price).second, runtime.try_emplace(price, price).second);
+        } else {
+            EXPECT_EQ(fixed.erase(price), runtime.erase(price));
+        }
+    }
+    EXPECT_EQ(prices_of(fixed), prices_of(runtime));
+}
+
+TEST(LevelContainersTest, BTreeSplitsAndFreesLeaves) {
+    using Tree = BTreeLevels<std::less<Price>>;
+    Tree asks{LevelAllocator(), TickSize(1)};
+    const Price count = 10 * static_cast<Price>(Tree::LEAF_SIZE);
+    for (Price p = count; p > 0; --p) asks.try_emplace(p, p);     // Worst first: splits at the front
+
+    EXPECT_EQ(asks.size(), static_cast<size_t>(count));
+    EXPECT_EQ(asks.begin()->first, 1);
+    for (Price p = 1; p <= count / 2; ++p) asks.erase(asks.begin());
+    EXPECT_EQ(asks.begin()->first, count / 2 + 1);
+    EXPECT_EQ(prices_of(asks).size(), static_cast<size_t>(count / 2));
+}
+
+TEST(LevelContainersTest, VectorHandlesTouchAndDeepInserts) {
+    VectorLevels<std::greater<Price>> bids{LevelAllocator(), TickSize(1)};
+    for (Price p = 100; p < 120; ++p) bids.try_emplace(p, p);        // Each one a new best
+    PriceLevel* deep = &bids.try_emplace(50, 50).first->second;     // Past the touch scan
+    bids.try_emplace(110, 110);                                      // Existing, near the touch
+    bids.try_emplace(105, 105);
+    auto [mid, inserted] = bids.try_emplace(99, 99);                 // Between deep and the rest
+    EXPECT_TRUE(inserted);
+    EXPECT_EQ(mid->first, 99);
+
+    EXPECT_EQ(bids.size(), 22u);
+    EXPECT_EQ(bids.begin()->first, 119);
+    bids.erase(bids.begin());                                        // Pop the touch
+    EXPECT_EQ(bids.begin()->first, 118);
+    EXPECT_EQ(&bids.find(50)->second, deep);
+
+    std::vector<Price> expected;
+    for (Price p = 118; p >= 99; --p) expected.push_back(p);
+    expected.push_back(50);
+    EXPECT_EQ(prices_of(bids), expected);
+}
+
+// ============================================================================
+// OrderBook on every backend
+// The same random flow through a book per backend must produce the same
+// trades and the same resting state as the std::map book.
+// ============================================================================
+
+struct FlowResult {
+    std::vector<Trade> trades;
+    BookSnapshot snapshot;
+    uint64_t checksum = 0;
+    bool verified = false;
+};
+
+static FlowResult run_flow(OrderBookConfig config, uint64_t seed) {
+    config.tick_size = price_to_fixed(0.01);
+    OrderBook book("AAPL", config);
+    std::deque<Order> orders;
+    std::vector<OrderId> ids;
+    std::mt19937_64 rng(seed);
+    FlowResult result;
+
+    for (int i = 0; i < 5'000; ++i) {
+        const uint64_t r = rng();
+        if (r % 10 < 6 || ids.empty()) {
+            const bool buy = (r >> 8) & 1;
+            const int ticks = static_cast<int>((r >> 16) % 60);
+            const double price = buy ? 99.80 + ticks * 0.01 : 100.20 - ticks * 0.01;
+            orders.emplace_back(book.next_order_id(), "AAPL", buy ? Side::Buy : Side::Sell,
+                                OrderType::Limit, 1 + (r >> 32) % 500, price_to_fixed(price));
+            auto trades = book.add_order(&orders.back());
+            result.trades.insert(result.trades.end(), trades.begin(), trades.end());
+            ids.push_back(orders.back().id);
+        } else if (r % 10 < 9) {
+            book.cancel_order(ids[(r >> 8) % ids.size()]);
+        } else {
+            orders.emplace_back(book.next_order_id(), "AAPL", (r >> 8) & 1 ? Side::Buy : Side::Sell,
+                                OrderType::Market, 1 + (r >> 32) % 2'000);
+            auto trades = book.add_order(&orders.back());
+            result.trades.insert(result.trades.end(), trades.begin(), trades.end());
+        }
+    }
+    book.snapshot(result.snapshot);
+    result.checksum = book.state_checksum();
+    result.verified = book.verify().ok();
+    return result;
+}
+
+static void expect_same_flow(const FlowResult& a, const FlowResult& b) {
+    EXPECT_TRUE(b.verified);
+    EXPECT_EQ(a.checksum, b.checksum);
+    ASSERT_EQ(a.trades.size(), b.trades.size());
+    for (size_t i = 0; i < a.trades.size(); ++i) {
+        EXPECT_EQ(a.trades[i].buy_order_id, b.trades[i].buy_order_id) << i;
+        EXPECT_EQ(a.trades[i].sell_order_id, b.trades[i].sell_order_id) << i;
+        EXPECT_EQ(a.trades[i].price, b.trades[i].price) << i;
+        EXPECT_EQ(a.trades[i].quantity, b.trades[i].quantity) << i;
+    }
+    ASSERT_EQ(a.snapshot.bid_depth, b.snapshot.bid_depth);
+    ASSERT_EQ(a.snapshot.ask_depth, b.snapshot.ask_depth);
+    for (size_t i = 0; i < a.snapshot.bid_depth; ++i) {
+        EXPECT_EQ(a.snapshot.bids[i].price, b.snapshot.bids[i].price);
+        EXPECT_EQ(a.snapshot.bids[i].quantity, b.snapshot.bids[i].quantity);
+    }
+    for (size_t i = 0; i < a.snapshot.ask_depth; ++i) {
+        EXPECT_EQ(a.snapshot.asks[i].price, b.snapshot.asks[i].price);
+        EXPECT_EQ(a.snapshot.asks[i].quantity, b.snapshot.asks[i].quantity);
+    }
+}
+
+TEST(LevelBackendTest, EveryBackendMatchesTheMapBook) {
+    for (LevelBackend backend : {LevelBackend::Ladder, LevelBackend::BTree, LevelBackend::Vector}) {
+        for (uint64_t seed : {1u, 2u, 3u}) {
+            OrderBookConfig config;
+            const FlowResult reference = run_flow(config, seed);
+            ASSERT_TRUE(reference.verified);
+
+            config.levels = backend;
+            SCOPED_TRACE(static_cast<int>(backend));
+            expect_same_flow(reference, run_flow(config, seed));
+        }
+    }
+}
+
+TEST(LevelBackendTest, BackendsComposeWithRetention) {
+    for (LevelBackend backend : {LevelBackend::Ladder, LevelBackend::BTree, LevelBackend::Vector}) {
+        OrderBookConfig config;
+        config.retain_empty_levels = 3;
+        const FlowResult reference = run_flow(config, 9);
+        ASSERT_TRUE(reference.verified);
+
+        config.levels = backend;
+        SCOPED_TRACE(static_cast<int>(backend));
+        expect_same_flow(reference, run_flow(config, 9));
+    }
+}
+
+TEST(LevelBackendTest, MemoryStatsCountTheLevelContainer) {
+    for (LevelBackend backend : {LevelBackend::Map, LevelBackend::Ladder, LevelBackend::BTree,
+                                 LevelBackend::Vector}) {
+        OrderBookConfig config;
+        config.levels = backend;
+        OrderBook book("AAPL", config);
+        const size_t before = book.memory_stats().levels;
+
+        Order buy(1, "AAPL", Side::Buy, OrderType::Limit, 100, price_to_fixed(150.0));
+        book.add_order(&buy);
+        EXPECT_GT(book.memory_stats().levels, before) << static_cast<int>(backend);
+    }
+}
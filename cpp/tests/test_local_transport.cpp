@@ -0,0 +1,253 @@
+#include <gtest/gtest.h>
+#include "local_transport.hpp"
+#include "matching_engine.hpp"
+#include <atomic>
+#include <deque>
+#include <thread>
+#include <unistd.h>
+
+using namespace orderbook;
+using namespace std::chrono_literals;
+
+namespace {
+
+std::vector<TradeRecord> make_records(size_t n, TradeId first_id) {
+    std::vector<TradeRecord> records(n);
+    for (size_t i = 0; i < n; ++i) {
+        records[i].id = first_id + i;
+        records[i].price = 1'000 + static_cast<Price>(i);
+        records[i].quantity = 1;
+    }
+    return records;
+}
+
+// Read until `n` records arrived (or a generous timeout)
+std::vector<TradeRecord> read_n(UdsTradeSubscriber& sub, size_t n, size_t max_per_read = 64) {
+    std::vector<TradeRecord> out;
+    std::vector<TradeRecord> buffer(max_per_read);
+    for (int i = 0; i < 500 && out.size() < n; ++i) {
+        const size_t got = sub.read(buffer.data(), buffer.size(), 10);
+        out.insert(out.end(), buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(got));
+    }
+    return out;
+}
+
+std::string socket_path(const char* name) {
+    return "/tmp/ob_uds_" + std::to_string(getpid()) + "_" + name;
+}
+
+} // namespace
+
+// ============================================================================
+// Unix domain socket
+// ============================================================================
+
+TEST(UdsTransportTest, SubscriberReceivesPublishedRecords) {
+    UdsTradePublisher publisher(socket_path("basic"));
+    ASSERT_TRUE(publisher.listening());
+    UdsTradeSubscriber subscriber(publisher.path());
+    ASSERT_TRUE(subscriber.connect());
+    ASSERT_TRUE(publisher.wait_for_subscribers(1, 1000ms));
+
+    auto records = make_records(1'000, 1);
+    EXPECT_EQ(publisher.publish(records.data(), records.size()), records.size());
+    EXPECT_TRUE(publisher.flush(1000ms));
+
+    auto received = read_n(subscriber, records.size());
+    ASSERT_EQ(received.size(), records.size());
+    for (size_t i = 0; i < received.size(); ++i) {
+        EXPECT_EQ(received[i].id, records[i].id);
+    }
+}
+
+TEST(UdsTransportTest, SmallReadsReassembleRecords) {
+    UdsTradePublisher publisher(socket_path("small"));
+    UdsTradeSubscriber subscriber(publisher.path());
+    ASSERT_TRUE(subscriber.connect());
+    ASSERT_TRUE(publisher.wait_for_subscribers(1, 1000ms));
+
+    auto records = make_records(10, 1);
+    publisher.publish(records.data(), records.size());
+    auto received = read_n(subscriber, records.size(), 1);   // One record per read
+    ASSERT_EQ(received.size(), 10u);
+    EXPECT_EQ(received.back().id, 10u);
+}
+
+TEST(UdsTransportTest, EverySubscriberGetsTheStream) {
+    UdsTradePublisher publisher(socket_path("fanout"));
+    UdsTradeSubscriber a(publisher.path()), b(publisher.path());
+    ASSERT_TRUE(a.connect());
+    ASSERT_TRUE(b.connect());
+    ASSERT_TRUE(publisher.wait_for_subscribers(2, 1000ms));
+
+    auto records = make_records(100, 1);
+    publisher.publish(records.data(), records.size());
+    EXPECT_EQ(read_n(a, 100).size(), 100u);
+    EXPECT_EQ(read_n(b, 100).size(), 100u);
+}
+
+TEST(UdsTransportTest, SlowSubscriberIsDroppedWithoutStallingOthers) {
+    constexpr size_t TOTAL = 100'000;           // Far past a socket buffer plus backlog
+    constexpr size_t WINDOW = 4'096;            // Most the reader may trail the publisher by
+    UdsTradePublisher publisher(socket_path("slow"), UdsTradePublisher::DEFAULT_QUEUE_CAPACITY,
+                                1'024, 50ms);
+    UdsTradeSubscriber stalled(publisher.path()), reader(publisher.path());
+    ASSERT_TRUE(stalled.connect());               // Never reads
+    ASSERT_TRUE(reader.connect());
+    ASSERT_TRUE(publisher.wait_for_subscribers(2, 1000ms));
+
+    std::vector<TradeRecord> received;
+    std::atomic<size_t> read_count{0};
+    std::thread consumer([&] {
+        std::vector<TradeRecord> buffer(256);
+        const auto deadline = std::chrono::steady_clock::now() + 30s;
+        while (received.size() < TOTAL && std::chrono::steady_clock::now() < deadline) {
+            const size_t got = reader.read(buffer.data(), buffer.size(), 10);
+            received.insert(received.end(), buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(got));
+            read_count.store(received.size(), std::memory_order_release);
+        }
+    });
+
+    // Publish only as far ahead of the reader as WINDOW, whatever the relative
+    // speed of sender and reader
+    auto records = make_records(TOTAL, 1);
+    const auto deadline = std::chrono::steady_clock::now() + 30s;
+    for (size_t done = 0; done < TOTAL && std::chrono::steady_clock::now() < deadline;) {
+        const size_t ahead = done - read_count.load(std::memory_order_acquire);
+        if (ahead >= WINDOW) {
+            std::this_thread::yield();
+            continue;
+        }
+        done += publisher.publish(records.data() + done, std::min(WINDOW - ahead, TOTAL - done));
+    }
+    EXPECT_TRUE(publisher.flush(5000ms));
+    consumer.join();
+
+    ASSERT_EQ(received.size(), TOTAL);
+    EXPECT_EQ(received.back().id, TOTAL);
+
+    // The stalled subscriber goes once its stall timeout has passed
+    while (publisher.subscribers() > 1 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(1ms);
+    }
+    EXPECT_EQ(publisher.slow_disconnects(), 1u);
+    EXPECT_EQ(publisher.subscribers(), 1u);
+}
+
+TEST(UdsTransportTest, TrailingReaderIsNotDropped) {
+    // Backlog far past max_backlog, but the reader keeps taking records
+    constexpr size_t TOTAL = 50'000;
+    UdsTradePublisher publisher(socket_path("trailing"), UdsTradePublisher::DEFAULT_QUEUE_CAPACITY,
+                                256, 1000ms);
+    UdsTradeSubscriber reader(publisher.path());
+    ASSERT_TRUE(reader.connect());
+    ASSERT_TRUE(publisher.wait_for_subscribers(1, 1000ms));
+
+    auto records = make_records(TOTAL, 1);
+    ASSERT_EQ(publisher.publish(records.data(), TOTAL), TOTAL);
+
+    auto received = read_n(reader, TOTAL, 1'024);
+    ASSERT_EQ(received.size(), TOTAL);
+    EXPECT_EQ(received.back().id, TOTAL);
+    EXPECT_EQ(publisher.slow_disconnects(), 0u);
+}
+
+TEST(UdsTransportTest, SubscriberSeesPublisherStop) {
+    UdsTradePublisher publisher(socket_path("stop"));
+    UdsTradeSubscriber subscriber(publisher.path());
+    ASSERT_TRUE(subscriber.connect());
+    ASSERT_TRUE(publisher.wait_for_subscribers(1, 1000ms));
+
+    publisher.stop();
+    TradeRecord r;
+    EXPECT_EQ(subscriber.read(&r, 1, 1000), 0u);
+    EXPECT_FALSE(subscriber.connected());
+    EXPECT_NE(access(publisher.path().c_str(), F_OK), 0);   // Socket file removed
+}
+
+TEST(UdsTransportTest, EngineSinkPublishesFills) {
+    UdsTradePublisher publisher(socket_path("engine"));
+    UdsTradeSubscriber subscriber(publisher.path());
+    ASSERT_TRUE(subscriber.connect());
+    ASSERT_TRUE(publisher.wait_for_subscribers(1, 1000ms));
+
+    MatchingEngine engine;
+    engine.add_book("AAPL");
+    engine.add_trade_sink(&publisher);
+    std::deque<Order> orders;
+    orders.emplace_back(1, "AAPL", Side::Sell, OrderType::Limit, 50, price_to_fixed(150.0));
+    orders.emplace_back(2, "AAPL", Side::Buy, OrderType::Limit, 20, price_to_fixed(150.0));
+    for (Order& o : orders) engine.add_order(&o);
+
+    auto received = read_n(subscriber, 1);
+    ASSERT_EQ(received.size(), 1u);
+    EXPECT_EQ(received[0].quantity, 20u);
+    EXPECT_EQ(received[0].sell_order_id, 1u);
+}
+
+// ============================================================================
+// Shared-memory ring
+// ============================================================================
+
+TEST(ShmTransportTest, ReaderSeesWrittenRecords) {
+    const std::string name = "/ob_shm_test_" + std::to_string(getpid());
+    ShmTradeWriter writer(name, 64);
+    ASSERT_TRUE(writer.ok());
+    ShmTradeReader reader(name);
+    ASSERT_TRUE(reader.ok());
+
+    TradeRecord out[64];
+    EXPECT_EQ(reader.read(out, 64), 0u);
+
+    auto records = make_records(10, 1);
+    EXPECT_EQ(writer.publish(records.data(), records.size()), 10u);
+    ASSERT_EQ(reader.read(out, 4), 4u);
+    EXPECT_EQ(out[3].id, 4u);
+    ASSERT_EQ(reader.read(out, 64), 6u);
+    EXPECT_EQ(out[5].id, 10u);
+}
+
+TEST(ShmTransportTest, FullRingDropsAndRecovers) {
+    const std::string name = "/ob_shm_full_" + std::to_string(getpid());
+    ShmTradeWriter writer(name, 4);
+    ShmTradeReader reader(name);
+
+    auto records = make_records(6, 1);
+    EXPECT_EQ(writer.publish(records.data(), 6), 4u);
+    EXPECT_EQ(writer.dropped(), 2u);
+
+    TradeRecord out[8];
+    ASSERT_EQ(reader.read(out, 8), 4u);
+    EXPECT_EQ(out[0].id, 1u);
+
+    // Wraps around the ring
+    EXPECT_EQ(writer.publish(records.data() + 4, 2), 2u);
+    ASSERT_EQ(reader.read(out, 8), 2u);
+    EXPECT_EQ(out[1].id, 6u);
+}
+
+TEST(ShmTransportTest, NewWriterDoesNotResetAnAttachedReader) {
+    const std::string name = "/ob_shm_replace_" + std::to_string(getpid());
+    ShmTradeWriter first(name, 16);
+    ShmTradeReader old_reader(name);
+    ASSERT_TRUE(old_reader.ok());
+    auto records = make_records(3, 1);
+    first.publish(records.data(), 3);
+
+    ShmTradeWriter second(name, 16);
+    ASSERT_TRUE(second.ok());
+    TradeRecord out[16];
+    ASSERT_EQ(old_reader.read(out, 16), 3u);           // Still the first ring
+    EXPECT_EQ(out[2].id, 3u);
+
+    ShmTradeReader new_reader(name);
+    ASSERT_TRUE(new_reader.ok());
+    EXPECT_EQ(new_reader.read(out, 16), 0u);
+    second.publish(records.data(), 1);
+    EXPECT_EQ(new_reader.read(out, 16), 1u);
+}
+
+TEST(ShmTransportTest, MissingRingIsNotOk) {
+    ShmTradeReader reader("/ob_shm_does_not_exist");
+    EXPECT_FALSE(reader.ok());
+}
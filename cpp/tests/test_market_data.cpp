@@ -0,0 +1,309 @@
+#include <gtest/gtest.h>
+#include "market_data.hpp"
+#include "matching_engine.hpp"
+#include <arpa/inet.h>
+#include <cstring>
+#include <deque>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace orderbook;
+
+// ============================================================================
+// Test Fixture
+// Publisher and receivers on loopback multicast, a fresh UDP port per test.
+// The handler records every delivered record's price and every loss.
+// ============================================================================
+
+namespace {
+
+struct Recorder : MarketDataHandler {
+    void on_packet(uint64_t sequence, const TradeRecord* records, size_t count) override {
+        sequences.push_back(sequence);
+        for (size_t i = 0; i < count; ++i) prices.push_back(records[i].price);
+    }
+    void on_loss(uint64_t from, uint64_t to) override { losses.emplace_back(from, to); }
+
+    std::vector<uint64_t> sequences;
+    std::vector<Price> prices;
+    std::vector<std::pair<uint64_t, uint64_t>> losses;
+};
+
+std::vector<TradeRecord> make_records(size_t n, Price first_price) {
+    std::vector<TradeRecord> records(n);
+    for (size_t i = 0; i < n; ++i) {
+        records[i].id = i + 1;
+        records[i].price = first_price + static_cast<Price>(i);
+        records[i].quantity = 1;
+    }
+    return records;
+}
+
+// Send hand-made packets to the group, in any order
+class RawSender {
+public:
+    explicit RawSender(const MarketDataConfig& config) : fd_(::socket(AF_INET, SOCK_DGRAM, 0)) {
+        in_addr local{};
+        ::inet_pton(AF_INET, config.interface.c_str(), &local);
+        setsockopt(fd_, IPPROTO_IP, IP_MULTICAST_IF, &local, sizeof(local));
+        group_.sin_family = AF_INET;
+        group_.sin_port = htons(config.port);
+        ::inet_pton(AF_INET, config.group.c_str(), &group_.sin_addr);
+    }
+    ~RawSender() { ::close(fd_); }
+
+    void send(uint64_t sequence, Price price) {
+        PacketHeader header;
+        header.count = 1;
+        header.sequence = sequence;
+        TradeRecord record = make_records(1, price)[0];
+        char packet[sizeof(header) + sizeof(record)];
+        std::memcpy(packet, &header, sizeof(header));
+        std::memcpy(packet + sizeof(header), &record, sizeof(record));
+        ::sendto(fd_, packet, sizeof(packet), 0, reinterpret_cast<sockaddr*>(&group_), sizeof(group_));
+    }
+
+private:
+    int fd_;
+    sockaddr_in group_{};
+};
+
+} // namespace
+
+class MarketDataTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        static uint16_t next_port = 0;
+        config.group = "239.255.42.1";
+        config.port = static_cast<uint16_t>(30000 + (getpid() % 1000) * 16 + next_port++ % 16);
+    }
+
+    MarketDataConfig receiver_config(const MarketDataPublisher& publisher, uint64_t start = 0) const {
+        MarketDataConfig c = config;
+        c.retransmit_port = publisher.retransmit_port();
+        c.start_sequence = start;
+        return c;
+    }
+
+    // Poll until `packets` have been delivered (or a generous timeout)
+    static void poll_for(MarketDataReceiver& receiver, const Recorder& recorder, size_t packets) {
+        for (int i = 0; i < 200 && recorder.sequences.size() < packets; ++i) {
+            receiver.poll(10);
+        }
+    }
+
+    MarketDataConfig config;
+};
+
+// ============================================================================
+// Publishing
+// ============================================================================
+
+TEST_F(MarketDataTest, ReceiverGetsPublishedRecords) {
+    MarketDataPublisher publisher(config);
+    ASSERT_TRUE(publisher.ok());
+    Recorder recorder;
+    MarketDataReceiver receiver(receiver_config(publisher), recorder);
+    ASSERT_TRUE(receiver.ok());
+
+    auto records = make_records(3, 1'000);
+    publisher.publish(records.data(), records.size());
+    poll_for(receiver, recorder, 1);
+
+    ASSERT_EQ(recorder.sequences, std::vector<uint64_t>{1});
+    EXPECT_EQ(recorder.prices, (std::vector<Price>{1'000, 1'001, 1'002}));
+    EXPECT_EQ(receiver.expected_sequence(), 2u);
+    EXPECT_EQ(receiver.gaps_detected(), 0u);
+}
+
+TEST_F(MarketDataTest, LargeBatchesSplitIntoPackets) {
+    MarketDataPublisher publisher(config);
+    Recorder recorder;
+    MarketDataReceiver receiver(receiver_config(publisher), recorder);
+
+    const size_t n = 2 * RECORDS_PER_PACKET + 5;
+    auto records = make_records(n, 0);
+    publisher.publish(records.data(), n);
+    EXPECT_EQ(publisher.next_sequence(), 4u);
+    poll_for(receiver, recorder, 3);
+
+    EXPECT_EQ(recorder.sequences, (std::vector<uint64_t>{1, 2, 3}));
+    ASSERT_EQ(recorder.prices.size(), n);
+    EXPECT_EQ(recorder.prices.back(), static_cast<Price>(n - 1));
+}
+
+TEST_F(MarketDataTest, EveryReceiverGetsEveryPacket) {
+    MarketDataPublisher publisher(config);
+    Recorder a, b;
+    MarketDataReceiver ra(receiver_config(publisher), a);
+    MarketDataReceiver rb(receiver_config(publisher), b);
+
+    auto records = make_records(1, 7);
+    publisher.publish(records.data(), 1);
+    poll_for(ra, a, 1);
+    poll_for(rb, b, 1);
+    EXPECT_EQ(a.prices, std::vector<Price>{7});
+    EXPECT_EQ(b.prices, std::vector<Price>{7});
+}
+
+// ============================================================================
+// Gap recovery
+// ============================================================================
+
+TEST_F(MarketDataTest, LateJoinerRecoversEarlierPackets) {
+    MarketDataPublisher publisher(config);
+    auto first = make_records(1, 100);
+    auto second = make_records(1, 200);
+    auto third = make_records(1, 300);
+    publisher.publish(first.data(), 1);
+    publisher.publish(second.data(), 1);
+
+    Recorder recorder;
+    MarketDataReceiver receiver(receiver_config(publisher, 1), recorder);
+    publisher.publish(third.data(), 1);                 // Reveals the gap [1, 3)
+    poll_for(receiver, recorder, 3);
+
+    EXPECT_EQ(recorder.sequences, (std::vector<uint64_t>{1, 2, 3}));
+    EXPECT_EQ(recorder.prices, (std::vector<Price>{100, 200, 300}));
+    EXPECT_EQ(receiver.gaps_detected(), 1u);
+    EXPECT_EQ(receiver.packets_recovered(), 2u);
+    EXPECT_TRUE(recorder.losses.empty());
+}
+
+TEST_F(MarketDataTest, HeartbeatRevealsMissedTail) {
+    MarketDataPublisher publisher(config);
+    auto records = make_records(1, 100);
+    publisher.publish(records.data(), 1);
+
+    Recorder recorder;
+    MarketDataReceiver receiver(receiver_config(publisher, 1), recorder);
+    publisher.heartbeat();
+    poll_for(receiver, recorder, 1);
+
+    EXPECT_EQ(recorder.prices, std::vector<Price>{100});
+    EXPECT_EQ(receiver.expected_sequence(), 2u);
+}
+
+TEST_F(MarketDataTest, OverwrittenPacketsAreReportedLost) {
+    config.retransmit_packets = 2;
+    MarketDataPublisher publisher(config);
+    for (Price p : {100, 200, 300, 400}) {
+        auto records = make_records(1, p);
+        publisher.publish(records.data(), 1);
+    }
+
+    Recorder recorder;
+    MarketDataReceiver receiver(receiver_config(publisher, 1), recorder);
+    auto records = make_records(1, 500);
+    publisher.publish(records.data(), 1);               // Ring now holds 4 and 5
+    poll_for(receiver, recorder, 2);
+
+    ASSERT_EQ(recorder.losses.size(), 1u);
+    EXPECT_EQ(recorder.losses[0], std::make_pair(uint64_t(1), uint64_t(4)));
+    EXPECT_EQ(recorder.prices, (std::vector<Price>{400, 500}));
+    EXPECT_EQ(receiver.packets_lost(), 3u);
+    EXPECT_EQ(receiver.packets_recovered(), 1u);
+}
+
+TEST_F(MarketDataTest, ReorderedPacketIsNotAGap) {
+    Recorder recorder;
+    MarketDataConfig c = config;
+    c.start_sequence = 1;
+    c.retransmit_port = 1;                               // Recovery would lose the packet
+    c.reorder_timeout_ms = 1'000;
+    MarketDataReceiver receiver(c, recorder);
+    ASSERT_TRUE(receiver.ok());
+
+    RawSender sender(config);
+    sender.send(2, 200);
+    sender.send(1, 100);                                 // Late, inside the window
+    sender.send(3, 300);
+    poll_for(receiver, recorder, 3);
+
+    EXPECT_EQ(recorder.sequences, (std::vector<uint64_t>{1, 2, 3}));
+    EXPECT_EQ(receiver.gaps_detected(), 0u);
+    EXPECT_TRUE(recorder.losses.empty());
+}
+
+TEST_F(MarketDataTest, GapIsRecoveredOnceTheReorderWindowCloses) {
+    MarketDataPublisher publisher(config);
+    auto first = make_records(1, 100);
+    publisher.publish(first.data(), 1);
+
+    Recorder recorder;
+    MarketDataConfig c = receiver_config(publisher, 1);
+    c.reorder_timeout_ms = 20;
+    MarketDataReceiver receiver(c, recorder);
+    auto second = make_records(1, 200);
+    publisher.publish(second.data(), 1);                 // Packet 1 never arrives by UDP
+
+    receiver.poll(0);
+    receiver.poll(0);
+    EXPECT_EQ(receiver.gaps_detected(), 0u);             // Still waiting for it
+    poll_for(receiver, recorder, 2);
+    EXPECT_EQ(recorder.prices, (std::vector<Price>{100, 200}));
+    EXPECT_EQ(receiver.gaps_detected(), 1u);
+    EXPECT_EQ(receiver.packets_recovered(), 1u);
+}
+
+TEST_F(MarketDataTest, BlockingPollWakesForAnOpenGap) {
+    MarketDataPublisher publisher(config);
+    auto first = make_records(1, 100);
+    publisher.publish(first.data(), 1);
+
+    Recorder recorder;
+    MarketDataConfig c = receiver_config(publisher, 1);
+    c.reorder_timeout_ms = 20;
+    MarketDataReceiver receiver(c, recorder);
+    auto second = make_records(1, 200);
+    publisher.publish(second.data(), 1);                 // Packet 1 never arrives by UDP
+
+    // The first wait returns with packet 2, the next when the window closes
+    for (int i = 0; i < 3 && recorder.sequences.size() < 2; ++i) {
+        receiver.poll(-1);
+    }
+    EXPECT_EQ(recorder.prices, (std::vector<Price>{100, 200}));
+    EXPECT_EQ(receiver.packets_recovered(), 1u);
+}
+
+TEST_F(MarketDataTest, UnreachableServiceSkipsTheGap) {
+    MarketDataPublisher publisher(config);
+    auto records = make_records(1, 100);
+    publisher.publish(records.data(), 1);
+
+    Recorder recorder;
+    MarketDataConfig c = receiver_config(publisher, 1);
+    c.retransmit_port = 1;                               // Nothing listens there
+    MarketDataReceiver receiver(c, recorder);
+    publisher.publish(records.data(), 1);
+    poll_for(receiver, recorder, 1);
+
+    ASSERT_EQ(recorder.losses.size(), 1u);
+    EXPECT_EQ(recorder.losses[0], std::make_pair(uint64_t(1), uint64_t(2)));
+    EXPECT_EQ(recorder.sequences, std::vector<uint64_t>{2});
+}
+
+// ============================================================================
+// Fed by the engine
+// ============================================================================
+
+TEST_F(MarketDataTest, EngineSinkPublishesFills) {
+    MarketDataPublisher publisher(config);
+    Recorder recorder;
+    MarketDataReceiver receiver(receiver_config(publisher), recorder);
+
+    MatchingEngine engine;
+    engine.add_book("AAPL");
+    engine.add_trade_sink(&publisher);
+
+    std::deque<Order> orders;
+    orders.emplace_back(1, "AAPL", Side::Sell, OrderType::Limit, 50, price_to_fixed(150.0));
+    orders.emplace_back(2, "AAPL", Side::Sell, OrderType::Limit, 50, price_to_fixed(151.0));
+    orders.emplace_back(3, "AAPL", Side::Buy, OrderType::Limit, 80, price_to_fixed(151.0));
+    for (Order& o : orders) engine.add_order(&o);
+    poll_for(receiver, recorder, 1);
+
+    EXPECT_EQ(recorder.sequences, std::vector<uint64_t>{1});      // One order, one packet
+    EXPECT_EQ(recorder.prices, (std::vector<Price>{price_to_fixed(150.0), price_to_fixed(151.0)}));
+}
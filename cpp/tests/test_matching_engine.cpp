@@ -0,0 +1,286 @@
+#include <gtest/gtest.h>
+#include "matching_engine.hpp"
+#include <deque>
+
+using namespace orderbook;
+
+// ============================================================================
+// Test Fixture
+// Two outright books (front and back month) and a calendar spread on them.
+// Orders live in a deque so their addresses stay stable while resting.
+// ============================================================================
+
+class MatchingEngineTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        engine.add_book("ESH6");
+        engine.add_book("ESM6");
+    }
+
+    Order& rest(const std::string& symbol, Side side, Quantity qty, double price) {
+        orders.emplace_back(next_id_++, symbol, side, OrderType::Limit, qty, price_to_fixed(price));
+        engine.add_order(&orders.back());
+        return orders.back();
+    }
+
+    // Buy front month, sell back month
+    MultiLegOrder calendar(Quantity qty, std::optional<double> limit = std::nullopt) {
+        MultiLegOrder order;
+        order.id = next_id_++;
+        order.legs = {{"ESH6", Side::Buy, 1}, {"ESM6", Side::Sell, 1}};
+        order.quantity = qty;
+        if (limit) order.limit_price = price_to_fixed(*limit);
+        return order;
+    }
+
+    MatchingEngine engine;
+    std::deque<Order> orders;
+    OrderId next_id_ = 1;
+};
+
+// ============================================================================
+// Routing
+// ============================================================================
+
+TEST_F(MatchingEngineTest, RoutesOrdersToTheirBook) {
+    rest("ESH6", Side::Buy, 10, 100.0);
+    rest("ESM6", Side::Sell, 10, 102.0);
+
+    EXPECT_EQ(engine.book("ESH6")->best_bid().value(), price_to_fixed(100.0));
+    EXPECT_EQ(engine.book("ESM6")->best_ask().value(), price_to_fixed(102.0));
+    EXPECT_EQ(engine.book_count(), 2u);
+}
+
+TEST_F(MatchingEngineTest, BooksGetDistinctInstrumentIds) {
+    rest("ESH6", Side::Sell, 10, 100.0);
+    Order buy(next_id_++, "ESH6", Side::Buy, OrderType::Limit, 10, price_to_fixed(100.0));
+    engine.add_order(&buy);
+
+    EXPECT_EQ(engine.book("ESH6")->config().instrument_id, 1);
+    EXPECT_EQ(engine.book("ESM6")->config().instrument_id, 2);
+    EXPECT_EQ(engine.book("ESH6")->trade_tape().at(0).instrument, 1);
+}
+
+TEST_F(MatchingEngineTest, OrderForUnknownSymbolIsRejected) {
+    Order o(next_id_++, "NQH6", Side::Buy, OrderType::Limit, 10, price_to_fixed(100.0));
+    auto trades = engine.add_order(&o);
+
+    EXPECT_TRUE(trades.empty());
+    EXPECT_EQ(o.status, OrderStatus::Rejected);
+    EXPECT_EQ(engine.cancel_order("NQH6", o.id), ErrorCode::BookNotFound);
+}
+
+// ============================================================================
+// estimate_fill()
+// ============================================================================
+
+TEST_F(MatchingEngineTest, EstimateFillWalksLevelsWithoutMutating) {
+    rest("ESH6", Side::Sell, 10, 100.0);
+    rest("ESH6", Side::Sell, 10, 101.0);
+    const OrderBook& book = *engine.book("ESH6");
+
+    FillEstimate e = book.estimate_fill(Side::Buy, 15);
+    EXPECT_EQ(e.quantity, 15u);
+    EXPECT_EQ(e.notional, price_to_fixed(100.0) * 10 + price_to_fixed(101.0) * 5);
+    EXPECT_EQ(e.worst_price, price_to_fixed(101.0));
+
+    FillEstimate limited = book.estimate_fill(Side::Buy, 15, price_to_fixed(100.0));
+    EXPECT_EQ(limited.quantity, 10u);
+
+    EXPECT_EQ(book.order_count(), 2u);
+    EXPECT_EQ(book.volume_at_price(Side::Sell, price_to_fixed(100.0)), 10u);
+}
+
+// ============================================================================
+// Multi-leg Orders
+// ============================================================================
+
+TEST_F(MatchingEngineTest, MultiLegExecutesAllLegs) {
+    auto& front_ask = rest("ESH6", Side::Sell, 10, 100.0);
+    auto& back_bid  = rest("ESM6", Side::Buy, 10, 102.0);
+
+    auto order = calendar(5);
+    std::vector<Trade> trades;
+    ASSERT_EQ(engine.execute_multi_leg(order, trades), ErrorCode::Success);
+
+    ASSERT_EQ(trades.size(), 2u);
+    EXPECT_EQ(order.status, OrderStatus::Filled);
+    EXPECT_EQ(front_ask.remaining_quantity(), 5u);
+    EXPECT_EQ(back_bid.remaining_quantity(), 5u);
+}
+
+TEST_F(MatchingEngineTest, MultiLegWithOneThinLegExecutesNothing) {
+    auto& front_ask = rest("ESH6", Side::Sell, 10, 100.0);
+    auto& back_bid  = rest("ESM6", Side::Buy, 3, 102.0);
+
+    auto order = calendar(5);
+    std::vector<Trade> trades;
+    EXPECT_EQ(engine.execute_multi_leg(order, trades), ErrorCode::InsufficientLiquidity);
+
+    EXPECT_TRUE(trades.empty());
+    EXPECT_EQ(order.status, OrderStatus::Rejected);
+    EXPECT_EQ(front_ask.remaining_quantity(), 10u);  // Untouched
+    EXPECT_EQ(back_bid.remaining_quantity(), 3u);
+}
+
+TEST_F(MatchingEngineTest, MultiLegRespectsNetLimit) {
+    rest("ESH6", Side::Sell, 10, 100.0);
+    rest("ESM6", Side::Buy, 10, 102.0);
+
+    // Buy at 100, sell at 102: net credit of 2 per unit (net debit -2)
+    std::vector<Trade> trades;
+    auto too_greedy = calendar(5, -3.0);
+    EXPECT_EQ(engine.execute_multi_leg(too_greedy, trades), ErrorCode::PriceLimitExceeded);
+    EXPECT_TRUE(trades.empty());
+
+    auto ok = calendar(5, -2.0);
+    EXPECT_EQ(engine.execute_multi_leg(ok, trades), ErrorCode::Success);
+}
+
+TEST_F(MatchingEngineTest, MultiLegNotionalOverflowIsRejected) {
+    // 5,000,000.0 * 4,294,967,295 in fixed point is far past int64
+    rest("ESH6", Side::Sell, MAX_ORDER_QUANTITY, 5'000'000.0);
+    rest("ESM6", Side::Buy, MAX_ORDER_QUANTITY, 1.0);
+
+    EXPECT_TRUE(engine.book("ESH6")->estimate_fill(Side::Buy, MAX_ORDER_QUANTITY).overflow);
+
+    std::vector<Trade> trades;
+    auto order = calendar(MAX_ORDER_QUANTITY, 1.0);
+    EXPECT_EQ(engine.execute_multi_leg(order, trades), ErrorCode::PriceLimitExceeded);
+    EXPECT_TRUE(trades.empty());
+
+    // Without a limit there is nothing to compare the notional against
+    EXPECT_EQ(engine.check_multi_leg(calendar(MAX_ORDER_QUANTITY)), ErrorCode::Success);
+}
+
+TEST_F(MatchingEngineTest, MultiLegQuantityTimesRatioMustFitAnOrder) {
+    rest("ESH6", Side::Sell, 10, 100.0);
+    rest("ESM6", Side::Buy, 10, 102.0);
+
+    auto order = calendar(1u << 20);
+    order.legs[0].ratio = 1u << 20;                  // 2^40 per leg
+    EXPECT_EQ(engine.check_multi_leg(order), ErrorCode::InvalidQuantity);
+
+    order.legs[0].ratio = std::numeric_limits<Quantity>::max();   // Wraps in 64 bits
+    EXPECT_EQ(engine.check_multi_leg(order), ErrorCode::InvalidQuantity);
+
+    EXPECT_EQ(engine.check_multi_leg(calendar(MAX_ORDER_QUANTITY + 1)), ErrorCode::InvalidQuantity);
+}
+
+TEST_F(MatchingEngineTest, MultiLegRejectsRepeatedBook) {
+    rest("ESH6", Side::Sell, 10, 100.0);
+
+    MultiLegOrder order;
+    order.legs = {{"ESH6", Side::Buy, 1}, {"ESH6", Side::Buy, 1}};
+    order.quantity = 5;
+    EXPECT_EQ(engine.check_multi_leg(order), ErrorCode::InvalidOrderType);
+}
+
+TEST_F(MatchingEngineTest, MultiLegRejectsIdRestingInALegBook) {
+    auto& front_ask = rest("ESH6", Side::Sell, 10, 100.0);
+    auto& back_bid  = rest("ESM6", Side::Buy, 10, 102.0);
+
+    auto order = calendar(5);
+    order.id = back_bid.id;                          // The ESM6 leg would be refused
+    std::vector<Trade> trades;
+    EXPECT_EQ(engine.execute_multi_leg(order, trades), ErrorCode::DuplicateOrderId);
+
+    EXPECT_TRUE(trades.empty());
+    EXPECT_EQ(order.status, OrderStatus::Rejected);
+    EXPECT_EQ(front_ask.remaining_quantity(), 10u);  // Untouched
+    EXPECT_EQ(back_bid.remaining_quantity(), 10u);
+}
+
+// ============================================================================
+// Implied-in Pricing
+// ============================================================================
+
+TEST_F(MatchingEngineTest, ImpliedPriceFromOutrights) {
+    auto spread = engine.register_spread({{"ESH6", Side::Buy, 1}, {"ESM6", Side::Sell, 1}});
+    EXPECT_FALSE(engine.implied_price(spread).bid.has_value());
+    EXPECT_FALSE(engine.implied_price(spread).ask.has_value());
+
+    rest("ESH6", Side::Buy, 10, 99.0);
+    rest("ESH6", Side::Sell, 10, 100.0);
+    rest("ESM6", Side::Buy, 10, 102.0);
+    rest("ESM6", Side::Sell, 10, 103.0);
+
+    // ask = 100 - 102, bid = 99 - 103
+    EXPECT_EQ(engine.implied_price(spread).ask.value(), price_to_fixed(-2.0));
+    EXPECT_EQ(engine.implied_price(spread).bid.value(), price_to_fixed(-4.0));
+}
+
+TEST_F(MatchingEngineTest, ImpliedPriceUpdatesWhenLegBboChanges) {
+    auto spread = engine.register_spread({{"ESH6", Side::Buy, 1}, {"ESM6", Side::Sell, 2}});
+    auto& front_ask = rest("ESH6", Side::Sell, 10, 100.0);
+    rest("ESH6", Side::Sell, 10, 101.0);
+    rest("ESM6", Side::Buy, 10, 50.0);
+
+    EXPECT_EQ(engine.implied_price(spread).ask.value(), price_to_fixed(0.0));
+
+    engine.cancel_order("ESH6", front_ask.id);
+    EXPECT_EQ(engine.implied_price(spread).ask.value(), price_to_fixed(1.0));
+}
+
+TEST_F(MatchingEngineTest, RegisterSpreadRejectsBadLegs) {
+    EXPECT_EQ(engine.register_spread({}), MatchingEngine::INVALID_SPREAD);
+    EXPECT_EQ(engine.register_spread({{"ESH6", Side::Buy, 0}}), MatchingEngine::INVALID_SPREAD);
+    EXPECT_EQ(engine.register_spread({{"ESH6", Side::Buy, MAX_ORDER_QUANTITY + 1}}),
+              MatchingEngine::INVALID_SPREAD);
+    EXPECT_EQ(engine.register_spread({{"ESH6", Side::Buy, 1}, {"NOPE", Side::Sell, 1}}),
+              MatchingEngine::INVALID_SPREAD);
+    EXPECT_EQ(engine.register_spread({{"ESH6", Side::Buy, 1}}), 0u);   // Nothing was half-registered
+}
+
+TEST_F(MatchingEngineTest, ImpliedPriceThatDoesNotFitIsUnset) {
+    auto spread = engine.register_spread({{"ESH6", Side::Buy, MAX_ORDER_QUANTITY},
+                                          {"ESM6", Side::Sell, 1}});
+    rest("ESH6", Side::Sell, 10, 10'000.0);            // ratio * ask is past int64
+    rest("ESM6", Side::Buy, 10, 100.0);
+    EXPECT_FALSE(engine.implied_price(spread).ask.has_value());
+
+    auto small = engine.register_spread({{"ESH6", Side::Buy, 2}, {"ESM6", Side::Sell, 1}});
+    EXPECT_EQ(engine.implied_price(small).ask.value(), price_to_fixed(19'900.0));
+}
+
+// ============================================================================
+// Trade Sinks
+// ============================================================================
+
+namespace {
+
+struct RecordingSink : TradeSink {
+    void on_trades(const OrderBook&, const TradeRecord* records, size_t count) override {
+        received.insert(received.end(), records, records + count);
+    }
+    std::vector<TradeRecord> received;
+};
+
+} // namespace
+
+TEST_F(MatchingEngineTest, SinksGetEveryFillOfAnOrderLargerThanTheTape) {
+    for (size_t tape : {size_t{16}, size_t{0}}) {
+        OrderBookConfig config;
+        config.trade_tape = tape;
+        const std::string symbol = "TAPE" + std::to_string(tape);
+        engine.add_book(symbol, config);
+        RecordingSink sink;
+        engine.add_trade_sink(&sink);
+
+        constexpr Quantity FILLS = 100;
+        for (Quantity i = 0; i < FILLS; ++i) rest(symbol, Side::Sell, 1, 100.0);
+        Order& buy = rest(symbol, Side::Buy, FILLS, 100.0);
+
+        ASSERT_EQ(sink.received.size(), FILLS) << "tape " << tape;
+        for (size_t i = 0; i < sink.received.size(); ++i) {
+            EXPECT_EQ(sink.received[i].id, i + 1);
+            EXPECT_EQ(sink.received[i].buy_order_id, buy.id);
+        }
+
+        // Small orders after the overrun come from the tape again
+        rest(symbol, Side::Sell, 1, 100.0);
+        rest(symbol, Side::Buy, 1, 100.0);
+        EXPECT_EQ(sink.received.size(), FILLS + 1);
+        engine.remove_trade_sink(&sink);
+    }
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include "node_pool.hpp"
+#include "counting_allocator.hpp"
+#include <list>
+#include <set>
+
+using namespace orderbook;
+
+// ============================================================================
+// NodePool
+// ============================================================================
+
+TEST(NodePoolTest, FirstAllocationCarvesHintedChunk) {
+    NodePool pool(1000);
+    void* p = pool.allocate(24);
+
+    EXPECT_NE(p, nullptr);
+    EXPECT_EQ(pool.node_size(), 24u);
+    EXPECT_EQ(pool.capacity(), 1000u);
+    EXPECT_EQ(pool.free_nodes(), 999u);
+}
+
+TEST(NodePoolTest, FreedNodeIsReused) {
+    NodePool pool(256);
+    void* a = pool.allocate(32);
+    pool.deallocate(a);
+    void* b = pool.allocate(32);
+
+    EXPECT_EQ(a, b);
+}
+
+TEST(NodePoolTest, GrowsWhenExhausted) {
+    NodePool pool(256);
+    std::set<void*> seen;
+    for (int i = 0; i < 300; ++i) {
+        seen.insert(pool.allocate(16));
+    }
+
+    EXPECT_EQ(seen.size(), 300u);       // All distinct
+    EXPECT_EQ(pool.capacity(), 512u);   // Doubled once
+}
+
+TEST(NodePoolTest, OnlyServesItsNodeSize) {
+    NodePool pool(256);
+    pool.allocate(40);
+
+    EXPECT_TRUE(pool.serves(40));
+    EXPECT_TRUE(pool.serves(36));       // Rounds up to the same node
+    EXPECT_FALSE(pool.serves(64));
+}
+
+// ============================================================================
+// CountingAllocator
+// ============================================================================
+
+TEST(CountingAllocatorTest, CountsContainerNodes) {
+    auto counter = std::make_shared<AllocationCounter>();
+    std::list<int, CountingAllocator<int>> list{CountingAllocator<int>(counter)};
+
+    list.push_back(1);
+    list.push_back(2);
+    EXPECT_EQ(counter->allocations, 2u);
+    EXPECT_GE(counter->bytes, 2 * sizeof(int));
+
+    list.clear();
+    EXPECT_EQ(counter->allocations, 0u);
+    EXPECT_EQ(counter->bytes, 0u);
+}
+
+TEST(CountingAllocatorTest, RoutesNodesThroughPool) {
+    auto counter = std::make_shared<AllocationCounter>();
+    counter->pool = std::make_unique<NodePool>(256);
+    std::list<int, CountingAllocator<int>> list{CountingAllocator<int>(counter)};
+
+    list.push_back(1);
+    EXPECT_EQ(counter->pool->free_nodes(), 255u);
+    list.pop_back();
+    EXPECT_EQ(counter->pool->free_nodes(), 256u);
+}
+
+TEST(CountingAllocatorTest, DefaultAllocatorCountsNothing) {
+    CountingAllocator<int> alloc;
+    int* p = alloc.allocate(4);
+    EXPECT_EQ(alloc.bytes(), 0u);
+    alloc.deallocate(p, 4);
+}
+
+TEST(CountingAllocatorTest, EqualOnlyWhenSharingACounter) {
+    auto counter = std::make_shared<AllocationCounter>();
+    CountingAllocator<int> a(counter);
+    CountingAllocator<long> rebound(a);
+
+    EXPECT_TRUE(a == rebound);
+    EXPECT_FALSE(a == CountingAllocator<int>(std::make_shared<AllocationCounter>()));
+    EXPECT_TRUE(a != CountingAllocator<int>());
+    EXPECT_TRUE(CountingAllocator<int>() == CountingAllocator<int>());
+    EXPECT_FALSE(std::allocator_traits<CountingAllocator<int>>::is_always_equal::value);
+}
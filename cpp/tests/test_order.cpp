@@ -193,6 +193,23 @@ TEST(OrderTest, CancelAlreadyCancelledFails) {
     EXPECT_EQ(o.status, OrderStatus::Cancelled);
 }
 
+TEST(OrderTest, ExpireNewOrder) {
+    Order o(1, "AAPL", Side::Buy, OrderType::Limit, 100, price_to_fixed(150.0));
+    bool result = o.expire();
+
+    EXPECT_TRUE(result);
+    EXPECT_EQ(o.status, OrderStatus::Expired);
+    EXPECT_FALSE(o.is_active());
+}
+
+TEST(OrderTest, ExpireFilledOrderFails) {
+    Order o(1, "AAPL", Side::Buy, OrderType::Limit, 100, price_to_fixed(150.0));
+    o.fill(100);
+
+    EXPECT_FALSE(o.expire());
+    EXPECT_EQ(o.status, OrderStatus::Filled);
+}
+
 // ============================================================================
 // validate_order()
 // ============================================================================
@@ -212,6 +229,13 @@ TEST(ValidateOrderTest, ZeroQuantityRejected) {
     EXPECT_EQ(validate_order(o), ErrorCode::InvalidQuantity);
 }
 
+TEST(ValidateOrderTest, QuantityAboveCapRejected) {
+    Order o(1, "AAPL", Side::Buy, OrderType::Limit, MAX_ORDER_QUANTITY + 1, price_to_fixed(150.0));
+    EXPECT_EQ(validate_order(o), ErrorCode::InvalidQuantity);
+    o.quantity = MAX_ORDER_QUANTITY;
+    EXPECT_EQ(validate_order(o), ErrorCode::Success);
+}
+
 TEST(ValidateOrderTest, LimitOrderWithNoPriceRejected) {
     Order o(1, "AAPL", Side::Buy, OrderType::Limit, 100, 0);
     EXPECT_EQ(validate_order(o), ErrorCode::InvalidPrice);
@@ -232,3 +256,12 @@ TEST(ValidateOrderTest, MarketOrderDoesNotNeedPrice) {
     Order o(1, "AAPL", Side::Buy, OrderType::Market, 50);
     EXPECT_EQ(validate_order(o), ErrorCode::Success);
 }
+
+TEST(ValidateOrderTest, GoodTillTimeWithoutExpireTimeRejected) {
+    Order o(1, "AAPL", Side::Buy, OrderType::Limit, 100, price_to_fixed(150.0));
+    o.time_in_force = TimeInForce::GoodTillTime;
+    EXPECT_EQ(validate_order(o), ErrorCode::InvalidExpireTime);
+
+    o.expire_time = now() + std::chrono::seconds(30);
+    EXPECT_EQ(validate_order(o), ErrorCode::Success);
+}
@@ -512,3 +512,526 @@ TEST_F(OrderBookTest, TradeIdsAreUnique) {
     ASSERT_EQ(trades.size(), 2u);
     EXPECT_NE(trades[0].id, trades[1].id);
 }
+
+TEST_F(OrderBookTest, TradeTapeRecordsEveryFill) {
+    auto s1 = make_limit_sell(50, 150.0);
+    auto s2 = make_limit_sell(50, 151.0);
+    book.add_order(&s1);
+    book.add_order(&s2);
+
+    auto buy = make_limit_buy(80, 151.0);
+    auto trades = book.add_order(&buy);
+
+    const TradeTape& tape = book.trade_tape();
+    ASSERT_EQ(tape.head(), trades.size());
+    for (size_t i = 0; i < trades.size(); ++i) {
+        const TradeRecord& r = tape.at(i);
+        EXPECT_EQ(r.id, trades[i].id);
+        EXPECT_EQ(r.buy_order_id, buy.id);
+        EXPECT_EQ(r.price, trades[i].price);
+        EXPECT_EQ(r.quantity, trades[i].quantity);
+        EXPECT_EQ(r.aggressor_side, Side::Buy);
+    }
+}
+
+TEST_F(OrderBookTest, OversizedOrderIsRejected) {
+    auto buy = make_limit_buy(MAX_ORDER_QUANTITY + 1, 150.0);
+    book.add_order(&buy);
+
+    EXPECT_EQ(buy.status, OrderStatus::Rejected);
+    EXPECT_TRUE(book.empty());
+}
+
+// ============================================================================
+// Good-Till-Time Expiry
+// ============================================================================
+
+TEST_F(OrderBookTest, GoodTillTimeOrderExpiresOnTick) {
+    const auto t0 = now();
+    auto buy = make_limit_buy(100, 150.0);
+    buy.time_in_force = TimeInForce::GoodTillTime;
+    buy.expire_time = t0 + std::chrono::seconds(5);
+    book.add_order(&buy);
+
+    EXPECT_EQ(book.tick(t0 + std::chrono::seconds(4)), 0u);
+    EXPECT_EQ(book.order_count(), 1u);
+
+    EXPECT_EQ(book.tick(t0 + std::chrono::seconds(6)), 1u);
+    EXPECT_EQ(buy.status, OrderStatus::Expired);
+    EXPECT_TRUE(book.empty());
+    EXPECT_EQ(book.bid_levels(), 0u);
+}
+
+TEST_F(OrderBookTest, GoodTillCancelOrderNeverExpires) {
+    auto buy = make_limit_buy(100, 150.0);
+    book.add_order(&buy);
+
+    EXPECT_EQ(book.tick(now() + std::chrono::hours(24 * 365)), 0u);
+    EXPECT_EQ(buy.status, OrderStatus::New);
+    EXPECT_EQ(book.order_count(), 1u);
+}
+
+TEST_F(OrderBookTest, GoodTillTimeWithoutExpireTimeIsRejected) {
+    auto buy = make_limit_buy(100, 150.0);
+    buy.time_in_force = TimeInForce::GoodTillTime;
+    book.add_order(&buy);
+
+    EXPECT_EQ(buy.status, OrderStatus::Rejected);
+    EXPECT_TRUE(book.empty());
+}
+
+TEST_F(OrderBookTest, CancelledGoodTillTimeOrderDoesNotExpire) {
+    const auto t0 = now();
+    auto buy = make_limit_buy(100, 150.0);
+    buy.time_in_force = TimeInForce::GoodTillTime;
+    buy.expire_time = t0 + std::chrono::seconds(1);
+    book.add_order(&buy);
+    book.cancel_order(buy.id);
+
+    EXPECT_EQ(book.tick(t0 + std::chrono::seconds(2)), 0u);
+    EXPECT_EQ(buy.status, OrderStatus::Cancelled);
+}
+
+TEST_F(OrderBookTest, FilledGoodTillTimeOrderDoesNotExpire) {
+    const auto t0 = now();
+    auto sell = make_limit_sell(100, 150.0);
+    sell.time_in_force = TimeInForce::GoodTillTime;
+    sell.expire_time = t0 + std::chrono::seconds(1);
+    book.add_order(&sell);
+
+    auto buy = make_limit_buy(100, 150.0);
+    book.add_order(&buy);
+
+    EXPECT_EQ(book.tick(t0 + std::chrono::seconds(2)), 0u);
+    EXPECT_EQ(sell.status, OrderStatus::Filled);
+}
+
+TEST_F(OrderBookTest, ExpiryIsProcessedInBatches) {
+    const auto t0 = now();
+    std::vector<Order> orders;
+    orders.reserve(10);
+    for (int i = 0; i < 10; ++i) {
+        orders.push_back(make_limit_buy(10, 150.0 - i));
+        orders.back().time_in_force = TimeInForce::GoodTillTime;
+        orders.back().expire_time = t0 + std::chrono::seconds(1);
+    }
+    for (auto& o : orders) book.add_order(&o);
+
+    const auto later = t0 + std::chrono::seconds(2);
+    EXPECT_EQ(book.tick(later, 4), 4u);
+    EXPECT_EQ(book.pending_expiries(), 6u);
+    EXPECT_EQ(book.order_count(), 6u);
+
+    EXPECT_EQ(book.tick(later, 4), 4u);
+    EXPECT_EQ(book.tick(later, 4), 2u);
+    EXPECT_TRUE(book.empty());
+    EXPECT_EQ(book.pending_expiries(), 0u);
+}
+
+// ============================================================================
+// Mass Cancel
+// ============================================================================
+
+TEST_F(OrderBookTest, CancelOrdersRemovesAllListed) {
+    auto b1 = make_limit_buy(100, 150.0);
+    auto b2 = make_limit_buy(100, 149.0);
+    auto s1 = make_limit_sell(100, 151.0);
+    book.add_order(&b1);
+    book.add_order(&b2);
+    book.add_order(&s1);
+
+    EXPECT_EQ(book.cancel_orders({b1.id, s1.id, 9999}), 2u);
+    EXPECT_EQ(book.order_count(), 1u);
+    EXPECT_EQ(b1.status, OrderStatus::Cancelled);
+    EXPECT_EQ(s1.status, OrderStatus::Cancelled);
+    EXPECT_EQ(book.best_bid().value(), price_to_fixed(149.0));
+    EXPECT_FALSE(book.best_ask().has_value());
+}
+
+// ============================================================================
+// Order Handles
+// ============================================================================
+
+TEST_F(OrderBookTest, HandleCancelsRestingOrder) {
+    auto b1 = make_limit_buy(100, 150.0);
+    OrderHandle handle;
+    book.add_order(&b1, handle);
+
+    ASSERT_FALSE(handle.is_null());
+    EXPECT_EQ(book.handle_of(b1.id), handle);
+    EXPECT_EQ(book.cancel_order(handle), ErrorCode::Success);
+    EXPECT_EQ(b1.status, OrderStatus::Cancelled);
+    EXPECT_TRUE(book.empty());
+    EXPECT_TRUE(book.verify().ok());
+}
+
+TEST_F(OrderBookTest, NoHandleForOrderThatDoesNotRest) {
+    auto s1 = make_limit_sell(100, 150.0);
+    auto b1 = make_limit_buy(100, 150.0);
+    auto bad = make_limit_buy(0, 150.0);
+    OrderHandle handle{7, 7};
+
+    book.add_order(&s1);
+    book.add_order(&b1, handle);
+    EXPECT_TRUE(handle.is_null());                 // Fully filled
+
+    book.add_order(&bad, handle);
+    EXPECT_TRUE(handle.is_null());                 // Rejected
+    EXPECT_EQ(book.cancel_order(OrderHandle{}), ErrorCode::OrderNotFound);
+}
+
+TEST_F(OrderBookTest, StaleHandleIsRejectedAfterSlotReuse) {
+    auto b1 = make_limit_buy(100, 150.0);
+    auto b2 = make_limit_buy(100, 149.0);
+    OrderHandle h1, h2;
+
+    book.add_order(&b1, h1);
+    book.cancel_order(b1.id);                      // Cancelled by id: handle goes stale too
+    book.add_order(&b2, h2);
+
+    EXPECT_EQ(h1.index, h2.index);                 // Slot recycled...
+    EXPECT_NE(h1, h2);                             // ...under a new generation
+    EXPECT_EQ(book.cancel_order(h1), ErrorCode::OrderNotFound);
+    EXPECT_EQ(b2.status, OrderStatus::New);
+    EXPECT_EQ(book.cancel_order(h2), ErrorCode::Success);
+}
+
+TEST_F(OrderBookTest, HandleGoesStaleWhenOrderFills) {
+    auto s1 = make_limit_sell(100, 150.0);
+    OrderHandle handle;
+    book.add_order(&s1, handle);
+
+    auto b1 = make_market_buy(100);
+    book.add_order(&b1);
+    EXPECT_EQ(book.cancel_order(handle), ErrorCode::OrderNotFound);
+    EXPECT_EQ(book.modify_order(handle, 10), ErrorCode::OrderNotFound);
+}
+
+TEST_F(OrderBookTest, DuplicateLiveIdIsRejected) {
+    auto b1 = make_limit_buy(100, 150.0);
+    auto dup = make_limit_buy(100, 149.0);
+    dup.id = b1.id;
+    OrderHandle h1, h2{7, 7};
+
+    book.add_order(&b1, h1);
+    EXPECT_TRUE(book.add_order(&dup, h2).empty());
+    EXPECT_EQ(dup.status, OrderStatus::Rejected);
+    EXPECT_TRUE(h2.is_null());
+    EXPECT_EQ(book.order_count(), 1u);
+
+    EXPECT_EQ(book.cancel_order(h1), ErrorCode::Success);   // Still the original order
+    EXPECT_EQ(b1.status, OrderStatus::Cancelled);
+    EXPECT_TRUE(book.empty());
+    EXPECT_TRUE(book.verify().ok());
+}
+
+TEST_F(OrderBookTest, ForeignIndexHandleIsRejected) {
+    EXPECT_EQ(book.cancel_order(OrderHandle{12345, 1}), ErrorCode::OrderNotFound);
+}
+
+// ============================================================================
+// Modify
+// ============================================================================
+
+TEST_F(OrderBookTest, ModifyDownKeepsQueuePosition) {
+    auto b1 = make_limit_buy(100, 150.0);
+    auto b2 = make_limit_buy(100, 150.0);
+    OrderHandle h1;
+    book.add_order(&b1, h1);
+    book.add_order(&b2);
+
+    EXPECT_EQ(book.modify_order(h1, 40), ErrorCode::Success);
+    EXPECT_EQ(book.volume_at_price(Side::Buy, price_to_fixed(150.0)), 140u);
+
+    auto s1 = make_limit_sell(40, 150.0);
+    auto trades = book.add_order(&s1);
+    ASSERT_EQ(trades.size(), 1u);
+    EXPECT_EQ(trades[0].buy_order_id, b1.id);      // Still first in line
+    EXPECT_EQ(b1.status, OrderStatus::Filled);
+    EXPECT_TRUE(book.verify().ok());
+}
+
+TEST_F(OrderBookTest, ModifyUpLosesQueuePosition) {
+    auto b1 = make_limit_buy(100, 150.0);
+    auto b2 = make_limit_buy(100, 150.0);
+    book.add_order(&b1);
+    book.add_order(&b2);
+
+    EXPECT_EQ(book.modify_order(b1.id, 150), ErrorCode::Success);
+    EXPECT_EQ(book.volume_at_price(Side::Buy, price_to_fixed(150.0)), 250u);
+
+    auto s1 = make_limit_sell(50, 150.0);
+    auto trades = book.add_order(&s1);
+    ASSERT_EQ(trades.size(), 1u);
+    EXPECT_EQ(trades[0].buy_order_id, b2.id);
+    EXPECT_TRUE(book.verify().ok());
+}
+
+TEST_F(OrderBookTest, ModifyAppliesToOpenQuantityOfPartialFill) {
+    auto b1 = make_limit_buy(100, 150.0);
+    book.add_order(&b1);
+    auto s1 = make_limit_sell(30, 150.0);
+    book.add_order(&s1);
+
+    EXPECT_EQ(book.modify_order(b1.id, 20), ErrorCode::Success);
+    EXPECT_EQ(b1.remaining_quantity(), 20u);
+    EXPECT_EQ(b1.filled_quantity, 30u);
+    EXPECT_EQ(book.volume_at_price(Side::Buy, price_to_fixed(150.0)), 20u);
+    EXPECT_EQ(book.modify_order(b1.id, 0), ErrorCode::InvalidQuantity);
+    EXPECT_EQ(book.modify_order(9999, 10), ErrorCode::OrderNotFound);
+    EXPECT_TRUE(book.verify().ok());
+}
+
+TEST_F(OrderBookTest, ModifyRespectsMaxOrderQuantity) {
+    auto b1 = make_limit_buy(100, 150.0);
+    book.add_order(&b1);
+    auto s1 = make_limit_sell(30, 150.0);
+    book.add_order(&s1);                          // 30 filled, 70 open
+
+    EXPECT_EQ(book.modify_order(b1.id, MAX_ORDER_QUANTITY + 1), ErrorCode::InvalidQuantity);
+    EXPECT_EQ(book.modify_order(b1.id, MAX_ORDER_QUANTITY), ErrorCode::InvalidQuantity);
+    EXPECT_EQ(b1.remaining_quantity(), 70u);      // Unchanged
+    EXPECT_EQ(book.volume_at_price(Side::Buy, price_to_fixed(150.0)), 70u);
+
+    EXPECT_EQ(book.modify_order(b1.id, MAX_ORDER_QUANTITY - 30), ErrorCode::Success);
+    EXPECT_EQ(b1.quantity, MAX_ORDER_QUANTITY);
+    EXPECT_TRUE(book.verify().ok());
+}
+
+// ============================================================================
+// Empty Level Retention
+// ============================================================================
+
+TEST_F(OrderBookTest, EmptiedTouchIsRetainedButInvisible) {
+    OrderBookConfig config;
+    config.retain_empty_levels = 2;
+    book = OrderBook("AAPL", config);
+
+    auto s1 = make_limit_sell(100, 150.0);
+    auto s2 = make_limit_sell(100, 151.0);
+    book.add_order(&s1);
+    book.add_order(&s2);
+    const size_t level_bytes = book.memory_stats().levels;
+
+    auto b1 = make_limit_buy(100, 150.0);
+    book.add_order(&b1);                           // Empties 150.0
+
+    EXPECT_EQ(book.memory_stats().levels, level_bytes);   // Node kept
+    EXPECT_EQ(book.best_ask(), price_to_fixed(151.0));
+    EXPECT_EQ(book.ask_levels(), 1u);
+    BookSnapshot snap;
+    book.snapshot(snap);
+    ASSERT_EQ(snap.ask_depth, 1u);
+    EXPECT_EQ(snap.asks[0].price, price_to_fixed(151.0));
+    EXPECT_EQ(book.estimate_fill(Side::Buy, 50).worst_price, price_to_fixed(151.0));
+    EXPECT_TRUE(book.verify().ok());
+
+    auto s3 = make_limit_sell(10, 150.0);
+    book.add_order(&s3);                           // Revives it, no new node
+    EXPECT_EQ(book.memory_stats().levels, level_bytes);
+    EXPECT_EQ(book.best_ask(), price_to_fixed(150.0));
+    EXPECT_EQ(book.ask_levels(), 2u);
+    EXPECT_TRUE(book.verify().ok());
+}
+
+TEST_F(OrderBookTest, MatchingStepsOverRetainedLevels) {
+    OrderBookConfig config;
+    config.retain_empty_levels = 4;
+    book = OrderBook("AAPL", config);
+
+    std::vector<Order> sells;
+    sells.reserve(3);
+    for (double price : {150.0, 150.5, 151.0}) {
+        sells.push_back(make_limit_sell(100, price));
+        book.add_order(&sells.back());
+    }
+    book.cancel_order(sells[0].id);
+    book.cancel_order(sells[1].id);
+
+    auto b1 = make_limit_buy(150, 151.0);
+    auto trades = book.add_order(&b1);
+    ASSERT_EQ(trades.size(), 1u);
+    EXPECT_EQ(trades[0].price, price_to_fixed(151.0));
+    EXPECT_EQ(book.best_bid(), price_to_fixed(151.0));    // Rest of b1
+    EXPECT_FALSE(book.best_ask().has_value());
+    EXPECT_TRUE(book.verify().ok());
+}
+
+TEST_F(OrderBookTest, FullRetentionBudgetKeepsLevelsNearestTouch) {
+    OrderBookConfig config;
+    config.retain_empty_levels = 1;
+    book = OrderBook("AAPL", config);
+
+    auto b1 = make_limit_buy(100, 149.0);
+    auto b2 = make_limit_buy(100, 150.0);
+    auto b3 = make_limit_buy(100, 148.0);
+    book.add_order(&b1);
+    book.add_order(&b2);
+    book.add_order(&b3);
+    const size_t one_level = book.memory_stats().levels / 3;
+
+    book.cancel_order(b1.id);                      // 149 retained
+    book.cancel_order(b2.id);                      // 150 is nearer: replaces 149
+    EXPECT_EQ(book.memory_stats().levels, 2 * one_level);
+    book.cancel_order(b3.id);                      // 148 is farther: erased
+    EXPECT_EQ(book.memory_stats().levels, one_level);
+
+    auto b4 = make_limit_buy(100, 150.0);
+    book.add_order(&b4);                           // Reuses the retained 150 level
+    EXPECT_EQ(book.memory_stats().levels, one_level);
+    EXPECT_EQ(book.bid_levels(), 1u);
+    EXPECT_TRUE(book.verify().ok());
+}
+
+TEST_F(OrderBookTest, WarmUpLeavesNoRetainedLevels) {
+    OrderBookConfig config;
+    config.retain_empty_levels = 1;
+    config.min_price = price_to_fixed(100.0);
+    book = OrderBook("AAPL", config);
+
+    ASSERT_TRUE(book.warm_up());
+    EXPECT_EQ(book.bid_levels(), 0u);
+    EXPECT_EQ(book.ask_levels(), 0u);
+    EXPECT_EQ(book.memory_stats().levels, 0u);    // No level nodes left at min_price
+    EXPECT_TRUE(book.verify().ok());
+
+    // The retention slot is free for a real level
+    auto s1 = make_limit_sell(100, 150.0);
+    book.add_order(&s1);
+    const size_t one_level = book.memory_stats().levels;
+    book.cancel_order(s1.id);
+    EXPECT_EQ(book.memory_stats().levels, one_level);
+    EXPECT_EQ(book.ask_levels(), 0u);
+}
+
+// ============================================================================
+// memory_stats()
+// ============================================================================
+
+TEST_F(OrderBookTest, MemoryStatsTrackEachComponent) {
+    const MemoryStats empty = book.memory_stats();
+    EXPECT_EQ(empty.levels, 0u);
+    EXPECT_EQ(empty.queue_nodes, 0u);
+    EXPECT_EQ(empty.orders, 0u);
+
+    auto b1 = make_limit_buy(100, 150.0);
+    auto b2 = make_limit_buy(100, 150.0);
+    auto s1 = make_limit_sell(100, 151.0);
+    book.add_order(&b1);
+    book.add_order(&b2);
+    book.add_order(&s1);
+
+    const MemoryStats stats = book.memory_stats();
+    EXPECT_GE(stats.levels, 2 * sizeof(PriceLevel));           // Two map nodes
+    EXPECT_GE(stats.queue_nodes, 3 * sizeof(Order*));           // Three list nodes
+    EXPECT_GT(stats.lookup_table, 3 * sizeof(OrderLocation));   // Nodes + buckets
+    EXPECT_EQ(stats.orders, 3 * sizeof(Order));
+    EXPECT_GT(stats.expiry_wheel, 0u);
+    EXPECT_EQ(stats.trade_tape, book.config().trade_tape * sizeof(TradeRecord));
+    EXPECT_EQ(stats.total(), stats.levels + stats.queue_nodes + stats.lookup_table +
+                             stats.expiry_wheel + stats.orders + stats.strings + stats.trade_tape);
+}
+
+TEST_F(OrderBookTest, MemoryStatsReturnToBaselineAfterCancel) {
+    auto b1 = make_limit_buy(100, 150.0);
+    book.add_order(&b1);
+    book.cancel_order(b1.id);
+
+    const MemoryStats stats = book.memory_stats();
+    EXPECT_EQ(stats.levels, 0u);
+    EXPECT_EQ(stats.queue_nodes, 0u);
+    EXPECT_EQ(stats.orders, 0u);
+}
+
+TEST_F(OrderBookTest, MemoryStatsCountHeapAllocatedSymbols) {
+    Order o(next_id_++, "A_VERY_LONG_INSTRUMENT_SYMBOL", Side::Buy, OrderType::Limit,
+            100, price_to_fixed(150.0));
+    const size_t before = book.memory_stats().strings;
+    book.add_order(&o);
+
+    EXPECT_EQ(book.memory_stats().strings, before + o.symbol.capacity() + 1);
+    book.cancel_order(o.id);
+    EXPECT_EQ(book.memory_stats().strings, before);
+}
+
+// ============================================================================
+// OrderBookConfig
+// ============================================================================
+
+TEST(OrderBookConfigTest, RejectsOffTickPrices) {
+    OrderBookConfig config;
+    config.tick_size = price_to_fixed(0.01);
+    OrderBook book("AAPL", config);
+
+    Order on_tick(1, "AAPL", Side::Buy, OrderType::Limit, 100, price_to_fixed(150.01));
+    Order off_tick(2, "AAPL", Side::Buy, OrderType::Limit, 100, price_to_fixed(150.0) + 5);
+    book.add_order(&on_tick);
+    book.add_order(&off_tick);
+
+    EXPECT_EQ(on_tick.status, OrderStatus::New);
+    EXPECT_EQ(off_tick.status, OrderStatus::Rejected);
+    EXPECT_EQ(book.order_count(), 1u);
+}
+
+TEST(OrderBookConfigTest, RejectsPricesOutsideBand) {
+    OrderBookConfig config;
+    config.min_price = price_to_fixed(100.0);
+    config.max_price = price_to_fixed(200.0);
+    OrderBook book("AAPL", config);
+
+    Order low(1, "AAPL", Side::Buy, OrderType::Limit, 100, price_to_fixed(99.0));
+    Order high(2, "AAPL", Side::Sell, OrderType::Limit, 100, price_to_fixed(201.0));
+    Order inside(3, "AAPL", Side::Buy, OrderType::Limit, 100, price_to_fixed(150.0));
+    book.add_order(&low);
+    book.add_order(&high);
+    book.add_order(&inside);
+
+    EXPECT_EQ(low.status, OrderStatus::Rejected);
+    EXPECT_EQ(high.status, OrderStatus::Rejected);
+    EXPECT_EQ(inside.status, OrderStatus::New);
+}
+
+TEST(OrderBookConfigTest, ExpectedOrdersReservesLookupBuckets) {
+    OrderBookConfig config;
+    config.expected_orders = 10'000;
+    OrderBook book("AAPL", config);
+
+    // Buckets are allocated up front, before any order arrives
+    EXPECT_GE(book.memory_stats().lookup_table, 10'000 * sizeof(void*));
+}
+
+TEST(OrderBookConfigTest, PoolAllocatorWarmUpReservesNodes) {
+    OrderBookConfig config;
+    config.expected_orders = 1'000;
+    config.expected_levels = 100;
+    config.allocator = AllocatorKind::Pool;
+    OrderBook book("AAPL", config);
+
+    ASSERT_TRUE(book.warm_up());
+    EXPECT_TRUE(book.empty());
+    EXPECT_EQ(book.bid_levels(), 0u);
+
+    // Pools are carved: everything is slack, nothing in use
+    const MemoryStats stats = book.memory_stats();
+    EXPECT_EQ(stats.levels, 0u);
+    EXPECT_EQ(stats.queue_nodes, 0u);
+    EXPECT_GT(stats.pool_slack, 1'000 * sizeof(Order*));
+
+    // Orders match normally on a pooled book
+    Order sell(1, "AAPL", Side::Sell, OrderType::Limit, 100, price_to_fixed(150.0));
+    Order buy(2, "AAPL", Side::Buy, OrderType::Limit, 100, price_to_fixed(150.0));
+    book.add_order(&sell);
+    auto trades = book.add_order(&buy);
+    ASSERT_EQ(trades.size(), 1u);
+    EXPECT_EQ(trades[0].id, 1u);   // warm_up doesn't consume trade IDs
+    EXPECT_TRUE(book.empty());
+}
+
+TEST(OrderBookConfigTest, WarmUpRefusesNonEmptyBook) {
+    OrderBook book("AAPL");
+    Order buy(1, "AAPL", Side::Buy, OrderType::Limit, 100, price_to_fixed(150.0));
+    book.add_order(&buy);
+
+    EXPECT_FALSE(book.warm_up());
+    EXPECT_EQ(book.order_count(), 1u);
+}
@@ -0,0 +1,248 @@
+#include <gtest/gtest.h>
+#include "order_index.hpp"
+#include "matching_engine.hpp"
+#include "counting_allocator.hpp"
+#include <deque>
+#include <limits>
+#include <map>
+#include <random>
+
+using namespace orderbook;
+
+// ============================================================================
+// Test Fixture
+// An OrderIndex of plain integers, so entries are easy to check.
+// ============================================================================
+
+class OrderIndexTest : public ::testing::Test {
+protected:
+    using Index = OrderIndex<uint64_t>;
+    static constexpr OrderId PAGE = Index::PAGE_SIZE;
+
+    std::map<OrderId, uint64_t> contents() const {
+        std::map<OrderId, uint64_t> out;
+        index.for_each([&](OrderId id, const uint64_t& v) { out[id] = v; });
+        return out;
+    }
+
+    Index index;
+};
+
+// ============================================================================
+// Dense ids
+// ============================================================================
+
+TEST_F(OrderIndexTest, DenseIdsStayOffTheOverflowMap) {
+    for (OrderId id = 1; id <= 5 * PAGE; ++id) {
+        index[id] = id * 10;
+    }
+    EXPECT_EQ(index.size(), 5 * PAGE);
+    EXPECT_EQ(index.overflow_size(), 0u);
+    ASSERT_NE(index.find(3 * PAGE + 7), nullptr);
+    EXPECT_EQ(*index.find(3 * PAGE + 7), (3 * PAGE + 7) * 10);
+    EXPECT_EQ(index.find(5 * PAGE + 1), nullptr);
+}
+
+TEST_F(OrderIndexTest, EntriesKeepTheirAddress) {
+    uint64_t* first = &index[1];
+    for (OrderId id = 2; id <= 10 * PAGE; ++id) {
+        index[id] = id;
+    }
+    EXPECT_EQ(index.find(1), first);
+}
+
+TEST_F(OrderIndexTest, EmptiedPagesAreRecycled) {
+    for (OrderId id = 1; id <= 2 * PAGE; ++id) index[id] = id;
+    const size_t bytes = index.page_bytes();
+
+    // Retire the oldest range, then issue a newer one: no growth
+    for (OrderId id = 1; id < PAGE; ++id) index.erase(id);
+    for (OrderId id = 2 * PAGE; id < 3 * PAGE; ++id) index[id] = id;
+    EXPECT_LE(index.page_bytes(), bytes + sizeof(void*));
+
+    EXPECT_EQ(index.find(5), nullptr);
+    EXPECT_EQ(index.size(), 2 * PAGE);
+    EXPECT_EQ(index.overflow_size(), 0u);
+}
+
+TEST_F(OrderIndexTest, ErasedSlotIsResetAndReusable) {
+    index[42] = 7;
+    index[43] = 8;
+    index.erase(42);
+    EXPECT_EQ(index.find(42), nullptr);
+    EXPECT_EQ(index[42], 0u);                // Default-constructed again
+    EXPECT_EQ(index.size(), 2u);
+}
+
+TEST_F(OrderIndexTest, TryEmplaceReportsPresentIds) {
+    index.set_dense_range(1, PAGE);
+    for (OrderId id : {OrderId{5}, 10 * PAGE}) {            // A page and the overflow map
+        auto [entry, inserted] = index.try_emplace(id);
+        ASSERT_TRUE(inserted);
+        *entry = id;
+
+        auto [again, inserted_again] = index.try_emplace(id);
+        EXPECT_FALSE(inserted_again);
+        EXPECT_EQ(again, entry);
+        EXPECT_EQ(*again, id);                               // Left untouched
+    }
+    EXPECT_EQ(index.size(), 2u);
+    EXPECT_EQ(index.overflow_size(), 1u);
+}
+
+TEST_F(OrderIndexTest, DenseReserveLeavesOverflowUnallocated) {
+    using Alloc = CountingAllocator<std::pair<const OrderId, uint64_t>>;
+    auto counter = std::make_shared<AllocationCounter>();
+    OrderIndex<uint64_t, Alloc> counted{Alloc(counter)};
+
+    counted.reserve(4 * PAGE);
+    EXPECT_EQ(counter->bytes, 0u);           // Pages only
+    EXPECT_GE(counted.page_bytes(), 4 * PAGE * sizeof(uint64_t));
+
+    counted.reserve(0, 1'000);               // Sparse ids: buckets
+    EXPECT_GE(counter->bytes, 1'000 * sizeof(void*));
+}
+
+// ============================================================================
+// Arbitrary ids
+// ============================================================================
+
+TEST_F(OrderIndexTest, FarIdsGoToOverflow) {
+    index[1] = 1;
+    index[std::numeric_limits<OrderId>::max()] = 2;
+    index[OrderId{1} << 50] = 3;
+
+    EXPECT_EQ(index.overflow_size(), 2u);
+    EXPECT_EQ(*index.find(std::numeric_limits<OrderId>::max()), 2u);
+    EXPECT_EQ(*index.find(OrderId{1} << 50), 3u);
+
+    index.erase(OrderId{1} << 50);
+    EXPECT_EQ(index.find(OrderId{1} << 50), nullptr);
+    EXPECT_EQ(index.size(), 2u);
+}
+
+TEST_F(OrderIndexTest, OverflowIdStillFoundAfterWindowMovesOverIt) {
+    index[1] = 1;
+    const OrderId far = (Index::MAX_WINDOW_PAGES + 2) * PAGE;
+    index[far] = 2;                          // Too far: overflow
+    ASSERT_EQ(index.overflow_size(), 1u);
+
+    index.erase(1);                          // Window empties
+    index[far - 1] = 3;                      // Window re-bases next to `far`
+    ASSERT_NE(index.find(far), nullptr);
+    EXPECT_EQ(*index.find(far), 2u);
+    EXPECT_EQ(index[far], 2u);               // Not duplicated into a page
+    EXPECT_EQ(index.size(), 2u);
+}
+
+TEST_F(OrderIndexTest, IdsOutsideTheDenseRangeGoToOverflow) {
+    index.set_dense_range(100, 199);
+    index[150] = 1;
+    index[200] = 2;                          // Next page, but outside the range
+    index[99] = 3;
+    EXPECT_EQ(index.overflow_size(), 2u);
+
+    index.set_dense_range(100, 299);         // Existing entries don't move
+    EXPECT_EQ(*index.find(200), 2u);
+    index[250] = 4;
+    EXPECT_EQ(index.overflow_size(), 2u);
+    EXPECT_EQ(index.size(), 4u);
+}
+
+TEST_F(OrderIndexTest, RandomOperationsMatchStdMap) {
+    std::mt19937_64 rng(11);
+    std::map<OrderId, uint64_t> reference;
+    OrderId next = 1'000'000;
+
+    for (int i = 0; i < 50'000; ++i) {
+        const int op = static_cast<int>(rng() % 10);
+        if (op < 5) {
+            OrderId id = (op == 0) ? rng() : next++;      // Mostly dense, some arbitrary
+            uint64_t v = rng();
+            index[id] = v;
+            reference[id] = v;
+        } else if (!reference.empty()) {
+            auto it = reference.lower_bound(rng() % (next + 1));
+            if (it == reference.end()) it = reference.begin();
+            index.erase(it->first);
+            reference.erase(it);
+        }
+    }
+    EXPECT_EQ(index.size(), reference.size());
+    EXPECT_EQ(contents(), reference);
+}
+
+// ============================================================================
+// OrderBook / MatchingEngine ids
+// ============================================================================
+
+TEST(OrderBookIdTest, NextOrderIdIsDenseFromIdBase) {
+    OrderBookConfig config;
+    config.id_base = 5'000;
+    OrderBook book("AAPL", config);
+
+    EXPECT_EQ(book.next_order_id(), 5'001u);
+    EXPECT_EQ(book.next_order_id(), 5'002u);
+}
+
+TEST(OrderBookIdTest, BookWorksOnIssuedIds) {
+    OrderBook book("AAPL");
+    std::deque<Order> orders;
+    for (int i = 0; i < 3'000; ++i) {
+        orders.emplace_back(book.next_order_id(), "AAPL", (i % 2) ? Side::Buy : Side::Sell,
+                            OrderType::Limit, 10, price_to_fixed((i % 2) ? 99.0 : 101.0));
+        book.add_order(&orders.back());
+    }
+    for (int i = 0; i < 3'000; i += 3) {
+        EXPECT_EQ(book.cancel_order(orders[i].id), ErrorCode::Success);
+    }
+    EXPECT_EQ(book.order_count(), 2'000u);
+    EXPECT_TRUE(book.verify().ok());
+}
+
+TEST(OrderBookIdTest, ClientIdsDoNotGetPages) {
+    // Ids a page apart: paging them would cost a whole page per order
+    OrderBook book("AAPL");
+    std::deque<Order> orders;
+    for (OrderId i = 1; i <= 1'000; ++i) {
+        orders.emplace_back(i * 1'024, "AAPL", Side::Buy, OrderType::Limit, 10,
+                            price_to_fixed(99.0));
+        book.add_order(&orders.back());
+    }
+    EXPECT_EQ(book.order_count(), 1'000u);
+    EXPECT_LT(book.memory_stats().lookup_table, 1'000u * 1'024);
+
+    // Issued ids still get pages alongside them
+    Order issued(book.next_order_id(), "AAPL", Side::Buy, OrderType::Limit, 10, price_to_fixed(99.0));
+    book.add_order(&issued);
+    EXPECT_EQ(book.cancel_order(issued.id), ErrorCode::Success);
+    EXPECT_EQ(book.cancel_order(orders[500].id), ErrorCode::Success);
+    EXPECT_TRUE(book.verify().ok());
+}
+
+TEST(OrderBookIdTest, WarmUpUsesAnIdInsideTheDenseWindow) {
+    OrderBookConfig config;
+    config.id_base = 5'000;
+    config.expected_orders = 100;
+    OrderBook book("AAPL", config);
+
+    ASSERT_TRUE(book.warm_up());
+    EXPECT_EQ(book.next_order_id(), 5'001u);   // Not consumed
+
+    // The real order reuses the page warm_up touched: no new page
+    const size_t lookup = book.memory_stats().lookup_table;
+    Order buy(book.next_order_id(), "AAPL", Side::Buy, OrderType::Limit, 10, price_to_fixed(99.0));
+    book.add_order(&buy);
+    EXPECT_LE(book.memory_stats().lookup_table, lookup + sizeof(void*));
+}
+
+TEST(OrderBookIdTest, EngineGivesBooksDisjointRanges) {
+    MatchingEngine engine;
+    OrderBook& a = engine.add_book("AAPL");
+    OrderBook& m = engine.add_book("MSFT");
+
+    OrderId ida = a.next_order_id();
+    OrderId idm = m.next_order_id();
+    EXPECT_NE(ida, idm);
+    EXPECT_EQ(idm - ida, OrderId{1} << MatchingEngine::BOOK_ID_BITS);
+}
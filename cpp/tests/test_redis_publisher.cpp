@@ -0,0 +1,505 @@
+#include <gtest/gtest.h>
+#include "matching_engine.hpp"
+#include "redis_publisher.hpp"
+#include <arpa/inet.h>
+#include <atomic>
+#include <cstdlib>
+#include <deque>
+#include <fcntl.h>
+#include <memory>
+#include <mutex>
+#include <netinet/in.h>
+#include <poll.h>
+#include <set>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace orderbook;
+using namespace std::chrono_literals;
+
+// ============================================================================
+// Helpers
+// FakeRedis: a loopback server that speaks just enough RESP for the
+// publisher. It answers every command with `reply` (":1" by default), or
+// holds the answers back while paused. Destroying it is Redis going down;
+// a new one on the same port is Redis coming back.
+// ============================================================================
+
+namespace {
+
+class FakeRedis {
+public:
+    explicit FakeRedis(int port = 0) {
+        listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        int one = 1;
+        setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(port));
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t len = sizeof(addr);
+        ::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        ::listen(listen_fd_, 4);
+        ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+        thread_ = std::thread(&FakeRedis::run, this);
+    }
+
+    ~FakeRedis() {
+        running_ = false;
+        thread_.join();
+        if (conn_fd_ >= 0) ::close(conn_fd_);
+        ::close(listen_fd_);
+    }
+
+    int port() const { return port_; }
+
+    void set_reply(const std::string& reply) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        reply_ = reply;
+    }
+
+    void pause(bool paused) { paused_ = paused; }
+
+    uint64_t commands() const { return commands_; }
+
+    std::string received() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return received_;
+    }
+
+    // Wait until `n` commands arrived
+    bool wait_for(uint64_t n) {
+        for (int i = 0; i < 500 && commands_ < n; ++i) std::this_thread::sleep_for(2ms);
+        return commands_ >= n;
+    }
+
+private:
+    void run() {
+        RespReplyScanner commands;             // A command is one RESP array
+        uint64_t owed = 0;
+        char buffer[16 * 1024];
+        while (running_) {
+            pollfd fds[2] = {{listen_fd_, POLLIN, 0}, {conn_fd_, POLLIN, 0}};
+            if (::poll(fds, conn_fd_ >= 0 ? 2 : 1, 5) < 0) continue;
+            if (fds[0].revents & POLLIN) {
+                if (conn_fd_ >= 0) ::close(conn_fd_);
+                conn_fd_ = ::accept(listen_fd_, nullptr, nullptr);
+                commands.reset();
+                owed = 0;
+            }
+            if (conn_fd_ >= 0 && (fds[1].revents & POLLIN)) {
+                const ssize_t n = ::recv(conn_fd_, buffer, sizeof(buffer), 0);
+                if (n <= 0) {
+                    ::close(conn_fd_);
+                    conn_fd_ = -1;
+                    continue;
+                }
+                const size_t complete = commands.feed(buffer, static_cast<size_t>(n));
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    received_.append(buffer, static_cast<size_t>(n));
+                }
+                owed += complete;
+                commands_ += complete;
+            }
+            if (conn_fd_ >= 0 && owed > 0 && !paused_) {
+                std::string replies;
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    for (uint64_t i = 0; i < owed; ++i) replies += reply_;
+                }
+                owed = 0;
+                (void)!::send(conn_fd_, replies.data(), replies.size(), MSG_NOSIGNAL);
+            }
+        }
+    }
+
+    int listen_fd_ = -1;
+    int conn_fd_ = -1;
+    int port_ = 0;
+    std::thread thread_;
+    std::atomic<bool> running_{true};
+    std::atomic<bool> paused_{false};
+    std::atomic<uint64_t> commands_{0};
+    std::mutex mutex_;
+    std::string reply_ = ":1\r\n";
+    std::string received_;
+};
+
+size_t count(const std::string& haystack, const std::string& needle) {
+    size_t n = 0;
+    for (size_t pos = haystack.find(needle); pos != std::string::npos; pos = haystack.find(needle, pos + 1)) ++n;
+    return n;
+}
+
+std::vector<TradeRecord> make_trades(size_t n) {
+    std::vector<TradeRecord> trades(n);
+    for (size_t i = 0; i < n; ++i) {
+        trades[i].id = i + 1;
+        trades[i].price = price_to_fixed(100.0) + static_cast<Price>(i);
+        trades[i].quantity = 1;
+        trades[i].buy_order_id = 2 * i + 1;
+        trades[i].sell_order_id = 2 * i + 2;
+    }
+    return trades;
+}
+
+std::string spill_path(const char* name) {
+    return "/tmp/ob_redis_spill_" + std::to_string(getpid()) + "_" + name;
+}
+
+RedisPublisherConfig config_for(int port, const char* name) {
+    RedisPublisherConfig config;
+    config.port = port;
+    config.spill_path = spill_path(name);
+    config.min_backoff = 5ms;
+    config.max_backoff = 40ms;
+    return config;
+}
+
+// A port nothing listens on (until a FakeRedis is started on it)
+int free_port() {
+    FakeRedis probe;
+    return probe.port();
+}
+
+// Every buy order id in the trade messages a server received
+std::set<uint64_t> buy_ids(const std::string& received) {
+    std::set<uint64_t> ids;
+    for (size_t pos = received.find(" buy="); pos != std::string::npos; pos = received.find(" buy=", pos + 1)) {
+        ids.insert(std::strtoull(received.c_str() + pos + 5, nullptr, 10));
+    }
+    return ids;
+}
+
+} // namespace
+
+// ============================================================================
+// RedisPublisher
+// ============================================================================
+
+TEST(RedisPublisherTest, PublishesTradeText) {
+    FakeRedis redis;
+    RedisPublisher publisher(config_for(redis.port(), "text"));
+    ASSERT_TRUE(publisher.wait_connected(1000ms));
+
+    publisher.publish_trade(Trade(1, 11, 22, "AAPL", price_to_fixed(101.0), 100, Side::Buy));
+    ASSERT_TRUE(redis.wait_for(1));
+    EXPECT_EQ(redis.received(),
+              "*3\r\n$7\r\nPUBLISH\r\n$6\r\ntrades\r\n"
+              "$51\r\nsymbol=AAPL price=101.000000 qty=100 buy=11 sell=22\r\n");
+    EXPECT_TRUE(publisher.flush(1000ms));
+    EXPECT_EQ(publisher.acknowledged(), 1u);
+    EXPECT_EQ(publisher.backlog_bytes(), 0u);
+}
+
+TEST(RedisPublisherTest, BatchIsPipelinedWithoutWaitingForReplies) {
+    FakeRedis redis;
+    RedisPublisher publisher(config_for(redis.port(), "pipelined"));
+    ASSERT_TRUE(publisher.wait_connected(1000ms));
+    redis.pause(true);
+
+    auto trades = make_trades(1'000);
+    publisher.publish_trades("AAPL", trades.data(), trades.size());
+    ASSERT_TRUE(redis.wait_for(1'000));                 // All sent, none answered
+    EXPECT_GT(publisher.backlog_bytes(), 0u);
+    EXPECT_EQ(publisher.acknowledged(), 0u);
+
+    redis.pause(false);
+    EXPECT_TRUE(publisher.flush(1000ms));
+    EXPECT_EQ(publisher.acknowledged(), 1'000u);
+    EXPECT_EQ(count(redis.received(), "PUBLISH"), 1'000u);
+}
+
+TEST(RedisPublisherTest, StreamGetsAnXaddPerTrade) {
+    FakeRedis redis;
+    RedisPublisherConfig config = config_for(redis.port(), "stream");
+    config.stream = "trades.stream";
+    config.stream_max_len = 500;
+    RedisPublisher publisher(config);
+
+    auto trades = make_trades(10);
+    publisher.publish_trades("MSFT", trades.data(), trades.size());
+    ASSERT_TRUE(redis.wait_for(20));
+    const std::string received = redis.received();
+    EXPECT_EQ(count(received, "$7\r\nPUBLISH\r\n"), 10u);
+    EXPECT_EQ(count(received, "$4\r\nXADD\r\n$13\r\ntrades.stream\r\n$6\r\nMAXLEN\r\n$1\r\n~\r\n$3\r\n500\r\n"), 10u);
+    EXPECT_TRUE(publisher.flush(1000ms));
+}
+
+TEST(RedisPublisherTest, LongSymbolsAreCutAtSymbolSize) {
+    FakeRedis redis;
+    RedisPublisher publisher(config_for(redis.port(), "symbols"));
+    const std::string exact(RedisPublisher::SYMBOL_SIZE, 'X');
+    const std::string longer = exact + "TAIL";
+
+    auto trades = make_trades(2);
+    publisher.publish_trades(exact, &trades[0], 1);
+    publisher.publish_trades(longer, &trades[1], 1);
+    ASSERT_TRUE(publisher.flush(1000ms));
+    const std::string received = redis.received();
+    EXPECT_EQ(count(received, "symbol=" + exact + " price="), 2u);
+    EXPECT_EQ(received.find("TAIL"), std::string::npos);
+}
+
+TEST(RedisPublisherTest, ErrorRepliesAreCountedNotRetried) {
+    FakeRedis redis;
+    redis.set_reply("-ERR unknown command\r\n");
+    RedisPublisher publisher(config_for(redis.port(), "errors"));
+
+    auto trades = make_trades(3);
+    publisher.publish_trades("AAPL", trades.data(), trades.size());
+    EXPECT_TRUE(publisher.flush(1000ms));
+    EXPECT_EQ(publisher.errors(), 3u);
+    EXPECT_EQ(publisher.last_error(), "ERR unknown command");
+    EXPECT_EQ(redis.commands(), 3u);
+}
+
+TEST(RedisPublisherTest, RetryableErrorsAreSentAgain) {
+    FakeRedis redis;
+    redis.set_reply("-LOADING Redis is loading the dataset in memory\r\n");
+    RedisPublisher publisher(config_for(redis.port(), "loading"));
+
+    auto trades = make_trades(3);
+    publisher.publish_trades("AAPL", trades.data(), trades.size());
+    for (int i = 0; i < 500 && publisher.last_error().empty(); ++i) std::this_thread::sleep_for(2ms);
+    EXPECT_EQ(publisher.last_error(), "LOADING Redis is loading the dataset in memory");
+    EXPECT_FALSE(publisher.flush(20ms));                 // Not acknowledged
+
+    redis.set_reply(":1\r\n");                          // Done loading
+    ASSERT_TRUE(publisher.flush(2000ms));
+    EXPECT_EQ(publisher.errors(), 0u);
+    EXPECT_EQ(publisher.acknowledged(), 3u);
+    EXPECT_GE(publisher.reconnects(), 1u);
+    EXPECT_EQ(buy_ids(redis.received()).size(), 3u);
+}
+
+TEST(RedisPublisherTest, EngineSinkPublishesEachOrdersFills) {
+    FakeRedis redis;
+    RedisPublisher publisher(config_for(redis.port(), "engine"));
+
+    MatchingEngine engine;
+    engine.add_book("AAPL");
+    engine.add_trade_sink(&publisher);
+    std::deque<Order> orders;
+    orders.emplace_back(1, "AAPL", Side::Sell, OrderType::Limit, 50, price_to_fixed(150.0));
+    orders.emplace_back(2, "AAPL", Side::Sell, OrderType::Limit, 50, price_to_fixed(150.5));
+    orders.emplace_back(3, "AAPL", Side::Buy, OrderType::Limit, 80, price_to_fixed(151.0));
+    for (Order& o : orders) engine.add_order(&o);
+
+    ASSERT_TRUE(redis.wait_for(2));
+    const std::string received = redis.received();
+    EXPECT_NE(received.find("symbol=AAPL price=150.000000 qty=50 buy=3 sell=1"), std::string::npos);
+    EXPECT_NE(received.find("symbol=AAPL price=150.500000 qty=30 buy=3 sell=2"), std::string::npos);
+}
+
+// ============================================================================
+// Outages
+// ============================================================================
+
+TEST(RedisPublisherTest, TradesBeforeRedisStartsAreSpilledThenSent) {
+    const int port = free_port();
+    RedisPublisher publisher(config_for(port, "late_start"));
+    EXPECT_TRUE(publisher.ok());
+    EXPECT_FALSE(publisher.wait_connected(50ms));
+
+    auto trades = make_trades(500);
+    publisher.publish_trades("AAPL", trades.data(), trades.size());
+    EXPECT_FALSE(publisher.flush(50ms));
+    EXPECT_GT(publisher.backlog_bytes(), 0u);
+    EXPECT_EQ(access(spill_path("late_start").c_str(), F_OK), 0);
+
+    FakeRedis redis(port);
+    ASSERT_TRUE(publisher.flush(2000ms));
+    EXPECT_EQ(buy_ids(redis.received()).size(), 500u);
+    EXPECT_EQ(publisher.reconnects(), 0u);               // First connection
+}
+
+TEST(RedisPublisherTest, RedisRestartLosesNothing) {
+    const int port = free_port();
+    auto redis = std::make_unique<FakeRedis>(port);
+    RedisPublisher publisher(config_for(port, "restart"));
+    ASSERT_TRUE(publisher.wait_connected(1000ms));
+
+    auto trades = make_trades(3'000);
+    publisher.publish_trades("AAPL", trades.data(), 1'000);
+    ASSERT_TRUE(redis->wait_for(1'000));
+    std::string received = redis->received();
+
+    // Redis goes away mid-stream; publishing carries on without blocking
+    redis.reset();
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 1'000; i < 2'000; ++i) publisher.publish_trades("AAPL", &trades[i], 1);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 500ms);
+    EXPECT_FALSE(publisher.flush(50ms));
+
+    // Back on the same port: the backlog goes first, then live trades
+    redis = std::make_unique<FakeRedis>(port);
+    publisher.publish_trades("AAPL", trades.data() + 2'000, 1'000);
+    ASSERT_TRUE(publisher.flush(2000ms));
+    EXPECT_GE(publisher.reconnects(), 1u);
+
+    received += redis->received();
+    const std::set<uint64_t> ids = buy_ids(received);
+    EXPECT_EQ(ids.size(), 3'000u);                       // At least once, none missing
+
+    // In order on the new connection
+    const std::string after = redis->received();
+    EXPECT_LT(after.find(" buy=3999 "), after.find(" buy=4001 "));
+    EXPECT_LT(after.find(" buy=4001 "), after.find(" buy=5999 "));
+}
+
+TEST(RedisPublisherTest, BacklogSurvivesAPublisherRestart) {
+    const int port = free_port();
+    {
+        RedisPublisher publisher(config_for(port, "persist"));
+        auto trades = make_trades(200);
+        publisher.publish_trades("AAPL", trades.data(), trades.size());
+        publisher.stop();                                // Redis never came up
+    }
+    EXPECT_EQ(access(spill_path("persist").c_str(), F_OK), 0);
+
+    // Still no Redis: the recovered backlog can't have been sent yet
+    RedisPublisher publisher(config_for(port, "persist"));
+    EXPECT_GT(publisher.backlog_bytes(), 0u);
+
+    FakeRedis redis(port);
+    ASSERT_TRUE(publisher.flush(2000ms));
+    EXPECT_EQ(buy_ids(redis.received()).size(), 200u);
+
+    publisher.stop();                                    // Empty: the file goes away
+    EXPECT_NE(access(spill_path("persist").c_str(), F_OK), 0);
+}
+
+TEST(RedisPublisherTest, FullSpillLogHoldsTradesUntilRedisDrainsIt) {
+    const int port = free_port();
+    RedisPublisherConfig config = config_for(port, "full");
+    config.max_spill_bytes = 1 << 20;                    // The minimum: about 11,000 trades
+    config.queue_capacity = 4096;
+    RedisPublisher publisher(config);
+
+    // The log can't grow, then the queue fills: publishing overflows to
+    // memory and returns promptly, dropping nothing
+    auto trades = make_trades(30'000);
+    const auto start = std::chrono::steady_clock::now();
+    publisher.publish_trades("AAPL", trades.data(), trades.size());
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 500ms);
+    for (int i = 0; i < 1000 && publisher.last_error().empty(); ++i) std::this_thread::sleep_for(2ms);
+    EXPECT_NE(publisher.last_error().find("spill log can't grow"), std::string::npos);
+    EXPECT_GT(publisher.overflowed(), 0u);
+    EXPECT_EQ(publisher.dropped(), 0u);
+    EXPECT_LE(publisher.backlog_bytes(), config.max_spill_bytes);
+
+    FakeRedis redis(port);
+    ASSERT_TRUE(publisher.flush(5000ms));
+    EXPECT_EQ(publisher.errors(), 0u);
+    EXPECT_EQ(publisher.acknowledged(), 30'000u);
+    const std::string received = redis.received();
+    EXPECT_EQ(buy_ids(received).size(), 30'000u);
+    EXPECT_LT(received.find(" buy=1 "), received.find(" buy=59999 "));
+}
+
+TEST(RedisPublisherTest, FullOverflowDropsAndCounts) {
+    const int port = free_port();
+    RedisPublisherConfig config = config_for(port, "overflow");
+    config.max_spill_bytes = 1 << 20;
+    config.queue_capacity = 1024;
+    config.max_overflow = 1024;
+    RedisPublisher publisher(config);
+
+    auto trades = make_trades(20'000);                   // Past log, queue and overflow
+    const auto start = std::chrono::steady_clock::now();
+    publisher.publish_trades("AAPL", trades.data(), trades.size());
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 500ms);
+    EXPECT_GT(publisher.dropped(), 0u);
+    EXPECT_NE(publisher.last_error().find("dropping trades"), std::string::npos);
+
+    FakeRedis redis(port);
+    ASSERT_TRUE(publisher.flush(5000ms));                // Everything not dropped
+    EXPECT_EQ(publisher.acknowledged() + publisher.dropped(), 20'000u);
+}
+
+TEST(RedisPublisherTest, SpillLogTakesOnePublisherAtATime) {
+    const int port = free_port();
+    auto first = std::make_unique<RedisPublisher>(config_for(port, "locked"));
+    ASSERT_TRUE(first->ok());
+
+    RedisPublisher second(config_for(port, "locked"));
+    EXPECT_FALSE(second.ok());
+    EXPECT_NE(second.last_error().find("in use"), std::string::npos);
+
+    first.reset();                                       // Lock released
+    RedisPublisher third(config_for(port, "locked"));
+    EXPECT_TRUE(third.ok());
+}
+
+TEST(RedisPublisherTest, DefaultSpillPathIsPerRedisServer) {
+    RedisPublisherConfig config;
+    config.port = free_port();
+    RedisPublisher publisher(config);
+    ASSERT_TRUE(publisher.ok());
+    const std::string name = "/orderbook.redis.127.0.0.1-" + std::to_string(config.port) + ".spill";
+    const std::string& path = publisher.spill_path();
+    ASSERT_GT(path.size(), name.size());
+    EXPECT_EQ(path.substr(path.size() - name.size()), name);
+
+    // In a directory only this user can get into, readable only by it
+    struct stat st {};
+    ASSERT_EQ(stat(path.substr(0, path.size() - name.size()).c_str(), &st), 0);
+    EXPECT_EQ(st.st_uid, geteuid());
+    EXPECT_EQ(st.st_mode & 077, 0u);
+    ASSERT_EQ(stat(path.c_str(), &st), 0);
+    EXPECT_EQ(st.st_mode & 0777, 0600u);
+}
+
+TEST(RedisPublisherTest, SpillLogRefusesFilesOthersControl) {
+    const int port = free_port();
+    const std::string path = spill_path("unsafe");
+    const std::string target = path + ".target";
+
+    // A symlink planted at the path is not followed
+    ASSERT_EQ(symlink(target.c_str(), path.c_str()), 0);
+    {
+        RedisPublisher publisher(config_for(port, "unsafe"));
+        EXPECT_FALSE(publisher.ok());
+        EXPECT_NE(publisher.last_error().find("cannot open spill log"), std::string::npos);
+    }
+    EXPECT_NE(access(target.c_str(), F_OK), 0);
+    unlink(path.c_str());
+
+    // Nor is a file anyone may write to
+    const int fd = ::open(path.c_str(), O_CREAT | O_WRONLY, 0600);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(fchmod(fd, 0666), 0);
+    ::close(fd);
+    {
+        RedisPublisher publisher(config_for(port, "unsafe"));
+        EXPECT_FALSE(publisher.ok());
+        EXPECT_NE(publisher.last_error().find("not private"), std::string::npos);
+    }
+    EXPECT_EQ(access(path.c_str(), F_OK), 0);            // Left alone
+    unlink(path.c_str());
+}
+
+TEST(RedisPublisherTest, LargeBacklogDrainsWhileLiveTradesFlow) {
+    const int port = free_port();
+    RedisPublisherConfig config = config_for(port, "large");
+    config.drain_bytes = 64 * 1024;
+    RedisPublisher publisher(config);
+
+    auto trades = make_trades(50'000);                   // About 4 MB of commands: the log grows
+    publisher.publish_trades("AAPL", trades.data(), 40'000);
+    ASSERT_FALSE(publisher.flush(20ms));
+
+    FakeRedis redis(port);
+    for (size_t i = 40'000; i < 50'000; i += 100) {
+        publisher.publish_trades("AAPL", &trades[i], 100);
+        std::this_thread::sleep_for(100us);
+    }
+    ASSERT_TRUE(publisher.flush(5000ms));
+    EXPECT_EQ(publisher.acknowledged(), 50'000u);
+    EXPECT_EQ(buy_ids(redis.received()).size(), 50'000u);
+}
@@ -0,0 +1,325 @@
+#include <gtest/gtest.h>
+#include "replication.hpp"
+#include <chrono>
+#include <cstring>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace orderbook;
+using namespace std::chrono_literals;
+
+// ============================================================================
+// Helpers
+// A small deterministic order flow on one book: alternating sides around a
+// fixed mid so roughly half the orders trade.
+// ============================================================================
+
+namespace {
+
+Command flow_order(OrderId id) {
+    const Side side = (id % 2) ? Side::Buy : Side::Sell;
+    const double offset = static_cast<double>(id % 7) - 3.0;
+    Order order(id, "AAPL", side, OrderType::Limit, 10 + id % 5, price_to_fixed(100.0 + offset));
+    return Command::new_order(order);
+}
+
+Command stamped(Command cmd, SequenceNumber seq) {
+    cmd.seq = seq;
+    return cmd;
+}
+
+} // namespace
+
+// ============================================================================
+// Command
+// ============================================================================
+
+TEST(CommandTest, NewOrderRoundTripsOrderFields) {
+    Order order(42, "ESH6", Side::Sell, OrderType::Limit, 25, price_to_fixed(101.5));
+    order.time_in_force = TimeInForce::GoodTillTime;
+    order.expire_time = Timestamp(std::chrono::seconds(90));
+
+    Command cmd = Command::new_order(order);
+    EXPECT_EQ(cmd.type, CommandType::NewOrder);
+    EXPECT_EQ(cmd.symbol_string(), "ESH6");
+    EXPECT_EQ(cmd.order_id, 42u);
+    EXPECT_EQ(cmd.side, Side::Sell);
+    EXPECT_EQ(cmd.price, price_to_fixed(101.5));
+    EXPECT_EQ(cmd.quantity, 25u);
+    EXPECT_EQ(cmd.time_in_force, TimeInForce::GoodTillTime);
+    EXPECT_EQ(cmd.time_ns, 90'000'000'000);
+}
+
+TEST(CommandTest, FullLengthSymbolIsNotTruncated) {
+    Command cmd = Command::add_book("ABCDEFGHIJKLMNOP");   // Exactly SYMBOL_SIZE
+    EXPECT_EQ(cmd.symbol_string(), "ABCDEFGHIJKLMNOP");
+}
+
+// ============================================================================
+// SequencedEngine: determinism and checks
+// ============================================================================
+
+TEST(SequencedEngineTest, SameCommandsGiveSameChecksum) {
+    SequencedEngine a;
+    SequencedEngine b;
+    std::vector<Trade> trades_a;
+    std::vector<Trade> trades_b;
+
+    SequenceNumber seq = 0;
+    auto apply_both = [&](Command cmd) {
+        cmd.seq = ++seq;
+        EXPECT_EQ(a.apply(cmd, &trades_a), b.apply(cmd, &trades_b));
+    };
+
+    apply_both(Command::add_book("AAPL"));
+    for (OrderId id = 1; id <= 500; ++id) {
+        apply_both(flow_order(id));
+        if (id % 10 == 0) apply_both(Command::cancel("AAPL", id - 3));
+    }
+
+    EXPECT_FALSE(trades_a.empty());
+    EXPECT_EQ(trades_a.size(), trades_b.size());
+    EXPECT_EQ(a.checksum(), b.checksum());
+    EXPECT_EQ(a.last_sequence(), seq);
+    EXPECT_EQ(a.live_orders(), b.live_orders());
+    EXPECT_EQ(a.live_orders(), a.engine().book("AAPL")->order_count());
+}
+
+TEST(SequencedEngineTest, BooksSeeDenseIdsAndClientsTheirOwn) {
+    SequencedEngine engine;
+    engine.apply(stamped(Command::add_book("AAPL"), 1));
+    engine.apply(stamped(Command::add_book("MSFT"), 2));
+    const OrderBook& msft = *engine.engine().book("MSFT");
+
+    // Scattered client ids become the book's own consecutive ids
+    const OrderId sell_id = 900'000'000'001;
+    const OrderId buy_id = 17;
+    Order sell(sell_id, "MSFT", Side::Sell, OrderType::Limit, 10, price_to_fixed(100.0));
+    Order rest(555, "MSFT", Side::Sell, OrderType::Limit, 10, price_to_fixed(101.0));
+    engine.apply(stamped(Command::new_order(sell), 3));
+    engine.apply(stamped(Command::new_order(rest), 4));
+    EXPECT_EQ(engine.engine_id(sell_id), msft.config().id_base + 1);
+    EXPECT_EQ(engine.engine_id(555), msft.config().id_base + 2);
+    EXPECT_FALSE(msft.handle_of(engine.engine_id(555)).is_null());
+
+    // Trades come back in client ids
+    std::vector<Trade> trades;
+    Order buy(buy_id, "MSFT", Side::Buy, OrderType::Limit, 10, price_to_fixed(100.0));
+    EXPECT_EQ(engine.apply(stamped(Command::new_order(buy), 5), &trades), ErrorCode::Success);
+    ASSERT_EQ(trades.size(), 1u);
+    EXPECT_EQ(trades[0].buy_order_id, buy_id);
+    EXPECT_EQ(trades[0].sell_order_id, sell_id);
+    EXPECT_FALSE(engine.is_live(sell_id));
+    EXPECT_EQ(engine.engine_id(sell_id), INVALID_ORDER_ID);
+
+    // Cancel by client id; the wrong book doesn't find it
+    EXPECT_EQ(engine.apply(stamped(Command::cancel("AAPL", 555), 6)), ErrorCode::OrderNotFound);
+    EXPECT_EQ(engine.apply(stamped(Command::cancel("MSFT", 555), 7)), ErrorCode::Success);
+    EXPECT_EQ(engine.live_orders(), 0u);
+    EXPECT_TRUE(msft.empty());
+}
+
+TEST(SequencedEngineTest, RejectsSequenceGapsWithoutApplying) {
+    SequencedEngine engine;
+    ASSERT_EQ(engine.apply(stamped(Command::add_book("AAPL"), 1)), ErrorCode::Success);
+
+    EXPECT_EQ(engine.apply(stamped(flow_order(1), 3)), ErrorCode::SequenceGap);
+    EXPECT_EQ(engine.apply(stamped(flow_order(1), 1)), ErrorCode::SequenceGap);
+    EXPECT_EQ(engine.last_sequence(), 1u);
+    EXPECT_EQ(engine.engine().book("AAPL")->order_count(), 0u);
+}
+
+TEST(SequencedEngineTest, ReportsRejections) {
+    SequencedEngine engine;
+    engine.apply(stamped(Command::add_book("AAPL"), 1));
+
+    Command unknown = flow_order(1);
+    std::memcpy(unknown.symbol, "MSFT", 4);
+    EXPECT_EQ(engine.apply(stamped(unknown, 2)), ErrorCode::BookNotFound);
+
+    Command zero = flow_order(2);
+    zero.quantity = 0;
+    EXPECT_EQ(engine.apply(stamped(zero, 3)), ErrorCode::InvalidQuantity);
+
+    Order resting(7, "AAPL", Side::Buy, OrderType::Limit, 10, price_to_fixed(90.0));
+    EXPECT_EQ(engine.apply(stamped(Command::new_order(resting), 4)), ErrorCode::Success);
+    EXPECT_EQ(engine.apply(stamped(Command::new_order(resting), 5)), ErrorCode::DuplicateOrderId);
+    EXPECT_EQ(engine.live_orders(), 1u);
+}
+
+TEST(SequencedEngineTest, CheckpointDetectsDivergence) {
+    SequencedEngine engine;
+    engine.apply(stamped(Command::add_book("AAPL"), 1));
+
+    Command good;
+    good.type = CommandType::Checkpoint;
+    good.checksum = engine.checkpoint_value();
+    EXPECT_EQ(engine.apply(stamped(good, 2)), ErrorCode::Success);
+    EXPECT_FALSE(engine.diverged());
+
+    Command bad = good;
+    bad.checksum ^= 1;
+    EXPECT_EQ(engine.apply(stamped(bad, 3)), ErrorCode::ChecksumMismatch);
+    EXPECT_TRUE(engine.diverged());
+}
+
+TEST(SequencedEngineTest, ExpiredOrdersAreReleased) {
+    SequencedEngine engine;
+    engine.apply(stamped(Command::add_book("AAPL"), 1));
+
+    Order gtt(1, "AAPL", Side::Buy, OrderType::Limit, 10, price_to_fixed(99.0));
+    gtt.time_in_force = TimeInForce::GoodTillTime;
+    gtt.expire_time = Timestamp(std::chrono::seconds(10));
+    Order gtc(2, "AAPL", Side::Buy, OrderType::Limit, 10, price_to_fixed(98.0));
+    engine.apply(stamped(Command::new_order(gtt), 2));
+    engine.apply(stamped(Command::new_order(gtc), 3));
+    ASSERT_EQ(engine.live_orders(), 2u);
+
+    engine.apply(stamped(Command::tick(Timestamp(std::chrono::seconds(11))), 4));
+    EXPECT_EQ(engine.live_orders(), 1u);     // Only the GTT order is released
+    EXPECT_EQ(engine.engine().book("AAPL")->order_count(), 1u);
+    EXPECT_EQ(engine.apply(stamped(Command::cancel("AAPL", 2), 5)), ErrorCode::Success);
+    EXPECT_EQ(engine.live_orders(), 0u);
+}
+
+// ============================================================================
+// Sequencer
+// ============================================================================
+
+TEST(SequencerTest, StampsConsecutiveSequenceNumbersAndCheckpoints) {
+    SequencedEngine engine;
+    Sequencer sequencer(engine, nullptr, 4);
+
+    sequencer.submit(Command::add_book("AAPL"));
+    for (OrderId id = 1; id <= 8; ++id) {
+        EXPECT_EQ(sequencer.submit(flow_order(id)), ErrorCode::Success);
+    }
+
+    // 9 commands plus a checkpoint after every 4th
+    EXPECT_EQ(sequencer.last_sequence(), 11u);
+    EXPECT_FALSE(engine.diverged());
+}
+
+TEST(SequencerTest, RejectsSymbolsTooLongForACommand) {
+    SequencedEngine engine;
+    Sequencer sequencer(engine);
+
+    // Cutting it would name "ABCDEFGHIJKLMNOP" instead
+    const std::string too_long = "ABCDEFGHIJKLMNOPQ";
+    EXPECT_EQ(sequencer.submit(Command::add_book(too_long)), ErrorCode::InvalidSymbol);
+    Order order(1, too_long, Side::Buy, OrderType::Limit, 10, price_to_fixed(99.0));
+    EXPECT_EQ(sequencer.submit(Command::new_order(order)), ErrorCode::InvalidSymbol);
+    EXPECT_EQ(sequencer.submit(Command::cancel(too_long, 1)), ErrorCode::InvalidSymbol);
+
+    EXPECT_EQ(sequencer.last_sequence(), 0u);   // Nothing was sequenced
+    EXPECT_EQ(engine.engine().book_count(), 0u);
+}
+
+// ============================================================================
+// Primary / backup over loopback TCP
+// ============================================================================
+
+class ReplicationTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_TRUE(primary.listening());
+        ASSERT_TRUE(backup.connect());
+        ASSERT_TRUE(primary.wait_for_backup(1000ms));
+    }
+
+    ReplicationPrimary primary{0};
+    ReplicationBackup backup{"127.0.0.1", primary.port(), 20ms};
+    SequencedEngine primary_engine;
+    Sequencer sequencer{primary_engine, &primary, 64};
+};
+
+TEST_F(ReplicationTest, BackupTracksPrimary) {
+    sequencer.submit(Command::add_book("AAPL"));
+    for (OrderId id = 1; id <= 2'000; ++id) {
+        sequencer.submit(flow_order(id));
+    }
+
+    ASSERT_TRUE(backup.wait_for_sequence(sequencer.last_sequence(), 5000ms));
+    EXPECT_FALSE(backup.diverged());
+    EXPECT_FALSE(backup.primary_failed());
+
+    SequencedEngine& replica = backup.promote();
+    EXPECT_EQ(replica.checksum(), primary_engine.checksum());
+    EXPECT_EQ(replica.live_orders(), primary_engine.live_orders());
+    EXPECT_EQ(replica.engine().book("AAPL")->best_bid(),
+              primary_engine.engine().book("AAPL")->best_bid());
+}
+
+TEST_F(ReplicationTest, BackupTakesOverAfterPrimaryFails) {
+    sequencer.submit(Command::add_book("AAPL"));
+    for (OrderId id = 1; id <= 100; ++id) {
+        sequencer.submit(flow_order(id));
+    }
+    ASSERT_TRUE(primary.flush(1000ms));
+    ASSERT_TRUE(backup.wait_for_sequence(sequencer.last_sequence(), 1000ms));
+
+    const auto crashed_at = std::chrono::steady_clock::now();
+    primary.stop();
+    ASSERT_TRUE(backup.wait_for_failover(1000ms));
+    const auto detected_in = std::chrono::steady_clock::now() - crashed_at;
+    EXPECT_LT(detected_in, 500ms);
+
+    // New primary continues the same sequence on the promoted engine
+    SequencedEngine& promoted = backup.promote();
+    EXPECT_EQ(promoted.checksum(), primary_engine.checksum());
+
+    Sequencer takeover(promoted);
+    const SequenceNumber before = takeover.last_sequence();
+    EXPECT_EQ(takeover.submit(flow_order(101)), ErrorCode::Success);
+    EXPECT_EQ(takeover.last_sequence(), before + 1);
+}
+
+TEST_F(ReplicationTest, SilentPrimaryIsDetectedByTimeout) {
+    sequencer.submit(Command::add_book("AAPL"));
+    ASSERT_TRUE(backup.wait_for_sequence(1, 1000ms));
+
+    // Heartbeats keep the link alive well past the failover timeout
+    std::this_thread::sleep_for(60ms);
+    EXPECT_FALSE(backup.primary_failed());
+}
+
+TEST(ReplicationPrimaryTest, StalledBackupCostsAtMostMaxBlockPerCommand) {
+    ReplicationPrimary primary{0, 1ms, 16, 10us};
+    ASSERT_TRUE(primary.listening());
+
+    // A "backup" that connects and never reads: the socket buffers fill,
+    // then the queue
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(primary.port());
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ASSERT_EQ(::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+    ASSERT_TRUE(primary.wait_for_backup(1000ms));
+
+    // Fill the socket, then the queue, until commands are refused in a row
+    // (a lone refusal may just be the sender thread not having run yet)
+    constexpr SequenceNumber N = 1'000'000;          // ~72 MB: more than the socket holds
+    SequenceNumber seq = 0;
+    for (int in_a_row = 0; in_a_row < 100 && seq < N;) {
+        in_a_row = primary.replicate(stamped(Command::tick(Timestamp{}), ++seq)) ? 0 : in_a_row + 1;
+    }
+    ASSERT_LT(seq, N);
+    const uint64_t overflowed = primary.overflowed();
+
+    // Still stalled: each command waits out max_block at most, then is
+    // dropped (the socket may take the odd batch as its buffer grows)
+    uint64_t refused = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 1'000; ++i) {
+        refused += !primary.replicate(stamped(Command::tick(Timestamp{}), ++seq));
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 500ms);
+    EXPECT_GT(refused, 0u);
+    EXPECT_EQ(primary.overflowed(), overflowed + refused);
+    EXPECT_FALSE(primary.flush(10ms));
+
+    primary.stop();
+    ::close(fd);
+}
@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+#include "resp_writer.hpp"
+#include <string>
+
+using namespace orderbook;
+
+namespace {
+
+std::string bytes(const RespWriter& w) {
+    return std::string(w.data(), w.size());
+}
+
+TradeRecord trade(TradeId id, Price price, uint32_t qty, OrderId buy, OrderId sell) {
+    TradeRecord r;
+    r.id = id;
+    r.price = price;
+    r.quantity = qty;
+    r.buy_order_id = buy;
+    r.sell_order_id = sell;
+    return r;
+}
+
+// The message RedisPublisher built with std::to_string before RespWriter
+std::string to_string_message(const std::string& symbol, const TradeRecord& t) {
+    return "symbol=" + symbol +
+           " price=" + std::to_string(price_to_double(t.price)) +
+           " qty="   + std::to_string(t.quantity) +
+           " buy="   + std::to_string(t.buy_order_id) +
+           " sell="  + std::to_string(t.sell_order_id);
+}
+
+std::string bulk(const std::string& s) {
+    return "$" + std::to_string(s.size()) + "\r\n" + s + "\r\n";
+}
+
+} // namespace
+
+// ============================================================================
+// RespWriter
+// ============================================================================
+
+TEST(RespWriterTest, PublishIsAnArrayOfBulkStrings) {
+    RespWriter w;
+    w.publish("trades", "hello");
+    EXPECT_EQ(bytes(w), "*3\r\n$7\r\nPUBLISH\r\n$6\r\ntrades\r\n$5\r\nhello\r\n");
+    EXPECT_EQ(w.commands(), 1u);
+}
+
+TEST(RespWriterTest, TradeMessageMatchesToStringFormat) {
+    const TradeRecord cases[] = {
+        trade(1, price_to_fixed(101.0), 100, 1, 2),
+        trade(2, 123'456'789, 7, 1'000'000'007, 18'446'744'073'709'551'615ull),
+        trade(3, 1, 1, 0, 0),                       // 0.000001
+        trade(4, 0, 0, 9, 10),
+        trade(5, -2'500'000, 3, 4, 5),              // -2.500000
+        trade(6, -1, 3, 4, 5),                      // -0.000001
+        trade(7, 99'999'999'999'999, 4'294'967'295u, 1, 1),
+    };
+    for (const TradeRecord& t : cases) {
+        RespWriter w;
+        w.publish_trade("trades", "AAPL", t);
+        EXPECT_EQ(bytes(w), "*3\r\n$7\r\nPUBLISH\r\n$6\r\ntrades\r\n" +
+                            bulk(to_string_message("AAPL", t)))
+            << "trade " << t.id;
+    }
+}
+
+TEST(RespWriterTest, XaddWithAndWithoutMaxLen) {
+    RespWriter w;
+    w.xadd_trade("trades.stream", 1000, "MSFT", trade(1, price_to_fixed(5.25), 10, 3, 4));
+    EXPECT_EQ(bytes(w), "*16\r\n" + bulk("XADD") + bulk("trades.stream") + bulk("MAXLEN") +
+                        bulk("~") + bulk("1000") + bulk("*") + bulk("symbol") + bulk("MSFT") +
+                        bulk("price") + bulk("5.250000") + bulk("qty") + bulk("10") +
+                        bulk("buy") + bulk("3") + bulk("sell") + bulk("4"));
+
+    w.clear();
+    w.xadd_trade("s", 0, "MSFT", trade(1, price_to_fixed(5.25), 10, 3, 4));
+    EXPECT_EQ(bytes(w).substr(0, 5 + bulk("XADD").size() + bulk("s").size() + bulk("*").size()),
+              "*13\r\n" + bulk("XADD") + bulk("s") + bulk("*"));
+}
+
+TEST(RespWriterTest, BatchSharesOneBufferAndClearKeepsIt) {
+    RespWriter w(256);
+    for (int i = 0; i < 100; ++i) w.publish_trade("trades", "AAPL", trade(i, price_to_fixed(100.0), 1, 1, 2));
+    EXPECT_EQ(w.commands(), 100u);
+    EXPECT_GT(w.capacity(), 256u);        // Grew to hold the batch
+
+    const size_t capacity = w.capacity();
+    const char* memory = w.data();
+    w.clear();
+    EXPECT_TRUE(w.empty());
+    for (int i = 0; i < 100; ++i) w.publish_trade("trades", "AAPL", trade(i, price_to_fixed(100.0), 1, 1, 2));
+    EXPECT_EQ(w.capacity(), capacity);   // No reallocation the second time
+    EXPECT_EQ(w.data(), memory);
+}
+
+// ============================================================================
+// RespReplyScanner
+// ============================================================================
+
+TEST(RespReplyScannerTest, CountsEveryReplyType) {
+    RespReplyScanner s;
+    const std::string replies = ":1\r\n+OK\r\n$15\r\n1700000000000-0\r\n$-1\r\n*2\r\n:1\r\n$1\r\nx\r\n*-1\r\n";
+    EXPECT_EQ(s.feed(replies.data(), replies.size()), 6u);
+    EXPECT_EQ(s.replies(), 6u);
+    EXPECT_EQ(s.errors(), 0u);
+    EXPECT_TRUE(s.ok());
+}
+
+TEST(RespReplyScannerTest, RepliesSplitAcrossReads) {
+    RespReplyScanner s;
+    const std::string replies = ":12\r\n$5\r\nhello\r\n*2\r\n:1\r\n:2\r\n";
+    size_t total = 0;
+    for (char c : replies) total += s.feed(&c, 1);   // One byte at a time
+    EXPECT_EQ(total, 3u);
+    EXPECT_EQ(s.replies(), 3u);
+}
+
+TEST(RespReplyScannerTest, ErrorRepliesAreCountedAndKept) {
+    RespReplyScanner s;
+    const std::string replies = ":1\r\n-WRONGTYPE Operation against a key\r\n:0\r\n";
+    EXPECT_EQ(s.feed(replies.data(), replies.size()), 3u);
+    EXPECT_EQ(s.errors(), 1u);
+    EXPECT_EQ(s.last_error(), "WRONGTYPE Operation against a key");
+}
+
+TEST(RespReplyScannerTest, RetryableErrorsStopTheScan) {
+    RespReplyScanner s;
+    const std::string replies = ":1\r\n-LOADING Redis is loading the dataset in memory\r\n:1\r\n";
+    EXPECT_EQ(s.feed(replies.data(), replies.size()), 1u);   // Only the reply before it
+    EXPECT_TRUE(s.retry());
+    EXPECT_EQ(s.errors(), 0u);
+    EXPECT_EQ(s.last_error(), "LOADING Redis is loading the dataset in memory");
+    EXPECT_EQ(s.feed(":1\r\n", 4), 0u);
+    s.reset();
+    EXPECT_FALSE(s.retry());
+
+    const std::string busy = "-BUSYGROUP Consumer Group name already exists\r\n-TRYAGAIN Multiple keys\r\n";
+    EXPECT_EQ(s.feed(busy.data(), busy.size()), 1u);         // BUSYGROUP is not BUSY
+    EXPECT_EQ(s.errors(), 1u);
+    EXPECT_TRUE(s.retry());
+}
+
+TEST(RespReplyScannerTest, GarbageStopsTheScanner) {
+    RespReplyScanner s;
+    const std::string replies = ":1\r\nHTTP/1.1 400\r\n";
+    EXPECT_EQ(s.feed(replies.data(), replies.size()), 1u);
+    EXPECT_FALSE(s.ok());
+    s.reset();
+    EXPECT_TRUE(s.ok());
+}
+
+TEST(RespReplyScannerTest, ElementSizeFindsCommandBoundaries) {
+    RespWriter w;
+    w.publish("trades", "a");
+    const size_t first = w.size();
+    w.publish("trades", "bc");
+
+    EXPECT_EQ(RespReplyScanner::element_size(w.data(), w.size()), first);
+    EXPECT_EQ(RespReplyScanner::element_size(w.data() + first, w.size() - first), w.size() - first);
+    EXPECT_EQ(RespReplyScanner::element_size(w.data(), first - 1), 0u);   // Incomplete
+}
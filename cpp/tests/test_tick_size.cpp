@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include "tick_size.hpp"
+#include "order.hpp"
+#include <random>
+
+using namespace orderbook;
+
+// ============================================================================
+// TickSize: reciprocal division must agree with hardware division
+// ============================================================================
+
+TEST(TickSizeTest, DefaultTickAcceptsEveryPrice) {
+    TickSize tick;
+    EXPECT_EQ(tick.tick(), 1);
+    EXPECT_EQ(tick.to_index(123'456'789), 123'456'789u);
+    EXPECT_TRUE(tick.is_aligned(7));
+}
+
+TEST(TickSizeTest, NonPositiveTickFallsBackToOne) {
+    EXPECT_EQ(TickSize(0).tick(), 1);
+    EXPECT_EQ(TickSize(-5).tick(), 1);
+}
+
+TEST(TickSizeTest, MatchesDivisionForCommonTicks) {
+    // Power-of-ten ticks, a power of two, and awkward divisors that need the
+    // 65-bit magic (7) or have a large shift
+    const Price ticks[] = {1, 10, 100, 1'000, 10'000, 100'000, 1'000'000,
+                           5'000, 25'000, 7, 3, 1'024, 999'983, 123'456'789};
+    std::mt19937_64 rng(42);
+
+    for (Price t : ticks) {
+        TickSize tick(t);
+        for (int i = 0; i < 10'000; ++i) {
+            Price price = static_cast<Price>(rng() >> 1);   // Any non-negative int64
+            if (i % 2) price %= price_to_fixed(1'000'000.0);  // Realistic range too
+            ASSERT_EQ(tick.to_index(price), static_cast<uint64_t>(price / t))
+                << "tick=" << t << " price=" << price;
+        }
+        EXPECT_EQ(tick.to_index(0), 0u);
+        EXPECT_EQ(tick.to_index(INT64_MAX), static_cast<uint64_t>(INT64_MAX / t));
+    }
+}
+
+TEST(TickSizeTest, IsAlignedDetectsOffTickPrices) {
+    TickSize cent(price_to_fixed(0.01));
+
+    EXPECT_TRUE(cent.is_aligned(price_to_fixed(150.25)));
+    EXPECT_FALSE(cent.is_aligned(price_to_fixed(150.25) + 1));
+    EXPECT_FALSE(cent.is_aligned(-price_to_fixed(1.0)));
+    EXPECT_EQ(cent.from_index(cent.to_index(price_to_fixed(150.25))), price_to_fixed(150.25));
+}
+
+// ============================================================================
+// FixedTickSize
+// ============================================================================
+
+TEST(FixedTickSizeTest, DecimalTickMatchesRuntimeTick) {
+    TickSize runtime(DecimalTick<2>::tick());
+    for (Price p = 0; p < price_to_fixed(2.0); p += 997) {
+        ASSERT_EQ(DecimalTick<2>::to_index(p), runtime.to_index(p));
+        ASSERT_EQ(DecimalTick<2>::is_aligned(p), runtime.is_aligned(p));
+    }
+}
+
+TEST(FixedTickSizeTest, UsableInConstantExpressions) {
+    static_assert(DecimalTick<2>::to_index(1'500'000) == 150, "");
+    static_assert(DecimalTick<0>::is_aligned(2'000'000), "");
+    static_assert(!DecimalTick<0>::is_aligned(2'000'001), "");
+    SUCCEED();
+}
+
+// ============================================================================
+// validate_order() with a tick size
+// ============================================================================
+
+TEST(ValidateOrderTest, OffTickLimitPriceRejected) {
+    TickSize cent(price_to_fixed(0.01));
+    Order on(1, "AAPL", Side::Buy, OrderType::Limit, 100, price_to_fixed(150.01));
+    Order off(2, "AAPL", Side::Buy, OrderType::Limit, 100, price_to_fixed(150.01) + 1);
+    Order market(3, "AAPL", Side::Buy, OrderType::Market, 100);
+
+    EXPECT_EQ(validate_order(on, cent), ErrorCode::Success);
+    EXPECT_EQ(validate_order(off, cent), ErrorCode::InvalidPrice);
+    EXPECT_EQ(validate_order(market, cent), ErrorCode::Success);
+}
@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+#include "timer_wheel.hpp"
+#include <vector>
+
+using namespace orderbook;
+using namespace std::chrono_literals;
+
+// ============================================================================
+// Test Fixture
+// A wheel with 1ms ticks starting at a fixed origin, plus helpers to drain it.
+// ============================================================================
+
+class TimerWheelTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        origin = now();
+        wheel = TimerWheel(origin, 1ms);
+    }
+
+    std::vector<OrderId> drain() {
+        std::vector<OrderId> ids;
+        while (TimerNode* node = wheel.pop_due()) {
+            ids.push_back(node->order_id);
+        }
+        return ids;
+    }
+
+    Timestamp origin{};
+    TimerWheel wheel{};
+};
+
+// ============================================================================
+// Basic Scheduling
+// ============================================================================
+
+TEST_F(TimerWheelTest, InitiallyEmpty) {
+    EXPECT_TRUE(wheel.empty());
+    EXPECT_FALSE(wheel.has_due());
+    EXPECT_EQ(wheel.pop_due(), nullptr);
+}
+
+TEST_F(TimerWheelTest, TimerNotDueBeforeDeadline) {
+    TimerNode node;
+    node.order_id = 1;
+    wheel.schedule(node, origin + 10ms);
+
+    wheel.advance(origin + 9ms);
+    EXPECT_FALSE(wheel.has_due());
+    EXPECT_EQ(wheel.size(), 1u);
+}
+
+TEST_F(TimerWheelTest, TimerDueAtDeadline) {
+    TimerNode node;
+    node.order_id = 1;
+    wheel.schedule(node, origin + 10ms);
+
+    wheel.advance(origin + 10ms);
+    ASSERT_TRUE(wheel.has_due());
+    EXPECT_EQ(wheel.pop_due(), &node);
+    EXPECT_TRUE(wheel.empty());
+    EXPECT_FALSE(node.linked());
+}
+
+TEST_F(TimerWheelTest, DeadlineInThePastIsImmediatelyDue) {
+    wheel.advance(origin + 5ms);
+
+    TimerNode node;
+    wheel.schedule(node, origin + 1ms);
+    EXPECT_TRUE(wheel.has_due());
+}
+
+TEST_F(TimerWheelTest, CancelUnlinksTimer) {
+    TimerNode a, b;
+    a.order_id = 1;
+    b.order_id = 2;
+    wheel.schedule(a, origin + 10ms);
+    wheel.schedule(b, origin + 10ms);
+
+    wheel.cancel(a);
+    EXPECT_FALSE(a.linked());
+    EXPECT_EQ(wheel.size(), 1u);
+
+    wheel.advance(origin + 10ms);
+    EXPECT_EQ(drain(), std::vector<OrderId>{2});
+}
+
+TEST_F(TimerWheelTest, CancelDueTimerRemovesItFromDueList) {
+    TimerNode node;
+    wheel.schedule(node, origin + 1ms);
+    wheel.advance(origin + 1ms);
+    ASSERT_EQ(wheel.due_count(), 1u);
+
+    wheel.cancel(node);
+    EXPECT_EQ(wheel.due_count(), 0u);
+    EXPECT_EQ(wheel.pop_due(), nullptr);
+}
+
+TEST_F(TimerWheelTest, RescheduleMovesTimer) {
+    TimerNode node;
+    wheel.schedule(node, origin + 5ms);
+    wheel.schedule(node, origin + 50ms);
+
+    wheel.advance(origin + 10ms);
+    EXPECT_FALSE(wheel.has_due());
+    wheel.advance(origin + 50ms);
+    EXPECT_TRUE(wheel.has_due());
+}
+
+// ============================================================================
+// Cascading Across Levels
+// ============================================================================
+
+TEST_F(TimerWheelTest, TimersAtEveryLevelFireOnTime) {
+    // One timer per level: 100ms (L0), 10s (L1), 1h (L2), 10 days (L3)
+    const std::vector<std::chrono::milliseconds> delays = {
+        100ms, 10s, 1h, std::chrono::hours(24 * 10)
+    };
+    std::vector<TimerNode> nodes(delays.size());
+    for (size_t i = 0; i < delays.size(); ++i) {
+        nodes[i].order_id = i + 1;
+        wheel.schedule(nodes[i], origin + delays[i]);
+    }
+
+    for (size_t i = 0; i < delays.size(); ++i) {
+        wheel.advance(origin + delays[i] - 1ms);
+        EXPECT_FALSE(wheel.has_due()) << "timer " << i << " fired early";
+        wheel.advance(origin + delays[i]);
+        EXPECT_EQ(drain(), std::vector<OrderId>{i + 1});
+    }
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST_F(TimerWheelTest, DeadlineBeyondWheelRangeStillFiresOnTime) {
+    // 4 levels of 1ms ticks reach ~49 days; 60 days must be re-placed, not fired early
+    TimerNode node;
+    node.order_id = 7;
+    const auto deadline = origin + std::chrono::hours(24 * 60);
+    wheel.schedule(node, deadline);
+
+    wheel.advance(deadline - 1ms);
+    EXPECT_FALSE(wheel.has_due());
+    wheel.advance(deadline);
+    EXPECT_EQ(drain(), std::vector<OrderId>{7});
+}
+
+TEST_F(TimerWheelTest, ManyTimersAcrossBoundariesAllFire) {
+    std::vector<TimerNode> nodes(2000);
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        nodes[i].order_id = i + 1;
+        wheel.schedule(nodes[i], origin + std::chrono::milliseconds(i * 37));
+    }
+
+    size_t fired = 0;
+    for (int step = 0; step <= 2000 * 37; step += 997) {
+        wheel.advance(origin + std::chrono::milliseconds(step));
+        while (TimerNode* node = wheel.pop_due()) {
+            EXPECT_LE((node->order_id - 1) * 37, static_cast<uint64_t>(step));
+            ++fired;
+        }
+    }
+    wheel.advance(origin + std::chrono::milliseconds(2000 * 37));
+    fired += drain().size();
+
+    EXPECT_EQ(fired, nodes.size());
+    EXPECT_TRUE(wheel.empty());
+}
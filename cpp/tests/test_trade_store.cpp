@@ -0,0 +1,238 @@
+#include <gtest/gtest.h>
+#include "trade_store.hpp"
+#include "matching_engine.hpp"
+#include <deque>
+#include <filesystem>
+#include <unistd.h>
+
+using namespace orderbook;
+
+// ============================================================================
+// Test Fixture
+// A fresh store directory per test, removed afterwards. Records are built at
+// chosen wall-clock times by undoing the store's steady -> wall offset.
+// ============================================================================
+
+class TradeStoreTest : public ::testing::Test {
+protected:
+    static constexpr int64_t DAY = TradeStore::NANOS_PER_DAY;
+    static constexpr int64_t JAN_2_2024 = 19724 * DAY;     // 2024-01-02 00:00 UTC
+
+    void SetUp() override {
+        const auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+        root = (std::filesystem::temp_directory_path() /
+                ("trade_store_" + std::to_string(getpid()) + "_" + info->name())).string();
+        std::filesystem::remove_all(root);
+    }
+
+    void TearDown() override { std::filesystem::remove_all(root); }
+
+    TradeRecord at_wall(const TradeStore& store, int64_t wall_ns, Price price, uint32_t qty = 1,
+                        Side side = Side::Buy) const {
+        TradeRecord r;
+        r.timestamp_ns = wall_ns - store.wall_time(0);
+        r.price = price;
+        r.quantity = qty;
+        r.aggressor_side = side;
+        return r;
+    }
+
+    std::string root;
+};
+
+// ============================================================================
+// Append and query
+// ============================================================================
+
+TEST_F(TradeStoreTest, QueryReturnsAppendedColumns) {
+    TradeStore store(root);
+    TradeRecord records[] = {
+        at_wall(store, JAN_2_2024 + 100, 1'000, 5, Side::Buy),
+        at_wall(store, JAN_2_2024 + 200, 1'010, 7, Side::Sell),
+        at_wall(store, JAN_2_2024 + 300, 1'005, 9, Side::Buy),
+    };
+    EXPECT_EQ(store.append("AAPL", records, 3), 3u);
+
+    auto slices = store.query("AAPL", JAN_2_2024 + 150, JAN_2_2024 + 300);
+    ASSERT_EQ(slices.size(), 1u);
+    const TradeColumns& c = slices[0];
+    EXPECT_EQ(c.day, 19724);
+    ASSERT_EQ(c.size, 1u);                             // [from, to): only the 200 row
+    EXPECT_EQ(c.timestamp_ns[0], JAN_2_2024 + 200);
+    EXPECT_EQ(c.price[0], 1'010);
+    EXPECT_EQ(c.quantity[0], 7u);
+    EXPECT_EQ(c.side[0], Side::Sell);
+
+    EXPECT_TRUE(store.query("MSFT", 0, JAN_2_2024 + DAY).empty());
+    EXPECT_TRUE(std::filesystem::exists(root + "/AAPL/2024-01-02/timestamp_ns"));
+}
+
+TEST_F(TradeStoreTest, SlicesPointIntoTheMapping) {
+    TradeStore store(root);
+    TradeRecord r = at_wall(store, JAN_2_2024 + 1, 1'000);
+    store.append("AAPL", &r, 1);
+
+    auto first = store.query("AAPL", JAN_2_2024, JAN_2_2024 + DAY);
+    r = at_wall(store, JAN_2_2024 + 2, 1'001);
+    store.append("AAPL", &r, 1);
+    auto second = store.query("AAPL", JAN_2_2024, JAN_2_2024 + DAY);
+
+    ASSERT_EQ(second.size(), 1u);
+    EXPECT_EQ(first[0].timestamp_ns, second[0].timestamp_ns);   // Same memory, no copy
+    EXPECT_EQ(second[0].size, 2u);
+}
+
+TEST_F(TradeStoreTest, RangeQueriesAcrossIndexStrides) {
+    TradeStore store(root);
+    const size_t n = 3 * TradeStore::INDEX_STRIDE + 17;
+    std::vector<TradeRecord> records;
+    for (size_t i = 0; i < n; ++i) {
+        // Runs of equal timestamps that straddle stride boundaries
+        records.push_back(at_wall(store, JAN_2_2024 + static_cast<int64_t>(i / 3) * 10,
+                                  static_cast<Price>(i)));
+    }
+    ASSERT_EQ(store.append("AAPL", records.data(), n), n);
+
+    for (int64_t from : {int64_t(0), int64_t(13'650), int64_t(13'651), int64_t(40'000)}) {
+        for (int64_t length : {int64_t(1), int64_t(10), int64_t(5'000), int64_t(1'000'000)}) {
+            size_t expected_begin = n, expected_count = 0;
+            for (size_t i = 0; i < n; ++i) {
+                const int64_t t = static_cast<int64_t>(i / 3) * 10;
+                if (t >= from && t < from + length) {
+                    if (expected_count++ == 0) expected_begin = i;
+                }
+            }
+            auto slices = store.query("AAPL", JAN_2_2024 + from, JAN_2_2024 + from + length);
+            const size_t count = slices.empty() ? 0 : slices[0].size;
+            EXPECT_EQ(count, expected_count) << from << " +" << length;
+            if (count > 0) {
+                EXPECT_EQ(slices[0].price[0], static_cast<Price>(expected_begin)) << from;
+            }
+        }
+    }
+}
+
+TEST_F(TradeStoreTest, TradesSplitIntoDays) {
+    TradeStore store(root);
+    TradeRecord records[] = {
+        at_wall(store, JAN_2_2024 - 5, 1),                  // 2024-01-01 23:59:59.999999995
+        at_wall(store, JAN_2_2024 + 5, 2),
+    };
+    store.append("AAPL", records, 2);
+
+    auto slices = store.query("AAPL", JAN_2_2024 - DAY, JAN_2_2024 + DAY);
+    ASSERT_EQ(slices.size(), 2u);
+    EXPECT_EQ(slices[0].price[0], 1);
+    EXPECT_EQ(slices[1].price[0], 2);
+    EXPECT_TRUE(std::filesystem::exists(root + "/AAPL/2024-01-01/header"));
+    EXPECT_TRUE(std::filesystem::exists(root + "/AAPL/2024-01-02/header"));
+}
+
+TEST_F(TradeStoreTest, TimestampsStaySorted) {
+    TradeStore store(root);
+    TradeRecord records[] = {
+        at_wall(store, JAN_2_2024 + 100, 1),
+        at_wall(store, JAN_2_2024 + 50, 2),                 // Older than its predecessor
+    };
+    store.append("AAPL", records, 2);
+
+    auto slices = store.query("AAPL", JAN_2_2024, JAN_2_2024 + DAY);
+    ASSERT_EQ(slices[0].size, 2u);
+    EXPECT_EQ(slices[0].timestamp_ns[1], JAN_2_2024 + 100);
+}
+
+TEST_F(TradeStoreTest, FullDayStopsAppending) {
+    TradeStore store(root, false, 4);
+    std::vector<TradeRecord> records(6, at_wall(store, JAN_2_2024, 1));
+    EXPECT_EQ(store.append("AAPL", records.data(), records.size()), 4u);
+    EXPECT_EQ(store.dropped(), 2u);
+}
+
+TEST_F(TradeStoreTest, SymbolsStayInsideTheRoot) {
+    TradeStore store(root);
+    TradeRecord r = at_wall(store, JAN_2_2024 + 1, 1'000);
+    for (const std::string symbol : {"../escape", "BRK/B", "..", "%2F"}) {
+        EXPECT_EQ(store.append(symbol, &r, 1), 1u) << symbol;
+        EXPECT_EQ(store.query(symbol, JAN_2_2024, JAN_2_2024 + DAY).size(), 1u) << symbol;
+    }
+    EXPECT_EQ(store.query("BRK", JAN_2_2024, JAN_2_2024 + DAY).size(), 0u);
+    EXPECT_TRUE(std::filesystem::exists(root + "/BRK%2FB"));
+    EXPECT_TRUE(std::filesystem::exists(root + "/%2E."));
+    EXPECT_FALSE(std::filesystem::exists(root + "/../escape"));
+
+    EXPECT_EQ(store.append("", &r, 1), 0u);
+    EXPECT_EQ(store.dropped(), 1u);
+}
+
+TEST_F(TradeStoreTest, ReaderSeesWriterAndCannotWrite) {
+    TradeStore writer(root);
+    TradeRecord r = at_wall(writer, JAN_2_2024 + 1, 1'000);
+    writer.append("AAPL", &r, 1);
+
+    TradeStore reader(root, true);
+    auto before = reader.query("AAPL", JAN_2_2024, JAN_2_2024 + DAY);
+    ASSERT_EQ(before.size(), 1u);
+    EXPECT_EQ(before[0].size, 1u);
+
+    r = at_wall(writer, JAN_2_2024 + 2, 1'001);
+    writer.append("AAPL", &r, 1);
+    EXPECT_EQ(reader.query("AAPL", JAN_2_2024, JAN_2_2024 + DAY)[0].size, 2u);   // Shared mapping
+
+    EXPECT_EQ(reader.append("AAPL", &r, 1), 0u);
+    EXPECT_TRUE(reader.query("MSFT", JAN_2_2024, JAN_2_2024 + DAY).empty());
+    EXPECT_FALSE(std::filesystem::exists(root + "/MSFT"));
+}
+
+TEST_F(TradeStoreTest, ReopenedStoreAppendsAfterExistingRows) {
+    {
+        TradeStore store(root);
+        TradeRecord r = at_wall(store, JAN_2_2024 + 1, 1'000);
+        store.append("AAPL", &r, 1);
+        EXPECT_TRUE(store.flush());
+    }
+    TradeStore store(root);
+    TradeRecord r = at_wall(store, JAN_2_2024 + 2, 1'001);
+    store.append("AAPL", &r, 1);
+
+    auto slices = store.query("AAPL", JAN_2_2024, JAN_2_2024 + DAY);
+    ASSERT_EQ(slices[0].size, 2u);
+    EXPECT_EQ(slices[0].price[0], 1'000);
+    EXPECT_EQ(slices[0].price[1], 1'001);
+}
+
+TEST_F(TradeStoreTest, DayNames) {
+    EXPECT_EQ(TradeStore::day_name(0), "1970-01-01");
+    EXPECT_EQ(TradeStore::day_name(19723), "2024-01-01");
+    EXPECT_EQ(TradeStore::day_name(19782), "2024-02-29");
+    EXPECT_EQ(TradeStore::day_name(-1), "1969-12-31");
+}
+
+// ============================================================================
+// Fed by the engine
+// ============================================================================
+
+TEST_F(TradeStoreTest, EngineSinkStoresEveryTrade) {
+    TradeStore store(root);
+    MatchingEngine engine;
+    engine.add_book("AAPL");
+    engine.add_trade_sink(&store);
+
+    std::deque<Order> orders;
+    orders.emplace_back(1, "AAPL", Side::Sell, OrderType::Limit, 50, price_to_fixed(150.0));
+    orders.emplace_back(2, "AAPL", Side::Sell, OrderType::Limit, 50, price_to_fixed(151.0));
+    orders.emplace_back(3, "AAPL", Side::Buy, OrderType::Limit, 80, price_to_fixed(151.0));
+    for (Order& o : orders) engine.add_order(&o);
+
+    const int64_t wall_now = store.wall_time(timestamp_to_nanos(now()));
+    auto slices = store.query("AAPL", wall_now - DAY, wall_now + DAY);
+    ASSERT_EQ(slices.size(), 1u);
+    ASSERT_EQ(slices[0].size, 2u);
+    EXPECT_EQ(slices[0].price[0], price_to_fixed(150.0));
+    EXPECT_EQ(slices[0].quantity[1], 30u);
+    EXPECT_EQ(slices[0].side[1], Side::Buy);
+
+    engine.remove_trade_sink(&store);
+    orders.emplace_back(4, "AAPL", Side::Buy, OrderType::Limit, 20, price_to_fixed(151.0));
+    EXPECT_EQ(engine.add_order(&orders.back()).size(), 1u);
+    EXPECT_EQ(store.query("AAPL", wall_now - DAY, wall_now + DAY)[0].size, 2u);
+}
@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include "trade_tape.hpp"
+#include <cstring>
+
+using namespace orderbook;
+
+static TradeRecord record(TradeId id) {
+    TradeRecord r;
+    r.id = id;
+    r.quantity = static_cast<uint32_t>(id * 10);
+    return r;
+}
+
+// Ids of every record in range, in order
+static std::vector<TradeId> ids_of(const TradeTape::Range& range) {
+    std::vector<TradeId> ids;
+    for (const TradeTape::Span& span : {range.first, range.second}) {
+        for (size_t i = 0; i < span.size; ++i) ids.push_back(span.data[i].id);
+    }
+    return ids;
+}
+
+// ============================================================================
+// TradeRecord
+// ============================================================================
+
+TEST(TradeRecordTest, CarriesEveryTradeField) {
+    Trade trade(7, 11, 12, "AAPL", price_to_fixed(150.25), 300, Side::Sell);
+    TradeRecord r = to_record(trade, 42);
+
+    EXPECT_EQ(r.id, 7u);
+    EXPECT_EQ(r.buy_order_id, 11u);
+    EXPECT_EQ(r.sell_order_id, 12u);
+    EXPECT_EQ(r.price, price_to_fixed(150.25));
+    EXPECT_EQ(r.quantity, 300u);
+    EXPECT_EQ(r.timestamp_ns, timestamp_to_nanos(trade.timestamp));
+    EXPECT_EQ(r.instrument, 42);
+    EXPECT_EQ(r.aggressor_side, Side::Sell);
+    EXPECT_EQ(r.reserved, 0);
+}
+
+TEST(TradeRecordTest, SurvivesARawByteCopy) {
+    TradeRecord r = to_record(Trade(1, 2, 3, "AAPL", 100, 5, Side::Buy), 9);
+    unsigned char bytes[sizeof(TradeRecord)];
+    std::memcpy(bytes, &r, sizeof r);
+
+    TradeRecord back;
+    std::memcpy(&back, bytes, sizeof back);
+    EXPECT_EQ(std::memcmp(&back, &r, sizeof r), 0);
+}
+
+// ============================================================================
+// TradeTape
+// ============================================================================
+
+TEST(TradeTapeTest, CapacityRoundsUpAndZeroDisables) {
+    EXPECT_EQ(TradeTape(5).capacity(), 8u);
+    TradeTape off(0);
+    off.push(record(1));
+    EXPECT_EQ(off.head(), 0u);
+    EXPECT_EQ(off.since(0).size(), 0u);
+}
+
+TEST(TradeTapeTest, SinceReturnsRecordsInPlace) {
+    TradeTape tape(8);
+    for (TradeId id = 1; id <= 5; ++id) tape.push(record(id));
+
+    TradeTape::Range range = tape.since(2);
+    EXPECT_EQ(range.begin, 2u);
+    EXPECT_EQ(range.end, 5u);
+    EXPECT_EQ(range.second.size, 0u);
+    EXPECT_EQ(range.first.data, &tape.at(2));           // No copy
+    EXPECT_EQ(ids_of(range), (std::vector<TradeId>{3, 4, 5}));
+    EXPECT_EQ(tape.since(5).size(), 0u);                // Caught up
+}
+
+TEST(TradeTapeTest, WrappedRangeSplitsInTwo) {
+    TradeTape tape(4);
+    for (TradeId id = 1; id <= 6; ++id) tape.push(record(id));
+
+    EXPECT_EQ(tape.tail(), 2u);
+    TradeTape::Range range = tape.since(3);
+    EXPECT_EQ(range.first.size, 1u);
+    EXPECT_EQ(range.second.size, 2u);
+    EXPECT_EQ(ids_of(range), (std::vector<TradeId>{4, 5, 6}));
+}
+
+TEST(TradeTapeTest, LappedReaderStartsAtTail) {
+    TradeTape tape(4);
+    for (TradeId id = 1; id <= 10; ++id) tape.push(record(id));
+
+    TradeTape::Range range = tape.since(1);
+    EXPECT_EQ(range.begin, 6u);                         // Records 1..5 were overwritten
+    EXPECT_EQ(ids_of(range), (std::vector<TradeId>{7, 8, 9, 10}));
+}
@@ -1,14 +1,21 @@
 """
-Backtester — replays historical BTCUSDT daily data through the C++ engine
+Backtester — replays historical BTCUSDT bars through the C++ engine
 and measures strategy performance.
 
+Bars come from the engine itself: the trades recorded in a TradeStore
+(see binance_feed.py) are aggregated by the engine's BarAggregator.
+Without a store it falls back to daily OHLCV from Yahoo Finance.
+
 Usage:
+    python python/backtest.py --store /var/lib/orderbook/trades --interval 1h
     python python/backtest.py
 """
 
+import argparse
 import sys
 import os
 import math
+import time
 
 import yfinance as yf
 import pandas as pd
@@ -31,8 +38,49 @@ def fetch_data(ticker: str = "BTC-USD", period: str = "1y") -> pd.DataFrame:
     return df
 
 
+INTERVALS = {
+    "1s": orderbook_engine.BarInterval.Second,
+    "1m": orderbook_engine.BarInterval.Minute,
+    "1h": orderbook_engine.BarInterval.Hour,
+}
+PERIODS_PER_YEAR = {"1d": 252, "1s": 365 * 86_400, "1m": 365 * 1_440, "1h": 365 * 24}
+
+
+class _BarCollector(orderbook_engine.BarListener):
+    """Keeps the closed bars of one interval as DataFrame rows."""
+
+    def __init__(self, interval):
+        super().__init__()
+        self.interval = interval
+        self.rows = []
+
+    def on_bar(self, symbol, bar):
+        if bar.interval == self.interval:
+            self.rows.append((pd.Timestamp(bar.start_ns, unit="ns", tz="UTC"),
+                              bar.open, bar.high, bar.low, bar.close, bar.volume))
+
+
+def load_engine_bars(store_root: str, symbol: str, interval: str = "1h",
+                     days: int = 365) -> pd.DataFrame:
+    """Build OHLCV bars from the engine's recorded trades (last `days` days)."""
+    store = orderbook_engine.TradeStore(store_root)
+    bars = orderbook_engine.BarAggregator()
+    collector = _BarCollector(INTERVALS[interval])
+    bars.add_listener(collector)
+
+    to_ns = time.time_ns()
+    for day in store.query(symbol, to_ns - days * 86_400 * 10**9, to_ns):
+        bars.add_trades(symbol, day["timestamp_ns"], day["price"], day["quantity"])
+    bars.close_all()
+
+    df = pd.DataFrame(collector.rows,
+                      columns=["Date", "Open", "High", "Low", "Close", "Volume"])
+    return df.set_index("Date")
+
+
 # ── Backtest engine ────────────────────────────────────────────────────────────
-def run(df: pd.DataFrame, starting_cash: float = 100_000.0) -> dict:
+def run(df: pd.DataFrame, starting_cash: float = 100_000.0,
+        periods_per_year: int = 252) -> dict:
     cash = starting_cash
     btc_held = 0.0
     portfolio_values = []
@@ -93,7 +141,7 @@ def run(df: pd.DataFrame, starting_cash: float = 100_000.0) -> dict:
     avg_daily   = sum(daily_returns) / len(daily_returns)
     variance    = sum((r - avg_daily) ** 2 for r in daily_returns) / len(daily_returns)
     std_daily   = math.sqrt(variance)
-    sharpe      = (avg_daily / std_daily) * math.sqrt(252) if std_daily > 0 else 0.0
+    sharpe      = (avg_daily / std_daily) * math.sqrt(periods_per_year) if std_daily > 0 else 0.0
 
     return {
         "start_value":   starting_cash,
@@ -108,9 +156,9 @@ def run(df: pd.DataFrame, starting_cash: float = 100_000.0) -> dict:
 
 
 # ── Report ─────────────────────────────────────────────────────────────────────
-def print_report(results: dict) -> None:
+def print_report(results: dict, label: str = "BTCUSDT (1 year daily)") -> None:
     print("\n" + "=" * 45)
-    print("  BACKTEST RESULTS — BTCUSDT (1 year daily)")
+    print(f"  BACKTEST RESULTS — {label}")
     print("=" * 45)
     print(f"  Starting capital : ${results['start_value']:>12,.2f}")
     print(f"  Ending value     : ${results['end_value']:>12,.2f}")
@@ -124,10 +172,25 @@ def print_report(results: dict) -> None:
 
 
 if __name__ == "__main__":
-    print("Fetching 1 year of BTC-USD daily data...")
-    df = fetch_data("BTC-USD", period="1y")
-    print(f"  {len(df)} trading days loaded.")
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[1])
+    parser.add_argument("--store", help="TradeStore root recorded by binance_feed.py")
+    parser.add_argument("--symbol", default="BTCUSDT")
+    parser.add_argument("--interval", choices=sorted(INTERVALS), default="1h")
+    parser.add_argument("--days", type=int, default=365)
+    args = parser.parse_args()
+
+    if args.store:
+        print(f"Building {args.interval} bars from {args.store} ...")
+        df = load_engine_bars(args.store, args.symbol, args.interval, args.days)
+        periods, label = PERIODS_PER_YEAR[args.interval], f"{args.symbol} ({args.interval} engine bars)"
+    else:
+        print("Fetching 1 year of BTC-USD daily data...")
+        df = fetch_data("BTC-USD", period="1y")
+        periods, label = PERIODS_PER_YEAR["1d"], "BTCUSDT (1 year daily)"
+    print(f"  {len(df)} bars loaded.")
+    if df.empty:
+        sys.exit("No bars to backtest.")
 
     print("Running backtest...")
-    results = run(df)
-    print_report(results)
+    results = run(df, periods_per_year=periods)
+    print_report(results, label)
@@ -2,9 +2,12 @@ import websocket
 import json
 import sys
 import os
+import time
 import redis
 
 REDIS_HOST = os.environ.get("REDIS_HOST", "127.0.0.1")
+# Where matched trades are recorded (read back by backtest.py --store)
+TRADE_STORE = os.environ.get("TRADE_STORE", os.path.join(os.path.dirname(__file__), "../data/trades"))
 
 # Add the build directory so Python can find the compiled C++ module
 sys.path.append(os.path.join(os.path.dirname(__file__), "../cpp/build"))
@@ -17,9 +20,35 @@ URL = "wss://stream.binance.com:9443/ws/btcusdt@depth10@100ms"
 book = orderbook_engine.OrderBook("BTCUSDT")
 
 # Redis client — publishes matched trades to the "trades" channel
+# and closed bars to "bars.1s" / "bars.1m" / "bars.1h"
 r = redis.Redis(host=REDIS_HOST, port=6379)
 
 
+BAR_CHANNELS = {
+    orderbook_engine.BarInterval.Second: "bars.1s",
+    orderbook_engine.BarInterval.Minute: "bars.1m",
+    orderbook_engine.BarInterval.Hour:   "bars.1h",
+}
+
+
+class RedisBars(orderbook_engine.BarListener):
+    def on_bar(self, symbol, bar):
+        msg = (f"symbol={symbol} start={bar.start_ns} open={bar.open:.2f} high={bar.high:.2f} "
+               f"low={bar.low:.2f} close={bar.close:.2f} volume={bar.volume} "
+               f"vwap={bar.vwap:.2f} trades={bar.trades}")
+        r.publish(BAR_CHANNELS[bar.interval], msg)
+
+
+# The book's trades go to disk and into 1s/1m/1h bars; each keeps the
+# trade tape sequence it has read up to
+store = orderbook_engine.TradeStore(TRADE_STORE, read_only=False)
+bars = orderbook_engine.BarAggregator()
+bar_publisher = RedisBars()
+bars.add_listener(bar_publisher)
+store_cursor = 0
+bars_cursor = 0
+
+
 def on_message(ws, message):
     data = json.loads(message)
 
@@ -38,6 +67,13 @@ def on_message(ws, message):
     buy_trades  = book.add_order("buy",  bid_price, bid_qty)
     sell_trades = book.add_order("sell", ask_price, ask_qty)
 
+    # Record the new trades and update the bars; close bars that ended
+    # even if this message traded nothing
+    global store_cursor, bars_cursor
+    store_cursor = store.feed(book, store_cursor)
+    bars_cursor = bars.feed(book, bars_cursor)
+    bars.advance(time.time_ns())
+
     # Publish any matched trades to Redis
     for t in buy_trades + sell_trades:
         msg = f"symbol=BTCUSDT price={t.price():.2f} qty={t.quantity}"
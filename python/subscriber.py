@@ -1,17 +1,52 @@
 import redis
 import os
+import socket
+import struct
+import sys
 
 REDIS_HOST = os.environ.get("REDIS_HOST", "127.0.0.1")
 
-# Connect to Redis — host read from env so Docker and local both work
-client = redis.Redis(host=REDIS_HOST, port=6379)
-pubsub = client.pubsub()
+# TradeRecord as sent over the engine's Unix socket (48 bytes, little-endian):
+# id, buy_order_id, sell_order_id, price (fixed point), timestamp_ns,
+# quantity, instrument, aggressor_side, reserved
+TRADE_RECORD = struct.Struct("<QQQqqIHBB")
+PRICE_MULTIPLIER = 1_000_000
 
-# Subscribe to the trades channel
-pubsub.subscribe("trades")
-print("Listening for trades on channel 'trades'...")
 
-# Print every message received
-for message in pubsub.listen():
-    if message["type"] == "message":
-        print(f"Trade received: {message['data'].decode()}")
+def listen_uds(path: str) -> None:
+    """Read raw TradeRecords from `orderbook_demo --transport uds`."""
+    sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    sock.connect(path)
+    print(f"Listening for trades on {path}...")
+    buffer = b""
+    while chunk := sock.recv(65536):
+        buffer += chunk
+        whole = len(buffer) - len(buffer) % TRADE_RECORD.size
+        for fields in TRADE_RECORD.iter_unpack(buffer[:whole]):
+            trade_id, buy, sell, price, _, qty, _, side, _ = fields
+            print(f"Trade received: id={trade_id} price={price / PRICE_MULTIPLIER:.2f} "
+                  f"qty={qty} buy={buy} sell={sell} aggressor={'buy' if side == 0 else 'sell'}")
+        buffer = buffer[whole:]
+
+
+def listen_redis() -> None:
+    # Connect to Redis — host read from env so Docker and local both work
+    client = redis.Redis(host=REDIS_HOST, port=6379)
+    pubsub = client.pubsub()
+
+    # Subscribe to the trades channel
+    pubsub.subscribe("trades")
+    print("Listening for trades on channel 'trades'...")
+
+    # Print every message received
+    for message in pubsub.listen():
+        if message["type"] == "message":
+            print(f"Trade received: {message['data'].decode()}")
+
+
+if __name__ == "__main__":
+    # python subscriber.py [--uds /tmp/orderbook.trades]
+    if len(sys.argv) > 2 and sys.argv[1] == "--uds":
+        listen_uds(sys.argv[2])
+    else:
+        listen_redis()